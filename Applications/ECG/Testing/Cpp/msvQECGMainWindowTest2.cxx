@@ -0,0 +1,347 @@
+/*==============================================================================
+
+  Library: MSVTK
+
+  Copyright (c) Kitware Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// End-to-end performance test of the ECG application on a synthetic study.
+// The study is first read with plain VTK readers to measure a baseline in
+// the same run, then the main window is driven through open, play, select
+// electrodes and close with an offscreen 3D view. The wall time of each phase
+// and the peak resident set size are reported, and the test fails when one of
+// them exceeds its budget, computed from the baseline:
+//   first-mesh  ratio * (time to read one mesh) + slack
+//   open        ratio * (time to read the whole study) + slack
+//   play        ratio * (time to read every mesh) + slack
+//   select      max-select-ms
+//   close       max-close-ms
+//   peak RSS    start RSS + ratio * (baseline RSS growth) + slack
+// The traces of the selected electrodes must plot the signal files.
+//
+// Options (all optional):
+//   --points N --steps N --signals N --samples N    size of the study
+//   --ratio R --slack-ms T --slack-rss-mb M          budgets from the baseline
+//   --max-select-ms T --max-close-ms T               absolute budgets
+
+// Qt includes
+#include <QApplication>
+#include <QDir>
+#include <QEventLoop>
+#include <QList>
+#include <QMap>
+#include <QStringList>
+#include <QTime>
+#include <QTimer>
+
+// CTK includes
+#include <ctkVTKChartView.h>
+
+// ECG includes
+#include "msvQECGMainWindow.h"
+#include "msvQECGSyntheticStudy.h"
+#include "msvQTimePlayerWidget.h"
+
+// VTK includes
+#include <QVTKWidget.h>
+#include "vtkChartXY.h"
+#include "vtkContextMapper2D.h"
+#include "vtkDataArray.h"
+#include "vtkDelimitedTextReader.h"
+#include "vtkPlotLine.h"
+#include "vtkPolyDataReader.h"
+#include "vtkRenderWindow.h"
+#include "vtkSmartPointer.h"
+#include "vtkTable.h"
+
+// STD includes
+#include <cstdlib>
+#include <iostream>
+
+namespace
+{
+//------------------------------------------------------------------------------
+// Process events until the signal is emitted or the timeout expires.
+bool waitForSignal(QObject* sender, const char* signal, int timeoutMs)
+{
+  QEventLoop loop;
+  QTimer timer;
+  timer.setSingleShot(true);
+  QObject::connect(sender, signal, &loop, SLOT(quit()));
+  QObject::connect(&timer, SIGNAL(timeout()), &loop, SLOT(quit()));
+  timer.start(timeoutMs);
+  loop.exec();
+  return timer.isActive();
+}
+
+//------------------------------------------------------------------------------
+// Read a signal file like the study loader does.
+vtkSmartPointer<vtkTable> readSignal(const QString& fileName)
+{
+  vtkSmartPointer<vtkDelimitedTextReader> reader =
+    vtkSmartPointer<vtkDelimitedTextReader>::New();
+  reader->SetDetectNumericColumns(true);
+  reader->SetHaveHeaders(true);
+  reader->SetFileName(fileName.toLatin1().constData());
+  reader->Update();
+  return reader->GetOutput();
+}
+
+//------------------------------------------------------------------------------
+// Return true if one of the line plots of the chart draws the voltage of
+// the signal sample by sample.
+bool isSignalPlotted(vtkChartXY* chart, vtkTable* signal)
+{
+  vtkDataArray* expected = vtkDataArray::SafeDownCast(signal->GetColumn(1));
+  if (!expected)
+    {
+    return false;
+    }
+  for (vtkIdType i = 0; i < chart->GetNumberOfPlots(); ++i)
+    {
+    vtkPlotLine* plot = vtkPlotLine::SafeDownCast(chart->GetPlot(i));
+    vtkTable* input = plot ? plot->GetInput() : 0;
+    vtkDataArray* voltage = input ?
+      plot->GetData()->GetInputArrayToProcess(1, input) : 0;
+    if (!voltage ||
+        voltage->GetNumberOfTuples() != expected->GetNumberOfTuples())
+      {
+      continue;
+      }
+    bool same = true;
+    for (vtkIdType j = 0; same && j < expected->GetNumberOfTuples(); ++j)
+      {
+      same = (voltage->GetTuple1(j) == expected->GetTuple1(j));
+      }
+    if (same)
+      {
+      return true;
+      }
+    }
+  return false;
+}
+
+//------------------------------------------------------------------------------
+int runTest(QMap<QString, double>& options, const msvQECGSyntheticStudy& study,
+            const QString& root)
+{
+  QMap<QString, double> times;
+  QMap<QString, double> budgets;
+  QTime timer;
+  double startRSS = msvQECGSyntheticStudy::peakResidentSetSize();
+
+  // Baseline: read the whole study with the VTK readers, keeping it in memory
+  double baselineRSS = 0.;
+  double readOneMesh = 0.;
+  double readMeshes = 0.;
+  double readSignals = 0.;
+  {
+  QList<vtkSmartPointer<vtkPolyDataReader> > meshReaders;
+  timer.start();
+  for (int step = 0; step < study.NumberOfSteps; ++step)
+    {
+    vtkSmartPointer<vtkPolyDataReader> reader =
+      vtkSmartPointer<vtkPolyDataReader>::New();
+    QString fileName = QDir(root).filePath(
+      QString("CartoPoints/Points%1.vtk").arg(step));
+    reader->SetFileName(fileName.toLatin1().constData());
+    reader->Update();
+    meshReaders << reader;
+    if (step == 0)
+      {
+      readOneMesh = timer.elapsed();
+      }
+    }
+  readMeshes = timer.elapsed();
+  QList<vtkSmartPointer<vtkTable> > signalTables;
+  timer.start();
+  for (int signal = 0; signal < study.NumberOfSignals; ++signal)
+    {
+    signalTables << readSignal(QDir(root).filePath(
+      QString("CartoSignals/Signal%1.csv").arg(signal)));
+    }
+  readSignals = timer.elapsed();
+  baselineRSS = msvQECGSyntheticStudy::peakResidentSetSize();
+  }
+
+  double ratio = options["--ratio"];
+  double slack = options["--slack-ms"];
+  budgets["first-mesh"] = ratio * readOneMesh + slack;
+  budgets["open"] = ratio * (readMeshes + readSignals) + slack;
+  budgets["play"] = ratio * readMeshes + slack;
+  budgets["select"] = options["--max-select-ms"];
+  budgets["close"] = options["--max-close-ms"];
+  double rssBudget = startRSS + ratio * (baselineRSS - startRSS) +
+    options["--slack-rss-mb"];
+
+  msvQECGMainWindow mainWindow;
+  QVTKWidget* threeDView = mainWindow.findChild<QVTKWidget*>("threeDView");
+  ctkVTKChartView* ecgView = mainWindow.findChild<ctkVTKChartView*>("ecgView");
+  msvQTimePlayerWidget* timePlayerWidget =
+    mainWindow.findChild<msvQTimePlayerWidget*>();
+  if (!threeDView || !ecgView || !timePlayerWidget)
+    {
+    std::cerr << "Error: main window widgets not found." << std::endl;
+    return EXIT_FAILURE;
+    }
+  threeDView->GetRenderWindow()->OffScreenRenderingOn();
+
+  // Open
+  timer.start();
+  mainWindow.openData(root);
+  if (!waitForSignal(&mainWindow, SIGNAL(studyLoaded()),
+                     static_cast<int>(budgets["open"])))
+    {
+    std::cerr << "Error: the study was not loaded in "
+              << budgets["open"] << " ms." << std::endl;
+    return EXIT_FAILURE;
+    }
+  times["open"] = timer.elapsed();
+  times["first-mesh"] = mainWindow.timeToFirstMesh();
+
+  // Play every time step
+  timer.start();
+  timePlayerWidget->goToFirstFrame();
+  for (int step = 1; step < study.NumberOfSteps; ++step)
+    {
+    timePlayerWidget->goToNextFrame();
+    }
+  times["play"] = timer.elapsed();
+
+  // Select electrodes, one by one then overlaid
+  timer.start();
+  for (int signal = 0; signal < study.NumberOfSignals; ++signal)
+    {
+    mainWindow.setCurrentSignal(signal);
+    }
+  QList<int> signalIds;
+  for (int signal = 0; signal < qMin(study.NumberOfSignals, 10); ++signal)
+    {
+    signalIds << signal;
+    mainWindow.setSelectedSignals(signalIds);
+    }
+  times["select"] = timer.elapsed();
+  if (mainWindow.selectedSignals() != signalIds)
+    {
+    std::cerr << "Error: unexpected selected signals." << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // The overlaid traces plot their own signal
+  int res = EXIT_SUCCESS;
+  for (int signal = 0; signal < qMin(study.NumberOfSignals, 2); ++signal)
+    {
+    vtkSmartPointer<vtkTable> expected = readSignal(QDir(root).filePath(
+      QString("CartoSignals/Signal%1.csv").arg(signal)));
+    if (!isSignalPlotted(ecgView->chart(), expected))
+      {
+      std::cerr << "Error: signal " << signal << " is not plotted."
+                << std::endl;
+      res = EXIT_FAILURE;
+      }
+    }
+
+  // Close
+  timer.start();
+  mainWindow.closeData();
+  times["close"] = timer.elapsed();
+
+  double peakRSS = msvQECGSyntheticStudy::peakResidentSetSize();
+
+  std::cout << study.NumberOfPoints << " points, " << study.NumberOfSteps
+            << " steps, " << study.NumberOfSignals << " signals of "
+            << study.NumberOfSamples << " samples" << std::endl;
+  std::cout << "baseline: " << readMeshes << " ms to read the meshes, "
+            << readSignals << " ms to read the signals, "
+            << baselineRSS - startRSS << " MB" << std::endl;
+  foreach(const QString& phase, times.keys())
+    {
+    std::cout << qPrintable(phase) << ": " << times[phase] << " ms"
+              << std::endl;
+    }
+  std::cout << "peak RSS: " << peakRSS << " MB" << std::endl;
+
+  foreach(const QString& phase, times.keys())
+    {
+    if (times[phase] < 0. || times[phase] > budgets[phase])
+      {
+      std::cerr << "Error: " << qPrintable(phase) << " took " << times[phase]
+                << " ms, more than " << budgets[phase] << " ms" << std::endl;
+      res = EXIT_FAILURE;
+      }
+    }
+  if (peakRSS > rssBudget)
+    {
+    std::cerr << "Error: peak RSS is " << peakRSS << " MB, more than "
+              << rssBudget << " MB" << std::endl;
+    res = EXIT_FAILURE;
+    }
+
+  return res;
+}
+
+} // end of anonymous namespace
+
+// -----------------------------------------------------------------------------
+int msvQECGMainWindowTest2(int argc, char * argv[] )
+{
+  QApplication app(argc, argv);
+
+  // Default size and budgets
+  QMap<QString, double> options;
+  options["--points"] = 5000;
+  options["--steps"] = 20;
+  options["--signals"] = 100;
+  options["--samples"] = 2500;
+  options["--ratio"] = 2.;
+  options["--slack-ms"] = 500;
+  options["--slack-rss-mb"] = 64;
+  options["--max-select-ms"] = 1000;
+  options["--max-close-ms"] = 500;
+  QStringList arguments = app.arguments();
+  for (int i = 1; i + 1 < arguments.count(); ++i)
+    {
+    if (options.contains(arguments[i]))
+      {
+      options[arguments[i]] = arguments[i + 1].toDouble();
+      ++i;
+      }
+    }
+
+  // Generate the study
+  msvQECGSyntheticStudy study;
+  study.NumberOfPoints = static_cast<int>(options["--points"]);
+  study.NumberOfSteps = static_cast<int>(options["--steps"]);
+  study.NumberOfSignals = static_cast<int>(options["--signals"]);
+  study.NumberOfSamples = static_cast<int>(options["--samples"]);
+  QString root = QDir::temp().filePath("msvQECGMainWindowTest2");
+  if (!study.write(root))
+    {
+    std::cerr << "Error: can't write the synthetic study in "
+              << qPrintable(root) << std::endl;
+    msvQECGSyntheticStudy::remove(root);
+    return EXIT_FAILURE;
+    }
+
+  int res = runTest(options, study, root);
+  if (!msvQECGSyntheticStudy::remove(root))
+    {
+    std::cerr << "Error: can't remove the synthetic study in "
+              << qPrintable(root) << std::endl;
+    res = EXIT_FAILURE;
+    }
+  return res;
+}
@@ -0,0 +1,143 @@
+/*==============================================================================
+
+  Library: MSVTK
+
+  Copyright (c) Kitware Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// Qt includes
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QTextStream>
+
+// ECG includes
+#include "msvQECGStudyLoader.h"
+#include "msvQECGSyntheticStudy.h"
+
+// VTK includes
+#include "vtkNew.h"
+#include "vtkPolyData.h"
+#include "vtkPolyDataWriter.h"
+#include "vtkSphereSource.h"
+#include "vtkTable.h"
+#include "vtkTableAlgorithm.h"
+
+// STD includes
+#include <cstdlib>
+#include <iostream>
+
+namespace
+{
+// -----------------------------------------------------------------------------
+int loadStudy(const QDir& root)
+{
+  vtkNew<vtkSphereSource> sphere;
+  vtkNew<vtkPolyDataWriter> writer;
+  writer->SetInputConnection(sphere->GetOutputPort());
+  for (int i = 0; i < 3; ++i)
+    {
+    QString fileName = root.filePath(QString("CartoPoints/Points%1.vtk").arg(i));
+    writer->SetFileName(fileName.toLatin1().constData());
+    writer->Write();
+    }
+  for (int i = 0; i < 2; ++i)
+    {
+    QFile file(root.filePath(QString("CartoSignals/Signal%1.csv").arg(i)));
+    file.open(QIODevice::WriteOnly | QIODevice::Text);
+    QTextStream stream(&file);
+    stream << "Time,Voltage\n";
+    for (int t = 0; t < 10; ++t)
+      {
+      stream << t << "," << 0.1 * t << "\n";
+      }
+    }
+
+  msvQECGStudyLoader loader;
+  loader.setRootDirectory(root.absolutePath());
+  loader.start();
+  if (!loader.wait(30000))
+    {
+    std::cerr << "Error: the study was not loaded in time." << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  if (loader.pointsFiles().count() != 3 || loader.signalsFiles().count() != 2)
+    {
+    std::cerr << "Error: unexpected number of files listed." << std::endl;
+    return EXIT_FAILURE;
+    }
+  if (!loader.firstMesh() ||
+      loader.firstMesh()->GetNumberOfPoints() !=
+      sphere->GetOutput()->GetNumberOfPoints())
+    {
+    std::cerr << "Error: the first mesh was not loaded." << std::endl;
+    return EXIT_FAILURE;
+    }
+  if (!loader.signalReader(1) ||
+      vtkTable::SafeDownCast(loader.signalReader(1)->GetOutputDataObject(0))
+        ->GetNumberOfRows() != 10)
+    {
+    std::cerr << "Error: the signals were not loaded." << std::endl;
+    return EXIT_FAILURE;
+    }
+  if (loader.signalReader(2) != 0)
+    {
+    std::cerr << "Error: unexpected signal reader." << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // A new study resets the results and starts a new generation
+  int generation = loader.generation();
+  loader.setRootDirectory(root.filePath("Missing"));
+  if (loader.firstMesh() != 0 || !loader.pointsFiles().isEmpty() ||
+      loader.generation() == generation)
+    {
+    std::cerr << "Error: results not reset with a new study." << std::endl;
+    return EXIT_FAILURE;
+    }
+  loader.start();
+  loader.wait();
+  if (loader.firstMesh() != 0 || loader.signalReader(0) != 0)
+    {
+    std::cerr << "Error: results found in a missing study." << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
+
+} // end of anonymous namespace
+
+// -----------------------------------------------------------------------------
+int msvQECGStudyLoaderTest1(int argc, char * argv[] )
+{
+  QCoreApplication app(argc, argv);
+
+  // Write a small study: 3 time steps and 2 signals
+  QDir root(QDir::temp());
+  root.mkpath("msvQECGStudyLoaderTest1/CartoPoints");
+  root.mkpath("msvQECGStudyLoaderTest1/CartoSignals");
+  root.cd("msvQECGStudyLoaderTest1");
+
+  int result = loadStudy(root);
+  if (!msvQECGSyntheticStudy::remove(root.absolutePath()))
+    {
+    std::cerr << "Error: the study was not removed." << std::endl;
+    result = EXIT_FAILURE;
+    }
+  return result;
+}
@@ -0,0 +1,171 @@
+/*==============================================================================
+
+  Library: MSVTK
+
+  Copyright (c) Kitware Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// Qt includes
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QTextStream>
+
+// ECG includes
+#include "msvQECGSyntheticStudy.h"
+
+// VTK includes
+#include "vtkCellArray.h"
+#include "vtkMath.h"
+#include "vtkNew.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkPolyDataWriter.h"
+
+// STD includes
+#include <cmath>
+
+#if defined(_WIN32)
+# include <windows.h>
+# include <psapi.h>
+#else
+# include <sys/resource.h>
+#endif
+
+//------------------------------------------------------------------------------
+msvQECGSyntheticStudy::msvQECGSyntheticStudy()
+{
+  this->NumberOfPoints = 1000;
+  this->NumberOfSteps = 10;
+  this->NumberOfSignals = 50;
+  this->NumberOfSamples = 2500;
+  this->Duration = 2500.;
+}
+
+//------------------------------------------------------------------------------
+bool msvQECGSyntheticStudy::write(const QString& rootDirectory) const
+{
+  QDir root(rootDirectory);
+  if (!root.mkpath("CartoPoints") || !root.mkpath("CartoSignals"))
+    {
+    return false;
+    }
+
+  // Points spread on a sphere that beats along the steps
+  vtkNew<vtkPoints> points;
+  points->SetNumberOfPoints(this->NumberOfPoints);
+  vtkNew<vtkCellArray> vertices;
+  for (vtkIdType i = 0; i < this->NumberOfPoints; ++i)
+    {
+    vertices->InsertNextCell(1, &i);
+    }
+  vtkNew<vtkPolyData> polyData;
+  polyData->SetPoints(points.GetPointer());
+  polyData->SetVerts(vertices.GetPointer());
+
+  vtkNew<vtkPolyDataWriter> writer;
+  writer->SetInput(polyData.GetPointer());
+  writer->SetFileTypeToBinary();
+  double goldenAngle = vtkMath::Pi() * (3. - sqrt(5.));
+  for (int step = 0; step < this->NumberOfSteps; ++step)
+    {
+    double radius = 50. + 5. * sin(2. * vtkMath::Pi() * step /
+                                   this->NumberOfSteps);
+    for (vtkIdType i = 0; i < this->NumberOfPoints; ++i)
+      {
+      double z = 1. - (2. * i + 1.) / this->NumberOfPoints;
+      double r = sqrt(1. - z * z);
+      double theta = goldenAngle * i;
+      points->SetPoint(i, radius * r * cos(theta), radius * r * sin(theta),
+                       radius * z);
+      }
+    points->Modified();
+
+    QString fileName =
+      root.filePath(QString("CartoPoints/Points%1.vtk").arg(step));
+    writer->SetFileName(fileName.toLatin1().constData());
+    if (!writer->Write())
+      {
+      return false;
+      }
+    }
+
+  // Signals: a sinus rhythm with a per signal activation delay
+  double period = this->Duration / 3.;
+  for (int signal = 0; signal < this->NumberOfSignals; ++signal)
+    {
+    QFile file(root.filePath(QString("CartoSignals/Signal%1.csv").arg(signal)));
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text))
+      {
+      return false;
+      }
+    QTextStream stream(&file);
+    stream << "Time (ms),Voltage (mV)\n";
+    double delay = period * signal / qMax(this->NumberOfSignals, 1);
+    for (int sample = 0; sample < this->NumberOfSamples; ++sample)
+      {
+      double time = this->Duration * sample / this->NumberOfSamples;
+      double phase = fmod(time + delay, period) / period;
+      double voltage = exp(-pow((phase - 0.5) * 20., 2.)) * 2. - 0.2;
+      stream << time << "," << voltage << "\n";
+      }
+    }
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+bool msvQECGSyntheticStudy::remove(const QString& rootDirectory)
+{
+  QDir root(rootDirectory);
+  if (!root.exists())
+    {
+    return true;
+    }
+  bool success = true;
+  foreach(const QFileInfo& entry, root.entryInfoList(
+            QDir::AllEntries | QDir::Hidden | QDir::System | QDir::NoDotAndDotDot))
+    {
+    success = (entry.isDir() && !entry.isSymLink() ?
+               remove(entry.absoluteFilePath()) :
+               root.remove(entry.fileName())) && success;
+    }
+  return root.rmdir(root.absolutePath()) && success;
+}
+
+//------------------------------------------------------------------------------
+double msvQECGSyntheticStudy::peakResidentSetSize()
+{
+#if defined(_WIN32)
+  PROCESS_MEMORY_COUNTERS counters;
+  if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+    {
+    return 0.;
+    }
+  return counters.PeakWorkingSetSize / 1048576.;
+#else
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0)
+    {
+    return 0.;
+    }
+# if defined(__APPLE__)
+  return usage.ru_maxrss / 1048576.; // in bytes
+# else
+  return usage.ru_maxrss / 1024.;    // in kilobytes
+# endif
+#endif
+}
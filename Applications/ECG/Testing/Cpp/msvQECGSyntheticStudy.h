@@ -0,0 +1,56 @@
+/*==============================================================================
+
+  Library: MSVTK
+
+  Copyright (c) Kitware Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// Helpers to write a synthetic CARTO study for the ECG tests:
+//  <root>/CartoPoints/Points<step>.vtk  numberOfSteps polydata of
+//                                        numberOfPoints vertices each,
+//  <root>/CartoSignals/Signal<i>.csv    numberOfSignals signals of
+//                                        numberOfSamples samples each.
+
+#ifndef __msvQECGSyntheticStudy_h
+#define __msvQECGSyntheticStudy_h
+
+// Qt includes
+#include <QString>
+
+struct msvQECGSyntheticStudy
+{
+  msvQECGSyntheticStudy();
+
+  int NumberOfPoints;
+  int NumberOfSteps;
+  int NumberOfSignals;
+  int NumberOfSamples;
+
+  /// Duration of the signals in ms, the sampling is uniform.
+  double Duration;
+
+  /// Write the study in rootDirectory (created if needed), existing files
+  /// of a previous study are overwritten. Return false on error.
+  bool write(const QString& rootDirectory) const;
+
+  /// Remove rootDirectory and everything it contains. Return false on error.
+  static bool remove(const QString& rootDirectory);
+
+  /// Peak resident set size of the current process, in MB.
+  static double peakResidentSetSize();
+};
+
+#endif
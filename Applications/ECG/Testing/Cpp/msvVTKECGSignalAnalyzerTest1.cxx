@@ -0,0 +1,176 @@
+/*==============================================================================
+
+  Library: MSVTK
+
+  Copyright (c) Kitware Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// MSVTK includes
+#include "msvVTKECGSignalAnalyzer.h"
+
+// STD includes
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+// VTK includes
+#include "vtkDoubleArray.h"
+#include "vtkIdList.h"
+#include "vtkIntArray.h"
+#include "vtkMath.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+
+namespace
+{
+//------------------------------------------------------------------------------
+bool fuzzyCompare(double a, double b)
+{
+  return std::fabs(a - b) < 1e-9;
+}
+}
+
+// -----------------------------------------------------------------------------
+int msvVTKECGSignalAnalyzerTest1(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
+{
+  // Signal 0: a triangle, 1000 samples, 1 sample per ms. The voltage rises
+  // by 1 mV/ms up to 500 mV at t=500 then falls by 2 mV/ms.
+  vtkNew<vtkIntArray> time;
+  vtkNew<vtkDoubleArray> voltage;
+  for (int t = 0; t < 1000; ++t)
+    {
+    time->InsertNextValue(t);
+    voltage->InsertNextValue(t <= 500 ? t : 500. - 2. * (t - 500));
+    }
+
+  // Signal 1: a single spike of -3 mV at t=200 on a flat line.
+  vtkNew<vtkDoubleArray> time1;
+  vtkNew<vtkDoubleArray> voltage1;
+  for (int t = 0; t < 300; ++t)
+    {
+    time1->InsertNextValue(t);
+    voltage1->InsertNextValue(t == 200 ? -3. : 0.);
+    }
+
+  vtkNew<msvVTKECGSignalAnalyzer> analyzer;
+  analyzer->SetNumberOfThreads(2);
+  analyzer->AddSignal(time.GetPointer(), voltage.GetPointer());
+  analyzer->AddSignal(time1.GetPointer(), voltage1.GetPointer());
+  analyzer->Update();
+
+  if (analyzer->GetNumberOfRebuiltSignals() != 2 ||
+      analyzer->GetPeakTimes()->GetNumberOfTuples() != 2)
+    {
+    std::cerr << "Error: signals not analyzed." << std::endl;
+    return EXIT_FAILURE;
+    }
+  if (!fuzzyCompare(analyzer->GetPeakTimes()->GetValue(0), 500.) ||
+      !fuzzyCompare(analyzer->GetPeakToPeak()->GetValue(0), 998.) ||
+      !fuzzyCompare(analyzer->GetMaxDVDT()->GetValue(0), 2.) ||
+      !fuzzyCompare(analyzer->GetActivationTimes()->GetValue(0), 501.))
+    {
+    std::cerr << "Error: unexpected features for the whole signal 0."
+              << std::endl;
+    return EXIT_FAILURE;
+    }
+  if (!fuzzyCompare(analyzer->GetPeakTimes()->GetValue(1), 200.) ||
+      !fuzzyCompare(analyzer->GetPeakToPeak()->GetValue(1), 3.) ||
+      !fuzzyCompare(analyzer->GetMaxDVDT()->GetValue(1), 3.) ||
+      !fuzzyCompare(analyzer->GetActivationTimes()->GetValue(1), 200.))
+    {
+    std::cerr << "Error: unexpected features for the whole signal 1."
+              << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Changing the window must not rebuild the block summaries
+  analyzer->SetWindow(100., 400.);
+  analyzer->Update();
+  if (analyzer->GetNumberOfRebuiltSignals() != 0)
+    {
+    std::cerr << "Error: summaries rebuilt for a window change." << std::endl;
+    return EXIT_FAILURE;
+    }
+  if (!fuzzyCompare(analyzer->GetPeakTimes()->GetValue(0), 400.) ||
+      !fuzzyCompare(analyzer->GetPeakToPeak()->GetValue(0), 300.) ||
+      !fuzzyCompare(analyzer->GetMaxDVDT()->GetValue(0), 1.) ||
+      !fuzzyCompare(analyzer->GetActivationTimes()->GetValue(0), 101.))
+    {
+    std::cerr << "Error: unexpected features for the window [100, 400]."
+              << std::endl;
+    return EXIT_FAILURE;
+    }
+  if (!fuzzyCompare(analyzer->GetPeakToPeak()->GetValue(1), 3.))
+    {
+    std::cerr << "Error: spike missed in the window [100, 400]." << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Window without samples
+  analyzer->SetWindow(5000., 6000.);
+  analyzer->Update();
+  if (!vtkMath::IsNan(analyzer->GetPeakTimes()->GetValue(0)))
+    {
+    std::cerr << "Error: features found in an empty window." << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Modifying a signal rebuilds its summaries only
+  analyzer->SetWindow(0., -1.);
+  voltage1->SetValue(250, 10.);
+  voltage1->Modified();
+  analyzer->Update();
+  if (analyzer->GetNumberOfRebuiltSignals() != 1 ||
+      !fuzzyCompare(analyzer->GetPeakTimes()->GetValue(1), 250.))
+    {
+    std::cerr << "Error: modified signal not analyzed again." << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Nothing modified, nothing computed
+  analyzer->Update();
+  if (analyzer->GetNumberOfRebuiltSignals() != 0)
+    {
+    std::cerr << "Error: signals analyzed again without modification."
+              << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Attach the activation maps to electrode points
+  vtkNew<vtkPoints> points;
+  points->SetNumberOfPoints(10);
+  vtkNew<vtkPolyData> polyData;
+  polyData->SetPoints(points.GetPointer());
+  vtkNew<vtkIdList> electrodeIds;
+  electrodeIds->InsertNextId(3);
+  electrodeIds->InsertNextId(7);
+  analyzer->AttachArrays(polyData.GetPointer(), electrodeIds.GetPointer());
+
+  vtkDataArray* activationMap = polyData->GetPointData()->GetArray(
+    msvVTKECGSignalAnalyzer::ActivationTimeArrayName);
+  if (!activationMap || activationMap->GetNumberOfTuples() != 10 ||
+      !fuzzyCompare(activationMap->GetTuple1(3), 501.) ||
+      !vtkMath::IsNan(activationMap->GetTuple1(0)))
+    {
+    std::cerr << "Error: activation map not attached." << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  analyzer->Print(std::cout);
+  return EXIT_SUCCESS;
+}
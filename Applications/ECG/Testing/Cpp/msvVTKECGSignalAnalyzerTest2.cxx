@@ -0,0 +1,102 @@
+/*==============================================================================
+
+  Library: MSVTK
+
+  Copyright (c) Kitware Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// Benchmark of msvVTKECGSignalAnalyzer.
+// Usage: msvVTKECGSignalAnalyzerTest2 [numberOfSignals numberOfSamples]
+// (default: 1000 signals of 10000 samples).
+
+// MSVTK includes
+#include "msvVTKECGSignalAnalyzer.h"
+
+// STD includes
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+// VTK includes
+#include "vtkDoubleArray.h"
+#include "vtkNew.h"
+#include "vtkSmartPointer.h"
+#include "vtkTimerLog.h"
+
+// -----------------------------------------------------------------------------
+int msvVTKECGSignalAnalyzerTest2(int argc, char* argv[])
+{
+  int numberOfSignals = (argc > 2) ? atoi(argv[1]) : 1000;
+  int numberOfSamples = (argc > 2) ? atoi(argv[2]) : 10000;
+
+  // All the signals share the time array, 1 sample per ms
+  vtkNew<vtkDoubleArray> time;
+  time->SetNumberOfTuples(numberOfSamples);
+  for (int t = 0; t < numberOfSamples; ++t)
+    {
+    time->SetValue(t, t);
+    }
+
+  vtkNew<msvVTKECGSignalAnalyzer> analyzer;
+  for (int s = 0; s < numberOfSignals; ++s)
+    {
+    vtkSmartPointer<vtkDoubleArray> voltage =
+      vtkSmartPointer<vtkDoubleArray>::New();
+    voltage->SetNumberOfTuples(numberOfSamples);
+    double* v = voltage->GetPointer(0);
+    for (int t = 0; t < numberOfSamples; ++t)
+      {
+      v[t] = std::sin(0.01 * t + s) + 0.1 * std::sin(0.37 * t);
+      }
+    analyzer->AddSignal(time.GetPointer(), voltage);
+    }
+
+  double megaSamples = static_cast<double>(numberOfSignals) *
+                       numberOfSamples / 1e6;
+  std::cout << numberOfSignals << " signals x " << numberOfSamples
+            << " samples, " << analyzer->GetNumberOfThreads()
+            << " threads" << std::endl;
+
+  vtkNew<vtkTimerLog> timer;
+  timer->StartTimer();
+  analyzer->Update();
+  timer->StopTimer();
+  double fullTime = timer->GetElapsedTime();
+  std::cout << "Full analysis: " << fullTime * 1000. << " ms ("
+            << megaSamples / fullTime << " MSamples/s)" << std::endl;
+
+  const int numberOfWindows = 100;
+  timer->StartTimer();
+  for (int w = 0; w < numberOfWindows; ++w)
+    {
+    double start = (w * numberOfSamples) / (2. * numberOfWindows);
+    analyzer->SetWindow(start, start + numberOfSamples / 2.);
+    analyzer->Update();
+    }
+  timer->StopTimer();
+  double windowTime = timer->GetElapsedTime() / numberOfWindows;
+  std::cout << "Window change: " << windowTime * 1000. << " ms" << std::endl;
+
+  if (analyzer->GetNumberOfRebuiltSignals() != 0 ||
+      analyzer->GetPeakToPeak()->GetNumberOfTuples() != numberOfSignals)
+    {
+    std::cerr << "Error: unexpected analysis after window changes."
+              << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
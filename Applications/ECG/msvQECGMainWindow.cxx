@@ -20,13 +20,17 @@
 
 // Qt includes
 #include "QFileDialog"
-#include "QRegExp"
+#include "QMap"
 #include "QString"
+#include "QTime"
+#include "QVector"
 
 // MSV includes
 #include "msvQECGMainWindow.h"
+#include "msvQECGStudyLoader.h"
 #include "msvQTimePlayerWidget.h"
 #include "msvVTKECGButtonsManager.h"
+#include "msvVTKECGSignalAnalyzer.h"
 #include "msvVTKPolyDataFileSeriesReader.h"
 #include "ui_msvQECGMainWindow.h"
 #include "msvQECGAboutDialog.h"
@@ -39,6 +43,7 @@
 #include "vtkCollection.h"
 #include "vtkDelimitedTextReader.h"
 #include "vtkDoubleArray.h"
+#include "vtkIdList.h"
 #include "vtkNew.h"
 #include "vtkOrientationMarkerWidget.h"
 #include "vtkPlotBar.h"
@@ -57,9 +62,10 @@ class msvQECGMainWindowPrivate: public Ui_msvQECGMainWindow
 protected:
   msvQECGMainWindow* const q_ptr;
 
-  void readCartoSignals(QDir signalsFilesDirectory);
-  void readCartoSignal(const QFileInfo& signalFile);
-  void readCartoPoints(QDir pointsFilesDirectory);
+  // Study loading
+  msvQECGStudyLoader* studyLoader;
+  QTime openTime;
+  double timeToFirstMesh;
 
   // Scene Rendering
   vtkSmartPointer<vtkRenderer> threeDRenderer;
@@ -68,10 +74,25 @@ protected:
 
   // CartoSignals
   vtkSmartPointer<vtkCollection> cartoSignals;
-  vtkSmartPointer<vtkPlotLine> signalPlot;
   vtkSmartPointer<vtkPlotLine> currentTimePlot;
   vtkSmartPointer<vtkTable> currentTimeLine;
 
+  // Signal store: the time column of the first signal followed by the
+  // voltage column of each signal sampled at the same times. The columns are
+  // named after the signal index and share the memory of the reader arrays,
+  // which are kept alive in signalsArrays; nothing is copied. Signals that
+  // can't be stored are plotted from their own reader output.
+  vtkSmartPointer<vtkTable> signalsTable;
+  QList<vtkSmartPointer<vtkDataArray> > signalsArrays;
+  QVector<int> signalsColumns;  // column in signalsTable, -1 if not stored
+  QVector<double> signalsBounds; // xmin, xmax, ymin, ymax per signal
+
+  // Signal traces displayed in the chart, by signal index
+  typedef QMap<int, vtkSmartPointer<vtkPlotLine> > SignalPlotsType;
+  SignalPlotsType signalPlots;
+  bool overlaySignals;
+  double chartBounds[4];
+
   // CartoPoints Pipeline
   vtkSmartPointer<msvVTKPolyDataFileSeriesReader> cartoPointsReader;
   vtkSmartPointer<vtkPolyDataReader>              polyDataReader;
@@ -81,6 +102,13 @@ protected:
   // buttonsManager
   vtkSmartPointer<msvVTKECGButtonsManager> buttonsManager;
 
+  // Activation maps computed from the signals, at the buttons points
+  vtkSmartPointer<msvVTKECGSignalAnalyzer> signalAnalyzer;
+  vtkSmartPointer<vtkIdList>               electrodeIds;
+  /// Set when the mesh, its time step, the signals or the analysis window
+  /// change, the next updateView() attaches the activation maps again.
+  bool                                     cartoPointsModified;
+
 public:
   msvQECGMainWindowPrivate(msvQECGMainWindow& object);
   ~msvQECGMainWindowPrivate();
@@ -95,7 +123,17 @@ public:
   virtual void clear();
 
   virtual void readCartoData(const QString&);
-  static bool fileLessThan(const QString &, const QString &);
+  /// False for the queued signals of a canceled or previous study.
+  bool isCurrentLoad(int generation) const;
+  virtual void showFirstMesh();
+  virtual void addCartoSignal(int index);
+  virtual void attachCartoPoints();
+  virtual void updateSignalAnalysis();
+
+  virtual void storeCartoSignal(int index);
+  virtual vtkSmartPointer<vtkPlotLine> createSignalPlot(int index);
+  virtual void setSelectedSignals(const QList<int>& signalIds);
+  virtual void updateChartAxes();
 };
 
 //------------------------------------------------------------------------------
@@ -105,6 +143,9 @@ public:
 msvQECGMainWindowPrivate::msvQECGMainWindowPrivate(msvQECGMainWindow& object)
   : q_ptr(&object)
 {
+  this->studyLoader = 0;
+  this->timeToFirstMesh = -1.;
+
   // Renderer
   this->threeDRenderer = vtkSmartPointer<vtkRenderer>::New();
   this->threeDRenderer->SetBackground(0.1, 0.2, 0.4);
@@ -131,6 +172,18 @@ msvQECGMainWindowPrivate::msvQECGMainWindowPrivate(msvQECGMainWindow& object)
   yCoords->InsertNextValue(1.);
   this->currentTimeLine->AddColumn(yCoords.GetPointer());
 
+  // Vertical bar for current time
+  this->currentTimePlot = vtkSmartPointer<vtkPlotLine>::New();
+  this->currentTimePlot->SetInput(this->currentTimeLine, 0, 1);
+  this->currentTimePlot->SetVisible(false);
+
+  this->signalsTable = vtkSmartPointer<vtkTable>::New();
+  this->overlaySignals = false;
+  for (int i = 0; i < 4; ++i)
+    {
+    this->chartBounds[i] = 0.;
+    }
+
   // CartoPoints Readers
   this->polyDataReader    = vtkSmartPointer<vtkPolyDataReader>::New();
   this->cartoPointsReader =
@@ -148,6 +201,11 @@ msvQECGMainWindowPrivate::msvQECGMainWindowPrivate(msvQECGMainWindow& object)
   // Set the buttons manager
   this->buttonsManager = vtkSmartPointer<msvVTKECGButtonsManager>::New();
   this->buttonsManager->SetRenderer(this->threeDRenderer);
+
+  // Signal analysis
+  this->signalAnalyzer = vtkSmartPointer<msvVTKECGSignalAnalyzer>::New();
+  this->electrodeIds = vtkSmartPointer<vtkIdList>::New();
+  this->cartoPointsModified = true;
 }
 
 //------------------------------------------------------------------------------
@@ -161,14 +219,30 @@ void msvQECGMainWindowPrivate::clear()
 {
   Q_Q(msvQECGMainWindow);
 
+  if (this->studyLoader)
+    {
+    this->studyLoader->cancel();                  // stop loading the study
+    this->studyLoader->wait();
+    }
+  this->timeToFirstMesh = -1.;
 
   this->timePlayerWidget->play(false);            // stop the player widget
   this->threeDRenderer->RemoveAllViewProps();     // clean up the renderer
   this->cartoPointsReader->RemoveAllFileNames();  // clean up the reader
+  this->cartoPointsMapper->SetInputConnection(    // reattach the reader
+    this->cartoPointsReader->GetOutputPort());
   this->cartoPointsMapper->Update();              // update the pipeline
   this->timePlayerWidget->updateFromFilter();     // update the player widget
   this->buttonsManager->Clear();                  // clean up the buttonsManager
-  q->setCurrentSignal(-1);
+  q->setCurrentSignal(-1);                        // clean up the chart
+  this->cartoSignals->RemoveAllItems();           // clean up the signals
+  this->signalsTable->Initialize();
+  this->signalsArrays.clear();
+  this->signalsColumns.clear();
+  this->signalsBounds.clear();
+  this->signalAnalyzer->RemoveAllSignals();       // clean up the analysis
+  this->electrodeIds->Reset();
+  this->cartoPointsModified = true;
 }
 
 //------------------------------------------------------------------------------
@@ -183,6 +257,18 @@ void msvQECGMainWindowPrivate::setupUi(QMainWindow * mainWindow)
 {
   Q_Q(msvQECGMainWindow);
 
+  // Study loader, its signals are queued to the GUI thread and may arrive
+  // after the study was closed or replaced: they carry its generation.
+  this->studyLoader = new msvQECGStudyLoader(q);
+  q->connect(this->studyLoader, SIGNAL(stageProgress(int,int,int)),
+             q, SIGNAL(studyLoadProgress(int,int,int)));
+  q->connect(this->studyLoader, SIGNAL(firstMeshLoaded(int)),
+             q, SLOT(onFirstMeshLoaded(int)));
+  q->connect(this->studyLoader, SIGNAL(signalLoaded(int,int)),
+             q, SLOT(onSignalLoaded(int,int)));
+  q->connect(this->studyLoader, SIGNAL(studyLoaded(int)),
+             q, SLOT(onStudyLoaded(int)));
+
   this->Ui_msvQECGMainWindow::setupUi(mainWindow);
   this->ecgReviewPanel->setVisible(false);
   q->setStatusBar(0);
@@ -219,6 +305,18 @@ void msvQECGMainWindowPrivate::setupUi(QMainWindow * mainWindow)
   this->ecgView->chart()->GetAxis(vtkAxis::RIGHT)->SetVisible(false);
   this->ecgView->chart()->GetAxis(vtkAxis::TOP)->SetBehavior(vtkAxis::CUSTOM);
   this->ecgView->chart()->GetAxis(vtkAxis::RIGHT)->SetBehavior(vtkAxis::CUSTOM);
+  this->ecgView->chart()->GetAxis(vtkAxis::BOTTOM)->SetBehavior(vtkAxis::CUSTOM);
+  this->ecgView->chart()->GetAxis(vtkAxis::LEFT)->SetBehavior(vtkAxis::CUSTOM);
+
+  // The current time bar lives in the top right corner for the whole session
+  this->ecgView->addPlot(this->currentTimePlot);
+  this->ecgView->chart()->SetPlotCorner(this->currentTimePlot, 2);
+  this->ecgView->chart()->GetAxis(vtkAxis::RIGHT)->SetMinimumLimit(0.);
+  this->ecgView->chart()->GetAxis(vtkAxis::RIGHT)->SetMaximumLimit(1.);
+  this->ecgView->chart()->GetAxis(vtkAxis::RIGHT)->SetRange(0., 1.);
+  this->ecgView->chart()->GetAxis(vtkAxis::TOP)->SetMinimumLimit(0.);
+  this->ecgView->chart()->GetAxis(vtkAxis::TOP)->SetMaximumLimit(2500.);
+  this->ecgView->chart()->GetAxis(vtkAxis::TOP)->SetRange(0., 2500.);
 }
 
 //------------------------------------------------------------------------------
@@ -248,31 +346,54 @@ void msvQECGMainWindowPrivate::updateUi()
 //------------------------------------------------------------------------------
 void msvQECGMainWindowPrivate::updateView()
 {
-  this->buttonsManager->UpdateButtonWidgets(static_cast<vtkPolyData*>
-    (this->cartoPointsReader->GetOutput()));
+  if (this->cartoPointsModified)
+    {
+    // While the study is loading, the mapper input is the first mesh.
+    // Update it first, a new time step comes without the activation maps.
+    this->cartoPointsMapper->Update();
+    vtkPolyData* points = this->cartoPointsMapper->GetInput();
+    this->signalAnalyzer->AttachArrays(points, this->electrodeIds);
+    this->buttonsManager->UpdateButtonWidgets(points);
+    this->cartoPointsModified = false;
+    }
   this->threeDView->GetRenderWindow()->Render();
 }
 
 //------------------------------------------------------------------------------
 void msvQECGMainWindowPrivate::readCartoData(const QString& rootDirectory)
 {
-  Q_Q(msvQECGMainWindow);
-  QDir dir(rootDirectory);
+  // The study is loaded in the background, the scene is filled stage by
+  // stage from the loader signals.
+  this->openTime.start();
+  this->studyLoader->setRootDirectory(rootDirectory);
+  this->studyLoader->start();
+}
 
-  if (dir.cd(QString("CartoSignals"))) {
-    this->readCartoSignals(dir);
-    q->setCurrentSignal(0);
-    dir.cdUp();
-  }
+//------------------------------------------------------------------------------
+bool msvQECGMainWindowPrivate::isCurrentLoad(int generation) const
+{
+  return generation == this->studyLoader->generation() &&
+         !this->studyLoader->isCanceled();
+}
 
-  if (dir.cd(QString("CartoPoints")))
-    this->readCartoPoints(dir);
+//------------------------------------------------------------------------------
+void msvQECGMainWindowPrivate::showFirstMesh()
+{
+  Q_Q(msvQECGMainWindow);
+  vtkPolyData* firstMesh = this->studyLoader->firstMesh();
+  if (!firstMesh)
+    {
+    return;
+    }
+
+  // Display the first time step until all the steps are available
+  this->cartoPointsMapper->SetInput(firstMesh);
+  this->cartoPointsModified = true;
 
   // Link to the cartoPoints the buttons
-  this->polyDataReader->Update();
   this->buttonsManager->SetNumberOfButtonWidgets(
-    this->cartoSignals->GetNumberOfItems());
-  this->buttonsManager->Init(this->polyDataReader->GetOutput());
+    this->studyLoader->signalsFiles().count());
+  this->buttonsManager->Init(firstMesh);
 
   // Render
   double extent[6];
@@ -280,79 +401,226 @@ void msvQECGMainWindowPrivate::readCartoData(const QString& rootDirectory)
   this->cartoPointsActor->VisibilityOn();
   this->threeDRenderer->AddActor(this->cartoPointsActor);
   this->threeDRenderer->ResetCamera(extent);
+  this->update();
+
+  this->timeToFirstMesh = this->openTime.elapsed();
+  emit q->firstMeshDisplayed(this->timeToFirstMesh);
 }
 
 //------------------------------------------------------------------------------
-void msvQECGMainWindowPrivate::readCartoPoints(QDir dir)
+void msvQECGMainWindowPrivate::addCartoSignal(int index)
 {
-  // Set file series patterns recognition
-  QStringList filters;
-  filters << "*.vtk";
-  dir.setNameFilters(filters);
-  QStringList files = dir.entryList(QDir::Files,QDir::Name);
+  Q_Q(msvQECGMainWindow);
+  vtkTableAlgorithm* reader = this->studyLoader->signalReader(index);
+  // Signals are appended in order.
+  if (!reader || index != this->cartoSignals->GetNumberOfItems())
+    {
+    return;
+    }
 
-  // Resort files using the index number
-  qSort(files.begin(), files.end(), msvQECGMainWindowPrivate::fileLessThan);
+  this->cartoSignals->AddItem(reader);
+  this->storeCartoSignal(index);
+  if (index == 0)
+    {
+    q->setCurrentSignal(0);
+    }
+}
 
+//------------------------------------------------------------------------------
+void msvQECGMainWindowPrivate::attachCartoPoints()
+{
   // Fill the FileSerieReader
-  foreach(const QString& file, files){
-    this->cartoPointsReader->AddFileName(
-      dir.filePath(file).toLatin1().constData());
-  }
+  foreach(const QString& file, this->studyLoader->pointsFiles())
+    {
+    this->cartoPointsReader->AddFileName(file.toLatin1().constData());
+    }
 
   // Create Instance of vtkDataObject for all outputs ports
   // Calls REQUEST_DATA_OBJECT && REQUEST_INFORMATION
   this->cartoPointsReader->SetOutputTimeRange(0,2500);
+  this->cartoPointsMapper->SetInputConnection(
+    this->cartoPointsReader->GetOutputPort());
   this->cartoPointsReader->Update();
+  this->cartoPointsModified = true;
 
   // Update the Widget given the info provided
   this->timePlayerWidget->updateFromFilter();
+  this->update();
 }
 
 //------------------------------------------------------------------------------
-void msvQECGMainWindowPrivate::readCartoSignals(QDir dir)
+void msvQECGMainWindowPrivate::updateSignalAnalysis()
 {
-  // Set file series patterns recognition
-  QStringList signalFileFilters;
-  signalFileFilters << "*.csv";
-  dir.setNameFilters(signalFileFilters);
-  QStringList signalFiles = dir.entryList(QDir::Files,QDir::Name);
+  this->signalAnalyzer->RemoveAllSignals();
+  this->signalAnalyzer->AddSignals(this->cartoSignals);
+  this->signalAnalyzer->Update();
+  this->buttonsManager->GetButtonIds(this->electrodeIds);
+  this->cartoPointsModified = true;
+}
 
-  // Resort files using their index number
-  qSort(signalFiles.begin(), signalFiles.end(),
-        msvQECGMainWindowPrivate::fileLessThan);
+//------------------------------------------------------------------------------
+void msvQECGMainWindowPrivate::storeCartoSignal(int index)
+{
+  vtkTableAlgorithm* reader = vtkTableAlgorithm::SafeDownCast(
+    this->cartoSignals->GetItemAsObject(index));
+  reader->Update();
+  vtkTable* table = reader->GetOutput();
+  vtkDataArray* time = vtkDataArray::SafeDownCast(table->GetColumn(0));
+  vtkDataArray* voltage = vtkDataArray::SafeDownCast(table->GetColumn(1));
+
+  // Cache the bounds of the signal for the axes
+  double bounds[4] = {0., 0., 0., 0.};
+  if (time && voltage)
+    {
+    time->GetRange(bounds, 0);
+    voltage->GetRange(bounds + 2, 0);
+    }
+  for (int i = 0; i < 4; ++i)
+    {
+    this->signalsBounds.push_back(bounds[i]);
+    }
 
-  // Fill the FileSerieReader
-  foreach(const QString& signalFile, signalFiles)
+  // Share the voltage column if the signal is sampled like the first one
+  int column = -1;
+  if (time && voltage)
     {
-    this->readCartoSignal(QFileInfo(dir, signalFile));
+    if (this->signalsTable->GetNumberOfColumns() == 0)
+      {
+      this->signalsTable->AddColumn(time);
+      }
+    vtkDataArray* storeTime =
+      vtkDataArray::SafeDownCast(this->signalsTable->GetColumn(0));
+    bool sameTimes = (storeTime == time);
+    if (!sameTimes &&
+        storeTime->GetNumberOfTuples() == time->GetNumberOfTuples())
+      {
+      sameTimes = true;
+      for (vtkIdType i = 0; sameTimes && i < time->GetNumberOfTuples(); ++i)
+        {
+        sameTimes = (storeTime->GetTuple1(i) == time->GetTuple1(i));
+        }
+      }
+    if (sameTimes)
+      {
+      // vtkTable::AddColumn replaces a column with the same name, and every
+      // reader names its voltage column alike: add a renamed array that
+      // uses the reader memory instead.
+      vtkSmartPointer<vtkDataArray> shared;
+      shared.TakeReference(voltage->NewInstance());
+      shared->SetNumberOfComponents(voltage->GetNumberOfComponents());
+      shared->SetVoidArray(voltage->GetVoidPointer(0),
+        voltage->GetNumberOfTuples() * voltage->GetNumberOfComponents(), 1);
+      shared->SetName(QString("%1 %2").arg(voltage->GetName() ?
+        voltage->GetName() : "Voltage").arg(index).toLatin1().constData());
+      this->signalsArrays.push_back(voltage);
+      column = this->signalsTable->GetNumberOfColumns();
+      this->signalsTable->AddColumn(shared);
+      }
     }
+  this->signalsColumns.push_back(column);
 }
 
 //------------------------------------------------------------------------------
-void msvQECGMainWindowPrivate::readCartoSignal(const QFileInfo& signalsFile)
+vtkSmartPointer<vtkPlotLine> msvQECGMainWindowPrivate::createSignalPlot(
+  int index)
 {
-  vtkNew<vtkDelimitedTextReader> reader;
-  reader->SetDetectNumericColumns(true);
-  reader->SetHaveHeaders(true);
-  reader->SetFileName(signalsFile.absoluteFilePath().toLatin1().constData());
+  // Distinct colors for the overlaid signals, the first one is red
+  static const double colors[6][3] = {
+    {1., 0., 0.}, {0., 0.5, 1.}, {0., 0.7, 0.}, {1., 0.5, 0.},
+    {0.6, 0., 0.8}, {0.4, 0.4, 0.4}};
+
+  vtkSmartPointer<vtkPlotLine> plot = vtkSmartPointer<vtkPlotLine>::New();
+  plot->SetWidth(1.);
+  int color = this->signalPlots.count() % 6;
+  plot->SetColor(colors[color][0], colors[color][1], colors[color][2]);
+
+  int column = this->signalsColumns[index];
+  if (column >= 0)
+    {
+    plot->SetInput(this->signalsTable, 0, column);
+    }
+  else
+    {
+    vtkTableAlgorithm* reader = vtkTableAlgorithm::SafeDownCast(
+      this->cartoSignals->GetItemAsObject(index));
+    plot->SetInput(reader->GetOutput(), 0, 1);
+    }
+  return plot;
+}
+
+//------------------------------------------------------------------------------
+void msvQECGMainWindowPrivate::setSelectedSignals(const QList<int>& signalIds)
+{
+  // Only the traces that change are removed or created
+  QList<int> removed;
+  for (SignalPlotsType::iterator it = this->signalPlots.begin();
+       it != this->signalPlots.end(); ++it)
+    {
+    if (!signalIds.contains(it.key()))
+      {
+      removed << it.key();
+      }
+    }
+  foreach(int signalId, removed)
+    {
+    this->ecgView->chart()->RemovePlotInstance(this->signalPlots[signalId]);
+    this->signalPlots.remove(signalId);
+    }
 
-  this->cartoSignals->AddItem(reader.GetPointer());
+  foreach(int signalId, signalIds)
+    {
+    if (signalId < 0 || signalId >= this->signalsColumns.count() ||
+        this->signalPlots.contains(signalId))
+      {
+      continue;
+      }
+    vtkSmartPointer<vtkPlotLine> plot = this->createSignalPlot(signalId);
+    this->ecgView->addPlot(plot);
+    this->signalPlots[signalId] = plot;
+    }
+
+  this->currentTimePlot->SetVisible(!this->signalPlots.isEmpty());
+  this->updateChartAxes();
 }
 
 //------------------------------------------------------------------------------
-bool msvQECGMainWindowPrivate::fileLessThan(const QString &s1, const QString &s2)
+void msvQECGMainWindowPrivate::updateChartAxes()
 {
-  // Compare file by the index contained within.
-  QString fileA, fileB;
-  QRegExp indexExp("(\\d+)");
+  if (this->signalPlots.isEmpty())
+    {
+    return;
+    }
 
-  int pos = indexExp.indexIn(s1);
-  fileA = (pos > -1) ? indexExp.cap() : "0";
-  pos = indexExp.indexIn(s2);
-  fileB = (pos > -1) ? indexExp.cap() : "0";
+  // Union of the cached bounds of the displayed signals
+  double bounds[4] = {VTK_DOUBLE_MAX, -VTK_DOUBLE_MAX,
+                      VTK_DOUBLE_MAX, -VTK_DOUBLE_MAX};
+  foreach(int signalId, this->signalPlots.keys())
+    {
+    const double* signalBounds = &this->signalsBounds[4 * signalId];
+    bounds[0] = qMin(bounds[0], signalBounds[0]);
+    bounds[1] = qMax(bounds[1], signalBounds[1]);
+    bounds[2] = qMin(bounds[2], signalBounds[2]);
+    bounds[3] = qMax(bounds[3], signalBounds[3]);
+    }
+
+  if (bounds[0] == this->chartBounds[0] && bounds[1] == this->chartBounds[1] &&
+      bounds[2] == this->chartBounds[2] && bounds[3] == this->chartBounds[3])
+    {
+    return;
+    }
+  for (int i = 0; i < 4; ++i)
+    {
+    this->chartBounds[i] = bounds[i];
+    }
 
-  return fileA.toInt() < fileB.toInt();
+  vtkAxis* xAxis = this->ecgView->chart()->GetAxis(vtkAxis::BOTTOM);
+  xAxis->SetMinimumLimit(bounds[0]);
+  xAxis->SetMaximumLimit(bounds[1]);
+  xAxis->SetRange(bounds[0], bounds[1]);
+  vtkAxis* yAxis = this->ecgView->chart()->GetAxis(vtkAxis::LEFT);
+  yAxis->SetMinimumLimit(bounds[2]);
+  yAxis->SetMaximumLimit(bounds[3]);
+  yAxis->SetRange(bounds[2], bounds[3]);
 }
 
 //------------------------------------------------------------------------------
@@ -383,9 +651,31 @@ void msvQECGMainWindow::openData()
   if (dir.isEmpty())
     return;
 
+  this->openData(dir);
+}
+
+//------------------------------------------------------------------------------
+void msvQECGMainWindow::openData(const QString& dir)
+{
+  Q_D(msvQECGMainWindow);
+
   d->clear();             // Clean Up data and scene
-  d->readCartoData(dir);  // Load data
   d->update();            // Update the Ui and the View
+  d->readCartoData(dir);  // Start loading data
+}
+
+//------------------------------------------------------------------------------
+double msvQECGMainWindow::timeToFirstMesh() const
+{
+  Q_D(const msvQECGMainWindow);
+  return d->timeToFirstMesh;
+}
+
+//------------------------------------------------------------------------------
+bool msvQECGMainWindow::isLoading() const
+{
+  Q_D(const msvQECGMainWindow);
+  return d->studyLoader->isRunning();
 }
 
 //------------------------------------------------------------------------------
@@ -414,42 +704,46 @@ void msvQECGMainWindow::updateView()
 
 //------------------------------------------------------------------------------
 void msvQECGMainWindow::setCurrentSignal(int pointId)
+{
+  QList<int> signalIds;
+  if (pointId >= 0)
+    {
+    signalIds << pointId;
+    }
+  this->setSelectedSignals(signalIds);
+}
+
+//------------------------------------------------------------------------------
+void msvQECGMainWindow::setSelectedSignals(const QList<int>& signalIds)
 {
   Q_D(msvQECGMainWindow);
-  d->ecgView->removeAllPlots();
+  d->setSelectedSignals(signalIds);
+  this->onCurrentTimeChanged(d->timePlayerWidget->currentTime());
+}
 
-  if (pointId < 0)
+//------------------------------------------------------------------------------
+QList<int> msvQECGMainWindow::selectedSignals() const
+{
+  Q_D(const msvQECGMainWindow);
+  return d->signalPlots.keys();
+}
+
+//------------------------------------------------------------------------------
+void msvQECGMainWindow::setOverlaySignals(bool overlay)
+{
+  Q_D(msvQECGMainWindow);
+  d->overlaySignals = overlay;
+  if (!overlay && d->signalPlots.count() > 1)
     {
-    return;
+    this->setCurrentSignal(d->signalPlots.keys().last());
     }
-  // Initialize signal view
-  d->signalPlot = vtkSmartPointer<vtkPlotLine>::New();
-  d->signalPlot->SetWidth(1.);
-  d->signalPlot->SetColor(1., 0., 0.);
-  d->ecgView->addPlot(d->signalPlot);
-  // Vertical bar for current time
-  d->currentTimePlot = vtkSmartPointer<vtkPlotLine>::New();
-  d->currentTimePlot->SetInput(d->currentTimeLine, 0, 1);
-  // top right corner
-  d->ecgView->addPlot(d->currentTimePlot);
-  d->ecgView->chart()->SetPlotCorner(d->currentTimePlot, 2);
-
-  vtkTableAlgorithm* cartoSignalsTable = vtkTableAlgorithm::SafeDownCast(
-    d->cartoSignals->GetItemAsObject(pointId));
-  cartoSignalsTable->Update();
-  int xCol = 0;
-  int yCol = 1;
-  d->signalPlot->SetInput(cartoSignalsTable->GetOutput(), xCol, yCol);
-  d->signalPlot->Update();
-  d->ecgView->boundAxesToChartBounds();
-  d->ecgView->setAxesToChartBounds();
-  d->ecgView->chart()->GetAxis(vtkAxis::RIGHT)->SetMinimumLimit(0.);
-  d->ecgView->chart()->GetAxis(vtkAxis::RIGHT)->SetMaximumLimit(1.);
-  d->ecgView->chart()->GetAxis(vtkAxis::RIGHT)->SetRange(0., 1.);
-  d->ecgView->chart()->GetAxis(vtkAxis::TOP)->SetMinimumLimit(0.);
-  d->ecgView->chart()->GetAxis(vtkAxis::TOP)->SetMaximumLimit(2500.);
-  d->ecgView->chart()->GetAxis(vtkAxis::TOP)->SetRange(0., 2500.);
-  this->onCurrentTimeChanged(d->timePlayerWidget->currentTime());
+}
+
+//------------------------------------------------------------------------------
+bool msvQECGMainWindow::overlaySignals() const
+{
+  Q_D(const msvQECGMainWindow);
+  return d->overlaySignals;
 }
 
 //------------------------------------------------------------------------------
@@ -458,7 +752,23 @@ void msvQECGMainWindow::onPointSelected()
   Q_D(msvQECGMainWindow);
   int pointId = d->buttonsManager->GetIndexFromButtonId(
     d->buttonsManager->GetLastSelectedButton());
-  this->setCurrentSignal(pointId);
+  if (!d->overlaySignals || pointId < 0)
+    {
+    this->setCurrentSignal(pointId);
+    return;
+    }
+
+  // In overlay mode, selecting an electrode toggles its trace
+  QList<int> signalIds = this->selectedSignals();
+  if (signalIds.contains(pointId))
+    {
+    signalIds.removeAll(pointId);
+    }
+  else
+    {
+    signalIds << pointId;
+    }
+  this->setSelectedSignals(signalIds);
 }
 
 //------------------------------------------------------------------------------
@@ -472,6 +782,85 @@ void msvQECGMainWindow::onCurrentTimeChanged(double time)
   xCoords->SetValue(1, time);
   d->currentTimeLine->Modified();
   d->ecgView->update();
-  // update 3D view
+  // update 3D view, the mesh of the new time step has no activation maps yet
+  d->cartoPointsModified = true;
+  this->updateView();
+}
+
+//------------------------------------------------------------------------------
+void msvQECGMainWindow::onFirstMeshLoaded(int generation)
+{
+  Q_D(msvQECGMainWindow);
+  if (!d->isCurrentLoad(generation))
+    {
+    return;
+    }
+  d->showFirstMesh();
+}
+
+//------------------------------------------------------------------------------
+void msvQECGMainWindow::onSignalLoaded(int index, int generation)
+{
+  Q_D(msvQECGMainWindow);
+  if (!d->isCurrentLoad(generation))
+    {
+    return;
+    }
+  d->addCartoSignal(index);
+}
+
+//------------------------------------------------------------------------------
+void msvQECGMainWindow::onStudyLoaded(int generation)
+{
+  Q_D(msvQECGMainWindow);
+  if (!d->isCurrentLoad(generation) ||
+      d->studyLoader->rootDirectory().isEmpty())
+    {
+    return;
+    }
+
+  d->updateSignalAnalysis();
+  d->attachCartoPoints();
+  emit studyLoaded();
+}
+
+//------------------------------------------------------------------------------
+void msvQECGMainWindow::setAnalysisWindow(double start, double end)
+{
+  Q_D(msvQECGMainWindow);
+  d->signalAnalyzer->SetWindow(start, end);
+  d->signalAnalyzer->Update();
+  d->cartoPointsModified = true;
+  this->updateView();
+}
+
+//------------------------------------------------------------------------------
+void msvQECGMainWindow::setActivationMap(const QString& arrayName)
+{
+  Q_D(msvQECGMainWindow);
+  vtkDoubleArray* features[4] = {d->signalAnalyzer->GetPeakTimes(),
+                                 d->signalAnalyzer->GetActivationTimes(),
+                                 d->signalAnalyzer->GetMaxDVDT(),
+                                 d->signalAnalyzer->GetPeakToPeak()};
+  vtkDoubleArray* feature = 0;
+  for (int i = 0; i < 4; ++i)
+    {
+    if (arrayName == features[i]->GetName())
+      {
+      feature = features[i];
+      }
+    }
+
+  if (!feature || feature->GetNumberOfTuples() == 0)
+    {
+    d->cartoPointsMapper->ScalarVisibilityOff();
+    }
+  else
+    {
+    d->cartoPointsMapper->ScalarVisibilityOn();
+    d->cartoPointsMapper->SetScalarModeToUsePointFieldData();
+    d->cartoPointsMapper->SelectColorArray(feature->GetName());
+    d->cartoPointsMapper->SetScalarRange(feature->GetRange());
+    }
   this->updateView();
 }
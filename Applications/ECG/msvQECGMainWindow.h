@@ -22,6 +22,7 @@
 #define __msvECGMainWindow_h
 
 // Qt includes
+#include <QList>
 #include <QMainWindow>
 
 // CTK includes
@@ -41,17 +42,60 @@ public:
   msvQECGMainWindow(QWidget *parent=0);
   virtual ~msvQECGMainWindow();
 
+  /// Time in ms between the opening of the last study and the display of its
+  /// first mesh, -1 if no mesh has been displayed yet.
+  double timeToFirstMesh() const;
+
+  /// Return true while a study is being loaded in the background.
+  bool isLoading() const;
+
+  /// Signals displayed in the chart.
+  QList<int> selectedSignals() const;
+  /// \sa setOverlaySignals()
+  bool overlaySignals() const;
+
 public slots:
   void openData();
+  void openData(const QString& rootDirectory);
   void closeData();
   void aboutApplication();
   void updateView();
   void setCurrentSignal(int pointId);
 
+  /// Display the traces of several signals at once. Only the traces that are
+  /// not already displayed are created, the samples are never copied.
+  void setSelectedSignals(const QList<int>& signalIds);
+
+  /// In overlay mode, selecting an electrode adds its signal to the chart
+  /// (or removes it if already displayed) instead of replacing the chart.
+  void setOverlaySignals(bool overlay);
+
+  /// Restrict the signal analysis to [start, end] (ms) and update the
+  /// activation maps. An empty window (end < start) analyzes whole signals.
+  void setAnalysisWindow(double start, double end);
+  /// Color the mesh with one of the msvVTKECGSignalAnalyzer point arrays
+  /// (e.g. msvVTKECGSignalAnalyzer::ActivationTimeArrayName). An empty name
+  /// disables the coloring.
+  void setActivationMap(const QString& arrayName);
+
+signals:
+  /// Progress of the study being loaded.
+  /// \sa msvQECGStudyLoader::Stage
+  void studyLoadProgress(int stage, int value, int maximum);
+  /// Emitted when the first mesh of the study is displayed, the user can
+  /// interact with the scene from then on.
+  void firstMeshDisplayed(double timeToFirstMesh);
+  /// Emitted when all the stages of the study are loaded.
+  void studyLoaded();
+
 protected slots:
   void onPointSelected();
   void onCurrentTimeChanged(double);
 
+  void onFirstMeshLoaded(int generation);
+  void onSignalLoaded(int index, int generation);
+  void onStudyLoaded(int generation);
+
 protected:
   QScopedPointer<msvQECGMainWindowPrivate> d_ptr;
 
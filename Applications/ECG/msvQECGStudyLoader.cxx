@@ -0,0 +1,301 @@
+/*==============================================================================
+
+  Library: MSVTK
+
+  Copyright (c) Kitware Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// Qt includes
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QRegExp>
+
+// ECG includes
+#include "msvQECGStudyLoader.h"
+
+// VTK includes
+#include "vtkDelimitedTextReader.h"
+#include "vtkPolyData.h"
+#include "vtkPolyDataReader.h"
+#include "vtkSmartPointer.h"
+
+// STD includes
+#include <vector>
+
+//------------------------------------------------------------------------------
+class msvQECGStudyLoaderPrivate
+{
+public:
+  msvQECGStudyLoaderPrivate();
+
+  QStringList listFiles(const QString& subDirectory,
+                        const QString& filter) const;
+  void readAhead(const QString& fileName) const;
+
+  QString RootDirectory;
+  QStringList PointsFiles;
+  QStringList SignalsFiles;
+  vtkSmartPointer<vtkPolyData> FirstMesh;
+  std::vector<vtkSmartPointer<vtkDelimitedTextReader> > SignalReaders;
+
+  int Generation;
+
+  mutable QMutex Mutex;
+  volatile bool Canceled;
+};
+
+//------------------------------------------------------------------------------
+// msvQECGStudyLoaderPrivate methods
+
+//------------------------------------------------------------------------------
+msvQECGStudyLoaderPrivate::msvQECGStudyLoaderPrivate()
+{
+  this->Generation = 0;
+  this->Canceled = false;
+}
+
+//------------------------------------------------------------------------------
+QStringList msvQECGStudyLoaderPrivate::listFiles(const QString& subDirectory,
+                                                 const QString& filter) const
+{
+  QStringList files;
+  QDir dir(this->RootDirectory);
+  if (!dir.cd(subDirectory))
+    {
+    return files;
+    }
+
+  dir.setNameFilters(QStringList() << filter);
+  foreach(const QString& file, dir.entryList(QDir::Files, QDir::Name))
+    {
+    files << dir.filePath(file);
+    }
+
+  // Resort files using their index number
+  qSort(files.begin(), files.end(), msvQECGStudyLoader::fileLessThan);
+  return files;
+}
+
+//------------------------------------------------------------------------------
+void msvQECGStudyLoaderPrivate::readAhead(const QString& fileName) const
+{
+  // Bring the file into the system cache so that the file series reader does
+  // not wait for the disk when the step is played.
+  QFile file(fileName);
+  if (!file.open(QIODevice::ReadOnly))
+    {
+    return;
+    }
+  char buffer[65536];
+  while (!this->Canceled && file.read(buffer, sizeof(buffer)) > 0)
+    {
+    }
+}
+
+//------------------------------------------------------------------------------
+// msvQECGStudyLoader methods
+
+//------------------------------------------------------------------------------
+msvQECGStudyLoader::msvQECGStudyLoader(QObject* parentObject)
+  : Superclass(parentObject)
+  , d_ptr(new msvQECGStudyLoaderPrivate)
+{
+}
+
+//------------------------------------------------------------------------------
+msvQECGStudyLoader::~msvQECGStudyLoader()
+{
+  this->cancel();
+  this->wait();
+}
+
+//------------------------------------------------------------------------------
+void msvQECGStudyLoader::setRootDirectory(const QString& rootDirectory)
+{
+  Q_D(msvQECGStudyLoader);
+  QMutexLocker locker(&d->Mutex);
+  d->RootDirectory = rootDirectory;
+
+  // A new study invalidates the results of the previous one.
+  d->PointsFiles.clear();
+  d->SignalsFiles.clear();
+  d->FirstMesh = 0;
+  d->SignalReaders.clear();
+  d->Canceled = false;
+  ++d->Generation;
+}
+
+//------------------------------------------------------------------------------
+QString msvQECGStudyLoader::rootDirectory() const
+{
+  Q_D(const msvQECGStudyLoader);
+  QMutexLocker locker(&d->Mutex);
+  return d->RootDirectory;
+}
+
+//------------------------------------------------------------------------------
+int msvQECGStudyLoader::generation() const
+{
+  Q_D(const msvQECGStudyLoader);
+  QMutexLocker locker(&d->Mutex);
+  return d->Generation;
+}
+
+//------------------------------------------------------------------------------
+QStringList msvQECGStudyLoader::pointsFiles() const
+{
+  Q_D(const msvQECGStudyLoader);
+  QMutexLocker locker(&d->Mutex);
+  return d->PointsFiles;
+}
+
+//------------------------------------------------------------------------------
+QStringList msvQECGStudyLoader::signalsFiles() const
+{
+  Q_D(const msvQECGStudyLoader);
+  QMutexLocker locker(&d->Mutex);
+  return d->SignalsFiles;
+}
+
+//------------------------------------------------------------------------------
+vtkPolyData* msvQECGStudyLoader::firstMesh() const
+{
+  Q_D(const msvQECGStudyLoader);
+  QMutexLocker locker(&d->Mutex);
+  return d->FirstMesh;
+}
+
+//------------------------------------------------------------------------------
+vtkTableAlgorithm* msvQECGStudyLoader::signalReader(int index) const
+{
+  Q_D(const msvQECGStudyLoader);
+  QMutexLocker locker(&d->Mutex);
+  if (index < 0 || index >= static_cast<int>(d->SignalReaders.size()))
+    {
+    return 0;
+    }
+  return d->SignalReaders[index];
+}
+
+//------------------------------------------------------------------------------
+void msvQECGStudyLoader::cancel()
+{
+  Q_D(msvQECGStudyLoader);
+  d->Canceled = true;
+}
+
+//------------------------------------------------------------------------------
+bool msvQECGStudyLoader::isCanceled() const
+{
+  Q_D(const msvQECGStudyLoader);
+  return d->Canceled;
+}
+
+//------------------------------------------------------------------------------
+void msvQECGStudyLoader::run()
+{
+  Q_D(msvQECGStudyLoader);
+  int generation = this->generation();
+
+  // Stage 1: list the files
+  emit stageProgress(ListingFiles, 0, 1);
+  QStringList pointsFiles = d->listFiles("CartoPoints", "*.vtk");
+  QStringList signalsFiles = d->listFiles("CartoSignals", "*.csv");
+  {
+  QMutexLocker locker(&d->Mutex);
+  d->PointsFiles = pointsFiles;
+  d->SignalsFiles = signalsFiles;
+  }
+  emit stageProgress(ListingFiles, 1, 1);
+  emit filesListed(generation);
+
+  // Stage 2: read the first mesh, it is all we need to display something.
+  if (d->Canceled)
+    {
+    return;
+    }
+  emit stageProgress(LoadingFirstMesh, 0, 1);
+  if (!pointsFiles.isEmpty())
+    {
+    vtkSmartPointer<vtkPolyDataReader> reader =
+      vtkSmartPointer<vtkPolyDataReader>::New();
+    reader->SetFileName(pointsFiles.first().toLatin1().constData());
+    reader->Update();
+    {
+    QMutexLocker locker(&d->Mutex);
+    d->FirstMesh = reader->GetOutput();
+    }
+    }
+  emit stageProgress(LoadingFirstMesh, 1, 1);
+  emit firstMeshLoaded(generation);
+
+  // Stage 3: parse the signals
+  for (int i = 0; i < signalsFiles.count(); ++i)
+    {
+    if (d->Canceled)
+      {
+      return;
+      }
+    emit stageProgress(LoadingSignals, i, signalsFiles.count());
+    vtkSmartPointer<vtkDelimitedTextReader> reader =
+      vtkSmartPointer<vtkDelimitedTextReader>::New();
+    reader->SetDetectNumericColumns(true);
+    reader->SetHaveHeaders(true);
+    reader->SetFileName(signalsFiles[i].toLatin1().constData());
+    reader->Update();
+    {
+    QMutexLocker locker(&d->Mutex);
+    d->SignalReaders.push_back(reader);
+    }
+    emit signalLoaded(i, generation);
+    }
+  emit stageProgress(LoadingSignals, signalsFiles.count(),
+                     signalsFiles.count());
+
+  // Stage 4: read ahead the remaining time steps
+  for (int i = 1; i < pointsFiles.count(); ++i)
+    {
+    if (d->Canceled)
+      {
+      return;
+      }
+    emit stageProgress(LoadingSteps, i - 1, pointsFiles.count() - 1);
+    d->readAhead(pointsFiles[i]);
+    emit stepLoaded(i, generation);
+    }
+  emit stageProgress(LoadingSteps, qMax(pointsFiles.count() - 1, 0),
+                     qMax(pointsFiles.count() - 1, 0));
+  emit stageProgress(Done, 1, 1);
+  emit studyLoaded(generation);
+}
+
+//------------------------------------------------------------------------------
+bool msvQECGStudyLoader::fileLessThan(const QString &s1, const QString &s2)
+{
+  // Compare file by the index contained within.
+  QString fileA, fileB;
+  QRegExp indexExp("(\\d+)");
+
+  int pos = indexExp.indexIn(QFileInfo(s1).fileName());
+  fileA = (pos > -1) ? indexExp.cap() : "0";
+  pos = indexExp.indexIn(QFileInfo(s2).fileName());
+  fileB = (pos > -1) ? indexExp.cap() : "0";
+
+  return fileA.toInt() < fileB.toInt();
+}
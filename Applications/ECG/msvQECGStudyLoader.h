@@ -0,0 +1,111 @@
+/*==============================================================================
+
+  Library: MSVTK
+
+  Copyright (c) Kitware Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// msvQECGStudyLoader loads a CARTO study (CartoPoints/*.vtk and
+// CartoSignals/*.csv) in a background thread, in stages:
+//  - ListingFiles:     list and sort the point and signal files,
+//  - LoadingFirstMesh: read the first CartoPoints time step,
+//  - LoadingSignals:   parse every CartoSignals file,
+//  - LoadingSteps:     read ahead the remaining CartoPoints time steps.
+// Each stage publishes its progress through stageProgress(). The results of a
+// stage can be retrieved from the GUI thread as soon as the corresponding
+// signal has been received; the loader never touches them afterwards.
+
+#ifndef __msvQECGStudyLoader_h
+#define __msvQECGStudyLoader_h
+
+// Qt includes
+#include <QStringList>
+#include <QThread>
+
+// ECG includes
+#include "msvECGExport.h"
+
+class msvQECGStudyLoaderPrivate;
+class vtkPolyData;
+class vtkTableAlgorithm;
+
+class MSV_ECG_EXPORT msvQECGStudyLoader : public QThread
+{
+  Q_OBJECT
+public:
+  typedef QThread Superclass;
+  msvQECGStudyLoader(QObject* parent=0);
+  virtual ~msvQECGStudyLoader();
+
+  enum Stage
+    {
+    ListingFiles = 0,
+    LoadingFirstMesh,
+    LoadingSignals,
+    LoadingSteps,
+    Done
+    };
+
+  /// Root directory of the study, it must be set before start().
+  /// Setting it starts a new load generation.
+  void setRootDirectory(const QString& rootDirectory);
+  QString rootDirectory() const;
+
+  /// Generation of the current study. The signals of a load carry the
+  /// generation it was started with, so that the receivers can drop the
+  /// queued signals of a previous study.
+  int generation() const;
+
+  /// Sorted list of the CartoPoints (resp. CartoSignals) files.
+  /// Valid after filesListed() has been emitted.
+  QStringList pointsFiles() const;
+  QStringList signalsFiles() const;
+
+  /// First CartoPoints time step. Valid after firstMeshLoaded().
+  vtkPolyData* firstMesh() const;
+
+  /// Updated reader of the index-th signal file. Valid after
+  /// signalLoaded(index).
+  vtkTableAlgorithm* signalReader(int index) const;
+
+  /// Ask the loader to stop as soon as possible. The stage in progress is
+  /// interrupted between two files.
+  void cancel();
+  bool isCanceled() const;
+
+  /// Compare files by the index contained within their names.
+  static bool fileLessThan(const QString &, const QString &);
+
+signals:
+  void stageProgress(int stage, int value, int maximum);
+  void filesListed(int generation);
+  void firstMeshLoaded(int generation);
+  void signalLoaded(int index, int generation);
+  void stepLoaded(int index, int generation);
+  /// Emitted when all the stages are done, unless the load was canceled.
+  void studyLoaded(int generation);
+
+protected:
+  virtual void run();
+
+  QScopedPointer<msvQECGStudyLoaderPrivate> d_ptr;
+
+private:
+  Q_DECLARE_PRIVATE(msvQECGStudyLoader);
+  Q_DISABLE_COPY(msvQECGStudyLoader);
+};
+
+#endif
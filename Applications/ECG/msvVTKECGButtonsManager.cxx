@@ -23,6 +23,7 @@
 #include <vtkCallbackCommand.h>
 #include <vtkCommand.h>
 #include <vtkCubeSource.h>
+#include <vtkIdList.h>
 #include <vtkNew.h>
 #include <vtkObjectFactory.h>
 #include <vtkPolyData.h>
@@ -312,6 +313,18 @@ int msvVTKECGButtonsManager::GetIndexFromButtonId(vtkIdType id) const
   return std::distance(this->Internal->HandleButtonWidgets.begin(), it);
 }
 
+//------------------------------------------------------------------------------
+void msvVTKECGButtonsManager::GetButtonIds(vtkIdList* ids) const
+{
+  ids->Reset();
+  msvVTKECGButtonsManager::vtkInternal::HandleButtonWidgetsType::iterator it;
+  for (it = this->Internal->HandleButtonWidgets.begin();
+       it != this->Internal->HandleButtonWidgets.end(); ++it)
+    {
+    ids->InsertNextId(it->first);
+    }
+}
+
 //------------------------------------------------------------------------------
 void msvVTKECGButtonsManager::PrintSelf(ostream& os, vtkIndent indent)
 {
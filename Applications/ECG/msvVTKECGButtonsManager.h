@@ -28,6 +28,7 @@
 // ECG includes
 #include "msvECGExport.h"
 
+class vtkIdList;
 class vtkPolyData;
 class vtkRenderer;
 
@@ -63,6 +64,10 @@ public:
   vtkIdType GetLastSelectedButton() const;
   int GetIndexFromButtonId(vtkIdType) const;
 
+  // Description:
+  // Fill the list with the point ids of the buttons, in index order.
+  void GetButtonIds(vtkIdList* ids) const;
+
   /// Callback using to process the widgets events
   static void ProcessWidgetsEvents(vtkObject *caller,
                                    unsigned long event,
@@ -0,0 +1,512 @@
+/*==============================================================================
+
+  Library: MSVTK
+
+  Copyright (c) Kitware Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// VTK includes
+#include <vtkCollection.h>
+#include <vtkDoubleArray.h>
+#include <vtkIdList.h>
+#include <vtkMath.h>
+#include <vtkMultiThreader.h>
+#include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+#include <vtkPolyData.h>
+#include <vtkSmartPointer.h>
+#include <vtkTable.h>
+#include <vtkTableAlgorithm.h>
+
+// STD includes
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+// MSVTK includes
+#include "msvVTKECGSignalAnalyzer.h"
+
+//------------------------------------------------------------------------------
+vtkStandardNewMacro(msvVTKECGSignalAnalyzer);
+
+const char* msvVTKECGSignalAnalyzer::PeakTimeArrayName = "Peak Time (ms)";
+const char* msvVTKECGSignalAnalyzer::ActivationTimeArrayName =
+  "Activation Time (ms)";
+const char* msvVTKECGSignalAnalyzer::MaxDVDTArrayName = "Max dV/dt (mV/ms)";
+const char* msvVTKECGSignalAnalyzer::PeakToPeakArrayName =
+  "Peak-to-Peak Voltage (mV)";
+
+namespace
+{
+// Number of samples summarized by a block.
+const vtkIdType BlockSize = 64;
+
+//------------------------------------------------------------------------------
+// Features of a range of samples, mergeable.
+struct Features
+{
+  Features()
+    : MinV(VTK_DOUBLE_MAX), MaxV(-VTK_DOUBLE_MAX),
+      MaxAbsV(-1.), PeakIndex(-1), MaxAbsDVDT(-1.), ActivationIndex(-1) {}
+
+  void AddSample(vtkIdType k, double v)
+    {
+    this->MinV = std::min(this->MinV, v);
+    this->MaxV = std::max(this->MaxV, v);
+    if (std::fabs(v) > this->MaxAbsV)
+      {
+      this->MaxAbsV = std::fabs(v);
+      this->PeakIndex = k;
+      }
+    }
+
+  void AddDerivative(vtkIdType k, double dvdt)
+    {
+    if (std::fabs(dvdt) > this->MaxAbsDVDT)
+      {
+      this->MaxAbsDVDT = std::fabs(dvdt);
+      this->ActivationIndex = k;
+      }
+    }
+
+  void Merge(const Features& other)
+    {
+    this->MinV = std::min(this->MinV, other.MinV);
+    this->MaxV = std::max(this->MaxV, other.MaxV);
+    if (other.MaxAbsV > this->MaxAbsV)
+      {
+      this->MaxAbsV = other.MaxAbsV;
+      this->PeakIndex = other.PeakIndex;
+      }
+    if (other.MaxAbsDVDT > this->MaxAbsDVDT)
+      {
+      this->MaxAbsDVDT = other.MaxAbsDVDT;
+      this->ActivationIndex = other.ActivationIndex;
+      }
+    }
+
+  double MinV;
+  double MaxV;
+  double MaxAbsV;
+  vtkIdType PeakIndex;
+  double MaxAbsDVDT;
+  vtkIdType ActivationIndex;
+};
+
+//------------------------------------------------------------------------------
+// Samples of a signal, a double copy is made only for non double arrays.
+struct Signal
+{
+  Signal() : T(0), V(0), NumberOfSamples(0), BuildMTime(0) {}
+
+  unsigned long GetInputMTime() const
+    {
+    return std::max(this->Time->GetMTime(), this->Voltage->GetMTime());
+    }
+
+  static const double* GetSamples(vtkDataArray* array,
+                                  std::vector<double>& copy)
+    {
+    vtkDoubleArray* doubles = vtkDoubleArray::SafeDownCast(array);
+    if (doubles && doubles->GetNumberOfComponents() == 1)
+      {
+      copy.clear();
+      return doubles->GetPointer(0);
+      }
+    copy.resize(array->GetNumberOfTuples());
+    for (vtkIdType i = 0; i < array->GetNumberOfTuples(); ++i)
+      {
+      copy[i] = array->GetComponent(i, 0);
+      }
+    return copy.empty() ? 0 : &copy[0];
+    }
+
+  double Derivative(vtkIdType k) const
+    {
+    double dt = this->T[k] - this->T[k-1];
+    return dt > 0. ? (this->V[k] - this->V[k-1]) / dt : 0.;
+    }
+
+  // Scan the samples [first, last], the derivative of a sample is only
+  // taken into account if the previous sample is after windowFirst.
+  // The samples are read from contiguous double buffers. The loop is not
+  // vectorized: its reductions keep the index of the extremum and skip NaN,
+  // which compilers only vectorize with relaxed floating point, and the
+  // division of the derivative bounds it anyway.
+  void Scan(vtkIdType first, vtkIdType last, vtkIdType windowFirst,
+            Features& features) const
+    {
+    for (vtkIdType k = first; k <= last; ++k)
+      {
+      features.AddSample(k, this->V[k]);
+      if (k > windowFirst)
+        {
+        features.AddDerivative(k, this->Derivative(k));
+        }
+      }
+    }
+
+  void Build()
+    {
+    this->T = GetSamples(this->Time, this->TimeCopy);
+    this->V = GetSamples(this->Voltage, this->VoltageCopy);
+    this->NumberOfSamples = std::min(this->Time->GetNumberOfTuples(),
+                                     this->Voltage->GetNumberOfTuples());
+    vtkIdType numberOfBlocks = (this->NumberOfSamples + BlockSize - 1) /
+                               BlockSize;
+    this->Blocks.assign(numberOfBlocks, Features());
+    for (vtkIdType b = 0; b < numberOfBlocks; ++b)
+      {
+      vtkIdType last = std::min((b + 1) * BlockSize, this->NumberOfSamples) - 1;
+      this->Scan(b * BlockSize, last, 0, this->Blocks[b]);
+      }
+    this->BuildMTime = this->GetInputMTime();
+    }
+
+  Features Query(double start, double end) const
+    {
+    Features features;
+    if (this->NumberOfSamples == 0)
+      {
+      return features;
+      }
+    vtkIdType first = 0;
+    vtkIdType last = this->NumberOfSamples - 1;
+    if (end >= start)
+      {
+      first = std::lower_bound(this->T, this->T + this->NumberOfSamples,
+                               start) - this->T;
+      last = (std::upper_bound(this->T, this->T + this->NumberOfSamples,
+                               end) - this->T) - 1;
+      }
+    if (last < first)
+      {
+      return features;
+      }
+
+    vtkIdType firstBlock = first / BlockSize;
+    vtkIdType lastBlock = last / BlockSize;
+    if (lastBlock - firstBlock < 2)
+      {
+      this->Scan(first, last, first, features);
+      return features;
+      }
+    this->Scan(first, (firstBlock + 1) * BlockSize - 1, first, features);
+    for (vtkIdType b = firstBlock + 1; b < lastBlock; ++b)
+      {
+      features.Merge(this->Blocks[b]);
+      }
+    this->Scan(lastBlock * BlockSize, last, first, features);
+    return features;
+    }
+
+  vtkSmartPointer<vtkDataArray> Time;
+  vtkSmartPointer<vtkDataArray> Voltage;
+  std::vector<double> TimeCopy;
+  std::vector<double> VoltageCopy;
+  const double* T;
+  const double* V;
+  vtkIdType NumberOfSamples;
+  std::vector<Features> Blocks;
+  unsigned long BuildMTime;
+};
+
+} // end of anonymous namespace
+
+//------------------------------------------------------------------------------
+class msvVTKECGSignalAnalyzer::vtkInternal
+{
+public:
+  vtkInternal();
+
+  static VTK_THREAD_RETURN_TYPE AnalyzeSignals(void* arg);
+
+  std::vector<Signal> Signals;
+  std::vector<char> Rebuild;
+  double Window[2];
+
+  vtkSmartPointer<vtkDoubleArray> Outputs[4];
+  double* OutputPointers[4];
+  vtkSmartPointer<vtkDoubleArray> PointArrays[4];
+  vtkTimeStamp UpdateTime;
+};
+
+//------------------------------------------------------------------------------
+// vtkInternal methods
+
+//------------------------------------------------------------------------------
+msvVTKECGSignalAnalyzer::vtkInternal::vtkInternal()
+{
+  const char* names[4] = {msvVTKECGSignalAnalyzer::PeakTimeArrayName,
+                          msvVTKECGSignalAnalyzer::ActivationTimeArrayName,
+                          msvVTKECGSignalAnalyzer::MaxDVDTArrayName,
+                          msvVTKECGSignalAnalyzer::PeakToPeakArrayName};
+  for (int i = 0; i < 4; ++i)
+    {
+    this->Outputs[i] = vtkSmartPointer<vtkDoubleArray>::New();
+    this->Outputs[i]->SetName(names[i]);
+    }
+  this->Window[0] = 0.;
+  this->Window[1] = -1.;
+}
+
+//------------------------------------------------------------------------------
+VTK_THREAD_RETURN_TYPE msvVTKECGSignalAnalyzer::vtkInternal
+::AnalyzeSignals(void* arg)
+{
+  vtkMultiThreader::ThreadInfo* threadInfo =
+    static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+  vtkInternal* self = static_cast<vtkInternal*>(threadInfo->UserData);
+
+  vtkIdType numberOfSignals = static_cast<vtkIdType>(self->Signals.size());
+  for (vtkIdType i = threadInfo->ThreadID; i < numberOfSignals;
+       i += threadInfo->NumberOfThreads)
+    {
+    Signal& signal = self->Signals[i];
+    if (self->Rebuild[i])
+      {
+      signal.Build();
+      }
+
+    // Each thread writes its own tuples
+    Features features = signal.Query(self->Window[0], self->Window[1]);
+    bool valid = features.PeakIndex >= 0;
+    bool hasDerivative = features.ActivationIndex >= 0;
+    self->OutputPointers[0][i] = valid ?
+      signal.T[features.PeakIndex] : vtkMath::Nan();
+    self->OutputPointers[1][i] = hasDerivative ?
+      signal.T[features.ActivationIndex] : vtkMath::Nan();
+    self->OutputPointers[2][i] = hasDerivative ?
+      features.MaxAbsDVDT : vtkMath::Nan();
+    self->OutputPointers[3][i] = valid ?
+      features.MaxV - features.MinV : vtkMath::Nan();
+    }
+
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+//------------------------------------------------------------------------------
+// msvVTKECGSignalAnalyzer methods
+
+//------------------------------------------------------------------------------
+msvVTKECGSignalAnalyzer::msvVTKECGSignalAnalyzer()
+{
+  this->Internal = new vtkInternal;
+  this->Window[0] = 0.;
+  this->Window[1] = -1.;
+  this->NumberOfThreads =
+    vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+  this->NumberOfRebuiltSignals = 0;
+  this->Threader = vtkMultiThreader::New();
+}
+
+//------------------------------------------------------------------------------
+msvVTKECGSignalAnalyzer::~msvVTKECGSignalAnalyzer()
+{
+  this->Threader->Delete();
+  delete this->Internal;
+}
+
+//------------------------------------------------------------------------------
+void msvVTKECGSignalAnalyzer::RemoveAllSignals()
+{
+  this->Internal->Signals.clear();
+  this->Modified();
+}
+
+//------------------------------------------------------------------------------
+void msvVTKECGSignalAnalyzer::AddSignal(vtkDataArray* time,
+                                        vtkDataArray* voltage)
+{
+  if (!time || !voltage)
+    {
+    vtkErrorMacro("A signal needs a time and a voltage array.");
+    return;
+    }
+
+  Signal signal;
+  signal.Time = time;
+  signal.Voltage = voltage;
+  this->Internal->Signals.push_back(signal);
+  this->Modified();
+}
+
+//------------------------------------------------------------------------------
+void msvVTKECGSignalAnalyzer::AddSignals(vtkCollection* tableAlgorithms,
+                                         int timeColumn, int voltageColumn)
+{
+  if (!tableAlgorithms)
+    {
+    return;
+    }
+
+  for (int i = 0; i < tableAlgorithms->GetNumberOfItems(); ++i)
+    {
+    vtkTableAlgorithm* algorithm = vtkTableAlgorithm::SafeDownCast(
+      tableAlgorithms->GetItemAsObject(i));
+    if (!algorithm)
+      {
+      continue;
+      }
+    algorithm->Update();
+    vtkTable* table = algorithm->GetOutput();
+    this->AddSignal(
+      vtkDataArray::SafeDownCast(table->GetColumn(timeColumn)),
+      vtkDataArray::SafeDownCast(table->GetColumn(voltageColumn)));
+    }
+}
+
+//------------------------------------------------------------------------------
+int msvVTKECGSignalAnalyzer::GetNumberOfSignals() const
+{
+  return static_cast<int>(this->Internal->Signals.size());
+}
+
+//------------------------------------------------------------------------------
+void msvVTKECGSignalAnalyzer::Update()
+{
+  vtkIdType numberOfSignals =
+    static_cast<vtkIdType>(this->Internal->Signals.size());
+
+  // Find the signals whose block summaries are out of date
+  this->Internal->Rebuild.assign(numberOfSignals, 0);
+  int numberOfRebuiltSignals = 0;
+  for (vtkIdType i = 0; i < numberOfSignals; ++i)
+    {
+    const Signal& signal = this->Internal->Signals[i];
+    if (signal.BuildMTime == 0 ||
+        signal.GetInputMTime() > signal.BuildMTime)
+      {
+      this->Internal->Rebuild[i] = 1;
+      ++numberOfRebuiltSignals;
+      }
+    }
+  if (numberOfRebuiltSignals == 0 &&
+      this->GetMTime() < this->Internal->UpdateTime)
+    {
+    this->NumberOfRebuiltSignals = 0;
+    return;
+    }
+
+  this->Internal->Window[0] = this->Window[0];
+  this->Internal->Window[1] = this->Window[1];
+  for (int i = 0; i < 4; ++i)
+    {
+    this->Internal->Outputs[i]->SetNumberOfTuples(numberOfSignals);
+    this->Internal->OutputPointers[i] =
+      this->Internal->Outputs[i]->GetPointer(0);
+    }
+
+  if (numberOfSignals > 0)
+    {
+    int numberOfThreads = static_cast<int>(
+      std::min(static_cast<vtkIdType>(this->NumberOfThreads), numberOfSignals));
+    this->Threader->SetNumberOfThreads(numberOfThreads);
+    this->Threader->SetSingleMethod(vtkInternal::AnalyzeSignals,
+                                    this->Internal);
+    this->Threader->SingleMethodExecute();
+    }
+
+  for (int i = 0; i < 4; ++i)
+    {
+    this->Internal->Outputs[i]->Modified();
+    }
+  this->NumberOfRebuiltSignals = numberOfRebuiltSignals;
+  this->Internal->UpdateTime.Modified();
+}
+
+//------------------------------------------------------------------------------
+vtkDoubleArray* msvVTKECGSignalAnalyzer::GetPeakTimes()
+{
+  return this->Internal->Outputs[0];
+}
+
+//------------------------------------------------------------------------------
+vtkDoubleArray* msvVTKECGSignalAnalyzer::GetActivationTimes()
+{
+  return this->Internal->Outputs[1];
+}
+
+//------------------------------------------------------------------------------
+vtkDoubleArray* msvVTKECGSignalAnalyzer::GetMaxDVDT()
+{
+  return this->Internal->Outputs[2];
+}
+
+//------------------------------------------------------------------------------
+vtkDoubleArray* msvVTKECGSignalAnalyzer::GetPeakToPeak()
+{
+  return this->Internal->Outputs[3];
+}
+
+//------------------------------------------------------------------------------
+void msvVTKECGSignalAnalyzer::AttachArrays(vtkPolyData* polyData,
+                                           vtkIdList* pointIds)
+{
+  if (!polyData || !pointIds)
+    {
+    return;
+    }
+
+  vtkIdType numberOfPoints = polyData->GetNumberOfPoints();
+  for (int i = 0; i < 4; ++i)
+    {
+    vtkDoubleArray* output = this->Internal->Outputs[i];
+    vtkSmartPointer<vtkDoubleArray>& pointArray =
+      this->Internal->PointArrays[i];
+
+    // The point arrays are shared by all the time steps with the same number
+    // of points, they are only refilled when the features change.
+    if (!pointArray || pointArray->GetNumberOfTuples() != numberOfPoints ||
+        pointArray->GetMTime() < output->GetMTime())
+      {
+      pointArray = vtkSmartPointer<vtkDoubleArray>::New();
+      pointArray->SetName(output->GetName());
+      pointArray->SetNumberOfTuples(numberOfPoints);
+      std::fill(pointArray->GetPointer(0),
+                pointArray->GetPointer(0) + numberOfPoints, vtkMath::Nan());
+      vtkIdType count = std::min(pointIds->GetNumberOfIds(),
+                                 output->GetNumberOfTuples());
+      for (vtkIdType s = 0; s < count; ++s)
+        {
+        vtkIdType pointId = pointIds->GetId(s);
+        if (pointId >= 0 && pointId < numberOfPoints)
+          {
+          pointArray->SetValue(pointId, output->GetValue(s));
+          }
+        }
+      }
+
+    if (polyData->GetPointData()->GetArray(output->GetName()) !=
+        pointArray.GetPointer())
+      {
+      polyData->GetPointData()->AddArray(pointArray);
+      }
+    }
+}
+
+//------------------------------------------------------------------------------
+void msvVTKECGSignalAnalyzer::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+
+  os << indent << "Number of signals: " << this->GetNumberOfSignals() << "\n";
+  os << indent << "Window: " << this->Window[0] << ", " << this->Window[1]
+     << "\n";
+  os << indent << "Number of threads: " << this->NumberOfThreads << "\n";
+  os << indent << "Number of rebuilt signals: "
+     << this->NumberOfRebuiltSignals << "\n";
+}
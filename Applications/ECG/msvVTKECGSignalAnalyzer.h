@@ -0,0 +1,132 @@
+/*==============================================================================
+
+  Library: MSVTK
+
+  Copyright (c) Kitware Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// msvVTKECGSignalAnalyzer computes per-signal features over an analysis
+// window [WindowStart, WindowEnd] (in the time unit of the signals):
+//  - the peak voltage time (time of the maximum absolute voltage),
+//  - the activation time (time of the maximum absolute dV/dt),
+//  - the maximum absolute dV/dt,
+//  - the peak-to-peak voltage.
+// Signals are processed in parallel with a vtkMultiThreader. For each signal,
+// summaries of fixed-size blocks of samples are built once; as long as the
+// signals are not modified, changing the analysis window only queries these
+// summaries and the samples of the two partial blocks at the window bounds.
+// The features can be attached as point data arrays to the electrode points
+// of a vtkPolyData (see AttachArrays()).
+
+#ifndef __msvVTKECGSignalAnalyzer_h
+#define __msvVTKECGSignalAnalyzer_h
+
+// VTK includes
+#include "vtkObject.h"
+
+// ECG includes
+#include "msvECGExport.h"
+
+class vtkCollection;
+class vtkDataArray;
+class vtkDoubleArray;
+class vtkIdList;
+class vtkMultiThreader;
+class vtkPolyData;
+
+class MSV_ECG_EXPORT msvVTKECGSignalAnalyzer : public vtkObject
+{
+public:
+  static msvVTKECGSignalAnalyzer* New();
+  vtkTypeMacro(msvVTKECGSignalAnalyzer, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Remove all the signals.
+  void RemoveAllSignals();
+
+  // Description:
+  // Add a signal given its time and voltage arrays (first component used).
+  // Times must be increasing.
+  void AddSignal(vtkDataArray* time, vtkDataArray* voltage);
+
+  // Description:
+  // Add the signals of a collection of vtkTableAlgorithm (as used by the ECG
+  // main window), given the column indices of the time and the voltage.
+  void AddSignals(vtkCollection* tableAlgorithms, int timeColumn = 0,
+                  int voltageColumn = 1);
+
+  int GetNumberOfSignals() const;
+
+  // Description:
+  // Set / Get the analysis window. An empty window (end < start) means the
+  // whole signal. Default is the whole signal.
+  vtkSetVector2Macro(Window, double);
+  vtkGetVector2Macro(Window, double);
+
+  // Description:
+  // Set / Get the number of threads used to analyze the signals.
+  // Default is the number of processors.
+  vtkSetClampMacro(NumberOfThreads, int, 1, VTK_INT_MAX);
+  vtkGetMacro(NumberOfThreads, int);
+
+  // Description:
+  // Compute the features if the signals or the window have been modified.
+  // Block summaries are rebuilt only for the signals that have been modified.
+  void Update();
+
+  // Description:
+  // Features computed by Update(), one tuple per signal.
+  vtkDoubleArray* GetPeakTimes();
+  vtkDoubleArray* GetActivationTimes();
+  vtkDoubleArray* GetMaxDVDT();
+  vtkDoubleArray* GetPeakToPeak();
+
+  // Description:
+  // Number of block summaries rebuilt during the last Update().
+  vtkGetMacro(NumberOfRebuiltSignals, int);
+
+  // Description:
+  // Add the features as point data arrays of the polydata. The signal i is
+  // associated with the point pointIds->GetId(i); other points get NaN.
+  // Arrays already attached and up to date are left untouched.
+  void AttachArrays(vtkPolyData* polyData, vtkIdList* pointIds);
+
+  // Description:
+  // Name of the point data arrays added by AttachArrays().
+  static const char* PeakTimeArrayName;
+  static const char* ActivationTimeArrayName;
+  static const char* MaxDVDTArrayName;
+  static const char* PeakToPeakArrayName;
+
+protected:
+  msvVTKECGSignalAnalyzer();
+  virtual ~msvVTKECGSignalAnalyzer();
+
+  double Window[2];
+  int NumberOfThreads;
+  int NumberOfRebuiltSignals;
+
+  vtkMultiThreader* Threader;
+
+private:
+  msvVTKECGSignalAnalyzer(const msvVTKECGSignalAnalyzer&);  // Not implemented.
+  void operator=(const msvVTKECGSignalAnalyzer&);           // Not implemented.
+
+  class vtkInternal;
+  vtkInternal* Internal;
+};
+#endif
@@ -25,6 +25,7 @@
 #include "BuildConfig.h"
 #include "msvApp.h"
 #include "vtkExtTypes.h"
+#include "msvFrameScheduler.h"
 
 class msvObjectFactory;
 
@@ -45,6 +46,7 @@ public:
 
 protected:
     void CreateSceneData();
+    void CreateFrameScheduler();
 
 protected:
     vtkRendererSP                           m_pRendererSP;
@@ -52,6 +54,7 @@ protected:
     vtkRenderWindowInteractorSP             m_RenderWindowInteractorSP;
 
     msvObjectFactory*                       m_pmsvObjectFactory;
+    msvFrameSchedulerSP                     m_FrameSchedulerSP;
 
 private:
 };
@@ -47,6 +47,7 @@ public:
     virtual int OnExit();
     virtual void Exit();
     void OnIdlePlatformDependent( wxIdleEvent& event );
+    void OnIdleTimer( wxTimerEvent& event );
     virtual void OnIdle();
     virtual void ResetElapsedTime();
     //virtual int OnRun();
@@ -56,6 +57,11 @@ protected:
 protected:
 
 private:
+    // Calls OnIdle and arms m_IdleTimer for the wait it asks for. Returns true
+    // if OnIdle must be called again as soon as possible
+    bool Tick();
+
+    wxTimer*                        m_IdleTimer;
     wxLongLong                      m_CurrentTimeMillisInternal;
     wxLongLong                      m_ElapsedTimeMillisInternal;
 };
@@ -33,11 +33,15 @@ using namespace std;
 msvAppBase::msvAppBase()
 : m_CurrentTimeMillis( 0 )
 , m_ElapsedTimeMillis( 0 )
+, m_IdleWaitMillis( 0 )
 {
 
 }
 
 msvAppBase::msvAppBase( int &argc, char **argv )
+: m_CurrentTimeMillis( 0 )
+, m_ElapsedTimeMillis( 0 )
+, m_IdleWaitMillis( 0 )
 {
 }
 
@@ -25,6 +25,7 @@
 #include "BuildConfig.h"
 #include "msvApp.h"
 #include "vtkExtTypes.h"
+#include "msvFrameScheduler.h"
 
 class msvObjectFactory;
 class vtkGPUPolyDataMapper;
@@ -46,6 +47,7 @@ public:
 
 protected:
     void CreateSceneData();
+    void CreateFrameScheduler();
 
 protected:
     vtkRendererSP                           m_pRendererSP;
@@ -53,6 +55,7 @@ protected:
     vtkRenderWindowInteractorSP             m_RenderWindowInteractorSP;
 
     msvObjectFactory*                       m_pmsvObjectFactory;
+    msvFrameSchedulerSP                     m_FrameSchedulerSP;
 
     vtkActorSP                              m_SampleActorSP;
     vtkPolyDataSP                           m_SamplePolydataSP;
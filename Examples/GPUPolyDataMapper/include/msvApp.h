@@ -53,6 +53,9 @@ protected:
     long                            m_CurrentTimeMillis;
     long                            m_ElapsedTimeMillis;
     ExitCommand*                    m_ExitCommand;
+    // Set by OnIdle: milliseconds the platform loop may wait before calling
+    // it again. 0 calls it again as soon as possible
+    long                            m_IdleWaitMillis;
 
 private:
 
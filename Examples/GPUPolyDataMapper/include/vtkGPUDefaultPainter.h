@@ -33,6 +33,12 @@
 // Typically, the delegate of the default painter be one that is capable of r
 // rendering graphics primitives or a vtkChooserPainter which can select appropriate
 // painters to do the rendering.
+// When UseInterleavedVertexBuffer is on, the default, a
+// vtkGPUInterleavedVertexBufferPainter takes the place of the
+// vtkDisplayListPainter: time-varying polydata is streamed to a buffer
+// object instead of compiling a display list for every time step. With
+// MapScalarsToTexture on as well, it maps the scalars to colors through a
+// 1D lookup texture instead of on the CPU.
 
 #ifndef __VTKGPUDEFAULTPAINTER_H__
 #define __VTKGPUDEFAULTPAINTER_H__
@@ -43,6 +49,7 @@ class vtkClipPlanesPainter;
 class vtkCoincidentTopologyResolutionPainter;
 class vtkCompositePainter;
 class vtkDisplayListPainter;
+class vtkGPUInterleavedVertexBufferPainter;
 class vtkLightingPainter;
 class vtkRepresentationPainter;
 class vtkScalarsToColorsPainter;
@@ -70,6 +77,25 @@ public:
     void SetDisplayListPainter(vtkDisplayListPainter*);
     vtkGetObjectMacro(DisplayListPainter, vtkDisplayListPainter);
 
+    // Description:
+    // Get/Set the painter that draws from an interleaved vertex buffer.
+    void SetInterleavedVertexBufferPainter(vtkGPUInterleavedVertexBufferPainter*);
+    vtkGetObjectMacro(InterleavedVertexBufferPainter, vtkGPUInterleavedVertexBufferPainter);
+
+    // Description:
+    // Whether the chain draws through the InterleavedVertexBufferPainter
+    // or through the DisplayListPainter. On by default.
+    vtkSetMacro(UseInterleavedVertexBuffer, int);
+    vtkGetMacro(UseInterleavedVertexBuffer, int);
+    vtkBooleanMacro(UseInterleavedVertexBuffer, int);
+
+    // Description:
+    // Whether the InterleavedVertexBufferPainter maps the scalars to colors
+    // with a 1D lookup texture instead of on the CPU. Off by default.
+    vtkSetMacro(MapScalarsToTexture, int);
+    vtkGetMacro(MapScalarsToTexture, int);
+    vtkBooleanMacro(MapScalarsToTexture, int);
+
     // Description:
     // Get/Set the painter used to handle composite datasets.
     void SetCompositePainter(vtkCompositePainter*);
@@ -137,6 +163,9 @@ protected:
     vtkScalarsToColorsPainter* ScalarsToColorsPainter;
     vtkClipPlanesPainter* ClipPlanesPainter;
     vtkDisplayListPainter* DisplayListPainter;
+    vtkGPUInterleavedVertexBufferPainter* InterleavedVertexBufferPainter;
+    int UseInterleavedVertexBuffer;
+    int MapScalarsToTexture;
     vtkCompositePainter* CompositePainter;
     vtkCoincidentTopologyResolutionPainter* CoincidentTopologyResolutionPainter;
     vtkLightingPainter* LightingPainter;
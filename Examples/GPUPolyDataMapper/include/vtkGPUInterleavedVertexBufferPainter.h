@@ -0,0 +1,200 @@
+/*==============================================================================
+
+  Library: MSVTK
+
+  Copyright (c) Computational Image and Simulation Technologies in Biomedicine (CISTIB),
+                Universitat Pompeu Fabra (UPF), Barcelona, Spain
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+// .NAME vtkGPUInterleavedVertexBufferPainter - draws polydata from one interleaved vertex buffer
+// .SECTION Description
+// vtkGPUInterleavedVertexBufferPainter draws the points, lines, polygons
+// and strips of its input from a single OpenGL buffer object holding the
+// positions, normals and colors of each vertex side by side, with the
+// indices in a second buffer object. The arrays are built by a
+// vtkGPUInterleavedVertexPacker.
+//
+// The scalars are mapped to colors here, through the lookup table in the
+// painter information, and only when the scalars or the table change.
+// When only the points, normals or colors of the input change the buffer is
+// kept: its storage is orphaned and refilled, so the driver does not wait
+// for the frames still drawing from the old contents. Time steps that share
+// their topology keep the index buffer too.
+//
+// With MapScalarsToTexture on, single component scalars are not mapped on
+// the CPU: they are streamed as they are, as the texture coordinates of unit
+// 0, and the lookup table is sampled into a 1D texture by a
+// vtkGPULookupTableTexture. The texture matrix maps the scalar range to the
+// texture and the fixed function pipeline looks the color up per fragment,
+// so changing the scalars costs one upload and changing the table costs
+// NumberOfTexels samples. Unsigned char scalars used as colors and vectors
+// are still mapped on the CPU.
+//
+// The point data arrays mapped to generic vertex attributes or texture
+// coordinates with DATA_ARRAY_TO_VERTEX_ATTRIBUTE each get a pair of buffer
+// objects of their own, filled in turn by a vtkGPUVertexAttributeStream
+// only when the array changes. With STATIC_GEOMETRY set the interleaved
+// buffer is kept across time steps, so animating a point data array
+// uploads that array alone.
+//
+// What it cannot draw goes to the delegate painter: everything when buffer
+// objects are not supported, the representation is not surface, colors,
+// normals or mapped attributes come from cell data, polygons have no point
+// normals to light them with, or an attribute is mapped without OpenGL 2.0.
+
+#ifndef __VTKGPUINTERLEAVEDVERTEXBUFFERPAINTER_H__
+#define __VTKGPUINTERLEAVEDVERTEXBUFFERPAINTER_H__
+
+#include "vtkPolyDataPainter.h"
+
+class vtkDataArray;
+class vtkGPUInterleavedVertexBufferPainterInternals;
+class vtkGPUInterleavedVertexPacker;
+class vtkGPULookupTableTexture;
+class vtkInformationIntegerKey;
+class vtkScalarsToColors;
+class vtkUnsignedCharArray;
+class vtkWindow;
+
+class vtkGPUInterleavedVertexBufferPainter : public vtkPolyDataPainter
+{
+public:
+    static vtkGPUInterleavedVertexBufferPainter *New();
+    vtkTypeMacro(vtkGPUInterleavedVertexBufferPainter, vtkPolyDataPainter);
+    virtual void PrintSelf(ostream &os, vtkIndent indent);
+
+    // Description:
+    // Get the packer that builds the arrays uploaded to the buffers.
+    vtkGetObjectMacro(Packer, vtkGPUInterleavedVertexPacker);
+
+    // Description:
+    // When set to 1 in the painter information, the points, normals and
+    // cells packed first are kept while the number of points stays the same.
+    // For time series where only the point data changes.
+    static vtkInformationIntegerKey* STATIC_GEOMETRY();
+
+    // Description:
+    // Map the scalars to colors in a 1D texture instead of on the CPU, when
+    // they have one component. Off by default.
+    vtkSetMacro(MapScalarsToTexture, int);
+    vtkGetMacro(MapScalarsToTexture, int);
+    vtkBooleanMacro(MapScalarsToTexture, int);
+
+    // Description:
+    // Get the texels the lookup table is sampled into with MapScalarsToTexture.
+    vtkGetObjectMacro(ScalarTexture, vtkGPULookupTableTexture);
+
+    // Description:
+    // Release the buffer objects. The parameter window could be used to
+    // determine which graphic resources to release.
+    virtual void ReleaseGraphicsResources(vtkWindow *);
+
+    // Description:
+    // Number of times the vertex buffer was created or resized, and the
+    // number of times its contents were streamed into the same buffer.
+    vtkGetMacro(NumberOfBufferRebuilds, int);
+    vtkGetMacro(NumberOfBufferUpdates, int);
+
+    // Description:
+    // Number of times a mapped attribute array was streamed to its buffers.
+    vtkGetMacro(NumberOfAttributeUploads, int);
+
+protected:
+    vtkGPUInterleavedVertexBufferPainter();
+    ~vtkGPUInterleavedVertexBufferPainter();
+
+    // Description:
+    // Draws from the buffers, or hands the call to the delegate.
+    virtual void RenderInternal(vtkRenderer *renderer, vtkActor *actor,
+        unsigned long typeflags, bool forceCompileOnly);
+
+    // Description:
+    // Whether this painter can draw the input with actor.
+    bool CanDraw(vtkRenderer *renderer, vtkActor *actor);
+
+    // Description:
+    // The scalars mapped to colors, if visible. cellFlag is set as
+    // vtkAbstractMapper::GetScalars does.
+    vtkDataArray *GetVisibleScalars(vtkPolyData *input, int &cellFlag);
+
+    // Description:
+    // Whether scalars can be mapped through the texture with colorMode.
+    bool CanMapScalarsToTexture(vtkDataArray *scalars, int colorMode);
+
+    // Description:
+    // Maps the point scalars to colors when they or the lookup table
+    // changed, or samples the table when they are mapped through the
+    // texture. Colors is null when scalars are not visible or go to the
+    // texture, TextureScalars is null unless they go to the texture.
+    void UpdateColors(vtkPolyData *input);
+
+    // Description:
+    // Brings the buffer objects up to date with the packer.
+    void UploadBuffers(int packResult);
+
+    // Description:
+    // Streams the point data arrays mapped to vertex attributes and the
+    // texture scalars that changed, and uploads the texture when the table
+    // was sampled again.
+    void UpdateAttributes(vtkPolyData *input);
+
+    // Description:
+    // Forgets the buffer objects of the mapped attributes, deleting them
+    // when their context is current.
+    void ReleaseAttributeBuffers(bool deleteBuffers);
+
+    // Description:
+    // Issues the draw calls of the primitives in typeflags.
+    void DrawBuffers(vtkActor *actor, unsigned long typeflags);
+
+    vtkGPUInterleavedVertexPacker *Packer;
+    vtkUnsignedCharArray *Colors;
+    vtkTimeStamp ColorsBuildTime;
+    // Only compared, never dereferenced: what Colors were mapped from
+    vtkDataArray *MappedScalars;
+    vtkScalarsToColors *MappedLookupTable;
+    int MappedColorMode;
+    int MappedComponent;
+    // Used when the mapper has none, as vtkScalarsToColorsPainter does
+    vtkScalarsToColors *DefaultLookupTable;
+
+    int MapScalarsToTexture;
+    vtkGPULookupTableTexture *ScalarTexture;
+    // The scalars streamed as texture coordinates this frame, or null
+    vtkDataArray *TextureScalars;
+    bool ScalarTextureModified;
+    unsigned int ScalarTextureId;
+
+    vtkGPUInterleavedVertexBufferPainterInternals *Internals;
+    // Only compared: the mappings the attributes were built from
+    vtkObject *LastMappings;
+    vtkTimeStamp AttributesBuildTime;
+
+    vtkWindow *LastWindow;
+    int BufferObjectsSupported;
+    int VertexAttributesSupported;
+    unsigned int VertexBuffer;
+    unsigned int IndexBuffer;
+    size_t VertexBufferSize;
+    int NumberOfBufferRebuilds;
+    int NumberOfBufferUpdates;
+    int NumberOfAttributeUploads;
+
+private:
+    vtkGPUInterleavedVertexBufferPainter(const vtkGPUInterleavedVertexBufferPainter &); // Not implemented
+    void operator=(const vtkGPUInterleavedVertexBufferPainter &);    // Not implemented
+};
+
+#endif  // __VTKGPUINTERLEAVEDVERTEXBUFFERPAINTER_H__
@@ -0,0 +1,189 @@
+/*==============================================================================
+
+  Library: MSVTK
+
+  Copyright (c) Computational Image and Simulation Technologies in Biomedicine (CISTIB),
+                Universitat Pompeu Fabra (UPF), Barcelona, Spain
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+// .NAME vtkGPUInterleavedVertexPacker - packs polydata into interleaved vertex and index arrays
+// .SECTION Description
+// vtkGPUInterleavedVertexPacker is the CPU side of
+// vtkGPUInterleavedVertexBufferPainter. It packs the points, the point
+// normals and the point colors of a vtkPolyData into one interleaved array
+// laid out as a vertex buffer expects it, and its cells into unsigned int
+// indices grouped by primitive: points, line segments, and triangles from
+// the polygons and the strips.
+//
+// Each vertex holds 3 floats of position, then 3 floats of normal if the
+// input has point normals, then 4 unsigned chars of RGBA if colors are
+// given. Pack remembers what it packed last: when only the points, normals
+// or colors changed it rewrites those fields in place and keeps the layout
+// and the indices, so the painter can update its buffer instead of
+// rebuilding it. Cells are compared by content, so the time steps of a
+// series that share their topology do not rebuild the indices either.
+//
+// With StaticGeometry on, the points, normals and cells are packed once
+// and kept for as long as the number of points and the layout do not
+// change, whatever array the input holds: the time steps of a series that
+// only animates its point data are not even compared.
+//
+// It does not touch OpenGL, so it can be used and tested without a context.
+
+#ifndef __VTKGPUINTERLEAVEDVERTEXPACKER_H__
+#define __VTKGPUINTERLEAVEDVERTEXPACKER_H__
+
+#include "vtkObject.h"
+#include "vtkWeakPointer.h"
+
+#include <vector>
+
+class vtkCellArray;
+class vtkDataArray;
+class vtkPolyData;
+class vtkUnsignedCharArray;
+
+class vtkGPUInterleavedVertexPacker : public vtkObject
+{
+public:
+    static vtkGPUInterleavedVertexPacker *New();
+    vtkTypeMacro(vtkGPUInterleavedVertexPacker, vtkObject);
+    virtual void PrintSelf(ostream &os, vtkIndent indent);
+
+    //BTX
+    // Description:
+    // What Pack did with the arrays.
+    enum PackResult
+    {
+        // Nothing changed since the last Pack
+        Unchanged = 0,
+        // Same layout and indices, some vertex fields were rewritten
+        VerticesUpdated,
+        // New layout or new indices, everything was packed again
+        Repacked
+    };
+
+    // Description:
+    // Groups of indices, each one drawn with a single primitive type.
+    enum Primitive
+    {
+        Points = 0,
+        Lines,
+        PolygonTriangles,
+        StripTriangles,
+        NumberOfPrimitives
+    };
+    //ETX
+
+    // Description:
+    // Packs the points, point normals and cells of input, and colors when not
+    // null (one RGBA tuple per point). Returns a PackResult. Returns Repacked
+    // with no vertices when the input has no points.
+    int Pack(vtkPolyData *input, vtkUnsignedCharArray *colors);
+
+    // Description:
+    // Keep the packed points, normals and indices while the number of points
+    // and the layout stay the same. Off by default.
+    vtkSetMacro(StaticGeometry, int);
+    vtkGetMacro(StaticGeometry, int);
+    vtkBooleanMacro(StaticGeometry, int);
+
+    // Description:
+    // Forgets what was packed, so the next Pack packs everything.
+    void Reset();
+
+    // Description:
+    // The interleaved vertices. Offsets and stride are in bytes; an offset
+    // is -1 when the field is not in the layout.
+    const unsigned char *GetVertexData() const
+    { return this->VertexData.empty() ? 0 : &this->VertexData[0]; }
+    size_t GetVertexDataSize() const { return this->VertexData.size(); }
+    int GetStride() const { return this->Stride; }
+    int GetNormalOffset() const { return this->NormalOffset; }
+    int GetColorOffset() const { return this->ColorOffset; }
+    int GetNumberOfVertices() const { return this->NumberOfVertices; }
+
+    // Description:
+    // The indices of all the primitives, one range after the other.
+    const unsigned int *GetIndexData() const
+    { return this->Indices.empty() ? 0 : &this->Indices[0]; }
+    size_t GetIndexDataSize() const
+    { return this->Indices.size() * sizeof(unsigned int); }
+    // Description:
+    // First index and number of indices of a primitive.
+    size_t GetIndexOffset(int primitive) const
+    { return this->IndexOffsets[primitive]; }
+    size_t GetNumberOfIndices(int primitive) const
+    { return this->IndexCounts[primitive]; }
+
+protected:
+    vtkGPUInterleavedVertexPacker();
+    ~vtkGPUInterleavedVertexPacker();
+
+    //BTX
+    // An input array as it was last packed, to tell whether it changed.
+    // MTime is the one of the array or of what holds it, the newest
+    struct PackedArray
+    {
+        PackedArray() : MTime(0) {}
+        bool Changed(vtkDataArray *array, unsigned long mtime) const;
+        void Set(vtkDataArray *array, unsigned long mtime);
+
+        vtkWeakPointer<vtkDataArray> Array;
+        unsigned long MTime;
+    };
+
+    // Connectivity of a cell array as it was last packed
+    struct PackedCells
+    {
+        PackedCells() : MTime(0) {}
+        // Remembers cells, returns whether they hold other connectivity
+        bool Update(vtkCellArray *cells);
+
+        vtkWeakPointer<vtkCellArray> Cells;
+        unsigned long MTime;
+        std::vector<vtkIdType> Connectivity;
+    };
+    //ETX
+
+    bool UpdateTopology(vtkPolyData *input);
+    void BuildIndices(vtkPolyData *input);
+    void PackPositions(vtkDataArray *points);
+    void PackNormals(vtkDataArray *normals);
+    void PackColors(vtkUnsignedCharArray *colors);
+
+    std::vector<unsigned char> VertexData;
+    std::vector<unsigned int> Indices;
+    size_t IndexOffsets[NumberOfPrimitives];
+    size_t IndexCounts[NumberOfPrimitives];
+    int Stride;
+    int NormalOffset;
+    int ColorOffset;
+    int NumberOfVertices;
+    int StaticGeometry;
+
+    //BTX
+    PackedArray PackedPoints;
+    PackedArray PackedNormals;
+    PackedArray PackedColors;
+    PackedCells PackedTopology[4];
+    //ETX
+
+private:
+    vtkGPUInterleavedVertexPacker(const vtkGPUInterleavedVertexPacker &); // Not implemented
+    void operator=(const vtkGPUInterleavedVertexPacker &);    // Not implemented
+};
+
+#endif  // __VTKGPUINTERLEAVEDVERTEXPACKER_H__
@@ -0,0 +1,103 @@
+/*==============================================================================
+
+  Library: MSVTK
+
+  Copyright (c) Computational Image and Simulation Technologies in Biomedicine (CISTIB),
+                Universitat Pompeu Fabra (UPF), Barcelona, Spain
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+// .NAME vtkGPULookupTableTexture - samples a lookup table into the texels of a 1D texture
+// .SECTION Description
+// vtkGPULookupTableTexture is the CPU side of mapping scalars to colors on
+// the GPU. It samples a vtkScalarsToColors at the centres of
+// NumberOfTexels texels spread over its range, as RGBA, and gives the
+// scale and shift that turn a scalar into the texture coordinate of its
+// color. With the raw scalars sent as texture coordinates and those in the
+// texture matrix, the vertex stage maps the range and the fragment stage
+// looks the color up, so nothing proportional to the number of vertices
+// is done on the CPU when the scalars change.
+//
+// Colors are interpolated between texels, as vtkMapper does with
+// InterpolateScalarsBeforeMapping on. Tables with a logarithmic scale are
+// sampled linearly in the scalar, which is coarse at the low end.
+//
+// It does not touch OpenGL, so it can be used and tested without a context.
+
+#ifndef __VTKGPULOOKUPTABLETEXTURE_H__
+#define __VTKGPULOOKUPTABLETEXTURE_H__
+
+#include "vtkObject.h"
+#include "vtkWeakPointer.h"
+
+#include <vector>
+
+class vtkScalarsToColors;
+
+class vtkGPULookupTableTexture : public vtkObject
+{
+public:
+    static vtkGPULookupTableTexture *New();
+    vtkTypeMacro(vtkGPULookupTableTexture, vtkObject);
+    virtual void PrintSelf(ostream &os, vtkIndent indent);
+
+    // Description:
+    // Number of texels of the texture. 256 by default.
+    vtkSetClampMacro(NumberOfTexels, int, 2, 4096);
+    vtkGetMacro(NumberOfTexels, int);
+
+    // Description:
+    // Builds lookupTable and samples it into the texels, when it or
+    // NumberOfTexels changed since the last call. Returns whether the texels
+    // were sampled again.
+    bool Update(vtkScalarsToColors *lookupTable);
+
+    // Description:
+    // Forgets what was sampled, so the next Update samples again.
+    void Reset();
+
+    // Description:
+    // The sampled colors, 4 unsigned chars per texel.
+    const unsigned char *GetTexels() const
+    { return this->Texels.empty() ? 0 : &this->Texels[0]; }
+    int GetNumberOfSampledTexels() const
+    { return static_cast<int>(this->Texels.size() / 4); }
+
+    // Description:
+    // The texture coordinate of a scalar is scalar * scale + shift: 0 at the
+    // start of the range, 1 at its end.
+    double GetTextureCoordinateScale() const { return this->Scale; }
+    double GetTextureCoordinateShift() const { return this->Shift; }
+    double GetTextureCoordinate(double scalar) const
+    { return scalar * this->Scale + this->Shift; }
+
+protected:
+    vtkGPULookupTableTexture();
+    ~vtkGPULookupTableTexture();
+
+    int NumberOfTexels;
+    //BTX
+    std::vector<unsigned char> Texels;
+    vtkWeakPointer<vtkScalarsToColors> LookupTable;
+    //ETX
+    unsigned long LookupTableMTime;
+    double Scale;
+    double Shift;
+
+private:
+    vtkGPULookupTableTexture(const vtkGPULookupTableTexture &); // Not implemented
+    void operator=(const vtkGPULookupTableTexture &);    // Not implemented
+};
+
+#endif  // __VTKGPULOOKUPTABLETEXTURE_H__
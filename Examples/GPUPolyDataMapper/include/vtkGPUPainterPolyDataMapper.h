@@ -78,6 +78,18 @@ public:
         int unit,
         const char* dataArrayName, int fieldAssociation, int componentno=-1);
 
+    // Description:
+    // Time-varying attribute mode: the geometry of the first input drawn is
+    // kept on the GPU while the inputs that follow have the same number of
+    // points, and only the arrays mapped with MapDataArrayToVertexAttribute
+    // and MapDataArrayToMultiTextureAttribute are uploaded when they change.
+    // For time series that animate point data over a fixed mesh. Turn
+    // ScalarVisibility off and color in the shader so the scalars are not
+    // mapped to colors on every time step as well. Off by default.
+    vtkSetMacro(TimeVaryingAttributes, int);
+    vtkGetMacro(TimeVaryingAttributes, int);
+    vtkBooleanMacro(TimeVaryingAttributes, int);
+
     // Description:
     // Remove a vertex attribute mapping.
     virtual void RemoveVertexAttributeMapping(const char* vertexAttributeName);
@@ -125,6 +137,7 @@ protected:
     // (look at vtkHardwareSelector).
     vtkPainter* SelectionPainter;
     vtkPainterGPUPolyDataMapperObserver* Observer;
+    int TimeVaryingAttributes;
 private:
     vtkPainterGPUPolyDataMapper(const vtkPainterGPUPolyDataMapper&); // Not implemented.
     void operator=(const vtkPainterGPUPolyDataMapper&); // Not implemented.
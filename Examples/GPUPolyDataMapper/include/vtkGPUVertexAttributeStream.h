@@ -0,0 +1,102 @@
+/*==============================================================================
+
+  Library: MSVTK
+
+  Copyright (c) Computational Image and Simulation Technologies in Biomedicine (CISTIB),
+                Universitat Pompeu Fabra (UPF), Barcelona, Spain
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+// .NAME vtkGPUVertexAttributeStream - stages a time-varying point data array for a vertex attribute
+// .SECTION Description
+// vtkGPUVertexAttributeStream holds the CPU side of one generic vertex
+// attribute drawn by vtkGPUInterleavedVertexBufferPainter: the values of
+// one component of a point data array, or all of them, as floats. Stage
+// converts them only when the array, its contents or the component
+// changed, so a time series that animates one scalar costs one float per
+// vertex per time step and nothing on the frames in between. Float arrays
+// are not copied: the staged data is the array itself.
+//
+// Each change goes to the other of two slots, the buffer objects the
+// painter streams into. The slot written is never the one the previous
+// frame drew from, so the upload does not wait for that frame to finish.
+//
+// It does not touch OpenGL, so it can be used and tested without a context.
+
+#ifndef __VTKGPUVERTEXATTRIBUTESTREAM_H__
+#define __VTKGPUVERTEXATTRIBUTESTREAM_H__
+
+#include "vtkObject.h"
+#include "vtkWeakPointer.h"
+
+#include <vector>
+
+class vtkDataArray;
+
+class vtkGPUVertexAttributeStream : public vtkObject
+{
+public:
+    static vtkGPUVertexAttributeStream *New();
+    vtkTypeMacro(vtkGPUVertexAttributeStream, vtkObject);
+    virtual void PrintSelf(ostream &os, vtkIndent indent);
+
+    // Description:
+    // Stages component of array, or all its components when component is
+    // -1, if they changed since the last call. Returns the slot the staged
+    // values have to be uploaded to, which becomes the current slot, or -1
+    // when nothing changed.
+    int Stage(vtkDataArray *array, int component);
+
+    // Description:
+    // Forgets what was staged, so the next Stage stages everything.
+    void Reset();
+
+    // Description:
+    // The staged values, GetNumberOfComponents floats per tuple.
+    const float *GetStagedData() const { return this->StagedData; }
+    size_t GetStagedDataSize() const
+    { return static_cast<size_t>(this->NumberOfTuples) * this->NumberOfComponents * sizeof(float); }
+    int GetNumberOfComponents() const { return this->NumberOfComponents; }
+    int GetNumberOfTuples() const { return this->NumberOfTuples; }
+
+    // Description:
+    // Slot of the last staged values, 0 or 1, or -1 when nothing is staged.
+    int GetCurrentSlot() const { return this->CurrentSlot; }
+
+    // Description:
+    // Number of times Stage staged new values.
+    vtkGetMacro(NumberOfUpdates, int);
+
+protected:
+    vtkGPUVertexAttributeStream();
+    ~vtkGPUVertexAttributeStream();
+
+    //BTX
+    std::vector<float> Staging;
+    vtkWeakPointer<vtkDataArray> Array;
+    //ETX
+    unsigned long MTime;
+    int Component;
+    const float *StagedData;
+    int NumberOfComponents;
+    int NumberOfTuples;
+    int CurrentSlot;
+    int NumberOfUpdates;
+
+private:
+    vtkGPUVertexAttributeStream(const vtkGPUVertexAttributeStream &); // Not implemented
+    void operator=(const vtkGPUVertexAttributeStream &);    // Not implemented
+};
+
+#endif  // __VTKGPUVERTEXATTRIBUTESTREAM_H__
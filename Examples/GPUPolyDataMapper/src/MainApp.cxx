@@ -26,10 +26,14 @@
 #include <vtkRenderer.h>
 #include <vtkRenderWindow.h>
 #include <vtkRenderWindowInteractor.h>
+#include <vtkCamera.h>
+#include <vtkTimerLog.h>
 
 #include <vtkPolyDataReader.h>
 #include <vtkPolyData.h>
 #include <vtkPolyDataMapper.h>
+#include <vtkActor.h>
+#include <vtkProperty.h>
 
 #include <vtkCommand.h>
 
@@ -38,6 +42,7 @@
 
 #include <string>
 #include <ios>
+#include <algorithm>
 
 using namespace std;
 
@@ -45,6 +50,9 @@ MSVTK_IMPLEMENT_APP( MainApp )
 
 #define USE_MAIN_FRAME 0
 
+// Renders only happen when something changed, this is just the idle period
+static const long TickPeriodMillis = 40;
+
 class ExitCommand : public vtkCommand
 {
 public:
@@ -104,6 +112,7 @@ bool MainApp::OnInit()
     m_pRenderWindowSP->AddRenderer( m_pRendererSP );
 
     CreateSceneData();
+    CreateFrameScheduler();
 
     m_pRenderWindowSP->Render();
 
@@ -116,6 +125,8 @@ bool MainApp::OnInit()
 
 int MainApp::OnExit()
 {
+    m_FrameSchedulerSP = 0;
+
     if( m_ExitCommand )
     {
         m_ExitCommand->Delete();
@@ -134,13 +145,43 @@ int MainApp::OnExit()
 
 void MainApp::OnIdle()
 {
-    if( m_ElapsedTimeMillis > 40 )
+    if( m_ElapsedTimeMillis > TickPeriodMillis )
     {
         ResetElapsedTime();
 
         //cout << setw( 5 ) << fixed << setprecision( 3 ) << right << vtkTimerLog::GetCPUTime() << ": Tick" << endl;
     }
-    m_pRenderWindowSP->Render();
+
+    // Interaction and property changes dirty the scheduler
+    if( m_FrameSchedulerSP->IsFrameDue( vtkTimerLog::GetUniversalTime() ) )
+    {
+        m_pRenderWindowSP->Render();
+    }
+
+    // Nothing else to do until the next tick or the next frame that may be due
+    long timeToNextTick = TickPeriodMillis + 1 - m_ElapsedTimeMillis;
+    long timeToNextFrame = static_cast<long>( m_FrameSchedulerSP->GetTimeToNextFrame( vtkTimerLog::GetUniversalTime() ) * 1000.0 );
+    m_IdleWaitMillis = min( timeToNextTick, timeToNextFrame );
+    if( m_IdleWaitMillis < 0 )
+    {
+        m_IdleWaitMillis = 0;
+    }
+}
+
+void MainApp::CreateFrameScheduler()
+{
+    m_FrameSchedulerSP = msvFrameSchedulerSP::New();
+    m_FrameSchedulerSP->SetRenderTarget( m_pRenderWindowSP );
+    // Size changes of the window
+    m_FrameSchedulerSP->Watch( m_pRenderWindowSP );
+    m_FrameSchedulerSP->Watch( m_RenderWindowInteractorSP, vtkCommand::ConfigureEvent );
+    m_FrameSchedulerSP->Watch( m_RenderWindowInteractorSP, vtkCommand::ExposeEvent );
+    // Props added or removed, and the camera moved by the interactor style
+    m_FrameSchedulerSP->Watch( m_pRendererSP );
+    m_FrameSchedulerSP->Watch( m_pRendererSP->GetActiveCamera() );
+    // Material changes of the sample
+    m_FrameSchedulerSP->Watch( m_SampleActorSP );
+    m_FrameSchedulerSP->Watch( m_SampleActorSP->GetProperty() );
 }
 
 string MainApp::GetResouceFolderPath()
@@ -0,0 +1,250 @@
+/*==============================================================================
+
+  Library: MSVTK
+
+  Copyright (c) Computational Image and Simulation Technologies in Biomedicine (CISTIB),
+                Universitat Pompeu Fabra (UPF), Barcelona, Spain
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#include "msvFrameScheduler.h"
+
+#include <vtkObjectFactory.h>
+#include <vtkCallbackCommand.h>
+#include <vtkTimerLog.h>
+
+using namespace std;
+
+vtkStandardNewMacro( msvFrameScheduler );
+
+msvFrameScheduler::msvFrameScheduler()
+: RenderStartTag( 0 )
+, RenderEndTag( 0 )
+, Dirty( true )
+, Rendering( false )
+, AnyFrameRendered( false )
+, MaximumFrameRate( 60.0 )
+, LastFrameTime( 0.0 )
+, NumberOfRenderedFrames( 0 )
+, NumberOfIdleChecks( 0 )
+, NumberOfSkippedChecks( 0 )
+, StatisticsStartTime( 0.0 )
+, StatisticsStartCPUTime( 0.0 )
+{
+    this->WatchCommand = vtkSmartPointer<vtkCallbackCommand>::New();
+    this->WatchCommand->SetCallback( msvFrameScheduler::OnWatchedEvent );
+    this->WatchCommand->SetClientData( this );
+    this->RenderCommand = vtkSmartPointer<vtkCallbackCommand>::New();
+    this->RenderCommand->SetCallback( msvFrameScheduler::OnRenderEvent );
+    this->RenderCommand->SetClientData( this );
+
+    ResetStatistics();
+}
+
+msvFrameScheduler::~msvFrameScheduler()
+{
+    SetRenderTarget( 0 );
+    UnwatchAll();
+}
+
+void msvFrameScheduler::Watch( vtkObject* object, unsigned long event )
+{
+    if( !object )
+    {
+        return;
+    }
+    WatchedObject watchedObject;
+    watchedObject.Object = object;
+    watchedObject.ObserverTag = object->AddObserver( event, this->WatchCommand );
+    this->WatchedObjects.push_back( watchedObject );
+}
+
+void msvFrameScheduler::Unwatch( vtkObject* object )
+{
+    vector<WatchedObject>::iterator it = this->WatchedObjects.begin();
+    while( it != this->WatchedObjects.end() )
+    {
+        if( it->Object == object )
+        {
+            object->RemoveObserver( it->ObserverTag );
+            it = this->WatchedObjects.erase( it );
+        }
+        else
+        {
+            it++;
+        }
+    }
+}
+
+void msvFrameScheduler::UnwatchAll()
+{
+    vector<WatchedObject>::iterator it;
+    for( it = this->WatchedObjects.begin(); it != this->WatchedObjects.end(); it++ )
+    {
+        // Objects already destroyed took their observers with them
+        if( it->Object )
+        {
+            it->Object->RemoveObserver( it->ObserverTag );
+        }
+    }
+    this->WatchedObjects.clear();
+}
+
+void msvFrameScheduler::SetRenderTarget( vtkObject* renderTarget )
+{
+    if( this->RenderTarget )
+    {
+        this->RenderTarget->RemoveObserver( this->RenderStartTag );
+        this->RenderTarget->RemoveObserver( this->RenderEndTag );
+    }
+    this->RenderTarget = renderTarget;
+    this->Rendering = false;
+    if( renderTarget )
+    {
+        this->RenderStartTag = renderTarget->AddObserver( vtkCommand::StartEvent, this->RenderCommand );
+        this->RenderEndTag = renderTarget->AddObserver( vtkCommand::EndEvent, this->RenderCommand );
+    }
+}
+
+void msvFrameScheduler::MarkDirty()
+{
+    this->Dirty = true;
+}
+
+bool msvFrameScheduler::IsDirty()
+{
+    return this->Dirty;
+}
+
+void msvFrameScheduler::SetMaximumFrameRate( double maximumFrameRate )
+{
+    if( maximumFrameRate <= 0.0 )
+    {
+        return;
+    }
+    this->MaximumFrameRate = maximumFrameRate;
+}
+
+double msvFrameScheduler::GetMaximumFrameRate()
+{
+    return this->MaximumFrameRate;
+}
+
+bool msvFrameScheduler::IsFrameDue( double currentTime )
+{
+    this->NumberOfIdleChecks++;
+    if( GetTimeToNextFrame( currentTime ) > 0.0 )
+    {
+        this->NumberOfSkippedChecks++;
+        return false;
+    }
+    return true;
+}
+
+double msvFrameScheduler::GetTimeToNextFrame( double currentTime )
+{
+    double framePeriod = 1.0 / this->MaximumFrameRate;
+    if( !this->Dirty )
+    {
+        return framePeriod;
+    }
+    if( !this->AnyFrameRendered )
+    {
+        return 0.0;
+    }
+    double timeToNextFrame = this->LastFrameTime + framePeriod - currentTime;
+    // A clock going backwards must not hold the frame for long
+    if( timeToNextFrame < 0.0 || timeToNextFrame > framePeriod )
+    {
+        return 0.0;
+    }
+    return timeToNextFrame;
+}
+
+void msvFrameScheduler::FrameRendered( double currentTime )
+{
+    this->Dirty = false;
+    this->AnyFrameRendered = true;
+    this->LastFrameTime = currentTime;
+    this->NumberOfRenderedFrames++;
+}
+
+int msvFrameScheduler::GetNumberOfRenderedFrames()
+{
+    return this->NumberOfRenderedFrames;
+}
+
+int msvFrameScheduler::GetNumberOfIdleChecks()
+{
+    return this->NumberOfIdleChecks;
+}
+
+int msvFrameScheduler::GetNumberOfSkippedChecks()
+{
+    return this->NumberOfSkippedChecks;
+}
+
+double msvFrameScheduler::GetCPUUsage()
+{
+    double elapsedTime = vtkTimerLog::GetUniversalTime() - this->StatisticsStartTime;
+    if( elapsedTime <= 0.0 )
+    {
+        return 0.0;
+    }
+    return ( vtkTimerLog::GetCPUTime() - this->StatisticsStartCPUTime ) / elapsedTime;
+}
+
+void msvFrameScheduler::ResetStatistics()
+{
+    this->NumberOfRenderedFrames = 0;
+    this->NumberOfIdleChecks = 0;
+    this->NumberOfSkippedChecks = 0;
+    this->StatisticsStartTime = vtkTimerLog::GetUniversalTime();
+    this->StatisticsStartCPUTime = vtkTimerLog::GetCPUTime();
+}
+
+void msvFrameScheduler::OnWatchedEvent( vtkObject* caller, unsigned long eventId, void* clientData, void* callData )
+{
+    msvFrameScheduler* self = static_cast<msvFrameScheduler*>( clientData );
+    // The render modifies the camera and the props on its own
+    if( self->Rendering )
+    {
+        return;
+    }
+    self->Dirty = true;
+}
+
+void msvFrameScheduler::OnRenderEvent( vtkObject* caller, unsigned long eventId, void* clientData, void* callData )
+{
+    msvFrameScheduler* self = static_cast<msvFrameScheduler*>( clientData );
+    if( eventId == vtkCommand::StartEvent )
+    {
+        self->Rendering = true;
+    }
+    else
+    {
+        self->Rendering = false;
+        self->FrameRendered( vtkTimerLog::GetUniversalTime() );
+    }
+}
+
+void msvFrameScheduler::PrintSelf( ostream& os, vtkIndent indent )
+{
+    this->Superclass::PrintSelf( os, indent );
+    os << indent << "Dirty: " << this->Dirty << endl;
+    os << indent << "MaximumFrameRate: " << this->MaximumFrameRate << endl;
+    os << indent << "NumberOfRenderedFrames: " << this->NumberOfRenderedFrames << endl;
+    os << indent << "NumberOfSkippedChecks: " << this->NumberOfSkippedChecks << endl;
+}
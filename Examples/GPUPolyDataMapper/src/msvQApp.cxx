@@ -78,6 +78,7 @@ bool msvQApp::OnInit()
 
     QTime currentTime = QTime::currentTime();
     this->startingTime = new QTime( currentTime.hour(), currentTime.minute(), currentTime.second(), currentTime.msec() );
+    m_CurrentTimeMillisInternal = 0;
 
     // Activate on idle
     this->timer = new QTimer( this );
@@ -108,11 +109,15 @@ void msvQApp::OnIdle()
 void msvQApp::OnIdlePlatformDependent()
 {
     QTime currentTime = QTime::currentTime();
-    m_CurrentTimeMillisInternal = this->startingTime->msecsTo( currentTime );
+    int currentTimeMillis = this->startingTime->msecsTo( currentTime );
 
-    m_ElapsedTimeMillis = static_cast<long>( m_CurrentTimeMillisInternal );
+    m_ElapsedTimeMillis += static_cast<long>( currentTimeMillis - m_CurrentTimeMillisInternal );
+    m_CurrentTimeMillisInternal = currentTimeMillis;
 
     OnIdle();
+
+    // Nothing to do until then, so do not keep the timer spinning
+    this->timer->setInterval( static_cast<int>( m_IdleWaitMillis ) );
 }
 
 void msvQApp::ResetElapsedTime()
@@ -27,10 +27,12 @@ using std::string;
 
 
 msvWxApp::msvWxApp()
+: m_IdleTimer( 0 )
 {
 }
 
 msvWxApp::msvWxApp( int &argc, char **argv )
+: m_IdleTimer( 0 )
 {
 }
 
@@ -60,6 +62,10 @@ bool msvWxApp::OnInit()
     m_CurrentTimeMillisInternal = ::wxGetLocalTimeMillis();
     Connect( wxEVT_IDLE, wxIdleEventHandler( msvWxApp::OnIdlePlatformDependent ), 0, this );
 
+    // Wakes the idle handler up when OnIdle has nothing to do until a deadline
+    m_IdleTimer = new wxTimer( this );
+    Connect( wxEVT_TIMER, wxTimerEventHandler( msvWxApp::OnIdleTimer ), 0, this );
+
     // success: wxApp::OnRun() will be called which will enter the main message
     // loop and the application will run. If we returned FALSE here, the
     // application would exit immediately.
@@ -68,6 +74,12 @@ bool msvWxApp::OnInit()
 
 int msvWxApp::OnExit()
 {
+    if( m_IdleTimer )
+    {
+        m_IdleTimer->Stop();
+        delete m_IdleTimer;
+        m_IdleTimer = 0;
+    }
     return msvAppBase::OnExit();
 }
 
@@ -80,6 +92,25 @@ void msvWxApp::OnIdlePlatformDependent( wxIdleEvent& event )
 {
     //wxApp::OnIdle( event );
 
+    // Keep the idle events coming only while OnIdle has work due at once
+    if( Tick() )
+    {
+        event.RequestMore();
+    }
+}
+
+void msvWxApp::OnIdleTimer( wxTimerEvent& event )
+{
+    // The deadline OnIdle waited for: idle events may have stopped, so get
+    // them going again when it has more to do
+    if( Tick() )
+    {
+        ::wxWakeUpIdle();
+    }
+}
+
+bool msvWxApp::Tick()
+{
     wxLongLong currentTimeMillis = ::wxGetLocalTimeMillis();
     m_ElapsedTimeMillisInternal = m_ElapsedTimeMillisInternal + ( currentTimeMillis - m_CurrentTimeMillisInternal );
 
@@ -89,7 +120,17 @@ void msvWxApp::OnIdlePlatformDependent( wxIdleEvent& event )
 
     OnIdle();
 
-    event.RequestMore();
+    // Nothing to do until then: instead of sleeping in the GUI thread, which
+    // would hold input and paint events back, let the timer call again
+    if( m_IdleWaitMillis > 0 )
+    {
+        if( m_IdleTimer )
+        {
+            m_IdleTimer->Start( static_cast<int>( m_IdleWaitMillis ), wxTIMER_ONE_SHOT );
+        }
+        return false;
+    }
+    return true;
 }
 
 void msvWxApp::ResetElapsedTime()
@@ -26,6 +26,7 @@
 #include "vtkCompositePainter.h"
 #include "vtkDisplayListPainter.h"
 #include "vtkGarbageCollector.h"
+#include "vtkGPUInterleavedVertexBufferPainter.h"
 #include "vtkLightingPainter.h"
 #include "vtkObjectFactory.h"
 #include "vtkPolyData.h"
@@ -41,6 +42,8 @@ vtkCxxSetObjectMacro(vtkGPUDefaultPainter, ClipPlanesPainter,
                      vtkClipPlanesPainter);
 vtkCxxSetObjectMacro(vtkGPUDefaultPainter, DisplayListPainter,
                      vtkDisplayListPainter);
+vtkCxxSetObjectMacro(vtkGPUDefaultPainter, InterleavedVertexBufferPainter,
+                     vtkGPUInterleavedVertexBufferPainter);
 vtkCxxSetObjectMacro(vtkGPUDefaultPainter, CompositePainter, vtkCompositePainter);
 vtkCxxSetObjectMacro(vtkGPUDefaultPainter, CoincidentTopologyResolutionPainter,
                      vtkCoincidentTopologyResolutionPainter);
@@ -52,6 +55,9 @@ vtkGPUDefaultPainter::vtkGPUDefaultPainter()
     this->ScalarsToColorsPainter = 0;
     this->ClipPlanesPainter = 0;
     this->DisplayListPainter = 0;
+    this->InterleavedVertexBufferPainter = 0;
+    this->UseInterleavedVertexBuffer = 1;
+    this->MapScalarsToTexture = 0;
     this->CompositePainter = 0;
     this->CoincidentTopologyResolutionPainter = 0;
     this->LightingPainter = 0;
@@ -70,6 +76,11 @@ vtkGPUDefaultPainter::vtkGPUDefaultPainter()
     this->SetDisplayListPainter(dlp);
     dlp->Delete();
 
+    vtkGPUInterleavedVertexBufferPainter* ivbp =
+        vtkGPUInterleavedVertexBufferPainter::New();
+    this->SetInterleavedVertexBufferPainter(ivbp);
+    ivbp->Delete();
+
     vtkCompositePainter* cpp = vtkCompositePainter::New();
     this->SetCompositePainter(cpp);
     cpp->Delete();
@@ -94,6 +105,7 @@ vtkGPUDefaultPainter::~vtkGPUDefaultPainter()
     this->SetScalarsToColorsPainter(0);
     this->SetClipPlanesPainter(0);
     this->SetDisplayListPainter(0);
+    this->SetInterleavedVertexBufferPainter(0);
     this->SetCompositePainter(0);
     this->SetCoincidentTopologyResolutionPainter(0);
     this->SetLightingPainter(0);
@@ -131,7 +143,18 @@ void vtkGPUDefaultPainter::BuildPainterChain()
         headPainter = (headPainter)? headPainter : painter;
     }
 */
-    painter = this->GetDisplayListPainter();
+    if (this->UseInterleavedVertexBuffer)
+    {
+        painter = this->GetInterleavedVertexBufferPainter();
+        if (painter)
+        {
+            this->InterleavedVertexBufferPainter->SetMapScalarsToTexture(this->MapScalarsToTexture);
+        }
+    }
+    else
+    {
+        painter = this->GetDisplayListPainter();
+    }
     if (painter)
     {
         if (prevPainter)
@@ -219,6 +242,10 @@ void vtkGPUDefaultPainter::ReleaseGraphicsResources(vtkWindow *window)
     {
         this->ScalarsToColorsPainter->ReleaseGraphicsResources(window);
     }
+    if (this->InterleavedVertexBufferPainter)
+    {
+        this->InterleavedVertexBufferPainter->ReleaseGraphicsResources(window);
+    }
     this->Superclass::ReleaseGraphicsResources(window);
 }
 
@@ -236,6 +263,8 @@ void vtkGPUDefaultPainter::ReportReferences(vtkGarbageCollector* collector)
         "ScalarsToColors Painter");
     vtkGarbageCollectorReport(collector, this->DisplayListPainter,
         "DisplayListPainter");
+    vtkGarbageCollectorReport(collector, this->InterleavedVertexBufferPainter,
+        "InterleavedVertexBufferPainter");
     vtkGarbageCollectorReport(collector, this->ClipPlanesPainter,
         "ClipPlanes Painter");
     vtkGarbageCollectorReport(collector, this->CompositePainter,
@@ -322,6 +351,22 @@ void vtkGPUDefaultPainter::PrintSelf(ostream& os, vtkIndent indent)
         os << "(none)" << endl;
     }
 
+    os << indent << "UseInterleavedVertexBuffer: "
+       << this->UseInterleavedVertexBuffer << endl;
+    os << indent << "MapScalarsToTexture: "
+       << this->MapScalarsToTexture << endl;
+    os << indent << "InterleavedVertexBufferPainter: ";
+    if (this->InterleavedVertexBufferPainter)
+    {
+        os << endl;
+        this->InterleavedVertexBufferPainter->PrintSelf(
+            os, indent.GetNextIndent());
+    }
+    else
+    {
+        os << "(none)" << endl;
+    }
+
     os << indent << "CompositePainter: ";
     if (this->CompositePainter)
     {
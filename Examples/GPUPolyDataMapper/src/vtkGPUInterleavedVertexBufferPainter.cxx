@@ -0,0 +1,708 @@
+/*==============================================================================
+
+  Library: MSVTK
+
+  Copyright (c) Computational Image and Simulation Technologies in Biomedicine (CISTIB),
+                Universitat Pompeu Fabra (UPF), Barcelona, Spain
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+#include "vtkGPUInterleavedVertexBufferPainter.h"
+
+#include "vtkAbstractMapper.h"
+#include "vtkActor.h"
+#include "vtkCellData.h"
+#include "vtkDataArray.h"
+#include "vtkDataObject.h"
+#include "vtkGenericVertexAttributeMapping.h"
+#include "vtkGPUInterleavedVertexPacker.h"
+#include "vtkGPULookupTableTexture.h"
+#include "vtkGPUVertexAttributeStream.h"
+#include "vtkInformation.h"
+#include "vtkInformationIntegerKey.h"
+#include "vtkLookupTable.h"
+#include "vtkMapper.h"
+#include "vtkObjectFactory.h"
+#include "vtkOpenGLExtensionManager.h"
+#include "vtkOpenGLRenderWindow.h"
+#include "vtkPointData.h"
+#include "vtkPolyData.h"
+#include "vtkProperty.h"
+#include "vtkRenderer.h"
+#include "vtkScalarsToColorsPainter.h"
+#include "vtkSmartPointer.h"
+#include "vtkTimerLog.h"
+#include "vtkUnsignedCharArray.h"
+
+#include "vtkOpenGL.h"
+#include "vtkgl.h"
+
+#include <string>
+#include <vector>
+
+vtkStandardNewMacro(vtkGPUInterleavedVertexBufferPainter);
+vtkInformationKeyMacro(vtkGPUInterleavedVertexBufferPainter, STATIC_GEOMETRY, Integer);
+
+//-----------------------------------------------------------------------------
+// Offsets into the bound buffer object are passed as pointers
+static inline const GLvoid *vtkGPUBufferOffset(size_t offset)
+{
+    return reinterpret_cast<const GLvoid *>(offset);
+}
+
+//-----------------------------------------------------------------------------
+class vtkGPUInterleavedVertexBufferPainterInternals
+{
+public:
+    // A point data array mapped to a generic vertex attribute, or to the
+    // texture coordinates of TextureUnit when it is not -1
+    struct Attribute
+    {
+        Attribute() : TextureUnit(-1), Component(-1), Active(false), Location(-1)
+        {
+            this->Buffers[0] = this->Buffers[1] = 0;
+            this->BufferSizes[0] = this->BufferSizes[1] = 0;
+        }
+
+        // Streams array to the buffer of the slot it was staged for, if it
+        // changed and has one tuple per vertex. Returns whether it uploaded.
+        bool Upload(vtkDataArray *array, int numberOfVertices);
+        // Forgets the buffers, deleting them when their context is current
+        void Release(bool deleteBuffers);
+        // Points the texture coordinates or the attribute of the program at
+        // the current slot
+        void Bind(GLint program);
+        void Unbind();
+
+        std::string Name;
+        int TextureUnit;
+        std::string ArrayName;
+        int Component;
+        vtkSmartPointer<vtkGPUVertexAttributeStream> Stream;
+        // One per slot of the stream
+        GLuint Buffers[2];
+        size_t BufferSizes[2];
+        // Whether the input has the array, with one tuple per vertex
+        bool Active;
+        // Where it was bound by the last draw, -1 if not bound
+        GLint Location;
+    };
+
+    std::vector<Attribute> Attributes;
+    // The scalars, when they are mapped to colors by the LUT texture
+    Attribute Scalars;
+};
+
+//-----------------------------------------------------------------------------
+bool vtkGPUInterleavedVertexBufferPainterInternals::Attribute::Upload(
+    vtkDataArray *array, int numberOfVertices)
+{
+    vtkGPUVertexAttributeStream *stream = this->Stream;
+    int slot = stream->Stage(array, this->Component);
+    this->Active = (array != 0 && stream->GetNumberOfTuples() == numberOfVertices &&
+        stream->GetNumberOfComponents() >= 1 && stream->GetNumberOfComponents() <= 4);
+    if (!this->Active)
+    {
+        // Staged again once it fits
+        stream->Reset();
+        return false;
+    }
+    if (slot < 0)
+    {
+        return false;
+    }
+
+    // The other slot is the one the last frame drew from
+    size_t size = stream->GetStagedDataSize();
+    if (this->Buffers[slot] == 0)
+    {
+        vtkgl::GenBuffers(1, &this->Buffers[slot]);
+    }
+    vtkgl::BindBuffer(vtkgl::ARRAY_BUFFER, this->Buffers[slot]);
+    if (this->BufferSizes[slot] != size)
+    {
+        vtkgl::BufferData(vtkgl::ARRAY_BUFFER, static_cast<vtkgl::GLsizeiptr>(size),
+            stream->GetStagedData(), vtkgl::DYNAMIC_DRAW);
+        this->BufferSizes[slot] = size;
+    }
+    else
+    {
+        vtkgl::BufferSubData(vtkgl::ARRAY_BUFFER, 0, static_cast<vtkgl::GLsizeiptr>(size),
+            stream->GetStagedData());
+    }
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+void vtkGPUInterleavedVertexBufferPainterInternals::Attribute::Release(bool deleteBuffers)
+{
+    for (int slot = 0; slot < 2; ++slot)
+    {
+        if (deleteBuffers && this->Buffers[slot] != 0)
+        {
+            vtkgl::DeleteBuffers(1, &this->Buffers[slot]);
+        }
+        this->Buffers[slot] = 0;
+        this->BufferSizes[slot] = 0;
+    }
+    this->Stream->Reset();
+    this->Active = false;
+}
+
+//-----------------------------------------------------------------------------
+void vtkGPUInterleavedVertexBufferPainterInternals::Attribute::Bind(GLint program)
+{
+    this->Location = -1;
+    if (!this->Active)
+    {
+        return;
+    }
+    GLint size = this->Stream->GetNumberOfComponents();
+    vtkgl::BindBuffer(vtkgl::ARRAY_BUFFER, this->Buffers[this->Stream->GetCurrentSlot()]);
+    if (this->TextureUnit >= 0)
+    {
+        vtkgl::ClientActiveTexture(vtkgl::TEXTURE0 + this->TextureUnit);
+        glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+        glTexCoordPointer(size, GL_FLOAT, 0, vtkGPUBufferOffset(0));
+        vtkgl::ClientActiveTexture(vtkgl::TEXTURE0);
+    }
+    else if (program != 0)
+    {
+        this->Location = vtkgl::GetAttribLocation(static_cast<GLuint>(program), this->Name.c_str());
+        if (this->Location >= 0)
+        {
+            vtkgl::EnableVertexAttribArray(static_cast<GLuint>(this->Location));
+            vtkgl::VertexAttribPointer(static_cast<GLuint>(this->Location), size,
+                GL_FLOAT, GL_FALSE, 0, vtkGPUBufferOffset(0));
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+void vtkGPUInterleavedVertexBufferPainterInternals::Attribute::Unbind()
+{
+    if (this->Active && this->TextureUnit >= 0)
+    {
+        vtkgl::ClientActiveTexture(vtkgl::TEXTURE0 + this->TextureUnit);
+        glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+        vtkgl::ClientActiveTexture(vtkgl::TEXTURE0);
+    }
+    else if (this->Location >= 0)
+    {
+        vtkgl::DisableVertexAttribArray(static_cast<GLuint>(this->Location));
+    }
+}
+
+//-----------------------------------------------------------------------------
+static vtkGenericVertexAttributeMapping *vtkGPUGetAttributeMappings(vtkInformation *info)
+{
+    if (!info->Has(vtkPolyDataPainter::DATA_ARRAY_TO_VERTEX_ATTRIBUTE()))
+    {
+        return 0;
+    }
+    return vtkGenericVertexAttributeMapping::SafeDownCast(
+        info->Get(vtkPolyDataPainter::DATA_ARRAY_TO_VERTEX_ATTRIBUTE()));
+}
+
+//-----------------------------------------------------------------------------
+vtkGPUInterleavedVertexBufferPainter::vtkGPUInterleavedVertexBufferPainter()
+{
+    this->Packer = vtkGPUInterleavedVertexPacker::New();
+    this->MapScalarsToTexture = 0;
+    this->Colors = 0;
+    this->MappedScalars = 0;
+    this->MappedLookupTable = 0;
+    this->MappedColorMode = -1;
+    this->MappedComponent = -1;
+    this->DefaultLookupTable = 0;
+    this->ScalarTexture = vtkGPULookupTableTexture::New();
+    this->TextureScalars = 0;
+    this->ScalarTextureModified = false;
+    this->ScalarTextureId = 0;
+    this->Internals = new vtkGPUInterleavedVertexBufferPainterInternals;
+    this->Internals->Scalars.TextureUnit = 0;
+    this->Internals->Scalars.Component = 0;
+    this->Internals->Scalars.Stream = vtkSmartPointer<vtkGPUVertexAttributeStream>::New();
+    this->LastMappings = 0;
+    this->LastWindow = 0;
+    this->BufferObjectsSupported = 0;
+    this->VertexAttributesSupported = 0;
+    this->VertexBuffer = 0;
+    this->IndexBuffer = 0;
+    this->VertexBufferSize = 0;
+    this->NumberOfBufferRebuilds = 0;
+    this->NumberOfBufferUpdates = 0;
+    this->NumberOfAttributeUploads = 0;
+}
+
+//-----------------------------------------------------------------------------
+vtkGPUInterleavedVertexBufferPainter::~vtkGPUInterleavedVertexBufferPainter()
+{
+    this->ReleaseGraphicsResources(this->LastWindow);
+    this->Packer->Delete();
+    if (this->Colors)
+    {
+        this->Colors->Delete();
+    }
+    if (this->DefaultLookupTable)
+    {
+        this->DefaultLookupTable->Delete();
+    }
+    this->ScalarTexture->Delete();
+    delete this->Internals;
+}
+
+//-----------------------------------------------------------------------------
+void vtkGPUInterleavedVertexBufferPainter::ReleaseGraphicsResources(vtkWindow *window)
+{
+    bool deleteBuffers = (window && this->VertexBuffer != 0);
+    if (deleteBuffers)
+    {
+        window->MakeCurrent();
+        GLuint buffers[2] = { this->VertexBuffer, this->IndexBuffer };
+        vtkgl::DeleteBuffers(2, buffers);
+        if (this->ScalarTextureId != 0)
+        {
+            GLuint texture = this->ScalarTextureId;
+            glDeleteTextures(1, &texture);
+        }
+    }
+    this->ReleaseAttributeBuffers(deleteBuffers);
+    this->VertexBuffer = 0;
+    this->IndexBuffer = 0;
+    this->VertexBufferSize = 0;
+    this->ScalarTextureId = 0;
+    this->LastWindow = 0;
+    // The next buffer gets everything
+    this->Packer->Reset();
+    this->Superclass::ReleaseGraphicsResources(window);
+}
+
+//-----------------------------------------------------------------------------
+vtkDataArray *vtkGPUInterleavedVertexBufferPainter::GetVisibleScalars(vtkPolyData *input, int &cellFlag)
+{
+    vtkInformation *info = this->GetInformation();
+    cellFlag = 0;
+    if (!info->Has(vtkScalarsToColorsPainter::SCALAR_VISIBILITY()) ||
+        !info->Get(vtkScalarsToColorsPainter::SCALAR_VISIBILITY()))
+    {
+        return 0;
+    }
+    return vtkAbstractMapper::GetScalars(input,
+        info->Get(vtkScalarsToColorsPainter::SCALAR_MODE()),
+        info->Get(vtkScalarsToColorsPainter::ARRAY_ACCESS_MODE()),
+        info->Get(vtkScalarsToColorsPainter::ARRAY_ID()),
+        info->Get(vtkScalarsToColorsPainter::ARRAY_NAME()), cellFlag);
+}
+
+//-----------------------------------------------------------------------------
+bool vtkGPUInterleavedVertexBufferPainter::CanDraw(vtkRenderer *renderer, vtkActor *actor)
+{
+    vtkRenderWindow *window = renderer->GetRenderWindow();
+    if (window != this->LastWindow)
+    {
+        // Buffers belong to the context that created them
+        this->ReleaseGraphicsResources(this->LastWindow);
+        window->MakeCurrent();
+        this->LastWindow = window;
+        vtkOpenGLRenderWindow *openGLWindow = vtkOpenGLRenderWindow::SafeDownCast(window);
+        vtkOpenGLExtensionManager *extensions =
+            openGLWindow ? openGLWindow->GetExtensionManager() : 0;
+        this->BufferObjectsSupported = (extensions &&
+            extensions->LoadSupportedExtension("GL_VERSION_1_3") &&
+            extensions->LoadSupportedExtension("GL_VERSION_1_5"));
+        this->VertexAttributesSupported =
+            (extensions && extensions->LoadSupportedExtension("GL_VERSION_2_0"));
+    }
+    if (!this->BufferObjectsSupported ||
+        actor->GetProperty()->GetRepresentation() != VTK_SURFACE)
+    {
+        return false;
+    }
+
+    vtkPolyData *input = this->GetInputAsPolyData();
+    if (input->GetCellData()->GetNormals())
+    {
+        return false;
+    }
+    if ((input->GetNumberOfPolys() > 0 || input->GetNumberOfStrips() > 0) &&
+        !input->GetPointData()->GetNormals())
+    {
+        return false;
+    }
+
+    vtkGenericVertexAttributeMapping *mappings = vtkGPUGetAttributeMappings(this->GetInformation());
+    unsigned int numberOfMappings = mappings ? mappings->GetNumberOfMappings() : 0;
+    for (unsigned int i = 0; i < numberOfMappings; ++i)
+    {
+        if (mappings->GetFieldAssociation(i) != vtkDataObject::FIELD_ASSOCIATION_POINTS ||
+            (mappings->GetTextureUnit(i) < 0 && !this->VertexAttributesSupported))
+        {
+            return false;
+        }
+    }
+
+    int cellFlag = 0;
+    if (this->GetVisibleScalars(input, cellFlag) && cellFlag != 0)
+    {
+        return false;
+    }
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+bool vtkGPUInterleavedVertexBufferPainter::CanMapScalarsToTexture(vtkDataArray *scalars, int colorMode)
+{
+    // Unsigned chars are colors already, unless told to map them
+    if (scalars->GetDataType() == VTK_UNSIGNED_CHAR && colorMode != VTK_COLOR_MODE_MAP_SCALARS)
+    {
+        return false;
+    }
+    // Vectors are mapped by magnitude or by component, on the CPU
+    return (scalars->GetNumberOfComponents() == 1);
+}
+
+//-----------------------------------------------------------------------------
+void vtkGPUInterleavedVertexBufferPainter::UpdateColors(vtkPolyData *input)
+{
+    int cellFlag = 0;
+    vtkDataArray *scalars = this->GetVisibleScalars(input, cellFlag);
+    this->TextureScalars = 0;
+    if (!scalars || this->MapScalarsToTexture)
+    {
+        // Mapped below, or through the texture from here on
+        if (this->Colors)
+        {
+            this->Colors->Delete();
+            this->Colors = 0;
+        }
+        this->MappedScalars = 0;
+        this->MappedLookupTable = 0;
+    }
+    if (!scalars)
+    {
+        return;
+    }
+
+    vtkInformation *info = this->GetInformation();
+    vtkScalarsToColors *lookupTable = vtkScalarsToColors::SafeDownCast(
+        info->Get(vtkScalarsToColorsPainter::LOOKUP_TABLE()));
+    if (!lookupTable)
+    {
+        if (!this->DefaultLookupTable)
+        {
+            this->DefaultLookupTable = vtkLookupTable::New();
+        }
+        lookupTable = this->DefaultLookupTable;
+    }
+    int colorMode = info->Get(vtkScalarsToColorsPainter::COLOR_MODE());
+    int component = info->Get(vtkScalarsToColorsPainter::ARRAY_COMPONENT());
+    if (!info->Get(vtkScalarsToColorsPainter::USE_LOOKUP_TABLE_SCALAR_RANGE()))
+    {
+        // Only modifies the table when the range changes
+        double *range = info->Get(vtkScalarsToColorsPainter::SCALAR_RANGE());
+        lookupTable->SetRange(range[0], range[1]);
+    }
+
+    if (this->MapScalarsToTexture && this->CanMapScalarsToTexture(scalars, colorMode))
+    {
+        // Only the table is sampled here, the scalars go as they are
+        if (this->ScalarTexture->Update(lookupTable))
+        {
+            this->ScalarTextureModified = true;
+        }
+        this->TextureScalars = scalars;
+        return;
+    }
+
+    if (this->Colors && scalars == this->MappedScalars &&
+        lookupTable == this->MappedLookupTable &&
+        colorMode == this->MappedColorMode && component == this->MappedComponent &&
+        scalars->GetMTime() < this->ColorsBuildTime &&
+        lookupTable->GetMTime() < this->ColorsBuildTime)
+    {
+        return;
+    }
+
+    lookupTable->Build();
+    vtkUnsignedCharArray *colors = lookupTable->MapScalars(scalars, colorMode, component);
+    if (this->Colors)
+    {
+        this->Colors->Delete();
+    }
+    this->Colors = colors;
+    this->MappedScalars = scalars;
+    this->MappedLookupTable = lookupTable;
+    this->MappedColorMode = colorMode;
+    this->MappedComponent = component;
+    this->ColorsBuildTime.Modified();
+}
+
+//-----------------------------------------------------------------------------
+void vtkGPUInterleavedVertexBufferPainter::UploadBuffers(int packResult)
+{
+    vtkGPUInterleavedVertexPacker *packer = this->Packer;
+    if (this->VertexBuffer == 0)
+    {
+        GLuint buffers[2];
+        vtkgl::GenBuffers(2, buffers);
+        this->VertexBuffer = buffers[0];
+        this->IndexBuffer = buffers[1];
+        packResult = vtkGPUInterleavedVertexPacker::Repacked;
+    }
+
+    vtkgl::GLsizeiptr vertexDataSize =
+        static_cast<vtkgl::GLsizeiptr>(packer->GetVertexDataSize());
+    if (packResult == vtkGPUInterleavedVertexPacker::Repacked ||
+        packer->GetVertexDataSize() != this->VertexBufferSize)
+    {
+        vtkgl::BindBuffer(vtkgl::ARRAY_BUFFER, this->VertexBuffer);
+        vtkgl::BufferData(vtkgl::ARRAY_BUFFER, vertexDataSize,
+            packer->GetVertexData(), vtkgl::DYNAMIC_DRAW);
+        vtkgl::BindBuffer(vtkgl::ELEMENT_ARRAY_BUFFER, this->IndexBuffer);
+        vtkgl::BufferData(vtkgl::ELEMENT_ARRAY_BUFFER,
+            static_cast<vtkgl::GLsizeiptr>(packer->GetIndexDataSize()),
+            packer->GetIndexData(), vtkgl::STATIC_DRAW);
+        this->VertexBufferSize = packer->GetVertexDataSize();
+        this->NumberOfBufferRebuilds++;
+    }
+    else if (packResult == vtkGPUInterleavedVertexPacker::VerticesUpdated)
+    {
+        // Orphans the old storage: the frames still drawing from it keep it
+        // while the new contents go to a fresh one, so nothing waits
+        vtkgl::BindBuffer(vtkgl::ARRAY_BUFFER, this->VertexBuffer);
+        vtkgl::BufferData(vtkgl::ARRAY_BUFFER, vertexDataSize, 0, vtkgl::DYNAMIC_DRAW);
+        vtkgl::BufferSubData(vtkgl::ARRAY_BUFFER, 0, vertexDataSize, packer->GetVertexData());
+        this->NumberOfBufferUpdates++;
+    }
+}
+
+//-----------------------------------------------------------------------------
+void vtkGPUInterleavedVertexBufferPainter::ReleaseAttributeBuffers(bool deleteBuffers)
+{
+    std::vector<vtkGPUInterleavedVertexBufferPainterInternals::Attribute> &attributes =
+        this->Internals->Attributes;
+    for (size_t i = 0; i < attributes.size(); ++i)
+    {
+        attributes[i].Release(deleteBuffers);
+    }
+    this->Internals->Scalars.Release(deleteBuffers);
+}
+
+//-----------------------------------------------------------------------------
+void vtkGPUInterleavedVertexBufferPainter::UpdateAttributes(vtkPolyData *input)
+{
+    std::vector<vtkGPUInterleavedVertexBufferPainterInternals::Attribute> &attributes =
+        this->Internals->Attributes;
+    vtkGenericVertexAttributeMapping *mappings = vtkGPUGetAttributeMappings(this->GetInformation());
+    if (mappings != this->LastMappings ||
+        (mappings && this->AttributesBuildTime < mappings->GetMTime()))
+    {
+        for (size_t i = 0; i < attributes.size(); ++i)
+        {
+            attributes[i].Release(true);
+        }
+        attributes.clear();
+        unsigned int numberOfMappings = mappings ? mappings->GetNumberOfMappings() : 0;
+        attributes.resize(numberOfMappings);
+        for (unsigned int i = 0; i < numberOfMappings; ++i)
+        {
+            const char *name = mappings->GetAttributeName(i);
+            attributes[i].Name = name ? name : "";
+            attributes[i].TextureUnit = mappings->GetTextureUnit(i);
+            attributes[i].ArrayName = mappings->GetArrayName(i);
+            attributes[i].Component = mappings->GetComponent(i);
+            attributes[i].Stream = vtkSmartPointer<vtkGPUVertexAttributeStream>::New();
+        }
+        this->LastMappings = mappings;
+        this->AttributesBuildTime.Modified();
+    }
+
+    int numberOfVertices = this->Packer->GetNumberOfVertices();
+    for (size_t i = 0; i < attributes.size(); ++i)
+    {
+        vtkDataArray *array = input->GetPointData()->GetArray(attributes[i].ArrayName.c_str());
+        if (attributes[i].Upload(array, numberOfVertices))
+        {
+            this->NumberOfAttributeUploads++;
+        }
+    }
+    if (this->Internals->Scalars.Upload(this->TextureScalars, numberOfVertices))
+    {
+        this->NumberOfAttributeUploads++;
+    }
+    vtkgl::BindBuffer(vtkgl::ARRAY_BUFFER, 0);
+
+    if (this->TextureScalars && (this->ScalarTextureId == 0 || this->ScalarTextureModified))
+    {
+        GLuint texture = this->ScalarTextureId;
+        if (texture == 0)
+        {
+            glGenTextures(1, &texture);
+            this->ScalarTextureId = texture;
+        }
+        glBindTexture(GL_TEXTURE_1D, texture);
+        glTexParameteri(GL_TEXTURE_1D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_1D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_1D, GL_TEXTURE_WRAP_S, vtkgl::CLAMP_TO_EDGE);
+        glTexImage1D(GL_TEXTURE_1D, 0, GL_RGBA, this->ScalarTexture->GetNumberOfSampledTexels(),
+            0, GL_RGBA, GL_UNSIGNED_BYTE, this->ScalarTexture->GetTexels());
+        glBindTexture(GL_TEXTURE_1D, 0);
+        this->ScalarTextureModified = false;
+    }
+}
+
+//-----------------------------------------------------------------------------
+void vtkGPUInterleavedVertexBufferPainter::DrawBuffers(vtkActor *actor, unsigned long typeflags)
+{
+    static const unsigned long primitiveFlags[vtkGPUInterleavedVertexPacker::NumberOfPrimitives] =
+    { vtkPainter::VERTS, vtkPainter::LINES, vtkPainter::POLYS, vtkPainter::STRIPS };
+    static const GLenum primitiveModes[vtkGPUInterleavedVertexPacker::NumberOfPrimitives] =
+    { GL_POINTS, GL_LINES, GL_TRIANGLES, GL_TRIANGLES };
+
+    vtkGPUInterleavedVertexPacker *packer = this->Packer;
+    GLsizei stride = static_cast<GLsizei>(packer->GetStride());
+
+    glPushAttrib(GL_ENABLE_BIT | GL_LIGHTING_BIT | GL_TEXTURE_BIT | GL_CURRENT_BIT | GL_TRANSFORM_BIT);
+    vtkgl::BindBuffer(vtkgl::ARRAY_BUFFER, this->VertexBuffer);
+    vtkgl::BindBuffer(vtkgl::ELEMENT_ARRAY_BUFFER, this->IndexBuffer);
+
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glVertexPointer(3, GL_FLOAT, stride, vtkGPUBufferOffset(0));
+    if (packer->GetNormalOffset() >= 0)
+    {
+        glEnableClientState(GL_NORMAL_ARRAY);
+        glNormalPointer(GL_FLOAT, stride, vtkGPUBufferOffset(packer->GetNormalOffset()));
+    }
+    else
+    {
+        // Only points and lines get here without normals, drawn unlit as
+        // the primitive painters do
+        glDisable(GL_LIGHTING);
+    }
+    if (packer->GetColorOffset() >= 0)
+    {
+        glEnableClientState(GL_COLOR_ARRAY);
+        glColorPointer(4, GL_UNSIGNED_BYTE, stride, vtkGPUBufferOffset(packer->GetColorOffset()));
+        glColorMaterial(GL_FRONT_AND_BACK, GL_AMBIENT_AND_DIFFUSE);
+        glEnable(GL_COLOR_MATERIAL);
+    }
+
+    // Scalars as texture coordinates: the texture matrix maps the range to
+    // [0, 1] and the texture gives the color, lit as a white material
+    vtkGPUInterleavedVertexBufferPainterInternals::Attribute &scalars = this->Internals->Scalars;
+    bool scalarsOnGPU = (this->TextureScalars && scalars.Active);
+    if (scalarsOnGPU)
+    {
+        vtkgl::ActiveTexture(vtkgl::TEXTURE0);
+        glEnable(GL_TEXTURE_1D);
+        glBindTexture(GL_TEXTURE_1D, this->ScalarTextureId);
+        glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
+        glMatrixMode(GL_TEXTURE);
+        glPushMatrix();
+        glLoadIdentity();
+        glTranslated(this->ScalarTexture->GetTextureCoordinateShift(), 0.0, 0.0);
+        glScaled(this->ScalarTexture->GetTextureCoordinateScale(), 1.0, 1.0);
+        glColorMaterial(GL_FRONT_AND_BACK, GL_AMBIENT_AND_DIFFUSE);
+        glEnable(GL_COLOR_MATERIAL);
+        glColor4d(1.0, 1.0, 1.0, actor->GetProperty()->GetOpacity());
+        scalars.Bind(0);
+    }
+
+    // Generic attributes go to the program the property bound, by name
+    std::vector<vtkGPUInterleavedVertexBufferPainterInternals::Attribute> &attributes =
+        this->Internals->Attributes;
+    GLint program = 0;
+    if (this->VertexAttributesSupported && !attributes.empty())
+    {
+        glGetIntegerv(vtkgl::CURRENT_PROGRAM, &program);
+    }
+    for (size_t i = 0; i < attributes.size(); ++i)
+    {
+        attributes[i].Bind(program);
+    }
+
+    for (int primitive = 0; primitive < vtkGPUInterleavedVertexPacker::NumberOfPrimitives; ++primitive)
+    {
+        size_t numberOfIndices = packer->GetNumberOfIndices(primitive);
+        if ((typeflags & primitiveFlags[primitive]) && numberOfIndices > 0)
+        {
+            glDrawElements(primitiveModes[primitive], static_cast<GLsizei>(numberOfIndices),
+                GL_UNSIGNED_INT, vtkGPUBufferOffset(packer->GetIndexOffset(primitive) * sizeof(unsigned int)));
+        }
+    }
+
+    for (size_t i = 0; i < attributes.size(); ++i)
+    {
+        attributes[i].Unbind();
+    }
+    if (scalarsOnGPU)
+    {
+        scalars.Unbind();
+        glMatrixMode(GL_TEXTURE);
+        glPopMatrix();
+        glBindTexture(GL_TEXTURE_1D, 0);
+    }
+    glDisableClientState(GL_COLOR_ARRAY);
+    glDisableClientState(GL_NORMAL_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
+    vtkgl::BindBuffer(vtkgl::ELEMENT_ARRAY_BUFFER, 0);
+    vtkgl::BindBuffer(vtkgl::ARRAY_BUFFER, 0);
+    glPopAttrib();
+}
+
+//-----------------------------------------------------------------------------
+void vtkGPUInterleavedVertexBufferPainter::RenderInternal(vtkRenderer *renderer,
+    vtkActor *actor, unsigned long typeflags, bool forceCompileOnly)
+{
+    vtkPolyData *input = this->GetInputAsPolyData();
+    if (forceCompileOnly || !input || !this->CanDraw(renderer, actor))
+    {
+        this->Superclass::RenderInternal(renderer, actor, typeflags, forceCompileOnly);
+        return;
+    }
+
+    this->Timer->StartTimer();
+    vtkInformation *info = this->GetInformation();
+    this->Packer->SetStaticGeometry(info->Has(STATIC_GEOMETRY()) ? info->Get(STATIC_GEOMETRY()) : 0);
+    this->UpdateColors(input);
+    int packResult = this->Packer->Pack(input, this->Colors);
+    if (this->Packer->GetNumberOfVertices() > 0)
+    {
+        this->UploadBuffers(packResult);
+        this->UpdateAttributes(input);
+        this->DrawBuffers(actor, typeflags);
+    }
+    this->Timer->StopTimer();
+    this->TimeToDraw += this->Timer->GetElapsedTime();
+}
+
+//-----------------------------------------------------------------------------
+void vtkGPUInterleavedVertexBufferPainter::PrintSelf(ostream& os, vtkIndent indent)
+{
+    this->Superclass::PrintSelf(os, indent);
+
+    os << indent << "MapScalarsToTexture: " << this->MapScalarsToTexture << endl;
+    os << indent << "BufferObjectsSupported: " << this->BufferObjectsSupported << endl;
+    os << indent << "VertexBufferSize: " << this->VertexBufferSize << endl;
+    os << indent << "NumberOfBufferRebuilds: " << this->NumberOfBufferRebuilds << endl;
+    os << indent << "NumberOfBufferUpdates: " << this->NumberOfBufferUpdates << endl;
+    os << indent << "VertexAttributesSupported: " << this->VertexAttributesSupported << endl;
+    os << indent << "NumberOfAttributes: " << this->Internals->Attributes.size() << endl;
+    os << indent << "NumberOfAttributeUploads: " << this->NumberOfAttributeUploads << endl;
+    os << indent << "Packer: " << endl;
+    this->Packer->PrintSelf(os, indent.GetNextIndent());
+    os << indent << "ScalarTexture: " << endl;
+    this->ScalarTexture->PrintSelf(os, indent.GetNextIndent());
+}
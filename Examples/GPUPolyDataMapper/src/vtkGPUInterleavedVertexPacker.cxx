@@ -0,0 +1,360 @@
+/*==============================================================================
+
+  Library: MSVTK
+
+  Copyright (c) Computational Image and Simulation Technologies in Biomedicine (CISTIB),
+                Universitat Pompeu Fabra (UPF), Barcelona, Spain
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+#include "vtkGPUInterleavedVertexPacker.h"
+
+#include "vtkCellArray.h"
+#include "vtkDataArray.h"
+#include "vtkIdTypeArray.h"
+#include "vtkObjectFactory.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkUnsignedCharArray.h"
+
+#include <string.h>
+
+vtkStandardNewMacro(vtkGPUInterleavedVertexPacker);
+
+//-----------------------------------------------------------------------------
+// Writes the first three components of each tuple as floats, one vertex
+// after the other.
+template <class T>
+void vtkGPUInterleavedVertexPackerPackFloats(const T *source, int numberOfComponents,
+                                             int numberOfTuples, unsigned char *destination, int stride)
+{
+    for (int i = 0; i < numberOfTuples; ++i)
+    {
+        float *vertex = reinterpret_cast<float *>(destination);
+        vertex[0] = static_cast<float>(source[0]);
+        vertex[1] = static_cast<float>(source[1]);
+        vertex[2] = static_cast<float>(source[2]);
+        source += numberOfComponents;
+        destination += stride;
+    }
+}
+
+// Floats only need to be copied
+template <>
+void vtkGPUInterleavedVertexPackerPackFloats(const float *source, int numberOfComponents,
+                                             int numberOfTuples, unsigned char *destination, int stride)
+{
+    for (int i = 0; i < numberOfTuples; ++i)
+    {
+        memcpy(destination, source, 3 * sizeof(float));
+        source += numberOfComponents;
+        destination += stride;
+    }
+}
+
+//-----------------------------------------------------------------------------
+bool vtkGPUInterleavedVertexPacker::PackedArray::Changed(vtkDataArray *array, unsigned long mtime) const
+{
+    return (this->Array.GetPointer() != array || this->MTime != mtime);
+}
+
+//-----------------------------------------------------------------------------
+void vtkGPUInterleavedVertexPacker::PackedArray::Set(vtkDataArray *array, unsigned long mtime)
+{
+    this->Array = array;
+    this->MTime = mtime;
+}
+
+//-----------------------------------------------------------------------------
+bool vtkGPUInterleavedVertexPacker::PackedCells::Update(vtkCellArray *cells)
+{
+    if (cells && this->Cells.GetPointer() == cells && this->MTime == cells->GetMTime())
+    {
+        return false;
+    }
+    this->Cells = cells;
+    this->MTime = cells ? cells->GetMTime() : 0;
+
+    // Another array, or the same one modified: compare what it holds
+    vtkIdType size = cells ? cells->GetNumberOfConnectivityEntries() : 0;
+    if (static_cast<size_t>(size) == this->Connectivity.size() && (size == 0 ||
+        memcmp(cells->GetPointer(), &this->Connectivity[0], size * sizeof(vtkIdType)) == 0))
+    {
+        return false;
+    }
+    if (size == 0)
+    {
+        this->Connectivity.clear();
+        return true;
+    }
+    this->Connectivity.assign(cells->GetPointer(), cells->GetPointer() + size);
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+vtkGPUInterleavedVertexPacker::vtkGPUInterleavedVertexPacker()
+{
+    this->StaticGeometry = 0;
+    this->Reset();
+}
+
+//-----------------------------------------------------------------------------
+vtkGPUInterleavedVertexPacker::~vtkGPUInterleavedVertexPacker()
+{
+}
+
+//-----------------------------------------------------------------------------
+void vtkGPUInterleavedVertexPacker::Reset()
+{
+    this->VertexData.clear();
+    this->Indices.clear();
+    for (int primitive = 0; primitive < NumberOfPrimitives; ++primitive)
+    {
+        this->IndexOffsets[primitive] = 0;
+        this->IndexCounts[primitive] = 0;
+    }
+    this->Stride = 0;
+    this->NormalOffset = -1;
+    this->ColorOffset = -1;
+    this->NumberOfVertices = 0;
+    this->PackedPoints = PackedArray();
+    this->PackedNormals = PackedArray();
+    this->PackedColors = PackedArray();
+    for (int primitive = 0; primitive < NumberOfPrimitives; ++primitive)
+    {
+        this->PackedTopology[primitive] = PackedCells();
+    }
+}
+
+//-----------------------------------------------------------------------------
+int vtkGPUInterleavedVertexPacker::Pack(vtkPolyData *input, vtkUnsignedCharArray *colors)
+{
+    vtkDataArray *points = (input && input->GetPoints()) ? input->GetPoints()->GetData() : 0;
+    if (!points || points->GetNumberOfTuples() == 0)
+    {
+        this->Reset();
+        return Repacked;
+    }
+
+    int numberOfVertices = static_cast<int>(points->GetNumberOfTuples());
+    vtkDataArray *normals = input->GetPointData()->GetNormals();
+    if (normals && (normals->GetNumberOfTuples() != numberOfVertices || normals->GetNumberOfComponents() != 3))
+    {
+        normals = 0;
+    }
+    if (colors && colors->GetNumberOfTuples() != numberOfVertices)
+    {
+        colors = 0;
+    }
+
+    int normalOffset = normals ? 3 * static_cast<int>(sizeof(float)) : -1;
+    int colorOffset = colors ? (normals ? 6 : 3) * static_cast<int>(sizeof(float)) : -1;
+    int stride = 3 * static_cast<int>(sizeof(float)) + (normals ? 3 * static_cast<int>(sizeof(float)) : 0) + (colors ? 4 : 0);
+
+    bool layoutChanged = (numberOfVertices != this->NumberOfVertices ||
+        normalOffset != this->NormalOffset || colorOffset != this->ColorOffset);
+    bool geometryKept = (this->StaticGeometry && !layoutChanged && !this->VertexData.empty());
+    bool topologyChanged = !geometryKept && this->UpdateTopology(input);
+    if (topologyChanged)
+    {
+        this->BuildIndices(input);
+    }
+
+    if (layoutChanged)
+    {
+        this->NumberOfVertices = numberOfVertices;
+        this->Stride = stride;
+        this->NormalOffset = normalOffset;
+        this->ColorOffset = colorOffset;
+        this->VertexData.resize(static_cast<size_t>(numberOfVertices) * stride);
+    }
+
+    bool vertexUpdated = false;
+    // Points are usually modified through vtkPoints, not through its array
+    unsigned long pointsMTime = input->GetPoints()->GetMTime();
+    pointsMTime = (points->GetMTime() > pointsMTime) ? points->GetMTime() : pointsMTime;
+    if (!geometryKept && (layoutChanged || this->PackedPoints.Changed(points, pointsMTime)))
+    {
+        this->PackPositions(points);
+        this->PackedPoints.Set(points, pointsMTime);
+        vertexUpdated = true;
+    }
+    if (normals && !geometryKept &&
+        (layoutChanged || this->PackedNormals.Changed(normals, normals->GetMTime())))
+    {
+        this->PackNormals(normals);
+        this->PackedNormals.Set(normals, normals->GetMTime());
+        vertexUpdated = true;
+    }
+    if (colors && (layoutChanged || this->PackedColors.Changed(colors, colors->GetMTime())))
+    {
+        this->PackColors(colors);
+        this->PackedColors.Set(colors, colors->GetMTime());
+        vertexUpdated = true;
+    }
+
+    if (layoutChanged || topologyChanged)
+    {
+        return Repacked;
+    }
+    return vertexUpdated ? VerticesUpdated : Unchanged;
+}
+
+//-----------------------------------------------------------------------------
+bool vtkGPUInterleavedVertexPacker::UpdateTopology(vtkPolyData *input)
+{
+    // All of them, so each one remembers its new array
+    bool changed = this->PackedTopology[Points].Update(input->GetVerts());
+    changed = this->PackedTopology[Lines].Update(input->GetLines()) || changed;
+    changed = this->PackedTopology[PolygonTriangles].Update(input->GetPolys()) || changed;
+    changed = this->PackedTopology[StripTriangles].Update(input->GetStrips()) || changed;
+    return changed;
+}
+
+//-----------------------------------------------------------------------------
+void vtkGPUInterleavedVertexPacker::BuildIndices(vtkPolyData *input)
+{
+    vtkCellArray *cellArrays[NumberOfPrimitives] =
+    { input->GetVerts(), input->GetLines(), input->GetPolys(), input->GetStrips() };
+
+    this->Indices.clear();
+    vtkIdType npts = 0;
+    vtkIdType *pts = 0;
+    for (int primitive = 0; primitive < NumberOfPrimitives; ++primitive)
+    {
+        vtkCellArray *cells = cellArrays[primitive];
+        this->IndexOffsets[primitive] = this->Indices.size();
+        if (!cells)
+        {
+            this->IndexCounts[primitive] = 0;
+            continue;
+        }
+
+        for (cells->InitTraversal(); cells->GetNextCell(npts, pts); )
+        {
+            switch (primitive)
+            {
+            case Points:
+                for (vtkIdType j = 0; j < npts; ++j)
+                {
+                    this->Indices.push_back(static_cast<unsigned int>(pts[j]));
+                }
+                break;
+            case Lines:
+                // Polylines as segments
+                for (vtkIdType j = 1; j < npts; ++j)
+                {
+                    this->Indices.push_back(static_cast<unsigned int>(pts[j - 1]));
+                    this->Indices.push_back(static_cast<unsigned int>(pts[j]));
+                }
+                break;
+            case PolygonTriangles:
+                // Convex polygons as fans
+                for (vtkIdType j = 2; j < npts; ++j)
+                {
+                    this->Indices.push_back(static_cast<unsigned int>(pts[0]));
+                    this->Indices.push_back(static_cast<unsigned int>(pts[j - 1]));
+                    this->Indices.push_back(static_cast<unsigned int>(pts[j]));
+                }
+                break;
+            case StripTriangles:
+                // Every other triangle is flipped to keep the orientation
+                for (vtkIdType j = 2; j < npts; ++j)
+                {
+                    bool odd = ((j & 1) == 1);
+                    this->Indices.push_back(static_cast<unsigned int>(pts[odd ? j - 1 : j - 2]));
+                    this->Indices.push_back(static_cast<unsigned int>(pts[odd ? j - 2 : j - 1]));
+                    this->Indices.push_back(static_cast<unsigned int>(pts[j]));
+                }
+                break;
+            }
+        }
+        this->IndexCounts[primitive] = this->Indices.size() - this->IndexOffsets[primitive];
+    }
+}
+
+//-----------------------------------------------------------------------------
+void vtkGPUInterleavedVertexPacker::PackPositions(vtkDataArray *points)
+{
+    int numberOfComponents = points->GetNumberOfComponents();
+    unsigned char *destination = &this->VertexData[0];
+    switch (points->GetDataType())
+    {
+        vtkTemplateMacro(
+            vtkGPUInterleavedVertexPackerPackFloats(
+                static_cast<VTK_TT *>(points->GetVoidPointer(0)), numberOfComponents,
+                this->NumberOfVertices, destination, this->Stride));
+    }
+}
+
+//-----------------------------------------------------------------------------
+void vtkGPUInterleavedVertexPacker::PackNormals(vtkDataArray *normals)
+{
+    unsigned char *destination = &this->VertexData[this->NormalOffset];
+    switch (normals->GetDataType())
+    {
+        vtkTemplateMacro(
+            vtkGPUInterleavedVertexPackerPackFloats(
+                static_cast<VTK_TT *>(normals->GetVoidPointer(0)), 3,
+                this->NumberOfVertices, destination, this->Stride));
+    }
+}
+
+//-----------------------------------------------------------------------------
+void vtkGPUInterleavedVertexPacker::PackColors(vtkUnsignedCharArray *colors)
+{
+    // Luminance, luminance-alpha, RGB or RGBA, as vtkScalarsToColors gives them
+    int numberOfComponents = colors->GetNumberOfComponents();
+    const unsigned char *source = colors->GetPointer(0);
+    unsigned char *destination = &this->VertexData[this->ColorOffset];
+    for (int i = 0; i < this->NumberOfVertices; ++i)
+    {
+        switch (numberOfComponents)
+        {
+        case 1:
+            destination[0] = destination[1] = destination[2] = source[0];
+            destination[3] = 255;
+            break;
+        case 2:
+            destination[0] = destination[1] = destination[2] = source[0];
+            destination[3] = source[1];
+            break;
+        case 3:
+            destination[0] = source[0];
+            destination[1] = source[1];
+            destination[2] = source[2];
+            destination[3] = 255;
+            break;
+        default:
+            memcpy(destination, source, 4);
+            break;
+        }
+        source += numberOfComponents;
+        destination += this->Stride;
+    }
+}
+
+//-----------------------------------------------------------------------------
+void vtkGPUInterleavedVertexPacker::PrintSelf(ostream& os, vtkIndent indent)
+{
+    this->Superclass::PrintSelf(os, indent);
+
+    os << indent << "NumberOfVertices: " << this->NumberOfVertices << endl;
+    os << indent << "Stride: " << this->Stride << endl;
+    os << indent << "NormalOffset: " << this->NormalOffset << endl;
+    os << indent << "ColorOffset: " << this->ColorOffset << endl;
+    os << indent << "NumberOfIndices: " << this->Indices.size() << endl;
+    os << indent << "StaticGeometry: " << this->StaticGeometry << endl;
+}
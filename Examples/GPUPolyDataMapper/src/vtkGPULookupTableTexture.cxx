@@ -0,0 +1,104 @@
+/*==============================================================================
+
+  Library: MSVTK
+
+  Copyright (c) Computational Image and Simulation Technologies in Biomedicine (CISTIB),
+                Universitat Pompeu Fabra (UPF), Barcelona, Spain
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+#include "vtkGPULookupTableTexture.h"
+
+#include "vtkObjectFactory.h"
+#include "vtkScalarsToColors.h"
+
+#include <string.h>
+
+vtkStandardNewMacro(vtkGPULookupTableTexture);
+
+//-----------------------------------------------------------------------------
+vtkGPULookupTableTexture::vtkGPULookupTableTexture()
+{
+    this->NumberOfTexels = 256;
+    this->Reset();
+}
+
+//-----------------------------------------------------------------------------
+vtkGPULookupTableTexture::~vtkGPULookupTableTexture()
+{
+}
+
+//-----------------------------------------------------------------------------
+void vtkGPULookupTableTexture::Reset()
+{
+    this->Texels.clear();
+    this->LookupTable = 0;
+    this->LookupTableMTime = 0;
+    this->Scale = 0.0;
+    this->Shift = 0.5;
+}
+
+//-----------------------------------------------------------------------------
+bool vtkGPULookupTableTexture::Update(vtkScalarsToColors *lookupTable)
+{
+    if (!lookupTable)
+    {
+        this->Reset();
+        return false;
+    }
+    lookupTable->Build();
+    if (this->LookupTable.GetPointer() == lookupTable &&
+        this->LookupTableMTime == lookupTable->GetMTime() &&
+        this->GetNumberOfSampledTexels() == this->NumberOfTexels)
+    {
+        return false;
+    }
+
+    double *range = lookupTable->GetRange();
+    double width = range[1] - range[0];
+    if (width > 0.0)
+    {
+        this->Scale = 1.0 / width;
+        this->Shift = -range[0] / width;
+    }
+    else
+    {
+        // Every scalar gets the one color
+        this->Scale = 0.0;
+        this->Shift = 0.5;
+        width = 0.0;
+    }
+
+    // At the texel centres, where the texture gives the sample unfiltered
+    this->Texels.resize(4 * static_cast<size_t>(this->NumberOfTexels));
+    for (int i = 0; i < this->NumberOfTexels; ++i)
+    {
+        double scalar = range[0] + width * (i + 0.5) / this->NumberOfTexels;
+        memcpy(&this->Texels[4 * i], lookupTable->MapValue(scalar), 4);
+    }
+
+    this->LookupTable = lookupTable;
+    this->LookupTableMTime = lookupTable->GetMTime();
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+void vtkGPULookupTableTexture::PrintSelf(ostream& os, vtkIndent indent)
+{
+    this->Superclass::PrintSelf(os, indent);
+
+    os << indent << "NumberOfTexels: " << this->NumberOfTexels << endl;
+    os << indent << "TextureCoordinateScale: " << this->Scale << endl;
+    os << indent << "TextureCoordinateShift: " << this->Shift << endl;
+}
@@ -29,6 +29,7 @@
 #include "vtkDisplayListPainter.h"
 #include "vtkGarbageCollector.h"
 #include "vtkGenericVertexAttributeMapping.h"
+#include "vtkGPUInterleavedVertexBufferPainter.h"
 #include "vtkHardwareSelectionPolyDataPainter.h"
 #include "vtkInformation.h"
 #include "vtkInformationObjectBaseKey.h"
@@ -73,6 +74,7 @@ public:
 vtkPainterGPUPolyDataMapper::vtkPainterGPUPolyDataMapper()
 {
     this->Painter = 0;
+    this->TimeVaryingAttributes = 0;
 
     this->PainterInformation = vtkInformation::New();
 
@@ -281,6 +283,9 @@ void vtkPainterGPUPolyDataMapper::UpdatePainterInformation()
     int immr = (this->ImmediateModeRendering || 
         vtkMapper::GetGlobalImmediateModeRendering());
     info->Set(vtkDisplayListPainter::IMMEDIATE_MODE_RENDERING(), immr);
+
+    info->Set(vtkGPUInterleavedVertexBufferPainter::STATIC_GEOMETRY(),
+        this->TimeVaryingAttributes);
 }
 
 //-----------------------------------------------------------------------------
@@ -413,5 +418,6 @@ void vtkPainterGPUPolyDataMapper::PrintSelf(ostream& os, vtkIndent indent)
         os << indent << "(none)" << endl;
     }
     os << indent << "SelectionPainter: " << this->SelectionPainter << endl;
+    os << indent << "TimeVaryingAttributes: " << this->TimeVaryingAttributes << endl;
 }
 
@@ -0,0 +1,129 @@
+/*==============================================================================
+
+  Library: MSVTK
+
+  Copyright (c) Computational Image and Simulation Technologies in Biomedicine (CISTIB),
+                Universitat Pompeu Fabra (UPF), Barcelona, Spain
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+#include "vtkGPUVertexAttributeStream.h"
+
+#include "vtkDataArray.h"
+#include "vtkObjectFactory.h"
+
+vtkStandardNewMacro(vtkGPUVertexAttributeStream);
+
+//-----------------------------------------------------------------------------
+// Copies numberOfComponents components of each tuple, starting at
+// firstComponent, as floats.
+template <class T>
+void vtkGPUVertexAttributeStreamStage(const T *source, int sourceComponents, int firstComponent,
+                                      int numberOfComponents, int numberOfTuples, float *destination)
+{
+    source += firstComponent;
+    for (int i = 0; i < numberOfTuples; ++i)
+    {
+        for (int j = 0; j < numberOfComponents; ++j)
+        {
+            *destination++ = static_cast<float>(source[j]);
+        }
+        source += sourceComponents;
+    }
+}
+
+//-----------------------------------------------------------------------------
+vtkGPUVertexAttributeStream::vtkGPUVertexAttributeStream()
+{
+    this->NumberOfUpdates = 0;
+    this->Reset();
+}
+
+//-----------------------------------------------------------------------------
+vtkGPUVertexAttributeStream::~vtkGPUVertexAttributeStream()
+{
+}
+
+//-----------------------------------------------------------------------------
+void vtkGPUVertexAttributeStream::Reset()
+{
+    this->Staging.clear();
+    this->Array = 0;
+    this->MTime = 0;
+    this->Component = -1;
+    this->StagedData = 0;
+    this->NumberOfComponents = 0;
+    this->NumberOfTuples = 0;
+    this->CurrentSlot = -1;
+}
+
+//-----------------------------------------------------------------------------
+int vtkGPUVertexAttributeStream::Stage(vtkDataArray *array, int component)
+{
+    if (!array)
+    {
+        this->Reset();
+        return -1;
+    }
+    if (this->CurrentSlot >= 0 && this->Array.GetPointer() == array &&
+        this->MTime == array->GetMTime() && this->Component == component)
+    {
+        return -1;
+    }
+
+    // A component the array does not have stands for all of them
+    int sourceComponents = array->GetNumberOfComponents();
+    bool allComponents = (component < 0 || component >= sourceComponents);
+    int firstComponent = allComponents ? 0 : component;
+    this->NumberOfComponents = allComponents ? sourceComponents : 1;
+    this->NumberOfTuples = static_cast<int>(array->GetNumberOfTuples());
+
+    if (array->GetDataType() == VTK_FLOAT && this->NumberOfComponents == sourceComponents)
+    {
+        // Already what the buffer holds
+        this->Staging.clear();
+        this->StagedData = static_cast<float *>(array->GetVoidPointer(0));
+    }
+    else
+    {
+        this->Staging.resize(static_cast<size_t>(this->NumberOfTuples) * this->NumberOfComponents);
+        float *destination = this->Staging.empty() ? 0 : &this->Staging[0];
+        switch (array->GetDataType())
+        {
+            vtkTemplateMacro(
+                vtkGPUVertexAttributeStreamStage(
+                    static_cast<VTK_TT *>(array->GetVoidPointer(0)), sourceComponents,
+                    firstComponent, this->NumberOfComponents, this->NumberOfTuples, destination));
+        }
+        this->StagedData = destination;
+    }
+
+    this->Array = array;
+    this->MTime = array->GetMTime();
+    this->Component = component;
+    this->CurrentSlot = (this->CurrentSlot == 0) ? 1 : 0;
+    this->NumberOfUpdates++;
+    return this->CurrentSlot;
+}
+
+//-----------------------------------------------------------------------------
+void vtkGPUVertexAttributeStream::PrintSelf(ostream& os, vtkIndent indent)
+{
+    this->Superclass::PrintSelf(os, indent);
+
+    os << indent << "NumberOfComponents: " << this->NumberOfComponents << endl;
+    os << indent << "NumberOfTuples: " << this->NumberOfTuples << endl;
+    os << indent << "CurrentSlot: " << this->CurrentSlot << endl;
+    os << indent << "NumberOfUpdates: " << this->NumberOfUpdates << endl;
+}
@@ -0,0 +1,345 @@
+/*==============================================================================
+
+  Library: MSVTK
+
+  Copyright (c) Computational Image and Simulation Technologies in Biomedicine (CISTIB),
+                Universitat Pompeu Fabra (UPF), Barcelona, Spain
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#include <gtest/gtest.h>
+
+#include <vtkSmartPointer.h>
+#include <vtkCellArray.h>
+#include <vtkFloatArray.h>
+#include <vtkDoubleArray.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkUnsignedCharArray.h>
+#include <vtkTimerLog.h>
+#include "vtkGPUInterleavedVertexPacker.h"
+
+#include <string.h>
+#include <iostream>
+
+const int BenchmarkGridSize = 512;
+const int BenchmarkPacks = 20;
+
+// A size x size grid of quads in the z = 0 plane, with point normals
+vtkSmartPointer<vtkPolyData> CreateGrid( int size )
+{
+    vtkSmartPointer<vtkPoints> pointsSP = vtkSmartPointer<vtkPoints>::New();
+    vtkSmartPointer<vtkFloatArray> normalsSP = vtkSmartPointer<vtkFloatArray>::New();
+    normalsSP->SetNumberOfComponents( 3 );
+    for( int j = 0; j <= size; j++ )
+    {
+        for( int i = 0; i <= size; i++ )
+        {
+            pointsSP->InsertNextPoint( i, j, 0.0 );
+            normalsSP->InsertNextTuple3( 0.0, 0.0, 1.0 );
+        }
+    }
+
+    vtkSmartPointer<vtkCellArray> polysSP = vtkSmartPointer<vtkCellArray>::New();
+    for( int j = 0; j < size; j++ )
+    {
+        for( int i = 0; i < size; i++ )
+        {
+            vtkIdType quad[4] = { j * ( size + 1 ) + i, j * ( size + 1 ) + i + 1,
+                                  ( j + 1 ) * ( size + 1 ) + i + 1, ( j + 1 ) * ( size + 1 ) + i };
+            polysSP->InsertNextCell( 4, quad );
+        }
+    }
+
+    vtkSmartPointer<vtkPolyData> gridSP = vtkSmartPointer<vtkPolyData>::New();
+    gridSP->SetPoints( pointsSP );
+    gridSP->SetPolys( polysSP );
+    gridSP->GetPointData()->SetNormals( normalsSP );
+    return gridSP;
+}
+
+vtkSmartPointer<vtkUnsignedCharArray> CreateColors( int numberOfComponents, int numberOfTuples )
+{
+    vtkSmartPointer<vtkUnsignedCharArray> colorsSP = vtkSmartPointer<vtkUnsignedCharArray>::New();
+    colorsSP->SetNumberOfComponents( numberOfComponents );
+    colorsSP->SetNumberOfTuples( numberOfTuples );
+    for( int i = 0; i < numberOfComponents * numberOfTuples; i++ )
+    {
+        colorsSP->SetValue( i, static_cast<unsigned char>( 10 + i ) );
+    }
+    return colorsSP;
+}
+
+const float* GetVertex( vtkGPUInterleavedVertexPacker* packer, int vertex )
+{
+    return reinterpret_cast<const float*>( packer->GetVertexData() + vertex * packer->GetStride() );
+}
+
+const unsigned char* GetColor( vtkGPUInterleavedVertexPacker* packer, int vertex )
+{
+    return packer->GetVertexData() + vertex * packer->GetStride() + packer->GetColorOffset();
+}
+
+TEST( TestInterleavedVertexPacker, Layout )
+{
+    vtkSmartPointer<vtkPolyData> gridSP = CreateGrid( 1 );
+    vtkSmartPointer<vtkGPUInterleavedVertexPacker> packerSP = vtkSmartPointer<vtkGPUInterleavedVertexPacker>::New();
+
+    EXPECT_EQ( vtkGPUInterleavedVertexPacker::Repacked, packerSP->Pack( gridSP, 0 ) );
+    EXPECT_EQ( 4, packerSP->GetNumberOfVertices() );
+    EXPECT_EQ( 24, packerSP->GetStride() );
+    EXPECT_EQ( 12, packerSP->GetNormalOffset() );
+    EXPECT_EQ( -1, packerSP->GetColorOffset() );
+    EXPECT_EQ( 4u * 24u, packerSP->GetVertexDataSize() );
+
+    vtkSmartPointer<vtkUnsignedCharArray> colorsSP = CreateColors( 4, 4 );
+    EXPECT_EQ( vtkGPUInterleavedVertexPacker::Repacked, packerSP->Pack( gridSP, colorsSP ) );
+    EXPECT_EQ( 28, packerSP->GetStride() );
+    EXPECT_EQ( 24, packerSP->GetColorOffset() );
+
+    // Last vertex: position ( 1, 1, 0 ), normal ( 0, 0, 1 ), color 22..25
+    const float* vertex = GetVertex( packerSP, 3 );
+    EXPECT_FLOAT_EQ( 1.0f, vertex[0] );
+    EXPECT_FLOAT_EQ( 1.0f, vertex[1] );
+    EXPECT_FLOAT_EQ( 0.0f, vertex[2] );
+    EXPECT_FLOAT_EQ( 0.0f, vertex[3] );
+    EXPECT_FLOAT_EQ( 0.0f, vertex[4] );
+    EXPECT_FLOAT_EQ( 1.0f, vertex[5] );
+    const unsigned char* color = GetColor( packerSP, 3 );
+    EXPECT_EQ( 22, color[0] );
+    EXPECT_EQ( 25, color[3] );
+
+    gridSP->GetPointData()->SetNormals( 0 );
+    EXPECT_EQ( vtkGPUInterleavedVertexPacker::Repacked, packerSP->Pack( gridSP, colorsSP ) );
+    EXPECT_EQ( 16, packerSP->GetStride() );
+    EXPECT_EQ( -1, packerSP->GetNormalOffset() );
+    EXPECT_EQ( 12, packerSP->GetColorOffset() );
+}
+
+TEST( TestInterleavedVertexPacker, Indices )
+{
+    vtkSmartPointer<vtkPoints> pointsSP = vtkSmartPointer<vtkPoints>::New();
+    for( int i = 0; i < 6; i++ )
+    {
+        pointsSP->InsertNextPoint( i, i % 2, 0.0 );
+    }
+    vtkIdType vertex[1] = { 5 };
+    vtkIdType polyline[3] = { 0, 1, 2 };
+    vtkIdType pentagon[5] = { 0, 1, 2, 3, 4 };
+    vtkIdType strip[5] = { 1, 2, 3, 4, 5 };
+    vtkSmartPointer<vtkCellArray> vertsSP = vtkSmartPointer<vtkCellArray>::New();
+    vertsSP->InsertNextCell( 1, vertex );
+    vtkSmartPointer<vtkCellArray> linesSP = vtkSmartPointer<vtkCellArray>::New();
+    linesSP->InsertNextCell( 3, polyline );
+    vtkSmartPointer<vtkCellArray> polysSP = vtkSmartPointer<vtkCellArray>::New();
+    polysSP->InsertNextCell( 5, pentagon );
+    vtkSmartPointer<vtkCellArray> stripsSP = vtkSmartPointer<vtkCellArray>::New();
+    stripsSP->InsertNextCell( 5, strip );
+
+    vtkSmartPointer<vtkPolyData> polyDataSP = vtkSmartPointer<vtkPolyData>::New();
+    polyDataSP->SetPoints( pointsSP );
+    polyDataSP->SetVerts( vertsSP );
+    polyDataSP->SetLines( linesSP );
+    polyDataSP->SetPolys( polysSP );
+    polyDataSP->SetStrips( stripsSP );
+
+    vtkSmartPointer<vtkGPUInterleavedVertexPacker> packerSP = vtkSmartPointer<vtkGPUInterleavedVertexPacker>::New();
+    EXPECT_EQ( vtkGPUInterleavedVertexPacker::Repacked, packerSP->Pack( polyDataSP, 0 ) );
+
+    const unsigned int expected[] =
+    {
+        5,                                  // vertex
+        0, 1, 1, 2,                         // polyline as segments
+        0, 1, 2, 0, 2, 3, 0, 3, 4,          // pentagon as a fan
+        1, 2, 3, 3, 2, 4, 3, 4, 5           // strip, every other one flipped
+    };
+    const size_t counts[vtkGPUInterleavedVertexPacker::NumberOfPrimitives] = { 1, 4, 9, 9 };
+    size_t offset = 0;
+    for( int primitive = 0; primitive < vtkGPUInterleavedVertexPacker::NumberOfPrimitives; primitive++ )
+    {
+        EXPECT_EQ( offset, packerSP->GetIndexOffset( primitive ) );
+        EXPECT_EQ( counts[primitive], packerSP->GetNumberOfIndices( primitive ) );
+        offset += counts[primitive];
+    }
+    ASSERT_EQ( sizeof( expected ), packerSP->GetIndexDataSize() );
+    EXPECT_EQ( 0, memcmp( expected, packerSP->GetIndexData(), sizeof( expected ) ) );
+}
+
+TEST( TestInterleavedVertexPacker, UpdatesOnlyWhatChanged )
+{
+    vtkSmartPointer<vtkPolyData> gridSP = CreateGrid( 2 );
+    vtkSmartPointer<vtkGPUInterleavedVertexPacker> packerSP = vtkSmartPointer<vtkGPUInterleavedVertexPacker>::New();
+
+    EXPECT_EQ( vtkGPUInterleavedVertexPacker::Repacked, packerSP->Pack( gridSP, 0 ) );
+    EXPECT_EQ( vtkGPUInterleavedVertexPacker::Unchanged, packerSP->Pack( gridSP, 0 ) );
+
+    // Points moved through vtkPoints
+    gridSP->GetPoints()->SetPoint( 4, 1.0, 1.0, 5.0 );
+    gridSP->GetPoints()->Modified();
+    EXPECT_EQ( vtkGPUInterleavedVertexPacker::VerticesUpdated, packerSP->Pack( gridSP, 0 ) );
+    EXPECT_FLOAT_EQ( 5.0f, GetVertex( packerSP, 4 )[2] );
+    EXPECT_EQ( vtkGPUInterleavedVertexPacker::Unchanged, packerSP->Pack( gridSP, 0 ) );
+
+    // Normals replaced
+    vtkSmartPointer<vtkFloatArray> normalsSP = vtkSmartPointer<vtkFloatArray>::New();
+    normalsSP->DeepCopy( gridSP->GetPointData()->GetNormals() );
+    normalsSP->SetTuple3( 4, 1.0, 0.0, 0.0 );
+    gridSP->GetPointData()->SetNormals( normalsSP );
+    EXPECT_EQ( vtkGPUInterleavedVertexPacker::VerticesUpdated, packerSP->Pack( gridSP, 0 ) );
+    EXPECT_FLOAT_EQ( 1.0f, GetVertex( packerSP, 4 )[3] );
+
+    // New cells
+    vtkIdType triangle[3] = { 0, 1, 4 };
+    gridSP->GetPolys()->InsertNextCell( 3, triangle );
+    gridSP->GetPolys()->Modified();
+    EXPECT_EQ( vtkGPUInterleavedVertexPacker::Repacked, packerSP->Pack( gridSP, 0 ) );
+    EXPECT_EQ( 4u * 6u + 3u, packerSP->GetNumberOfIndices( vtkGPUInterleavedVertexPacker::PolygonTriangles ) );
+
+    packerSP->Reset();
+    EXPECT_EQ( vtkGPUInterleavedVertexPacker::Repacked, packerSP->Pack( gridSP, 0 ) );
+}
+
+TEST( TestInterleavedVertexPacker, SharedTopologyAcrossTimeSteps )
+{
+    // Two time steps read separately: other arrays, same connectivity
+    vtkSmartPointer<vtkPolyData> firstStepSP = CreateGrid( 4 );
+    vtkSmartPointer<vtkPolyData> secondStepSP = CreateGrid( 4 );
+    secondStepSP->GetPoints()->SetPoint( 0, 0.0, 0.0, 1.0 );
+
+    vtkSmartPointer<vtkGPUInterleavedVertexPacker> packerSP = vtkSmartPointer<vtkGPUInterleavedVertexPacker>::New();
+    EXPECT_EQ( vtkGPUInterleavedVertexPacker::Repacked, packerSP->Pack( firstStepSP, 0 ) );
+    EXPECT_EQ( vtkGPUInterleavedVertexPacker::VerticesUpdated, packerSP->Pack( secondStepSP, 0 ) );
+    EXPECT_FLOAT_EQ( 1.0f, GetVertex( packerSP, 0 )[2] );
+    EXPECT_EQ( vtkGPUInterleavedVertexPacker::VerticesUpdated, packerSP->Pack( firstStepSP, 0 ) );
+    EXPECT_FLOAT_EQ( 0.0f, GetVertex( packerSP, 0 )[2] );
+
+    vtkSmartPointer<vtkPolyData> otherTopologySP = CreateGrid( 4 );
+    vtkIdType* connectivity = otherTopologySP->GetPolys()->GetPointer();
+    connectivity[1] = 6;
+    otherTopologySP->GetPolys()->Modified();
+    EXPECT_EQ( vtkGPUInterleavedVertexPacker::Repacked, packerSP->Pack( otherTopologySP, 0 ) );
+}
+
+TEST( TestInterleavedVertexPacker, StaticGeometry )
+{
+    vtkSmartPointer<vtkPolyData> firstStepSP = CreateGrid( 4 );
+    vtkSmartPointer<vtkPolyData> secondStepSP = CreateGrid( 4 );
+    secondStepSP->GetPoints()->SetPoint( 0, 0.0, 0.0, 1.0 );
+    vtkSmartPointer<vtkUnsignedCharArray> colorsSP = CreateColors( 4, 25 );
+
+    vtkSmartPointer<vtkGPUInterleavedVertexPacker> packerSP = vtkSmartPointer<vtkGPUInterleavedVertexPacker>::New();
+    packerSP->StaticGeometryOn();
+    EXPECT_EQ( vtkGPUInterleavedVertexPacker::Repacked, packerSP->Pack( firstStepSP, colorsSP ) );
+
+    // Other points, kept
+    EXPECT_EQ( vtkGPUInterleavedVertexPacker::Unchanged, packerSP->Pack( secondStepSP, colorsSP ) );
+    EXPECT_FLOAT_EQ( 0.0f, GetVertex( packerSP, 0 )[2] );
+
+    // Colors still follow
+    colorsSP->SetValue( 0, 200 );
+    colorsSP->Modified();
+    EXPECT_EQ( vtkGPUInterleavedVertexPacker::VerticesUpdated, packerSP->Pack( secondStepSP, colorsSP ) );
+    EXPECT_EQ( 200, GetColor( packerSP, 0 )[0] );
+
+    // Another number of points is another geometry
+    EXPECT_EQ( vtkGPUInterleavedVertexPacker::Repacked, packerSP->Pack( CreateGrid( 3 ), 0 ) );
+    EXPECT_EQ( 16, packerSP->GetNumberOfVertices() );
+
+    packerSP->StaticGeometryOff();
+    EXPECT_EQ( vtkGPUInterleavedVertexPacker::Repacked, packerSP->Pack( secondStepSP, 0 ) );
+    EXPECT_FLOAT_EQ( 1.0f, GetVertex( packerSP, 0 )[2] );
+}
+
+TEST( TestInterleavedVertexPacker, ColorComponents )
+{
+    vtkSmartPointer<vtkPolyData> gridSP = CreateGrid( 1 );
+    vtkSmartPointer<vtkGPUInterleavedVertexPacker> packerSP = vtkSmartPointer<vtkGPUInterleavedVertexPacker>::New();
+
+    // Luminance
+    packerSP->Pack( gridSP, CreateColors( 1, 4 ) );
+    const unsigned char* color = GetColor( packerSP, 1 );
+    EXPECT_EQ( 11, color[0] );
+    EXPECT_EQ( 11, color[1] );
+    EXPECT_EQ( 11, color[2] );
+    EXPECT_EQ( 255, color[3] );
+
+    // Luminance and alpha
+    packerSP->Pack( gridSP, CreateColors( 2, 4 ) );
+    color = GetColor( packerSP, 1 );
+    EXPECT_EQ( 12, color[0] );
+    EXPECT_EQ( 12, color[2] );
+    EXPECT_EQ( 13, color[3] );
+
+    // RGB
+    packerSP->Pack( gridSP, CreateColors( 3, 4 ) );
+    color = GetColor( packerSP, 1 );
+    EXPECT_EQ( 13, color[0] );
+    EXPECT_EQ( 14, color[1] );
+    EXPECT_EQ( 15, color[2] );
+    EXPECT_EQ( 255, color[3] );
+
+    // Colors that do not match the points are left out
+    EXPECT_EQ( vtkGPUInterleavedVertexPacker::Repacked, packerSP->Pack( gridSP, CreateColors( 4, 3 ) ) );
+    EXPECT_EQ( -1, packerSP->GetColorOffset() );
+}
+
+TEST( TestInterleavedVertexPacker, DoublePoints )
+{
+    vtkSmartPointer<vtkPolyData> gridSP = CreateGrid( 1 );
+    vtkSmartPointer<vtkPoints> pointsSP = vtkSmartPointer<vtkPoints>::New();
+    pointsSP->SetDataTypeToDouble();
+    pointsSP->InsertNextPoint( 0.0, 0.0, 0.0 );
+    pointsSP->InsertNextPoint( 1.0, 0.0, 0.0 );
+    pointsSP->InsertNextPoint( 0.5, 2.5, -1.0 );
+    pointsSP->InsertNextPoint( 1.0, 1.0, 0.0 );
+    gridSP->SetPoints( pointsSP );
+
+    vtkSmartPointer<vtkGPUInterleavedVertexPacker> packerSP = vtkSmartPointer<vtkGPUInterleavedVertexPacker>::New();
+    packerSP->Pack( gridSP, 0 );
+    const float* vertex = GetVertex( packerSP, 2 );
+    EXPECT_FLOAT_EQ( 0.5f, vertex[0] );
+    EXPECT_FLOAT_EQ( 2.5f, vertex[1] );
+    EXPECT_FLOAT_EQ( -1.0f, vertex[2] );
+}
+
+TEST( TestInterleavedVertexPacker, BenchmarkPack )
+{
+    vtkSmartPointer<vtkPolyData> gridSP = CreateGrid( BenchmarkGridSize );
+    vtkSmartPointer<vtkUnsignedCharArray> colorsSP = CreateColors( 4, gridSP->GetNumberOfPoints() );
+    vtkSmartPointer<vtkGPUInterleavedVertexPacker> packerSP = vtkSmartPointer<vtkGPUInterleavedVertexPacker>::New();
+
+    double startTime = vtkTimerLog::GetUniversalTime();
+    for( int i = 0; i < BenchmarkPacks; i++ )
+    {
+        packerSP->Reset();
+        EXPECT_EQ( vtkGPUInterleavedVertexPacker::Repacked, packerSP->Pack( gridSP, colorsSP ) );
+    }
+    const double fullPackTime = ( vtkTimerLog::GetUniversalTime() - startTime ) / BenchmarkPacks;
+
+    startTime = vtkTimerLog::GetUniversalTime();
+    for( int i = 0; i < BenchmarkPacks; i++ )
+    {
+        gridSP->GetPoints()->Modified();
+        EXPECT_EQ( vtkGPUInterleavedVertexPacker::VerticesUpdated, packerSP->Pack( gridSP, colorsSP ) );
+    }
+    const double pointsPackTime = ( vtkTimerLog::GetUniversalTime() - startTime ) / BenchmarkPacks;
+
+    const double megabytes = ( packerSP->GetVertexDataSize() + packerSP->GetIndexDataSize() ) / ( 1024.0 * 1024.0 );
+    std::cout << "Full pack of " << packerSP->GetNumberOfVertices() << " vertices: " << fullPackTime * 1000.0
+              << " ms, " << megabytes / fullPackTime << " MB/s" << std::endl;
+    std::cout << "Points only: " << pointsPackTime * 1000.0 << " ms" << std::endl;
+    EXPECT_LT( pointsPackTime, fullPackTime );
+}
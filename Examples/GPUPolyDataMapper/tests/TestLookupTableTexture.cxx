@@ -0,0 +1,152 @@
+/*==============================================================================
+
+  Library: MSVTK
+
+  Copyright (c) Computational Image and Simulation Technologies in Biomedicine (CISTIB),
+                Universitat Pompeu Fabra (UPF), Barcelona, Spain
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#include <gtest/gtest.h>
+
+#include <vtkSmartPointer.h>
+#include <vtkLookupTable.h>
+#include <vtkTimerLog.h>
+#include "vtkGPULookupTableTexture.h"
+
+#include <iostream>
+
+const int BenchmarkTables = 1000;
+
+// Black below the middle of 0..10, white above
+vtkSmartPointer<vtkLookupTable> CreateLookupTable()
+{
+    vtkSmartPointer<vtkLookupTable> lookupTableSP = vtkSmartPointer<vtkLookupTable>::New();
+    lookupTableSP->SetNumberOfTableValues( 2 );
+    lookupTableSP->SetTableValue( 0, 0.0, 0.0, 0.0, 1.0 );
+    lookupTableSP->SetTableValue( 1, 1.0, 1.0, 1.0, 1.0 );
+    lookupTableSP->SetRange( 0.0, 10.0 );
+    return lookupTableSP;
+}
+
+TEST( TestLookupTableTexture, SamplesTexelCentres )
+{
+    vtkSmartPointer<vtkLookupTable> lookupTableSP = CreateLookupTable();
+    vtkSmartPointer<vtkGPULookupTableTexture> textureSP = vtkSmartPointer<vtkGPULookupTableTexture>::New();
+    textureSP->SetNumberOfTexels( 4 );
+
+    EXPECT_EQ( 0, textureSP->GetNumberOfSampledTexels() );
+    EXPECT_TRUE( textureSP->Update( lookupTableSP ) );
+    ASSERT_EQ( 4, textureSP->GetNumberOfSampledTexels() );
+
+    const unsigned char *texels = textureSP->GetTexels();
+    EXPECT_EQ( 0, texels[0] );
+    EXPECT_EQ( 0, texels[4] );
+    EXPECT_EQ( 255, texels[8] );
+    EXPECT_EQ( 255, texels[12] );
+    // Opaque
+    EXPECT_EQ( 255, texels[3] );
+    EXPECT_EQ( 255, texels[15] );
+}
+
+TEST( TestLookupTableTexture, MapsRangeToTextureCoordinates )
+{
+    vtkSmartPointer<vtkLookupTable> lookupTableSP = CreateLookupTable();
+    lookupTableSP->SetRange( -2.0, 6.0 );
+    vtkSmartPointer<vtkGPULookupTableTexture> textureSP = vtkSmartPointer<vtkGPULookupTableTexture>::New();
+    textureSP->Update( lookupTableSP );
+
+    EXPECT_DOUBLE_EQ( 0.0, textureSP->GetTextureCoordinate( -2.0 ) );
+    EXPECT_DOUBLE_EQ( 0.5, textureSP->GetTextureCoordinate( 2.0 ) );
+    EXPECT_DOUBLE_EQ( 1.0, textureSP->GetTextureCoordinate( 6.0 ) );
+    EXPECT_DOUBLE_EQ( 0.125, textureSP->GetTextureCoordinateScale() );
+    EXPECT_DOUBLE_EQ( 0.25, textureSP->GetTextureCoordinateShift() );
+}
+
+TEST( TestLookupTableTexture, SamplesOnlyWhenModified )
+{
+    vtkSmartPointer<vtkLookupTable> lookupTableSP = CreateLookupTable();
+    vtkSmartPointer<vtkGPULookupTableTexture> textureSP = vtkSmartPointer<vtkGPULookupTableTexture>::New();
+
+    EXPECT_TRUE( textureSP->Update( lookupTableSP ) );
+    EXPECT_EQ( 256, textureSP->GetNumberOfSampledTexels() );
+    EXPECT_FALSE( textureSP->Update( lookupTableSP ) );
+
+    lookupTableSP->SetTableValue( 0, 1.0, 0.0, 0.0, 1.0 );
+    EXPECT_TRUE( textureSP->Update( lookupTableSP ) );
+    EXPECT_EQ( 255, textureSP->GetTexels()[0] );
+    EXPECT_FALSE( textureSP->Update( lookupTableSP ) );
+
+    textureSP->SetNumberOfTexels( 16 );
+    EXPECT_TRUE( textureSP->Update( lookupTableSP ) );
+    EXPECT_EQ( 16, textureSP->GetNumberOfSampledTexels() );
+
+    // Another table with the same colors
+    vtkSmartPointer<vtkLookupTable> otherSP = CreateLookupTable();
+    EXPECT_TRUE( textureSP->Update( otherSP ) );
+
+    textureSP->Reset();
+    EXPECT_EQ( 0, textureSP->GetNumberOfSampledTexels() );
+    EXPECT_TRUE( textureSP->Update( otherSP ) );
+}
+
+TEST( TestLookupTableTexture, ClampsNumberOfTexels )
+{
+    vtkSmartPointer<vtkGPULookupTableTexture> textureSP = vtkSmartPointer<vtkGPULookupTableTexture>::New();
+    textureSP->SetNumberOfTexels( 1 );
+    EXPECT_EQ( 2, textureSP->GetNumberOfTexels() );
+    textureSP->SetNumberOfTexels( 100000 );
+    EXPECT_EQ( 4096, textureSP->GetNumberOfTexels() );
+}
+
+TEST( TestLookupTableTexture, DegenerateRange )
+{
+    vtkSmartPointer<vtkLookupTable> lookupTableSP = CreateLookupTable();
+    lookupTableSP->SetRange( 3.0, 3.0 );
+    vtkSmartPointer<vtkGPULookupTableTexture> textureSP = vtkSmartPointer<vtkGPULookupTableTexture>::New();
+    textureSP->SetNumberOfTexels( 4 );
+    EXPECT_TRUE( textureSP->Update( lookupTableSP ) );
+
+    // Every scalar lands in the middle, where every texel has the one color
+    EXPECT_DOUBLE_EQ( 0.5, textureSP->GetTextureCoordinate( -100.0 ) );
+    EXPECT_DOUBLE_EQ( 0.5, textureSP->GetTextureCoordinate( 100.0 ) );
+    const unsigned char *texels = textureSP->GetTexels();
+    EXPECT_EQ( texels[0], texels[12] );
+}
+
+TEST( TestLookupTableTexture, NullLookupTable )
+{
+    vtkSmartPointer<vtkGPULookupTableTexture> textureSP = vtkSmartPointer<vtkGPULookupTableTexture>::New();
+    EXPECT_FALSE( textureSP->Update( 0 ) );
+    EXPECT_EQ( 0, textureSP->GetNumberOfSampledTexels() );
+    EXPECT_TRUE( textureSP->GetTexels() == 0 );
+}
+
+TEST( TestLookupTableTexture, Benchmark )
+{
+    vtkSmartPointer<vtkLookupTable> lookupTableSP = CreateLookupTable();
+    vtkSmartPointer<vtkGPULookupTableTexture> textureSP = vtkSmartPointer<vtkGPULookupTableTexture>::New();
+
+    // A new table every frame: the cost does not depend on the number of vertices
+    const double startTime = vtkTimerLog::GetUniversalTime();
+    for( int i = 0; i < BenchmarkTables; i++ )
+    {
+        lookupTableSP->SetRange( 0.0, 10.0 + i );
+        textureSP->Update( lookupTableSP );
+    }
+    const double sampleTime = ( vtkTimerLog::GetUniversalTime() - startTime ) / BenchmarkTables;
+    std::cout << "Sampling " << textureSP->GetNumberOfTexels() << " texels: "
+              << 1000.0 * sampleTime << " ms" << std::endl;
+}
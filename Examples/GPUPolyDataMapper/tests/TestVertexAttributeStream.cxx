@@ -0,0 +1,142 @@
+/*==============================================================================
+
+  Library: MSVTK
+
+  Copyright (c) Computational Image and Simulation Technologies in Biomedicine (CISTIB),
+                Universitat Pompeu Fabra (UPF), Barcelona, Spain
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#include <gtest/gtest.h>
+
+#include <vtkSmartPointer.h>
+#include <vtkDoubleArray.h>
+#include <vtkFloatArray.h>
+#include <vtkTimerLog.h>
+#include "vtkGPUVertexAttributeStream.h"
+
+#include <iostream>
+
+const int BenchmarkVertices = 100000;
+const int BenchmarkSteps = 50;
+
+// Two components per tuple: ( i, 10 * i )
+template <class ArrayType>
+vtkSmartPointer<ArrayType> CreateArray( int numberOfTuples )
+{
+    vtkSmartPointer<ArrayType> arraySP = vtkSmartPointer<ArrayType>::New();
+    arraySP->SetNumberOfComponents( 2 );
+    arraySP->SetNumberOfTuples( numberOfTuples );
+    for( int i = 0; i < numberOfTuples; i++ )
+    {
+        arraySP->SetValue( 2 * i, i );
+        arraySP->SetValue( 2 * i + 1, 10 * i );
+    }
+    return arraySP;
+}
+
+TEST( TestVertexAttributeStream, StagesOneComponent )
+{
+    vtkSmartPointer<vtkDoubleArray> arraySP = CreateArray<vtkDoubleArray>( 3 );
+    vtkSmartPointer<vtkGPUVertexAttributeStream> streamSP = vtkSmartPointer<vtkGPUVertexAttributeStream>::New();
+
+    EXPECT_EQ( -1, streamSP->GetCurrentSlot() );
+    EXPECT_EQ( 0, streamSP->Stage( arraySP, 1 ) );
+    EXPECT_EQ( 1, streamSP->GetNumberOfComponents() );
+    EXPECT_EQ( 3, streamSP->GetNumberOfTuples() );
+    EXPECT_EQ( 3u * sizeof( float ), streamSP->GetStagedDataSize() );
+    EXPECT_FLOAT_EQ( 0.0f, streamSP->GetStagedData()[0] );
+    EXPECT_FLOAT_EQ( 10.0f, streamSP->GetStagedData()[1] );
+    EXPECT_FLOAT_EQ( 20.0f, streamSP->GetStagedData()[2] );
+
+    // All of them
+    EXPECT_EQ( 1, streamSP->Stage( arraySP, -1 ) );
+    EXPECT_EQ( 2, streamSP->GetNumberOfComponents() );
+    EXPECT_FLOAT_EQ( 2.0f, streamSP->GetStagedData()[4] );
+    EXPECT_FLOAT_EQ( 20.0f, streamSP->GetStagedData()[5] );
+
+    // A component the array does not have
+    EXPECT_EQ( 0, streamSP->Stage( arraySP, 2 ) );
+    EXPECT_EQ( 2, streamSP->GetNumberOfComponents() );
+    EXPECT_EQ( -1, streamSP->Stage( arraySP, 2 ) );
+}
+
+TEST( TestVertexAttributeStream, FloatsAreNotCopied )
+{
+    vtkSmartPointer<vtkFloatArray> arraySP = CreateArray<vtkFloatArray>( 4 );
+    vtkSmartPointer<vtkGPUVertexAttributeStream> streamSP = vtkSmartPointer<vtkGPUVertexAttributeStream>::New();
+
+    streamSP->Stage( arraySP, -1 );
+    EXPECT_EQ( arraySP->GetPointer( 0 ), streamSP->GetStagedData() );
+
+    streamSP->Stage( arraySP, 0 );
+    EXPECT_NE( arraySP->GetPointer( 0 ), streamSP->GetStagedData() );
+    EXPECT_FLOAT_EQ( 3.0f, streamSP->GetStagedData()[3] );
+}
+
+TEST( TestVertexAttributeStream, AlternatesSlotsOnChanges )
+{
+    vtkSmartPointer<vtkFloatArray> firstStepSP = CreateArray<vtkFloatArray>( 4 );
+    vtkSmartPointer<vtkFloatArray> secondStepSP = CreateArray<vtkFloatArray>( 4 );
+    vtkSmartPointer<vtkGPUVertexAttributeStream> streamSP = vtkSmartPointer<vtkGPUVertexAttributeStream>::New();
+
+    EXPECT_EQ( 0, streamSP->Stage( firstStepSP, 0 ) );
+    // Frames without a new time step upload nothing
+    EXPECT_EQ( -1, streamSP->Stage( firstStepSP, 0 ) );
+    EXPECT_EQ( 0, streamSP->GetCurrentSlot() );
+
+    EXPECT_EQ( 1, streamSP->Stage( secondStepSP, 0 ) );
+    EXPECT_EQ( -1, streamSP->Stage( secondStepSP, 0 ) );
+
+    firstStepSP->SetValue( 0, 5.0f );
+    firstStepSP->Modified();
+    EXPECT_EQ( 0, streamSP->Stage( firstStepSP, 0 ) );
+    EXPECT_FLOAT_EQ( 5.0f, streamSP->GetStagedData()[0] );
+    EXPECT_EQ( 3, streamSP->GetNumberOfUpdates() );
+
+    streamSP->Reset();
+    EXPECT_EQ( -1, streamSP->GetCurrentSlot() );
+    EXPECT_EQ( 0, streamSP->Stage( firstStepSP, 0 ) );
+
+    EXPECT_EQ( -1, streamSP->Stage( 0, 0 ) );
+    EXPECT_EQ( -1, streamSP->GetCurrentSlot() );
+}
+
+TEST( TestVertexAttributeStream, BenchmarkStage )
+{
+    // A voltage map: one double per vertex and time step, staged as floats
+    vtkSmartPointer<vtkDoubleArray> stepsSP[2];
+    for( int i = 0; i < 2; i++ )
+    {
+        stepsSP[i] = vtkSmartPointer<vtkDoubleArray>::New();
+        stepsSP[i]->SetNumberOfTuples( BenchmarkVertices );
+        for( int j = 0; j < BenchmarkVertices; j++ )
+        {
+            stepsSP[i]->SetValue( j, i + j * 0.001 );
+        }
+    }
+    vtkSmartPointer<vtkGPUVertexAttributeStream> streamSP = vtkSmartPointer<vtkGPUVertexAttributeStream>::New();
+
+    double startTime = vtkTimerLog::GetUniversalTime();
+    for( int i = 0; i < BenchmarkSteps; i++ )
+    {
+        EXPECT_GE( streamSP->Stage( stepsSP[i % 2], -1 ), 0 );
+    }
+    const double stageTime = ( vtkTimerLog::GetUniversalTime() - startTime ) / BenchmarkSteps;
+
+    std::cout << "Staging " << BenchmarkVertices << " values: " << stageTime * 1000.0 << " ms, "
+              << streamSP->GetStagedDataSize() << " bytes per time step" << std::endl;
+    EXPECT_EQ( BenchmarkVertices * sizeof( float ), streamSP->GetStagedDataSize() );
+}
@@ -25,6 +25,8 @@
 #include "BuildConfig.h"
 #include "msvApp.h"
 #include "vtkExtTypes.h"
+#include "msvFrameScheduler.h"
+#include "msvRenderThread.h"
 
 #include <vector>
 
@@ -42,6 +44,15 @@ class vtkThreadSafeRenderWindow;
 class vtkThreadSafeRenderWindowInteractor;
 
 #define USE_THREADSAFE_RENDERER 0
+// Prints the rendered frames and the CPU usage every few seconds
+#define REPORT_FRAME_STATISTICS 0
+// Records how long the phases of each frame take, written to FrameTrace.json
+// for chrome://tracing and summed up on exit
+#define TRACE_FRAMES 0
+// Renders from a thread of its own instead of the idle loop. The interactor
+// moves a camera of a renderer that is never drawn, which the render thread
+// follows, and the entities change the scene through its queue
+#define USE_RENDER_THREAD 0
 
 // Define a new application type, each program should derive a class from wxApp
 class MainApp: public msvApp
@@ -67,6 +78,10 @@ protected:
     void ConfigureVTK();
     void CreateSceneData();
     void CreateAnimation();
+    void CreateFrameScheduler();
+    void CreateRenderThread();
+    void AddFrameTraceObservers();
+    void ReportFrameTrace();
 
 protected:
     vtkThreadSafeRendererWrapper*   m_RendererWrapper;
@@ -84,6 +99,10 @@ protected:
 
     msvEntityMgr*                           m_pmsvEntityMgr;
     msvObjectFactory*                       m_pmsvObjectFactory;
+    msvFrameSchedulerSP                     m_FrameSchedulerSP;
+    msvRenderThreadSP                       m_RenderThreadSP;
+    vtkRendererSP                           m_InteractionRendererSP;
+    double                                  m_LastStatisticsReportTime;
 
     vtkSmartPointer<vtkPolyData>            m_PolyDataSP;
     vtkSmartPointer<vtkPolyDataMapper>      m_PolyDataMapperSP;
@@ -0,0 +1,118 @@
+/*==============================================================================
+
+  Library: MSVTK
+
+  Copyright (c) Computational Image and Simulation Technologies in Biomedicine (CISTIB),
+                Universitat Pompeu Fabra (UPF), Barcelona, Spain
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#ifndef __MSVATOMIC_H__
+#define __MSVATOMIC_H__
+
+// Description:
+// Minimal atomic operations for the lock-free structures of the example.
+// All of them are full barriers: whatever was written before them is visible
+// to the thread that observes their result
+
+#if defined( _MSC_VER )
+#include <windows.h>
+#elif !defined( __GNUC__ )
+#error "msvAtomic.h: no atomic operations available for this compiler"
+#endif
+
+// Description:
+// Stores newValue in *target if it holds expected. Returns what *target held
+inline void* msvAtomicCompareAndSwapPointer( void* volatile* target, void* expected, void* newValue )
+{
+#if defined( _MSC_VER )
+    return InterlockedCompareExchangePointer( target, newValue, expected );
+#else
+    return __sync_val_compare_and_swap( target, expected, newValue );
+#endif
+}
+
+// Description:
+// Stores newValue in *target. Returns what *target held
+inline void* msvAtomicExchangePointer( void* volatile* target, void* newValue )
+{
+#if defined( _MSC_VER )
+    return InterlockedExchangePointer( target, newValue );
+#else
+    // __sync_lock_test_and_set is only an acquire barrier
+    void* oldValue = *target;
+    for( ;; )
+    {
+        void* previousValue = __sync_val_compare_and_swap( target, oldValue, newValue );
+        if( previousValue == oldValue )
+        {
+            return oldValue;
+        }
+        oldValue = previousValue;
+    }
+#endif
+}
+
+// Description:
+// Adds increment to *target. Returns the new value
+inline long msvAtomicAdd( volatile long* target, long increment )
+{
+#if defined( _MSC_VER )
+    return InterlockedExchangeAdd( target, increment ) + increment;
+#else
+    return __sync_add_and_fetch( target, increment );
+#endif
+}
+
+// Description:
+// Stores newValue in *target. Returns what *target held
+inline long msvAtomicExchange( volatile long* target, long newValue )
+{
+#if defined( _MSC_VER )
+    return InterlockedExchange( target, newValue );
+#else
+    long oldValue = *target;
+    for( ;; )
+    {
+        long previousValue = __sync_val_compare_and_swap( target, oldValue, newValue );
+        if( previousValue == oldValue )
+        {
+            return oldValue;
+        }
+        oldValue = previousValue;
+    }
+#endif
+}
+
+// Description:
+// Reads *target, ordered with the atomic operations around it
+inline long msvAtomicLoad( volatile long* target )
+{
+    return msvAtomicAdd( target, 0 );
+}
+
+// Description:
+// Keeps the compiler from moving memory accesses across it. No instruction
+// is emitted
+inline void msvCompilerBarrier()
+{
+#if defined( _MSC_VER )
+    _ReadWriteBarrier();
+#else
+    __asm__ __volatile__( "" ::: "memory" );
+#endif
+}
+
+#endif  // #ifndef __MSVATOMIC_H__
@@ -0,0 +1,182 @@
+/*==============================================================================
+
+  Library: MSVTK
+
+  Copyright (c) Computational Image and Simulation Technologies in Biomedicine (CISTIB),
+                Universitat Pompeu Fabra (UPF), Barcelona, Spain
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#ifndef __MSVDEFERREDCOMMANDQUEUE_H__
+#define __MSVDEFERREDCOMMANDQUEUE_H__
+
+#include <vtkObject.h>
+#include <vtkSmartPointer.h>
+
+#include <string>
+
+class msvDeferredCommandQueue;
+
+// A call recorded to be made later, usually between two frames
+class msvDeferredCommand
+{
+public:
+    msvDeferredCommand() : NextCommand( 0 ) {}
+    virtual ~msvDeferredCommand() {}
+    virtual void Execute() = 0;
+
+private:
+    friend class msvDeferredCommandQueue;
+    // Link used while the command is in a queue
+    msvDeferredCommand*                 NextCommand;
+};
+
+// Calls with their arguments copied. Objects passed as arguments are kept
+// alive until the call is made, strings are copied
+
+template <class C, class A>
+class msvDeferredCall1 : public msvDeferredCommand
+{
+public:
+    typedef void (C::*MethodType)( A );
+    msvDeferredCall1( MethodType method, C* object, A arg ) : Method( method ), Object( object ), Arg( arg ) {}
+    virtual void Execute() { (this->Object->*this->Method)( this->Arg ); }
+private:
+    MethodType                          Method;
+    C*                                  Object;
+    A                                   Arg;
+};
+
+template <class C, class A>
+class msvDeferredCall2 : public msvDeferredCommand
+{
+public:
+    typedef void (C::*MethodType)( A, A );
+    msvDeferredCall2( MethodType method, C* object, A arg1, A arg2 ) : Method( method ), Object( object ), Arg1( arg1 ), Arg2( arg2 ) {}
+    virtual void Execute() { (this->Object->*this->Method)( this->Arg1, this->Arg2 ); }
+private:
+    MethodType                          Method;
+    C*                                  Object;
+    A                                   Arg1;
+    A                                   Arg2;
+};
+
+template <class C, class A>
+class msvDeferredCall3 : public msvDeferredCommand
+{
+public:
+    typedef void (C::*MethodType)( A, A, A );
+    msvDeferredCall3( MethodType method, C* object, A arg1, A arg2, A arg3 ) : Method( method ), Object( object ), Arg1( arg1 ), Arg2( arg2 ), Arg3( arg3 ) {}
+    virtual void Execute() { (this->Object->*this->Method)( this->Arg1, this->Arg2, this->Arg3 ); }
+private:
+    MethodType                          Method;
+    C*                                  Object;
+    A                                   Arg1;
+    A                                   Arg2;
+    A                                   Arg3;
+};
+
+template <class C>
+class msvDeferredCall0 : public msvDeferredCommand
+{
+public:
+    typedef void (C::*MethodType)();
+    msvDeferredCall0( MethodType method, C* object ) : Method( method ), Object( object ) {}
+    virtual void Execute() { (this->Object->*this->Method)(); }
+private:
+    MethodType                          Method;
+    C*                                  Object;
+};
+
+template <class C, class O>
+class msvDeferredObjectCall : public msvDeferredCommand
+{
+public:
+    typedef void (C::*MethodType)( O* );
+    msvDeferredObjectCall( MethodType method, C* object, O* arg ) : Method( method ), Object( object ), Arg( arg ) {}
+    virtual void Execute() { (this->Object->*this->Method)( this->Arg ); }
+private:
+    MethodType                          Method;
+    C*                                  Object;
+    vtkSmartPointer<O>                  Arg;
+};
+
+template <class C>
+class msvDeferredStringCall : public msvDeferredCommand
+{
+public:
+    typedef void (C::*MethodType)( const char* );
+    msvDeferredStringCall( MethodType method, C* object, const char* arg ) : Method( method ), Object( object ), IsNull( arg == 0 ), Arg( arg ? arg : "" ) {}
+    virtual void Execute() { (this->Object->*this->Method)( this->IsNull ? 0 : this->Arg.c_str() ); }
+private:
+    MethodType                          Method;
+    C*                                  Object;
+    bool                                IsNull;
+    std::string                         Arg;
+};
+
+// Commands pushed by any thread and applied in order by the one that owns the
+// target, between frames. Lock-free with many producers and one consumer:
+// Push links the command on top of a stack with a compare-and-swap, and
+// ApplyAll takes the whole stack with one exchange and runs it oldest first.
+// The commands of each producer are applied in the order it pushed them.
+// Applying runs on the detached list, so a command may push further
+// commands; those wait for the next ApplyAll
+class msvDeferredCommandQueue : public vtkObject
+{
+public:
+    vtkTypeMacro( msvDeferredCommandQueue, vtkObject );
+    // Description:
+    // Construct object
+    static msvDeferredCommandQueue* New();
+
+    // Description:
+    // Takes ownership of the command. Any thread, never waits
+    void Push( msvDeferredCommand* command );
+    // Description:
+    // Executes and deletes the pending commands. Returns how many there were.
+    // Only one thread at a time may apply or clear the queue
+    int ApplyAll();
+    // Description:
+    // Deletes the pending commands without executing them
+    void Clear();
+
+    // Description:
+    // Snapshots while producers are pushing
+    int GetNumberOfPendingCommands();
+    unsigned long GetNumberOfAppliedCommands();
+
+    virtual void PrintSelf( ostream& os, vtkIndent indent );
+
+protected:
+    msvDeferredCommandQueue();
+    ~msvDeferredCommandQueue();
+
+private:
+    // Detaches the pending commands, oldest first
+    msvDeferredCommand* TakeAll();
+
+    // Newest pushed command, linked to the older ones
+    void* volatile                      Head;
+    volatile long                       NumberOfPendingCommands;
+    volatile long                       NumberOfAppliedCommands;
+
+    msvDeferredCommandQueue( const msvDeferredCommandQueue& );  // Not implemented.
+    void operator=( const msvDeferredCommandQueue& );  // Not implemented.
+};
+
+typedef vtkSmartPointer<msvDeferredCommandQueue>  msvDeferredCommandQueueSP;
+
+#endif	// #ifndef __MSVDEFERREDCOMMANDQUEUE_H__
@@ -34,7 +34,9 @@ class vtkPolyData;
 class vtkRenderer;
 class vtkThreadSafeRenderer;
 class vtkTemporalDataSetTimeStepProvider;
+class vtkVolumeProperty;
 class msvEntityMgr;
+class msvDeferredCommandQueue;
 
 class msvEntityImpl;
 
@@ -67,6 +69,39 @@ public:
     // Set the provider of time steps
     void SetTimeStepProvider( vtkTemporalDataSetTimeStepProvider* timeStepProvider );
 
+    // Description:
+    // When another thread renders the renderer (see msvRenderThread), the
+    // props and time steps reach the scene through its queue. Set it before
+    // the renderer
+    void SetSceneUpdateQueue( msvDeferredCommandQueue* sceneUpdates );
+
+    // Description:
+    // Property of the volume shown by structured points entities. Created on
+    // demand if none is set; it can be shared by several entities
+    void SetVolumeProperty( vtkVolumeProperty* volumeProperty );
+    vtkVolumeProperty* GetVolumeProperty();
+
+    // Description:
+    // Levels of detail of polydata entities: decimated versions of every
+    // time step, among which a vtkLODActor picks one per frame from the
+    // measured render time of each and the time the renderer allocates to
+    // the entity. When the interaction stops the allocated time grows and
+    // the full resolution step is drawn. 2 by default, 0 draws every step
+    // at full resolution. Applies from the next time step
+    void SetNumberOfLevelsOfDetail( int numberOfLevels );
+    int GetNumberOfLevelsOfDetail();
+
+    // Description:
+    // Decimates a time step into its levels of detail, unless they are
+    // cached from a previous load. Meant for the loader threads, before the
+    // step is handed to the entity
+    void BuildLevelsOfDetail( vtkPolyData* dataObject, int timeStepNumber );
+
+    // Description:
+    // Releases the levels of detail of a time step, once the loader no
+    // longer holds it. A step staged later is drawn at full resolution
+    void ReleaseLevelsOfDetail( int timeStepNumber );
+
     // Updates having into account the elapsed time, in microseconds
     void Tick( long elapsedTime );
 
@@ -29,6 +29,8 @@
 #include <vector>
 
 class vtkRenderer;
+class vtkVolumeProperty;
+class msvDeferredCommandQueue;
 
 class msvEntity;
 struct msvEntityInfoEntry;
@@ -48,13 +50,45 @@ public:
 
     void SetRenderer( vtkRenderer* assignedRenderer );
 
+    // Description:
+    // Queue through which the entities change the scene when another thread
+    // renders the renderer, e.g. the one of an msvRenderThread. Set it before
+    // the renderer. Null changes the scene directly
+    void SetSceneUpdateQueue( msvDeferredCommandQueue* sceneUpdates );
+
     virtual void PrintSelf( ostream& os, vtkIndent indent );
 
     // Fills a petition to provide new time steps to the entity that asks for it
     void RequestSequentialTimeSteps( msvEntity* requesterEntity, int firstTimeStepRequested = 0, int timeStepsRequested = 1 );
     void RequestNextSequentialTimeStep( msvEntity* requesterEntity );
 
-    // Updates having into account the elapsed time, in microseconds
+    // Description:
+    // Number of persistent threads loading time steps for all the entities.
+    // Defaults to the number of processors, up to 4. Changing it stops the
+    // running pool; pending requests are dropped and issued again
+    void SetNumberOfLoaderThreads( int numberOfLoaderThreads );
+    int GetNumberOfLoaderThreads();
+
+    // Description:
+    // Time steps kept loaded ahead of the one an entity shows. With adaptive
+    // lookahead the depth follows the measured decode time of a frame against
+    // the playback period, up to maxLookaheadDepth; otherwise it is fixed at
+    // maxLookaheadDepth. Depths are clamped to [1, 16]
+    void SetEntityLookahead( msvEntity* entity, int maxLookaheadDepth, bool adaptive = true );
+    int GetEntityLookaheadDepth( msvEntity* entity );
+
+    // Description:
+    // Maximum lookahead depth given to new entities. Defaults to 8
+    void SetDefaultLookaheadDepth( int defaultLookaheadDepth );
+    int GetDefaultLookaheadDepth();
+
+    // Description:
+    // Volume property given to every structured points entity. Changing it
+    // affects all of them
+    vtkVolumeProperty* GetVolumeProperty();
+
+    // Updates having into account the elapsed time, in microseconds. Invokes
+    // ModifiedEvent when any entity changed its time step
     void Tick( long elapsedTime );
 
 protected:
@@ -0,0 +1,130 @@
+/*==============================================================================
+
+  Library: MSVTK
+
+  Copyright (c) Computational Image and Simulation Technologies in Biomedicine (CISTIB),
+                Universitat Pompeu Fabra (UPF), Barcelona, Spain
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#ifndef __MSVFRAMESCHEDULER_H__
+#define __MSVFRAMESCHEDULER_H__
+
+#include <vtkObject.h>
+#include <vtkSmartPointer.h>
+#include <vtkWeakPointer.h>
+#include <vtkCommand.h>
+
+#include <vector>
+
+class vtkCallbackCommand;
+
+// Decides when the application has to render. The scene is marked dirty by
+// the events of the watched objects (entity time step swaps, interactor
+// events, camera and property changes) and a frame is only due when it is
+// dirty and a refresh period has gone by since the last one
+class msvFrameScheduler : public vtkObject
+{
+public:
+    vtkTypeMacro( msvFrameScheduler, vtkObject );
+    // Description:
+    // Construct object
+    static msvFrameScheduler* New();
+
+    // Description:
+    // Marks the scene dirty every time object invokes event
+    void Watch( vtkObject* object, unsigned long event = vtkCommand::ModifiedEvent );
+    void Unwatch( vtkObject* object );
+    void UnwatchAll();
+
+    // Description:
+    // Object that invokes StartEvent and EndEvent around each render, usually
+    // the render window. Events of the watched objects in between are caused
+    // by the render itself and do not dirty the scene. Every EndEvent counts as
+    // a rendered frame, whoever asked for the render
+    void SetRenderTarget( vtkObject* renderTarget );
+
+    void MarkDirty();
+    bool IsDirty();
+
+    // Description:
+    // Renders are capped at this rate, usually the refresh rate of the
+    // display. Defaults to 60 frames per second
+    void SetMaximumFrameRate( double maximumFrameRate );
+    double GetMaximumFrameRate();
+
+    // Description:
+    // True when the scene is dirty and the refresh period has gone by. Times
+    // are in seconds, as given by vtkTimerLog::GetUniversalTime
+    bool IsFrameDue( double currentTime );
+    // Description:
+    // Seconds the caller can sleep before a frame may be due. 0 if it is due
+    // now; the whole refresh period if the scene is clean
+    double GetTimeToNextFrame( double currentTime );
+    // Description:
+    // Clears the dirty state. Called on the EndEvent of the render target, or
+    // by hand when there is none
+    void FrameRendered( double currentTime );
+
+    // Description:
+    // Statistics since the last ResetStatistics. The idle CPU usage is the
+    // processor time spent by the process over the wall time elapsed, 1.0
+    // meaning a whole core
+    int GetNumberOfRenderedFrames();
+    int GetNumberOfIdleChecks();
+    int GetNumberOfSkippedChecks();
+    double GetCPUUsage();
+    void ResetStatistics();
+
+    virtual void PrintSelf( ostream& os, vtkIndent indent );
+
+protected:
+    msvFrameScheduler();
+    ~msvFrameScheduler();
+
+private:
+    static void OnWatchedEvent( vtkObject* caller, unsigned long eventId, void* clientData, void* callData );
+    static void OnRenderEvent( vtkObject* caller, unsigned long eventId, void* clientData, void* callData );
+
+private:
+    struct WatchedObject
+    {
+        vtkWeakPointer<vtkObject>       Object;
+        unsigned long                   ObserverTag;
+    };
+
+    vtkSmartPointer<vtkCallbackCommand> WatchCommand;
+    vtkSmartPointer<vtkCallbackCommand> RenderCommand;
+    std::vector<WatchedObject>          WatchedObjects;
+    vtkWeakPointer<vtkObject>           RenderTarget;
+    unsigned long                       RenderStartTag;
+    unsigned long                       RenderEndTag;
+
+    bool                                Dirty;
+    bool                                Rendering;
+    bool                                AnyFrameRendered;
+    double                              MaximumFrameRate;
+    double                              LastFrameTime;
+
+    int                                 NumberOfRenderedFrames;
+    int                                 NumberOfIdleChecks;
+    int                                 NumberOfSkippedChecks;
+    double                              StatisticsStartTime;
+    double                              StatisticsStartCPUTime;
+};
+
+typedef vtkSmartPointer<msvFrameScheduler>  msvFrameSchedulerSP;
+
+#endif	// #ifndef __MSVFRAMESCHEDULER_H__
@@ -0,0 +1,172 @@
+/*==============================================================================
+
+  Library: MSVTK
+
+  Copyright (c) Computational Image and Simulation Technologies in Biomedicine (CISTIB),
+                Universitat Pompeu Fabra (UPF), Barcelona, Spain
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+#ifndef __MSVFRAMETRACE_H__
+#define __MSVFRAMETRACE_H__
+
+#include <vtkTimerLog.h>
+#include <vtkIOStream.h>
+
+#include <vector>
+
+// Description:
+// A zone of the trace: a named phase of a frame run by one thread. Times
+// are in seconds, as given by vtkTimerLog::GetUniversalTime
+struct msvTraceEvent
+{
+    // Not copied, so it must live as long as the trace, e.g. a literal
+    const char*                         Name;
+    double                              StartTime;
+    double                              Duration;
+    unsigned long                       FrameNumber;
+    int                                 ThreadIndex;
+};
+
+// Description:
+// Distribution of the durations of the zones with the same name, in seconds
+struct msvTraceHistogram
+{
+    msvTraceHistogram();
+
+    // Bucket i counts the durations from 2^i to 2^(i+1) microseconds. The
+    // first one also takes the shorter ones and the last one the longer ones
+    enum { NumberOfBuckets = 24 };
+
+    unsigned long                       Count;
+    double                              Minimum;
+    double                              Maximum;
+    double                              Mean;
+    double                              Median;
+    double                              Percentile95;
+    double                              Percentile99;
+    unsigned long                       Buckets[NumberOfBuckets];
+};
+
+// Description:
+// Records how long each phase of the frames takes, like vtkTimerLog does for
+// its events. Every thread that records gets a ring of its own that keeps
+// its latest zones, so recording never takes a lock and never allocates
+// after the first zone of the thread. The rings are read on demand, to write
+// a Chrome trace (chrome://tracing) or to sum up a zone in a histogram.
+// Disabled by default, a zone then costs a test of a flag
+class msvFrameTrace
+{
+public:
+    // Description:
+    // Turns the recording on or off for all the threads
+    static void SetEnabled( bool enabled );
+    static bool GetEnabled() { return Enabled != 0; }
+    static void EnableOn() { SetEnabled( true ); }
+    static void EnableOff() { SetEnabled( false ); }
+
+    // Description:
+    // Zones kept by each thread, the older ones are overwritten. Only takes
+    // effect for the threads that record their first zone afterwards, or
+    // for all of them after ResetLog. Defaults to 16384
+    static void SetMaxEntries( int maxEntries );
+    static int GetMaxEntries();
+
+    // Description:
+    // Drops the recorded zones. No thread may be recording meanwhile, e.g.
+    // call it while the trace is disabled and no zone is open
+    static void ResetLog();
+
+    // Description:
+    // Starts the next frame: the zones recorded from now on belong to it
+    static void NextFrame();
+    static unsigned long GetFrameNumber();
+
+    // Description:
+    // Name of the calling thread in the exported trace. Must live as long as
+    // the trace, e.g. a literal
+    static void SetThreadName( const char* name );
+
+    // Description:
+    // Records a zone timed by the caller, for phases that do not fit in a
+    // scope. Does nothing while disabled
+    static void AddZone( const char* name, double startTime, double endTime )
+    {
+        if( Enabled )
+        {
+            RecordZone( name, startTime, endTime );
+        }
+    }
+
+    // Description:
+    // Copies the zones kept by every thread, each thread oldest first. Safe
+    // while the other threads are recording: zones overwritten during the
+    // copy are left out
+    static void GetEvents( std::vector<msvTraceEvent>& events );
+
+    // Description:
+    // Distribution of the durations of the zones named name. Returns false
+    // when there is none
+    static bool GetHistogram( const char* name, msvTraceHistogram& histogram );
+
+    // Description:
+    // Writes the kept zones in the JSON format of the Chrome trace viewer.
+    // Returns false if the file cannot be written
+    static bool WriteChromeTrace( const char* fileName );
+    static void WriteChromeTrace( ostream& os );
+
+private:
+    static void RecordZone( const char* name, double startTime, double endTime );
+
+    static volatile int                 Enabled;
+
+    msvFrameTrace();  // Not implemented.
+};
+
+// Description:
+// Records the time from its construction to its destruction as a zone of
+// the trace. Use it through MSV_TRACE_ZONE
+class msvTraceZone
+{
+public:
+    explicit msvTraceZone( const char* name )
+    : Name( name )
+    , StartTime( msvFrameTrace::GetEnabled() ? vtkTimerLog::GetUniversalTime() : -1.0 )
+    {
+    }
+
+    ~msvTraceZone()
+    {
+        if( this->StartTime >= 0.0 )
+        {
+            msvFrameTrace::AddZone( this->Name, this->StartTime, vtkTimerLog::GetUniversalTime() );
+        }
+    }
+
+private:
+    const char*                         Name;
+    double                              StartTime;
+
+    msvTraceZone( const msvTraceZone& );  // Not implemented.
+    void operator=( const msvTraceZone& );  // Not implemented.
+};
+
+#define MSV_TRACE_CONCATENATE_IMPL( a, b ) a##b
+#define MSV_TRACE_CONCATENATE( a, b ) MSV_TRACE_CONCATENATE_IMPL( a, b )
+
+// Description:
+// Times the rest of the enclosing scope as a zone named name
+#define MSV_TRACE_ZONE( name ) msvTraceZone MSV_TRACE_CONCATENATE( msvTraceZone, __LINE__ )( name )
+
+#endif  // #ifndef __MSVFRAMETRACE_H__
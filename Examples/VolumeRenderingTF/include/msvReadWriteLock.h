@@ -0,0 +1,93 @@
+/*==============================================================================
+
+  Library: MSVTK
+
+  Copyright (c) Computational Image and Simulation Technologies in Biomedicine (CISTIB),
+                Universitat Pompeu Fabra (UPF), Barcelona, Spain
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#ifndef __MSVREADWRITELOCK_H__
+#define __MSVREADWRITELOCK_H__
+
+#include <vtkObject.h>
+#include <vtkSmartPointer.h>
+
+class vtkMutexLock;
+class vtkConditionVariable;
+
+// Contention counters of a msvReadWriteLock. Times are in seconds
+struct msvLockCounters
+{
+    msvLockCounters();
+
+    unsigned long                       ReadLocks;
+    unsigned long                       WriteLocks;
+    // Locks that had to wait for another thread
+    unsigned long                       ContendedReadLocks;
+    unsigned long                       ContendedWriteLocks;
+    double                              ReadWaitTime;
+    double                              WriteWaitTime;
+    double                              WriteHoldTime;
+    double                              MaximumWriteHoldTime;
+};
+
+// Lock shared by any number of readers or held by a single writer. Readers
+// are preferred: a reader only waits while a writer holds the lock, never for
+// writers that are waiting, so a thread may take the read lock again while it
+// already holds it
+class msvReadWriteLock : public vtkObject
+{
+public:
+    vtkTypeMacro( msvReadWriteLock, vtkObject );
+    // Description:
+    // Construct object
+    static msvReadWriteLock* New();
+
+    void LockRead();
+    void UnlockRead();
+    void LockWrite();
+    void UnlockWrite();
+
+    // Description:
+    // Same as LockWrite and UnlockWrite, so it can replace a vtkMutexLock
+    void Lock();
+    void Unlock();
+
+    // Description:
+    // Counters since construction or the last ResetCounters
+    void GetCounters( msvLockCounters& counters );
+    void ResetCounters();
+
+    virtual void PrintSelf( ostream& os, vtkIndent indent );
+
+protected:
+    msvReadWriteLock();
+    ~msvReadWriteLock();
+
+private:
+    vtkMutexLock*                       StateLock;
+    vtkConditionVariable*               ReadCondition;
+    vtkConditionVariable*               WriteCondition;
+    int                                 ActiveReaders;
+    int                                 WaitingWriters;
+    bool                                WriterActive;
+    double                              WriteLockTime;
+    msvLockCounters                     Counters;
+};
+
+typedef vtkSmartPointer<msvReadWriteLock>  msvReadWriteLockSP;
+
+#endif	// #ifndef __MSVREADWRITELOCK_H__
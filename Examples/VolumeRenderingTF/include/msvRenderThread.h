@@ -0,0 +1,163 @@
+/*==============================================================================
+
+  Library: MSVTK
+
+  Copyright (c) Computational Image and Simulation Technologies in Biomedicine (CISTIB),
+                Universitat Pompeu Fabra (UPF), Barcelona, Spain
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#ifndef __MSVRENDERTHREAD_H__
+#define __MSVRENDERTHREAD_H__
+
+#include <vtkObject.h>
+#include <vtkSmartPointer.h>
+#include <vtkWeakPointer.h>
+#include <vtkMultiThreader.h>
+
+#include "msvTripleBuffer.h"
+#include "msvDeferredCommandQueue.h"
+
+class vtkRenderWindow;
+class vtkRenderer;
+class vtkCamera;
+class vtkCallbackCommand;
+
+// Camera and window size posted by the GUI thread for the next frame
+struct msvViewState
+{
+    msvViewState();
+
+    double                              Position[3];
+    double                              FocalPoint[3];
+    double                              ViewUp[3];
+    double                              ViewAngle;
+    double                              ParallelScale;
+    int                                 ParallelProjection;
+    // 0 keeps the size of the window
+    int                                 Size[2];
+};
+
+// Renders a window from a thread of its own, so heavy frames never hold the
+// GUI thread. While running, the thread owns the window and its context:
+// nothing else may render it, and the scene only changes through this class.
+// The GUI thread posts view states, which reach the thread through a triple
+// buffer, and any thread (loaders included) posts scene updates, applied in
+// order at the start of the next frame. The thread renders when one of them
+// arrived or a render was requested, at most at the maximum frame rate.
+// Offscreen windows work the same, without any window system
+class msvRenderThread : public vtkObject
+{
+public:
+    vtkTypeMacro( msvRenderThread, vtkObject );
+    // Description:
+    // Construct object
+    static msvRenderThread* New();
+
+    // Description:
+    // Window to render and renderer whose active camera follows the posted
+    // view states. Set them before Start
+    void SetRenderWindow( vtkRenderWindow* renderWindow );
+    vtkRenderWindow* GetRenderWindow();
+    void SetRenderer( vtkRenderer* renderer );
+    vtkRenderer* GetRenderer();
+
+    // Description:
+    // Defaults to 60 frames per second
+    void SetMaximumFrameRate( double maximumFrameRate );
+    double GetMaximumFrameRate();
+
+    void Start();
+    // Description:
+    // Returns once the thread rendered its last frame and exited
+    void Stop();
+    bool IsRunning();
+
+    // Description:
+    // GUI thread side. Never waits for the render; only the newest state
+    // posted before a frame starts is used
+    void PostViewState( const msvViewState& viewState );
+    // Description:
+    // Posts the state of camera every time it is modified, e.g. the camera
+    // moved by the interactor. Null stops watching
+    void WatchCamera( vtkCamera* camera );
+    // Description:
+    // GUI thread side. True when the render thread moved the camera itself,
+    // e.g. a scene update that reset it; the watched camera is then set to
+    // the same state without posting it back
+    bool SyncWatchedCamera();
+
+    // Description:
+    // Any thread. Takes ownership of the command
+    void PostSceneUpdate( msvDeferredCommand* command );
+    msvDeferredCommandQueue* GetSceneUpdates();
+    // Description:
+    // Any thread. Renders a frame even if nothing was posted
+    void RequestRender();
+
+    // Description:
+    // Copies the state of camera and back
+    static void CaptureViewState( vtkCamera* camera, msvViewState& viewState );
+    static void ApplyViewState( const msvViewState& viewState, vtkCamera* camera );
+
+    // Description:
+    // Statistics since Start. The frame time is only exact once stopped
+    unsigned long GetNumberOfRenderedFrames();
+    unsigned long GetNumberOfAppliedViewStates();
+    double GetMaximumFrameTime();
+
+    virtual void PrintSelf( ostream& os, vtkIndent indent );
+
+protected:
+    msvRenderThread();
+    ~msvRenderThread();
+
+private:
+    static VTK_THREAD_RETURN_TYPE RenderLoop( void* arg );
+    void RenderLoop();
+    // Render thread side. Returns true when something has to be drawn
+    bool ApplyPostedChanges();
+    void RenderFrame();
+    static void OnWatchedCameraModified( vtkObject* caller, unsigned long eventId, void* clientData, void* callData );
+
+private:
+    vtkSmartPointer<vtkRenderWindow>    RenderWindow;
+    vtkSmartPointer<vtkRenderer>        Renderer;
+    vtkSmartPointer<vtkMultiThreader>   Threader;
+    int                                 ThreadID;
+    volatile long                       StopRequested;
+    volatile long                       RenderRequested;
+    double                              MaximumFrameRate;
+
+    // GUI thread to render thread
+    msvTripleBuffer<msvViewState>       PostedViewStates;
+    msvDeferredCommandQueueSP           SceneUpdates;
+    // Render thread to GUI thread, when the scene updates moved the camera
+    msvTripleBuffer<msvViewState>       RenderedViewStates;
+    unsigned long                       AppliedCameraMTime;
+
+    vtkWeakPointer<vtkCamera>           WatchedCamera;
+    vtkSmartPointer<vtkCallbackCommand> WatchCommand;
+    unsigned long                       WatchTag;
+    bool                                SyncingWatchedCamera;
+
+    volatile long                       NumberOfRenderedFrames;
+    volatile long                       NumberOfAppliedViewStates;
+    double                              MaximumFrameTime;
+};
+
+typedef vtkSmartPointer<msvRenderThread>  msvRenderThreadSP;
+
+#endif	// #ifndef __MSVRENDERTHREAD_H__
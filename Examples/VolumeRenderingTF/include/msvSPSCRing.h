@@ -0,0 +1,129 @@
+/*==============================================================================
+
+  Library: MSVTK
+
+  Copyright (c) Computational Image and Simulation Technologies in Biomedicine (CISTIB),
+                Universitat Pompeu Fabra (UPF), Barcelona, Spain
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#ifndef __MSVSPSCRING_H__
+#define __MSVSPSCRING_H__
+
+#include "msvAtomic.h"
+
+#include <vector>
+
+// Description:
+// Bounded lock-free ring with one producer thread and one consumer thread.
+// Push is only called by the producer and Pop by the consumer; neither ever
+// waits. Different threads may take the producer role over time as long as
+// something else orders their pushes, such as a lock taken between them.
+// The slot of a popped item is reset to T(), so the consumer releases what
+// it holds (e.g. smart pointers) instead of the producer. Each side reads
+// the index of the other with msvAtomicLoad and hands a slot over by storing
+// its own with msvAtomicExchange, both full barriers.
+template <class T>
+class msvSPSCRing
+{
+public:
+    explicit msvSPSCRing( unsigned int capacity = 8 )
+    : Slots( capacity + 1 )
+    , Head( 0 )
+    , Tail( 0 )
+    {
+    }
+
+    // Description:
+    // Producer side. Returns false, leaving the ring untouched, when full
+    bool Push( const T& item )
+    {
+        long tail = this->Tail;
+        long nextTail = this->Next( tail );
+        if( nextTail == msvAtomicLoad( &this->Head ) )
+        {
+            return false;
+        }
+        this->Slots[tail] = item;
+        msvAtomicExchange( &this->Tail, nextTail );
+        return true;
+    }
+
+    // Description:
+    // Consumer side. Returns false when empty
+    bool Pop( T& item )
+    {
+        long head = this->Head;
+        if( head == msvAtomicLoad( &this->Tail ) )
+        {
+            return false;
+        }
+        item = this->Slots[head];
+        this->Slots[head] = T();
+        msvAtomicExchange( &this->Head, this->Next( head ) );
+        return true;
+    }
+
+    // Description:
+    // Exact when called from either side while the other one is idle,
+    // otherwise a snapshot
+    unsigned int GetSize() const
+    {
+        long head = this->Head;
+        long tail = this->Tail;
+        return static_cast<unsigned int>( ( tail >= head ) ? tail - head : tail + static_cast<long>( this->Slots.size() ) - head );
+    }
+    unsigned int GetCapacity() const
+    {
+        return static_cast<unsigned int>( this->Slots.size() ) - 1;
+    }
+    unsigned int GetFreeSpace() const
+    {
+        return this->GetCapacity() - this->GetSize();
+    }
+    bool IsEmpty() const
+    {
+        return this->Head == this->Tail;
+    }
+
+    // Description:
+    // Drops the contents and resizes. Neither side may be using the ring
+    void SetCapacity( unsigned int capacity )
+    {
+        std::vector<T>( capacity + 1 ).swap( this->Slots );
+        this->Head = 0;
+        this->Tail = 0;
+    }
+
+private:
+    long Next( long index ) const
+    {
+        ++index;
+        return ( index == static_cast<long>( this->Slots.size() ) ) ? 0 : index;
+    }
+
+    std::vector<T>          Slots;
+    // Written by the consumer only. Kept apart from Tail so both sides do not
+    // fight for the same cache line
+    volatile long           Head;
+    char                    Padding[64];
+    // Written by the producer only
+    volatile long           Tail;
+
+    msvSPSCRing( const msvSPSCRing& );  // Not implemented.
+    void operator=( const msvSPSCRing& );  // Not implemented.
+};
+
+#endif  // #ifndef __MSVSPSCRING_H__
@@ -0,0 +1,61 @@
+/*==============================================================================
+
+  Library: MSVTK
+
+  Copyright (c) Computational Image and Simulation Technologies in Biomedicine (CISTIB),
+                Universitat Pompeu Fabra (UPF), Barcelona, Spain
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#ifndef __MSVSCENECOMMANDS_H__
+#define __MSVSCENECOMMANDS_H__
+
+#include <vtkRenderer.h>
+#include <vtkProp.h>
+#include <vtkSmartPointer.h>
+
+#include "msvDeferredCommandQueue.h"
+
+// Replaces one prop with another in a single step, so no frame is drawn
+// with both or with none of them. Either may be null
+class msvSwapViewPropCommand : public msvDeferredCommand
+{
+public:
+    msvSwapViewPropCommand( vtkRenderer* renderer, vtkProp* oldProp, vtkProp* newProp )
+    : Renderer( renderer )
+    , OldProp( oldProp )
+    , NewProp( newProp )
+    {
+    }
+
+    virtual void Execute()
+    {
+        if( this->OldProp && this->Renderer->HasViewProp( this->OldProp ) )
+        {
+            this->Renderer->RemoveViewProp( this->OldProp );
+        }
+        if( this->NewProp && !this->Renderer->HasViewProp( this->NewProp ) )
+        {
+            this->Renderer->AddViewProp( this->NewProp );
+        }
+    }
+
+private:
+    vtkRenderer*                        Renderer;
+    vtkSmartPointer<vtkProp>            OldProp;
+    vtkSmartPointer<vtkProp>            NewProp;
+};
+
+#endif  // #ifndef __MSVSCENECOMMANDS_H__
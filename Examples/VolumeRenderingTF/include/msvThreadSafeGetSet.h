@@ -22,6 +22,10 @@ limitations under the License.
 #ifndef __MSVTHREADSAFEGETSET_H__
 #define __MSVTHREADSAFEGETSET_H__
 
+#include "msvReadWriteLock.h"
+#include "msvDeferredCommandQueue.h"
+#include "msvAtomic.h"
+
 
 
 
@@ -190,76 +194,172 @@ limitations under the License.
 
 
 
+// Access policies
+//
+// Chosen at compile time, so the code they do not need is not even generated.
+// Each one tells how a getter reads the wrapped object and whether a setter
+// hands its call to QueueWrite or makes it at once. The hand-written methods
+// take the lock through LockShared and LockExclusive of CompoundAccess, so
+// they follow the policy too:
+// - msvUnsynchronizedAccess: plain calls, for single-threaded builds. No lock
+//   is taken and every write is made at once
+// - msvAtomicScalarAccess: getters read without any lock, which is safe for
+//   values no wider than a pointer; wider ones take the read lock. Setters
+//   are queued. For scalar fields such as Erase or Draw
+// - msvLockedAccess: getters share the read lock, setters are queued. For
+//   compound state such as vectors, strings and objects
+
+#define MSV_THREAD_SAFETY_NONE          0
+#define MSV_THREAD_SAFETY_LOCKED        1
+#define MSV_THREAD_SAFETY_ATOMIC        2
+
+// Policy of the build. NONE for single-threaded builds, LOCKED to take the
+// lock for every getter, ATOMIC (the default) to keep it for compound state
+#ifndef MSV_THREAD_SAFETY
+#define MSV_THREAD_SAFETY MSV_THREAD_SAFETY_ATOMIC
+#endif
+
+struct msvUnsynchronizedAccess
+{
+    enum { DefersWrites = 0 };
+    template <class T> static void BeginRead( msvReadWriteLock* ) {}
+    template <class T> static void EndRead( msvReadWriteLock* ) {}
+    static void LockShared( msvReadWriteLock* ) {}
+    static void UnlockShared( msvReadWriteLock* ) {}
+    static void LockExclusive( msvReadWriteLock* ) {}
+    static void UnlockExclusive( msvReadWriteLock* ) {}
+};
+
+struct msvLockedAccess
+{
+    enum { DefersWrites = 1 };
+    template <class T> static void BeginRead( msvReadWriteLock* lock ) { lock->LockRead(); }
+    template <class T> static void EndRead( msvReadWriteLock* lock ) { lock->UnlockRead(); }
+    static void LockShared( msvReadWriteLock* lock ) { lock->LockRead(); }
+    static void UnlockShared( msvReadWriteLock* lock ) { lock->UnlockRead(); }
+    static void LockExclusive( msvReadWriteLock* lock ) { lock->LockWrite(); }
+    static void UnlockExclusive( msvReadWriteLock* lock ) { lock->UnlockWrite(); }
+};
+
+// Reads of values no wider than a pointer are not torn, the barrier only
+// keeps the compiler from reusing an older read
+template <bool WordSized>
+struct msvAtomicScalarRead
+{
+    static void Begin( msvReadWriteLock* ) { msvCompilerBarrier(); }
+    static void End( msvReadWriteLock* ) { msvCompilerBarrier(); }
+};
+
+template <>
+struct msvAtomicScalarRead<false>
+{
+    static void Begin( msvReadWriteLock* lock ) { lock->LockRead(); }
+    static void End( msvReadWriteLock* lock ) { lock->UnlockRead(); }
+};
+
+struct msvAtomicScalarAccess
+{
+    enum { DefersWrites = 1 };
+    template <class T> static void BeginRead( msvReadWriteLock* lock ) { msvAtomicScalarRead<sizeof( T ) <= sizeof( void* )>::Begin( lock ); }
+    template <class T> static void EndRead( msvReadWriteLock* lock ) { msvAtomicScalarRead<sizeof( T ) <= sizeof( void* )>::End( lock ); }
+    static void LockShared( msvReadWriteLock* lock ) { lock->LockRead(); }
+    static void UnlockShared( msvReadWriteLock* lock ) { lock->UnlockRead(); }
+    static void LockExclusive( msvReadWriteLock* lock ) { lock->LockWrite(); }
+    static void UnlockExclusive( msvReadWriteLock* lock ) { lock->UnlockWrite(); }
+};
+
+#if( MSV_THREAD_SAFETY == MSV_THREAD_SAFETY_NONE )
+typedef msvUnsynchronizedAccess msvScalarAccess;
+typedef msvUnsynchronizedAccess msvCompoundAccess;
+#elif( MSV_THREAD_SAFETY == MSV_THREAD_SAFETY_LOCKED )
+typedef msvLockedAccess         msvScalarAccess;
+typedef msvLockedAccess         msvCompoundAccess;
+#else
+typedef msvAtomicScalarAccess   msvScalarAccess;
+typedef msvLockedAccess         msvCompoundAccess;
+#endif
+
+
+
+
+
 // Safe get set
+//
+// The class using these macros wraps an object of type ImplType in Impl and
+// guards it with a msvReadWriteLock in Mutex. It also names the policies of
+// its scalar and compound accessors as ScalarAccess and CompoundAccess,
+// usually msvScalarAccess and msvCompoundAccess. Deferred setters are handed
+// to its QueueWrite method, which decides when they are applied, or at once
+// when CompoundAccess does not defer writes. The
+// accessors are not virtual so the forwarders of the public class inline them
 
 #define vtkSafeSetMacro(name,type) \
-    virtual void Set##name (type _arg) \
-    { \
-        this->Mutex->Lock(); \
-        Impl->Set##name(_arg); \
-        this->Mutex->Unlock(); \
+    void Set##name (type _arg) \
+    { \
+        if( ScalarAccess::DefersWrites ) \
+        { \
+            this->QueueWrite( new msvDeferredCall1<ImplType, type>( &ImplType::Set##name, this->Impl, _arg ) ); \
+        } \
+        else \
+        { \
+            this->Impl->Set##name( _arg ); \
+        } \
     }
 
 #define vtkSafeGetMacro(name,type) \
-    virtual type Get##name() \
+    type Get##name() \
     { \
-        type aux( 0 ); \
-        this->Mutex->Lock(); \
-        aux = this->Impl->Get##name(); \
-        this->Mutex->Unlock(); \
+        ScalarAccess::BeginRead<type>( this->Mutex ); \
+        type aux = this->Impl->Get##name(); \
+        ScalarAccess::EndRead<type>( this->Mutex ); \
         return aux; \
     }
 
 #define vtkSafeBooleanMacro(name,type) \
-    virtual void name##On () { this->Set##name(static_cast<type>(1));} \
-    virtual void name##Off () { this->Set##name(static_cast<type>(0));}
+    void name##On () { this->Set##name(static_cast<type>(1));} \
+    void name##Off () { this->Set##name(static_cast<type>(0));}
 
 #define vtkSafeGetObjectMacro(name,type) \
     type *Get##name() \
     { \
-        type* aux( 0 ); \
-        this->Mutex->Lock(); \
-        aux = this->Impl->Get##name(); \
-        this->Mutex->Unlock(); \
+        ScalarAccess::BeginRead<type*>( this->Mutex ); \
+        type* aux = this->Impl->Get##name(); \
+        ScalarAccess::EndRead<type*>( this->Mutex ); \
         return aux; \
     }
 
 #define vtkSafeSetClampMacro(name,type,min,max) \
-    virtual void Set##name(type _arg) \
-    { \
-        this->Mutex->Lock(); \
-        this->Impl->Set##name( _arg ); \
-        this->Mutex->Unlock(); \
-    } \
-    virtual type Get##name##MinValue() \
+    vtkSafeSetMacro(name,type) \
+    type Get##name##MinValue() \
     { \
-        type aux( 0 ); \
-        this->Mutex->Lock(); \
-        aux = this->Impl->Get##name##MinValue(); \
-        this->Mutex->Unlock(); \
+        ScalarAccess::BeginRead<type>( this->Mutex ); \
+        type aux = this->Impl->Get##name##MinValue(); \
+        ScalarAccess::EndRead<type>( this->Mutex ); \
         return aux; \
     } \
-    virtual type Get##name##MaxValue() \
+    type Get##name##MaxValue() \
     { \
-        type aux( 0 ); \
-        this->Mutex->Lock(); \
-        aux = this->Impl->Get##name##MaxValue(); \
-        this->Mutex->Unlock(); \
+        ScalarAccess::BeginRead<type>( this->Mutex ); \
+        type aux = this->Impl->Get##name##MaxValue(); \
+        ScalarAccess::EndRead<type>( this->Mutex ); \
         return aux; \
     }
 
 #define vtkSafeSetVector2Macro(name,type) \
     void Set##name( type _arg1, type _arg2 ) \
     { \
-        this->Mutex->Lock(); \
-        this->Impl->Set##name( _arg1, _arg2 ); \
-        this->Mutex->Unlock(); \
+        if( CompoundAccess::DefersWrites ) \
+        { \
+            this->QueueWrite( new msvDeferredCall2<ImplType, type>( &ImplType::Set##name, this->Impl, _arg1, _arg2 ) ); \
+        } \
+        else \
+        { \
+            this->Impl->Set##name( _arg1, _arg2 ); \
+        } \
     } \
     void Set##name( type _arg[2] ) \
     { \
-        this->Mutex->Lock(); \
-        this->Impl->Set##name( _arg[0], _arg[1] ); \
-        this->Mutex->Unlock(); \
+        this->Set##name( _arg[0], _arg[1] ); \
     }
 
 #define vtkSafeGetVector2Macro(name,type) \
@@ -269,25 +369,30 @@ limitations under the License.
     } \
     void Get##name( type &_arg1, type &_arg2 ) \
     { \
+        CompoundAccess::BeginRead<type[2]>( this->Mutex ); \
         this->Impl->Get##name( _arg1, _arg2 ); \
+        CompoundAccess::EndRead<type[2]>( this->Mutex ); \
     } \
     void Get##name( type _arg[2] ) \
     { \
-        this->Impl->Get##name( _arg[0], _arg[1] ); \
+        this->Get##name( _arg[0], _arg[1] ); \
     }
 
 #define vtkSafeSetVector3Macro(name,type) \
     void Set##name( type _arg1, type _arg2, type _arg3) \
     { \
-        this->Mutex->Lock(); \
-        this->Impl->Set##name( _arg1, _arg2, _arg3); \
-        this->Mutex->Unlock(); \
+        if( CompoundAccess::DefersWrites ) \
+        { \
+            this->QueueWrite( new msvDeferredCall3<ImplType, type>( &ImplType::Set##name, this->Impl, _arg1, _arg2, _arg3 ) ); \
+        } \
+        else \
+        { \
+            this->Impl->Set##name( _arg1, _arg2, _arg3 ); \
+        } \
     } \
     void Set##name( type _arg[3] ) \
     { \
-        this->Mutex->Lock(); \
-        this->Impl->Set##name( _arg[0], _arg[1], _arg[2] ); \
-        this->Mutex->Unlock(); \
+        this->Set##name( _arg[0], _arg[1], _arg[2] ); \
     }
 
 #define vtkSafeGetVector3Macro(name,type) \
@@ -297,44 +402,49 @@ limitations under the License.
     } \
     void Get##name( type &_arg1, type &_arg2, type &_arg3 ) \
     { \
+        CompoundAccess::BeginRead<type[3]>( this->Mutex ); \
         this->Impl->Get##name( _arg1, _arg2, _arg3 ); \
+        CompoundAccess::EndRead<type[3]>( this->Mutex ); \
     } \
     void Get##name( type _arg[3] ) \
     { \
-        this->Impl->Get##name( _arg[0], _arg[1], _arg[2] ); \
+        this->Get##name( _arg[0], _arg[1], _arg[2] ); \
     }
 
 #define vtkSafeGetVectorMacro(name,type,count) \
     type *Get##name() \
     { \
-        type* aux( 0 ); \
-        this->Mutex->Lock(); \
-        aux = this->Impl->Get##name(); \
-        this->Mutex->Unlock(); \
+        CompoundAccess::BeginRead<type[count]>( this->Mutex ); \
+        type* aux = this->Impl->Get##name(); \
+        CompoundAccess::EndRead<type[count]>( this->Mutex ); \
         return aux; \
     } \
     void Get##name(type data[count]) \
     { \
-        this->Mutex->Lock(); \
+        CompoundAccess::BeginRead<type[count]>( this->Mutex ); \
         this->Impl->Get##name( data ); \
-        this->Mutex->Unlock(); \
+        CompoundAccess::EndRead<type[count]>( this->Mutex ); \
     }
 
 #define vtkSafeSetStringMacro(name) \
-    virtual void Set##name( const char* _arg) \
-    { \
-        this->Mutex->Lock(); \
-        Impl->Set##name(_arg); \
-        this->Mutex->Unlock(); \
+    void Set##name( const char* _arg) \
+    { \
+        if( CompoundAccess::DefersWrites ) \
+        { \
+            this->QueueWrite( new msvDeferredStringCall<ImplType>( &ImplType::Set##name, this->Impl, _arg ) ); \
+        } \
+        else \
+        { \
+            this->Impl->Set##name( _arg ); \
+        } \
     }
 
 #define vtkSafeGetStringMacro(name) \
-    virtual char* Get##name() \
+    char* Get##name() \
     { \
-        char* aux( 0 ); \
-        this->Mutex->Lock(); \
-        aux = this->Impl->Get##name(); \
-        this->Mutex->Unlock(); \
+        CompoundAccess::BeginRead<char*>( this->Mutex ); \
+        char* aux = this->Impl->Get##name(); \
+        CompoundAccess::EndRead<char*>( this->Mutex ); \
         return aux; \
     }
 
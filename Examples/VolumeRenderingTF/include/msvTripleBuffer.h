@@ -0,0 +1,90 @@
+/*==============================================================================
+
+  Library: MSVTK
+
+  Copyright (c) Computational Image and Simulation Technologies in Biomedicine (CISTIB),
+                Universitat Pompeu Fabra (UPF), Barcelona, Spain
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#ifndef __MSVTRIPLEBUFFER_H__
+#define __MSVTRIPLEBUFFER_H__
+
+#include "msvAtomic.h"
+
+// Description:
+// Latest-value hand-over between one writer thread and one reader thread.
+// The writer fills its own slot and publishes it by swapping it with the
+// middle one; the reader takes the middle slot by swapping it with its own,
+// only when something new was published. Neither side ever waits nor sees a
+// slot the other one is using. Values published before the reader looks are
+// dropped in favour of the newest one
+template <class T>
+class msvTripleBuffer
+{
+public:
+    msvTripleBuffer()
+    : Back( 0 )
+    , Middle( 1 )
+    , Front( 2 )
+    {
+    }
+
+    // Description:
+    // Writer side. Copies the value and publishes it
+    void Publish( const T& value )
+    {
+        this->Slots[this->Back] = value;
+        this->Back = msvAtomicExchange( &this->Middle, this->Back | FreshBit ) & IndexMask;
+    }
+
+    // Description:
+    // Reader side. Makes the newest published value the front one. Returns
+    // false, keeping the front one, when nothing was published since the
+    // last call
+    bool Update()
+    {
+        if( ( msvAtomicLoad( &this->Middle ) & FreshBit ) == 0 )
+        {
+            return false;
+        }
+        this->Front = msvAtomicExchange( &this->Middle, this->Front ) & IndexMask;
+        return true;
+    }
+
+    // Description:
+    // Reader side. Valid until the next Update
+    const T& GetFront() const
+    {
+        return this->Slots[this->Front];
+    }
+
+private:
+    enum { IndexMask = 3, FreshBit = 4 };
+
+    T                       Slots[3];
+    // Owned by the writer
+    long                    Back;
+    // Index of the slot in between, plus FreshBit when the reader did not
+    // take it yet
+    volatile long           Middle;
+    // Owned by the reader
+    long                    Front;
+
+    msvTripleBuffer( const msvTripleBuffer& );  // Not implemented.
+    void operator=( const msvTripleBuffer& );  // Not implemented.
+};
+
+#endif  // #ifndef __MSVTRIPLEBUFFER_H__
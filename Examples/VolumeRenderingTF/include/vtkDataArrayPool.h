@@ -0,0 +1,97 @@
+/*==============================================================================
+
+  Library: MSVTK
+
+  Copyright (c) Computational Image and Simulation Technologies in Biomedicine (CISTIB),
+                Universitat Pompeu Fabra (UPF), Barcelona, Spain
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#ifndef __VTKDATAARRAYPOOL_H__
+#define __VTKDATAARRAYPOOL_H__
+
+#include <vtkObject.h>
+
+class vtkDataArray;
+class vtkDataObject;
+class vtkInformationIntegerKey;
+class vtkDataArrayPoolInternals;
+
+// Description:
+// Pool of data arrays shared by the readers and the temporal cache of a
+// series. Readers Acquire the arrays they decode into; the cache Recycles the
+// time steps it evicts. Once nobody else references an evicted step, its
+// pooled arrays go back to the pool and are handed out again to the next
+// Acquire of the same type, number of components and number of tuples.
+// Only arrays created by the pool are recycled, so memory that the arrays
+// do not own is never reused. Thread safe.
+class vtkDataArrayPool : public vtkObject
+{
+public:
+    static vtkDataArrayPool *New();
+    vtkTypeMacro( vtkDataArrayPool, vtkObject );
+    void PrintSelf( ostream& os, vtkIndent indent );
+
+    // Description:
+    // Returns an array of the given shape, recycled if possible. The caller
+    // owns the returned reference, as with New. The contents are undefined.
+    vtkDataArray* Acquire( int dataType, int numComponents, vtkIdType numTuples );
+
+    // Description:
+    // Hand over an evicted time step. Its pooled arrays are recycled once the
+    // pool holds the last reference to it.
+    void Recycle( vtkDataObject* dataObject );
+
+    // Description:
+    // Maximum number of free arrays kept. The oldest are released first.
+    vtkSetClampMacro(MaxFreeArrays, int, 0, VTK_INT_MAX);
+    vtkGetMacro(MaxFreeArrays, int);
+
+    // Description:
+    // Release all the free arrays and the evicted time steps
+    void Clear();
+
+    // Description:
+    // Statistics: acquires served by a recycled array, acquires that needed a new
+    // array and the bytes of the recycled arrays handed out
+    vtkGetMacro(NumberOfHits, vtkTypeInt64);
+    vtkGetMacro(NumberOfMisses, vtkTypeInt64);
+    vtkGetMacro(RecycledBytes, vtkTypeInt64);
+    void ResetStatistics();
+
+    // Description:
+    // Set in the information of the arrays created by the pool
+    static vtkInformationIntegerKey* POOLED_ARRAY();
+
+protected:
+    vtkDataArrayPool();
+    ~vtkDataArrayPool();
+
+    // Moves the arrays of the evicted steps nobody references into the free list
+    void HarvestRecycledObjects();
+
+    int MaxFreeArrays;
+    vtkTypeInt64 NumberOfHits;
+    vtkTypeInt64 NumberOfMisses;
+    vtkTypeInt64 RecycledBytes;
+
+    vtkDataArrayPoolInternals* Internals;
+
+private:
+    vtkDataArrayPool( const vtkDataArrayPool& );  // Not implemented.
+    void operator=( const vtkDataArrayPool& );  // Not implemented.
+};
+
+#endif	// #ifndef __VTKDATAARRAYPOOL_H__
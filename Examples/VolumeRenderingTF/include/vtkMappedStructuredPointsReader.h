@@ -0,0 +1,93 @@
+/*==============================================================================
+
+  Library: MSVTK
+
+  Copyright (c) Computational Image and Simulation Technologies in Biomedicine (CISTIB),
+                Universitat Pompeu Fabra (UPF), Barcelona, Spain
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#ifndef __VTKMAPPEDSTRUCTUREDPOINTSREADER_H__
+#define __VTKMAPPEDSTRUCTUREDPOINTSREADER_H__
+
+#include <vtkStructuredPointsReader.h>
+
+class vtkInformationObjectBaseKey;
+class vtkDataArrayPool;
+
+// Description:
+// Legacy structured points reader that memory maps the voxels of binary
+// files instead of parsing them into new scalars. The scalars array points
+// into the mapping, so the pages are only read when something touches them,
+// usually the volume mapper uploading the texture. The mapping is released
+// with the array.
+// Only files holding just the point scalars are mapped, and only when the
+// voxels can be used as they are stored: the legacy format is big endian,
+// so on little endian hosts this means one byte voxels. With an ArrayPool,
+// the voxels that can not be mapped are copied and swapped into recycled
+// arrays. Any other file is read by vtkStructuredPointsReader.
+class vtkMappedStructuredPointsReader : public vtkStructuredPointsReader
+{
+public:
+    static vtkMappedStructuredPointsReader *New();
+    vtkTypeMacro( vtkMappedStructuredPointsReader, vtkStructuredPointsReader );
+    void PrintSelf( ostream& os, vtkIndent indent );
+
+    // Description:
+    // Enable/disable the memory mapping of the voxels. On by default.
+    vtkSetMacro(MemoryMapping, int);
+    vtkGetMacro(MemoryMapping, int);
+    vtkBooleanMacro(MemoryMapping, int);
+
+    // Description:
+    // Pool the scalars that can not be mapped are acquired from. None by default.
+    virtual void SetArrayPool( vtkDataArrayPool* );
+    vtkGetObjectMacro(ArrayPool, vtkDataArrayPool);
+
+    // Description:
+    // Whether the scalars of the last read were mapped from the file
+    vtkGetMacro(ScalarsMapped, int);
+
+    // Description:
+    // Key set in the information of mapped arrays, holding the mapping
+    static vtkInformationObjectBaseKey* MAPPED_FILE_REGION();
+
+    // Description:
+    // Hint the system to start reading the given file in the background,
+    // so the next time step is in memory when it is requested
+    static void PrefetchFile( const char* fileName );
+
+protected:
+    vtkMappedStructuredPointsReader();
+    virtual ~vtkMappedStructuredPointsReader();
+
+    virtual int RequestData( vtkInformation*, vtkInformationVector**,
+                             vtkInformationVector* );
+
+    // Maps the scalars of the file into the output, or copies them into a
+    // pooled array. Returns false if the file has to be read by the superclass,
+    // leaving the output untouched
+    bool ReadBinaryScalars( vtkInformationVector* outputVector );
+
+    int MemoryMapping;
+    int ScalarsMapped;
+    vtkDataArrayPool* ArrayPool;
+
+private:
+    vtkMappedStructuredPointsReader( const vtkMappedStructuredPointsReader& );  // Not implemented.
+    void operator=( const vtkMappedStructuredPointsReader& );  // Not implemented.
+};
+
+#endif	// #ifndef __VTKMAPPEDSTRUCTUREDPOINTSREADER_H__
@@ -30,6 +30,7 @@
 class vtkStdString;
 class vtkStringArray;
 class vtkDataReader;
+class vtkDataArrayPool;
 
 class vtkMultipleDataReader : public vtkTemporalDataSetAlgorithm
 {
@@ -60,18 +61,83 @@ public:
     vtkGetMacro(TimeStepWrap, int);
     vtkBooleanMacro(TimeStepWrap, int);
 
+    // Description:
+    // Series descriptor with the time of every file, for instance the cardiac
+    // phase in ms. Every non empty line not starting with '#' is either a time
+    // value, given in the same order as the files, or a file name followed by
+    // its time. When not set, a DefaultTimeDescriptorName file in the directory
+    // of the first file is used if present. Without descriptor the time of
+    // every step is its index.
+    vtkSetStringMacro(TimeDescriptorFileName);
+    vtkGetStringMacro(TimeDescriptorFileName);
+    static const char* DefaultTimeDescriptorName;
+
+    // Description:
+    // Index of the file holding the given time, that is the last file whose
+    // time is not greater than it, wrapping if TimeStepWrap is set. Returns -1
+    // if there is no such file.
+    int GetFileIndexForTime( double time );
+
     // Description:
     // Set/Get the time steps the user wants to load
     void SetRequestedTimesTeps( double* timeSteps, int numTimeSteps );
     double* GetRequestedTimesTeps();
 
+    // Description:
+    // Maximum number of threads decoding the requested time steps. Every step
+    // is read by its own reader instance. Defaults to the vtkMultiThreader
+    // global default number of threads.
+    vtkSetClampMacro(MaxDecodeThreads, int, 1, VTK_INT_MAX);
+    vtkGetMacro(MaxDecodeThreads, int);
+
+    // Description:
+    // Pool of arrays the concrete readers decode into. Give it to the temporal
+    // cache downstream so the arrays of the steps it evicts are reused.
+    vtkGetObjectMacro(ArrayPool, vtkDataArrayPool);
+
+    // Description:
+    // Abandon the time steps being decoded, if any. Can be called from another
+    // thread when a newer request supersedes the current one. The abandoned
+    // update leaves the output empty, without DATA_TIME_STEPS, and the reader
+    // will execute again on next update.
+    // SetRequestedTimesTeps also cancels the batch in progress.
+    void CancelPendingTimeSteps();
+
     // Description:
     // Read the meta information from the list of files in the directory
     virtual int ReadMetaData( vtkInformation* );
 
+    // Description:
+    // Policies to check that all the files of a series hold the same dataset type.
+    // CheckAllFiles sniffs the header of every file, spreading the work among
+    // threads. TrustFirstFile only sniffs the first file and assumes the rest of
+    // the series matches it.
+    enum SeriesTypeCheckPolicies
+    {
+        CheckAllFiles = 0,
+        TrustFirstFile
+    };
+    vtkSetClampMacro(SeriesTypeCheckPolicy, int, CheckAllFiles, TrustFirstFile);
+    vtkGetMacro(SeriesTypeCheckPolicy, int);
+    void SetSeriesTypeCheckPolicyToCheckAllFiles()
+        { this->SetSeriesTypeCheckPolicy( CheckAllFiles ); }
+    void SetSeriesTypeCheckPolicyToTrustFirstFile()
+        { this->SetSeriesTypeCheckPolicy( TrustFirstFile ); }
+
+    // Description:
+    // GetDataObjectType parses the header of the file through a vtkDataReader.
+    // SniffDataObjectType only reads the first bytes of the file and caches the
+    // result by path, modification time and size, so asking again for an
+    // unchanged file costs a stat. GetSeriesDataObjectType sniffs following
+    // the SeriesTypeCheckPolicy and returns -1 if the types differ.
     int GetDataObjectType( const vtkStdString& fileName );
+    int SniffDataObjectType( const vtkStdString& fileName );
     int GetSeriesDataObjectType( vtkStringArray* series );
 
+    // Description:
+    // Forget the types sniffed so far. The cache is shared by all the readers.
+    static void ClearSniffedDataObjectTypes();
+
     void SetFileNames( vtkStringArray* fileNames );
     vtkStringArray* GetFileNames();
 
@@ -97,6 +163,9 @@ protected:
     // Get a concrete instance of the reader
     virtual vtkDataReader* GetConcreteReaderInstance();
 
+    // Fills TimeStepValues from the series descriptor, if any
+    bool ReadTimeDescriptor();
+
     // Sets in the output data of type vtkTemporalDataSet the time step data read from single file
     virtual void SetOutputTimeStep( vtkDataReader* pDataReader, vtkTemporalDataSet *outputData, int timeStep );
 
@@ -114,6 +183,17 @@ protected:
     int NumRequestedTimeSteps;
     int DataObjectType;
     int NumAvailableTimeSteps;
+    int SeriesTypeCheckPolicy;
+    int MaxDecodeThreads;
+    // Bumped every time the batch being decoded is superseded, only accessed
+    // through the msvAtomic operations
+    volatile long DecodeGeneration;
+    char* TimeDescriptorFileName;
+    // Time of every file, empty when the series has no descriptor
+    std::vector<double> TimeStepValues;
+    // File read for every time step of the current output
+    std::vector<int> LoadedFileIndices;
+    vtkDataArrayPool* ArrayPool;
 
 };
 
@@ -42,11 +42,28 @@ public:
     vtkTemporalDataSet* GetOutput( int idx );
     vtkTemporalDataSet* GetOutput();
 
+    // Description:
+    // Memory map the voxels of binary files instead of reading them, see
+    // vtkMappedStructuredPointsReader. On by default.
+    vtkSetMacro(MemoryMapping, int);
+    vtkGetMacro(MemoryMapping, int);
+    vtkBooleanMacro(MemoryMapping, int);
+
+    // Description:
+    // After every read, hint the system to load the file of the time step
+    // following the last one requested. Off by default.
+    vtkSetMacro(PrefetchNextTimeStep, int);
+    vtkGetMacro(PrefetchNextTimeStep, int);
+    vtkBooleanMacro(PrefetchNextTimeStep, int);
+
 protected:
     vtkMultipleStructuredPointsReader();
     virtual ~vtkMultipleStructuredPointsReader();
 
 
+    virtual int RequestData( vtkInformation*, vtkInformationVector**,
+                             vtkInformationVector* );
+
     virtual vtkDataReader* GetConcreteReaderInstance();
 
     virtual void SetOutputTimeStep( vtkDataReader* pDataReader, vtkTemporalDataSet *outputData, int timeStep );
@@ -55,6 +72,9 @@ private:
     vtkMultipleStructuredPointsReader( const vtkMultipleStructuredPointsReader& );  // Not implemented.
     void operator=( const vtkMultipleStructuredPointsReader& );  // Not implemented.
 
+    int MemoryMapping;
+    int PrefetchNextTimeStep;
+
 private:
 
 };
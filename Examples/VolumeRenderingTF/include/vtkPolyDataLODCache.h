@@ -0,0 +1,121 @@
+/*==============================================================================
+
+  Library: MSVTK
+
+  Copyright (c) Computational Image and Simulation Technologies in Biomedicine (CISTIB),
+                Universitat Pompeu Fabra (UPF), Barcelona, Spain
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#ifndef __VTKPOLYDATALODCACHE_H__
+#define __VTKPOLYDATALODCACHE_H__
+
+#include <vtkObject.h>
+#include <vtkSmartPointer.h>
+
+class vtkPolyData;
+class vtkPolyDataLODCacheInternals;
+
+// Description:
+// Decimated versions of the time steps of a polydata series, kept per step
+// until ReleaseLevels, so a step is decimated once while the loader holds it. BuildLevels clusters the
+// vertices of a step with vtkQuadricClustering into NumberOfLevels levels,
+// from the finest to the coarsest, each on a grid with half the divisions of
+// the previous one. Levels that would not at least halve the points of the
+// previous one are not kept, so small steps get fewer levels or none.
+// The levels keep the point and cell data of the step, so they are colored
+// like it: the normals are recomputed, every other point array is averaged
+// over the input points closest to each level point, and every level cell
+// takes the data of one of the cells it merges. Thread safe: the levels are
+// built by the loader threads while the entity reads them.
+class vtkPolyDataLODCache : public vtkObject
+{
+public:
+    static vtkPolyDataLODCache *New();
+    vtkTypeMacro( vtkPolyDataLODCache, vtkObject );
+    void PrintSelf( ostream& os, vtkIndent indent );
+
+    // Description:
+    // Number of decimated levels built for every step, up to 8. 2 by default.
+    // Changing it clears the cache
+    void SetNumberOfLevels( int numberOfLevels );
+    int GetNumberOfLevels();
+
+    // Description:
+    // Divisions of the clustering grid of the finest level along the longest
+    // side of the bounds of a step, at least 2. 64 by default. Changing it
+    // clears the cache
+    void SetNumberOfDivisions( int numberOfDivisions );
+    int GetNumberOfDivisions();
+
+    // Description:
+    // Decimates polyData into the levels of timeStep, unless they are cached.
+    // Returns whether they were built. polyData is only read, but not while
+    // another thread updates it
+    bool BuildLevels( int timeStep, vtkPolyData* polyData );
+
+    // Description:
+    // Whether the levels of timeStep are cached, and how many were kept
+    bool HasLevels( int timeStep );
+    int GetNumberOfBuiltLevels( int timeStep );
+
+    // Description:
+    // A level of timeStep, 0 being the finest, or null if it was not built.
+    // The levels are never modified once built
+    vtkSmartPointer<vtkPolyData> GetLevel( int timeStep, int level );
+
+    // Description:
+    // Release the levels of timeStep, usually when it leaves the window of
+    // the loader. Its next BuildLevels decimates it again
+    void ReleaseLevels( int timeStep );
+
+    // Description:
+    // Release the levels of every step
+    void Clear();
+
+    // Description:
+    // Statistics: steps decimated, and builds skipped because the step was
+    // cached
+    vtkGetMacro(NumberOfBuiltSteps, int);
+    vtkGetMacro(NumberOfHits, int);
+    void ResetStatistics();
+
+protected:
+    vtkPolyDataLODCache();
+    ~vtkPolyDataLODCache();
+
+    // Decimates polyData on a grid with numberOfDivisions along its longest side
+    vtkPolyData* Decimate( vtkPolyData* polyData, int numberOfDivisions );
+
+    // True if polyData has point arrays other than its normals
+    bool HasPointDataToResample( vtkPolyData* polyData );
+
+    // Fills the point data of level, clustered from input, with the average
+    // of the input points closest to each of its points. Normals excluded
+    void ResamplePointData( vtkPolyData* input, vtkPolyData* level );
+
+    int NumberOfLevels;
+    int NumberOfDivisions;
+    int NumberOfBuiltSteps;
+    int NumberOfHits;
+
+    vtkPolyDataLODCacheInternals* Internals;
+
+private:
+    vtkPolyDataLODCache( const vtkPolyDataLODCache& );  // Not implemented.
+    void operator=( const vtkPolyDataLODCache& );  // Not implemented.
+};
+
+#endif	// #ifndef __VTKPOLYDATALODCACHE_H__
@@ -24,9 +24,13 @@
 #define __VTKTEMPORALDATASETTIMESTEPPROVIDER_H__
 
 #include "vtkTemporalDataSetCache.h"
+#include <vtkSmartPointer.h>
+#include <vtkDataObject.h>
 
 #include <vector>
 
+class vtkDataArrayPool;
+
 class vtkTemporalDataSetTimeStepProvider : public vtkTemporalDataSetCache
 {
 public:
@@ -56,6 +60,24 @@ public:
     vtkGetMacro(TimeStepWrap, int);
     vtkBooleanMacro(TimeStepWrap, int);
 
+    // Description:
+    // Pool the evicted time steps are handed to, usually the one of the
+    // reader upstream. None by default.
+    virtual void SetArrayPool( vtkDataArrayPool* );
+    vtkGetObjectMacro(ArrayPool, vtkDataArrayPool);
+
+    // Description:
+    // Number of time steps requested upstream by the last update. Once the
+    // window is full, sliding it by one step requests a single time step.
+    vtkGetMacro(LastNumberOfRequestedTimeSteps, int);
+
+    // Description:
+    // Source indices of the steps that left the window in the last update.
+    // Whatever is kept per step downstream, such as decimated levels, can be
+    // released along with them
+    int GetNumberOfEvictedTimeSteps() const;
+    int GetEvictedTimeStep( int index ) const;
+
 
 protected:
     vtkTemporalDataSetTimeStepProvider();
@@ -64,6 +86,41 @@ protected:
     int NextTimeStep;
     int SourceMaxAvailableTimeSteps;
     int TimeStepWrap;
+    // Time of every step published by the source, NextTimeStep indexes it
+    std::vector<double> SourceTimeSteps;
+    int LastNumberOfRequestedTimeSteps;
+    vtkDataArrayPool* ArrayPool;
+
+    // Description:
+    // Sliding window over the source steps NextTimeStep .. NextTimeStep+CacheSize-1,
+    // kept in a ring. The step at window position k lives in slot
+    // ( WindowHead + k ) % CacheSize, so sliding the window by one only moves
+    // the head: the slot of the step that left receives the incoming one.
+    struct WindowSlot
+    {
+        int SourceIndex;
+        double Time;
+        vtkSmartPointer<vtkDataObject> Data;
+    };
+    std::vector<WindowSlot> Window;
+    int WindowHead;
+    int WindowFirstStep;
+    // Source index and time of every window position, reused between updates
+    std::vector<int> WindowSourceIndices;
+    std::vector<double> WindowTimes;
+    std::vector<double> RequestedTimes;
+    std::vector<int> EvictedSourceIndices;
+
+    // Description:
+    // Computes the window positions for NextTimeStep and CacheSize and moves the
+    // ring head accordingly
+    void UpdateWindow();
+    int GetWindowSlot( int windowPosition ) const;
+
+    // Description:
+    // Hands the data of a slot whose step left the window to the array pool
+    // and records the step as evicted
+    void EvictSlot( WindowSlot& slot );
 
     virtual int RequestUpdateExtent(vtkInformation*, vtkInformationVector** ,
                                   vtkInformationVector* );
@@ -71,6 +128,9 @@ protected:
     virtual int RequestInformation( vtkInformation*, vtkInformationVector**,
       vtkInformationVector* );
 
+    virtual int RequestData( vtkInformation*, vtkInformationVector**,
+      vtkInformationVector* );
+
     virtual int FillOutputPortInformation(int port, vtkInformation* info);
 
 private:
@@ -51,6 +51,22 @@ public:
     static vtkThreadSafeRenderWindow* New();
     virtual void PrintSelf( ostream& os, vtkIndent indent );
 
+    // Description:
+    // Getters of the window state share a read/write lock with Render, so they
+    // never wait for a frame to finish. Frame buffer readbacks and buffer size
+    // queries touch the GL context and take the lock exclusively, after the
+    // frame. Setters, AddRenderer and RemoveRenderer are queued and
+    // applied in order at the start of the next Render, or when
+    // ApplyPendingWrites is called. Window system setup is applied at once
+    void ApplyPendingWrites();
+    int GetNumberOfPendingWrites();
+
+    // Description:
+    // Lock acquisitions, contention and hold times since creation or the last
+    // reset
+    void GetLockCounters( msvLockCounters& counters );
+    void ResetLockCounters();
+
     // Description:
     // Add a renderer to the list of renderers.
     virtual void AddRenderer(vtkRenderer *);
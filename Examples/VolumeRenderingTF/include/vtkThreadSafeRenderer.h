@@ -39,6 +39,35 @@ public:
     static vtkThreadSafeRenderer* New();
     virtual void PrintSelf( ostream& os, vtkIndent indent );
 
+    // Description:
+    // Getters of the renderer state share a read/write lock with Render, so
+    // they never wait for a frame to finish. GetZ, ComputeVisiblePropBounds,
+    // picking and the coordinate conversions touch the GL context or the
+    // pipeline and take the lock exclusively, after the frame. Setters and
+    // the methods that change the scene (adding props, lights, resetting the
+    // camera...) are queued and applied in order at the start of the next
+    // Render, or when ApplyPendingWrites is called.
+    // The collections returned by GetActors and GetVolumes are the ones
+    // published with the last applied writes
+    void ApplyPendingWrites();
+    int GetNumberOfPendingWrites();
+
+    // Description:
+    // Scene update API for any thread, loaders included. Both go through the
+    // same lock-free queue as the writes above, so they never wait for the
+    // render, and the render applies everything recorded before the frame
+    // starts in one go. SwapViewProp removes oldProp and adds newProp in a
+    // single step, either may be null. QueueSceneUpdate takes ownership of
+    // a command that hands data to the scene, e.g. the new input of a mapper
+    void SwapViewProp( vtkProp* oldProp, vtkProp* newProp );
+    void QueueSceneUpdate( msvDeferredCommand* command );
+
+    // Description:
+    // Lock acquisitions, contention and hold times since creation or the last
+    // reset
+    void GetLockCounters( msvLockCounters& counters );
+    void ResetLockCounters();
+
     // Description:
     // Add/Remove different types of props to the renderer.
     // These methods are all synonyms to AddViewProp and RemoveViewProp.
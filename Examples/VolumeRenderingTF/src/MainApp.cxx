@@ -48,6 +48,7 @@
 #include <vtkCommand.h>
 
 #include <vtkRenderWindowInteractor.h>
+#include <vtkInteractorObserver.h>
 #include <vtkErrorCode.h>
 #include <vtkObjectFactory.h>
 #include <vtkTimerLog.h>
@@ -70,10 +71,13 @@
 #include "vtkThreadSafeRenderer.h"
 #include "vtkThreadSafeRenderWindow.h"
 #include "vtkThreadSafeRenderWindowInteractor.h"
+#include "msvFrameTrace.h"
 
 
 #include <string>
 #include <ios>
+#include <iomanip>
+#include <algorithm>
 
 using namespace std;
 
@@ -81,6 +85,10 @@ MSVTK_IMPLEMENT_APP( MainApp )
 
 #define USE_MAIN_FRAME 0
 
+// Entities advance at this period; renders only happen when something changed
+static const long TickPeriodMillis = 40;
+static const double StatisticsReportPeriod = 5.0;
+
 class ExitCommand : public vtkCommand
 {
 public:
@@ -109,6 +117,71 @@ void ExitCommand::Execute( vtkObject *caller, unsigned long eventId, void *callD
     msvGetApp().Exit();
 }
 
+// Traces the frames of the render window: each one starts a frame of the
+// trace, the renderer draws in the Render zone and the Swap zone lasts from
+// its end to the end of the window render, when the buffers are swapped
+class FrameTraceCommand : public vtkCommand
+{
+public:
+    static FrameTraceCommand* New();
+
+    virtual void Execute( vtkObject *caller, unsigned long eventId, void *callData );
+protected:
+
+    FrameTraceCommand();
+    virtual ~FrameTraceCommand();
+
+    double RenderStartTime;
+    double SwapStartTime;
+};
+
+FrameTraceCommand::FrameTraceCommand()
+: RenderStartTime( -1.0 )
+, SwapStartTime( -1.0 )
+{}
+
+FrameTraceCommand::~FrameTraceCommand()
+{}
+
+FrameTraceCommand* FrameTraceCommand::New()
+{
+    return new FrameTraceCommand;
+}
+
+void FrameTraceCommand::Execute( vtkObject *caller, unsigned long eventId, void *callData )
+{
+    if( !msvFrameTrace::GetEnabled() )
+    {
+        this->RenderStartTime = -1.0;
+        this->SwapStartTime = -1.0;
+        return;
+    }
+
+    double currentTime = vtkTimerLog::GetUniversalTime();
+    if( vtkRenderWindow::SafeDownCast( caller ) )
+    {
+        if( eventId == vtkCommand::StartEvent )
+        {
+            msvFrameTrace::NextFrame();
+        }
+        else if( this->SwapStartTime >= 0.0 )
+        {
+            msvFrameTrace::AddZone( "Swap", this->SwapStartTime, currentTime );
+            this->SwapStartTime = -1.0;
+        }
+    }
+    else if( eventId == vtkCommand::StartEvent )
+    {
+        this->RenderStartTime = currentTime;
+    }
+    else if( this->RenderStartTime >= 0.0 )
+    {
+        msvFrameTrace::AddZone( "Render", this->RenderStartTime, currentTime );
+        this->RenderStartTime = -1.0;
+        this->SwapStartTime = currentTime;
+    }
+}
+
 
 MainApp::MainApp()
 : m_VolumeReaderSP( 0 )
@@ -125,6 +198,7 @@ MainApp::MainApp()
 , m_AnimationSceneSP( 0 )
 , m_pmsvEntityMgr( 0 )
 , m_pmsvObjectFactory( 0 )
+, m_LastStatisticsReportTime( 0.0 )
 {
 
 }
@@ -145,6 +219,7 @@ MainApp::MainApp( int &argc, char **argv )
 , m_AnimationSceneSP( 0 )
 , m_pmsvEntityMgr( 0 )
 , m_pmsvObjectFactory( 0 )
+, m_LastStatisticsReportTime( 0.0 )
 {
 }
 
@@ -185,12 +260,25 @@ bool MainApp::OnInit()
     m_pRenderWindowSP->SetMultiSamples( 0 );
     m_pRenderWindowSP->AddRenderer( m_pRendererSP );
 
+    msvFrameTrace::SetThreadName( "Main" );
+    AddFrameTraceObservers();
+#if( TRACE_FRAMES )
+    msvFrameTrace::EnableOn();
+#endif
 
     m_pmsvEntityMgr = msvEntityMgr::New();
 
+#if( USE_RENDER_THREAD )
+    CreateRenderThread();
     CreateSceneData();
+    // From here on only the render thread renders the window
+    m_RenderThreadSP->Start();
+#else
+    CreateSceneData();
+    CreateFrameScheduler();
 
     m_pRenderWindowSP->Render();
+#endif
 
     m_ExitCommand = 0;
     m_ExitCommand = ExitCommand::New();
@@ -203,6 +291,18 @@ bool MainApp::OnInit()
 
 int MainApp::OnExit()
 {
+    if( m_RenderThreadSP )
+    {
+        m_RenderThreadSP->Stop();
+        m_RenderThreadSP = 0;
+    }
+    m_FrameSchedulerSP = 0;
+
+#if( TRACE_FRAMES )
+    msvFrameTrace::EnableOff();
+    ReportFrameTrace();
+#endif
+
     if( m_ExitCommand )
     {
         m_ExitCommand->Delete();
@@ -227,7 +327,7 @@ int MainApp::OnExit()
 
 void MainApp::OnIdle()
 {
-    if( m_ElapsedTimeMillis > 40 )
+    if( m_ElapsedTimeMillis > TickPeriodMillis )
     {
         if( m_pmsvEntityMgr )
         {
@@ -237,7 +337,116 @@ void MainApp::OnIdle()
 
         //cout << setw( 5 ) << fixed << setprecision( 3 ) << right << vtkTimerLog::GetCPUTime() << ": Tick" << endl;
     }
-    m_pRenderWindowSP->Render();
+
+#if( USE_RENDER_THREAD )
+    // The render thread draws at its own cadence; here the interaction camera
+    // only catches up with the resets made by the scene updates
+    m_RenderThreadSP->SyncWatchedCamera();
+    m_IdleWaitMillis = max( TickPeriodMillis + 1 - m_ElapsedTimeMillis, 0L );
+#else
+    // Time step swaps, interaction and property changes dirty the scheduler
+    if( m_FrameSchedulerSP->IsFrameDue( vtkTimerLog::GetUniversalTime() ) )
+    {
+        m_pRenderWindowSP->Render();
+    }
+
+    double currentTime = vtkTimerLog::GetUniversalTime();
+#if( REPORT_FRAME_STATISTICS )
+    if( currentTime - m_LastStatisticsReportTime > StatisticsReportPeriod )
+    {
+        cout << "Frames rendered: " << m_FrameSchedulerSP->GetNumberOfRenderedFrames()
+             << ", idle checks skipped: " << m_FrameSchedulerSP->GetNumberOfSkippedChecks()
+             << "/" << m_FrameSchedulerSP->GetNumberOfIdleChecks()
+             << ", CPU usage: " << fixed << setprecision( 1 ) << m_FrameSchedulerSP->GetCPUUsage() * 100.0 << "%" << endl;
+        m_FrameSchedulerSP->ResetStatistics();
+        m_LastStatisticsReportTime = currentTime;
+    }
+#endif
+
+    // Nothing else to do until the next tick or the next frame that may be due
+    long timeToNextTick = TickPeriodMillis + 1 - m_ElapsedTimeMillis;
+    long timeToNextFrame = static_cast<long>( m_FrameSchedulerSP->GetTimeToNextFrame( currentTime ) * 1000.0 );
+    m_IdleWaitMillis = min( timeToNextTick, timeToNextFrame );
+    if( m_IdleWaitMillis < 0 )
+    {
+        m_IdleWaitMillis = 0;
+    }
+#endif
+}
+
+void MainApp::CreateRenderThread()
+{
+    m_RenderThreadSP = msvRenderThreadSP::New();
+    m_RenderThreadSP->SetRenderWindow( m_pRenderWindowSP );
+    m_RenderThreadSP->SetRenderer( m_pRendererSP );
+
+    // The interactor style moves the camera of a renderer that is never
+    // drawn, and the render thread follows it. The interactor must not
+    // render from this thread
+    m_InteractionRendererSP = vtkRendererSP::New();
+    m_InteractionRendererSP->GetActiveCamera()->DeepCopy( m_pRendererSP->GetActiveCamera() );
+    m_RenderWindowInteractorSP->GetInteractorStyle()->SetDefaultRenderer( m_InteractionRendererSP );
+    m_RenderWindowInteractorSP->EnableRenderOff();
+    m_RenderThreadSP->WatchCamera( m_InteractionRendererSP->GetActiveCamera() );
+
+    // Loaded time steps, props and camera resets reach the scene between
+    // two frames of the render thread
+    m_pmsvEntityMgr->SetSceneUpdateQueue( m_RenderThreadSP->GetSceneUpdates() );
+}
+
+void MainApp::CreateFrameScheduler()
+{
+    m_FrameSchedulerSP = msvFrameSchedulerSP::New();
+    m_FrameSchedulerSP->SetRenderTarget( m_pRenderWindowSP );
+    // Size changes of the window
+    m_FrameSchedulerSP->Watch( m_pRenderWindowSP );
+    m_FrameSchedulerSP->Watch( m_RenderWindowInteractorSP, vtkCommand::ConfigureEvent );
+    m_FrameSchedulerSP->Watch( m_RenderWindowInteractorSP, vtkCommand::ExposeEvent );
+    // Props added or removed, and the camera moved by the interactor style
+    m_FrameSchedulerSP->Watch( m_pRendererSP );
+    m_FrameSchedulerSP->Watch( m_pRendererSP->GetActiveCamera() );
+    if( m_pmsvEntityMgr != 0 )
+    {
+        // Entity time step swaps
+        m_FrameSchedulerSP->Watch( m_pmsvEntityMgr );
+        m_FrameSchedulerSP->Watch( m_pmsvEntityMgr->GetVolumeProperty() );
+    }
+    m_LastStatisticsReportTime = vtkTimerLog::GetUniversalTime();
+}
+
+void MainApp::AddFrameTraceObservers()
+{
+    // Whichever thread renders records the zones
+    FrameTraceCommand* frameTraceCommand = FrameTraceCommand::New();
+    m_pRenderWindowSP->AddObserver( vtkCommand::StartEvent, frameTraceCommand );
+    m_pRenderWindowSP->AddObserver( vtkCommand::EndEvent, frameTraceCommand );
+    m_pRendererSP->AddObserver( vtkCommand::StartEvent, frameTraceCommand );
+    m_pRendererSP->AddObserver( vtkCommand::EndEvent, frameTraceCommand );
+    frameTraceCommand->Delete();
+}
+
+void MainApp::ReportFrameTrace()
+{
+    const char* zoneNames[] = { "Tick", "AssignTimeStep", "LockWait", "ApplyPostedChanges", "Render", "Swap" };
+    const int numberOfZoneNames = sizeof( zoneNames ) / sizeof( zoneNames[0] );
+
+    cout << "Frames traced: " << msvFrameTrace::GetFrameNumber() << endl;
+    for( int index = 0; index < numberOfZoneNames; index++ )
+    {
+        msvTraceHistogram histogram;
+        if( msvFrameTrace::GetHistogram( zoneNames[index], histogram ) )
+        {
+            cout << zoneNames[index] << ": " << histogram.Count << " zones, mean "
+                 << fixed << setprecision( 3 ) << histogram.Mean * 1000.0 << " ms, median "
+                 << histogram.Median * 1000.0 << " ms, 99% " << histogram.Percentile99 * 1000.0
+                 << " ms, max " << histogram.Maximum * 1000.0 << " ms" << endl;
+        }
+    }
+
+    if( !msvFrameTrace::WriteChromeTrace( "FrameTrace.json" ) )
+    {
+        cout << "Could not write FrameTrace.json" << endl;
+    }
 }
 
 string MainApp::GetResouceFolderPath()
@@ -0,0 +1,128 @@
+/*==============================================================================
+
+  Library: MSVTK
+
+  Copyright (c) Computational Image and Simulation Technologies in Biomedicine (CISTIB),
+                Universitat Pompeu Fabra (UPF), Barcelona, Spain
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#include "msvDeferredCommandQueue.h"
+
+#include "msvAtomic.h"
+
+#include <vtkObjectFactory.h>
+
+using namespace std;
+
+vtkStandardNewMacro( msvDeferredCommandQueue );
+
+msvDeferredCommandQueue::msvDeferredCommandQueue()
+: Head( 0 )
+, NumberOfPendingCommands( 0 )
+, NumberOfAppliedCommands( 0 )
+{
+}
+
+msvDeferredCommandQueue::~msvDeferredCommandQueue()
+{
+    Clear();
+}
+
+void msvDeferredCommandQueue::Push( msvDeferredCommand* command )
+{
+    if( !command )
+    {
+        return;
+    }
+    msvAtomicAdd( &this->NumberOfPendingCommands, 1 );
+    // A stale first guess only costs one more round
+    void* head = this->Head;
+    for( ;; )
+    {
+        command->NextCommand = static_cast<msvDeferredCommand*>( head );
+        void* previousHead = msvAtomicCompareAndSwapPointer( &this->Head, head, command );
+        if( previousHead == head )
+        {
+            break;
+        }
+        head = previousHead;
+    }
+}
+
+msvDeferredCommand* msvDeferredCommandQueue::TakeAll()
+{
+    msvDeferredCommand* newest = static_cast<msvDeferredCommand*>( msvAtomicExchangePointer( &this->Head, 0 ) );
+
+    // The stack holds them newest first
+    msvDeferredCommand* oldest = 0;
+    while( newest )
+    {
+        msvDeferredCommand* next = newest->NextCommand;
+        newest->NextCommand = oldest;
+        oldest = newest;
+        newest = next;
+    }
+    return oldest;
+}
+
+int msvDeferredCommandQueue::ApplyAll()
+{
+    msvDeferredCommand* command = TakeAll();
+    long numberOfCommands = 0;
+    while( command )
+    {
+        msvDeferredCommand* next = command->NextCommand;
+        command->Execute();
+        delete command;
+        command = next;
+        ++numberOfCommands;
+    }
+    msvAtomicAdd( &this->NumberOfPendingCommands, -numberOfCommands );
+    msvAtomicAdd( &this->NumberOfAppliedCommands, numberOfCommands );
+
+    return static_cast<int>( numberOfCommands );
+}
+
+void msvDeferredCommandQueue::Clear()
+{
+    msvDeferredCommand* command = TakeAll();
+    long numberOfCommands = 0;
+    while( command )
+    {
+        msvDeferredCommand* next = command->NextCommand;
+        delete command;
+        command = next;
+        ++numberOfCommands;
+    }
+    msvAtomicAdd( &this->NumberOfPendingCommands, -numberOfCommands );
+}
+
+int msvDeferredCommandQueue::GetNumberOfPendingCommands()
+{
+    return static_cast<int>( msvAtomicLoad( &this->NumberOfPendingCommands ) );
+}
+
+unsigned long msvDeferredCommandQueue::GetNumberOfAppliedCommands()
+{
+    return static_cast<unsigned long>( msvAtomicLoad( &this->NumberOfAppliedCommands ) );
+}
+
+void msvDeferredCommandQueue::PrintSelf( ostream& os, vtkIndent indent )
+{
+    this->Superclass::PrintSelf( os, indent );
+    os << indent << "NumberOfPendingCommands: " << GetNumberOfPendingCommands() << endl;
+    os << indent << "NumberOfAppliedCommands: " << GetNumberOfAppliedCommands() << endl;
+}
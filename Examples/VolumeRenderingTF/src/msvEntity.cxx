@@ -22,6 +22,10 @@
 #include "msvEntity.h"
 
 #include "msvEntityMgr.h"
+#include "msvDeferredCommandQueue.h"
+#include "msvSceneCommands.h"
+#include "msvFrameTrace.h"
+#include "vtkPolyDataLODCache.h"
 
 #include <vtkObjectFactory.h>
 #include <vtkStructuredPoints.h>
@@ -29,6 +33,7 @@
 //#include <vtkRenderer.h>
 #include <vtkThreadSafeRenderer.h>
 #include <vtkActor.h>
+#include <vtkLODActor.h>
 #include <vtkVolumeProperty.h>
 #include <vtkVolume.h>
 #include <vtkGPUVolumeRayCastMapper.h>
@@ -37,10 +42,65 @@
 
 
 #include <vector>
+#include <algorithm>
 
 //using namespace std;
 using std::numeric_limits;
 
+// Hands a time step to the mapper: copies it into the staging data and makes
+// that the input, along with the levels of detail of the step. Deferred to
+// the start of a frame when the renderer queues scene updates, so the render
+// never sees a half-copied input, nor levels of another step
+class msvStageTimeStepCommand : public msvDeferredCommand
+{
+public:
+    msvStageTimeStepCommand( vtkAbstractMapper3D* mapper, vtkDataSet* stagingData, vtkDataSet* dataObject )
+    : Mapper( mapper )
+    , StagingData( stagingData )
+    , DataObject( dataObject )
+    {
+    }
+
+    // The mapper of a level of detail and its input. The levels are never
+    // modified, so they need no staging. A null level draws the step
+    void AddLevelOfDetail( vtkPolyDataMapper* mapper, vtkPolyData* level )
+    {
+        this->LevelMappers.push_back( mapper );
+        this->Levels.push_back( level );
+    }
+
+    virtual void Execute()
+    {
+        // Shallow: the arrays are shared with the loaded time step, the mapper
+        // uploads them once when it sees the new input
+        this->StagingData->ShallowCopy( this->DataObject );
+
+        vtkVolumeMapper* volumeMapper = vtkVolumeMapper::SafeDownCast( this->Mapper );
+        vtkPolyDataMapper* polyDataMapper = vtkPolyDataMapper::SafeDownCast( this->Mapper );
+        if( volumeMapper )
+        {
+            volumeMapper->SetInput( vtkStructuredPoints::SafeDownCast( this->StagingData ) );
+        }
+        else if( polyDataMapper )
+        {
+            polyDataMapper->SetInput( vtkPolyData::SafeDownCast( this->StagingData ) );
+        }
+
+        for( size_t indexLevel = 0; indexLevel < this->LevelMappers.size(); indexLevel++ )
+        {
+            vtkPolyData* level = this->Levels[indexLevel];
+            this->LevelMappers[indexLevel]->SetInput( level ? level : vtkPolyData::SafeDownCast( this->StagingData ) );
+        }
+    }
+
+private:
+    vtkSmartPointer<vtkAbstractMapper3D> Mapper;
+    vtkSmartPointer<vtkDataSet>         StagingData;
+    vtkSmartPointer<vtkDataSet>         DataObject;
+    std::vector< vtkSmartPointer<vtkPolyDataMapper> > LevelMappers;
+    std::vector< vtkSmartPointer<vtkPolyData> > Levels;
+};
+
 ////////////////////////////
 // Private Implementor class
 ////////////////////////////
@@ -74,6 +134,19 @@ public:
     // Set the provider of time steps
     void SetTimeStepProvider( vtkTemporalDataSetTimeStepProvider* timeStepProvider );
 
+    // Queue of the thread that renders, when it is not this one
+    void SetSceneUpdateQueue( msvDeferredCommandQueue* sceneUpdates );
+
+    // Volume property of the volume prop, usually shared with other entities
+    void SetVolumeProperty( vtkVolumeProperty* volumeProperty );
+    vtkVolumeProperty* GetVolumeProperty();
+
+    // Levels of detail of the polydata time steps
+    void SetNumberOfLevelsOfDetail( int numberOfLevels );
+    int GetNumberOfLevelsOfDetail();
+    void BuildLevelsOfDetail( vtkPolyData* dataObject, int timeStepNumber );
+    void ReleaseLevelsOfDetail( int timeStepNumber );
+
     // Updates having into account the elapsed time, in microseconds
     void Tick( long elapsedTime );
 
@@ -83,9 +156,15 @@ public:
     virtual void PrintSelf( ostream& os, vtkIndent indent );
 
 private:
-    void DeleteTimeStepData();
-    void ReplaceCurrentTimeStepData( vtkDataSet* newTimeStepData, vtkProp* newTimeStepProp,
-        vtkAbstractMapper3D* newtTimeStepMapper, vtkVolumeProperty* newTimeStepVolumeProperty );
+    // Swaps the prop and mapper, only when the entity gets its first time step
+    // or the kind of its data changes
+    void ReplaceRenderResources( vtkProp* newProp, vtkAbstractMapper3D* newMapper );
+    // Hands the time step to the mapper through the staging data it is not
+    // using, which becomes the front one, and its levels of detail to theirs
+    void StageTimeStepData( vtkDataSet* dataObject, int timeStepNumber );
+    // Applied at the start of the next frame by the render thread or a
+    // thread-safe renderer, at once otherwise
+    void SubmitSceneUpdate( msvDeferredCommand* command );
     void AddViewPropToRenderer( vtkProp* prop );
     void RemoveViewPropToRenderer( vtkProp* prop );
 
@@ -93,10 +172,28 @@ private:
 
     msvEntity*                          PublicInterface;
     vtkRenderer*                        AssignedRenderer;
-    vtkDataSet*                         CurrentTimeStepData;
-    vtkProp*                            CurrentTimeStepProp;
-    vtkAbstractMapper3D*                CurrentTimeStepMapper;
-    vtkVolumeProperty*                  CurrentTimeStepVolumeProperty;
+    // Not null when AssignedRenderer queues the scene updates
+    vtkThreadSafeRenderer*              AssignedThreadSafeRenderer;
+    // Not null when another thread renders AssignedRenderer
+    vtkSmartPointer<msvDeferredCommandQueue> SceneUpdates;
+    // Whether the prop was added to the renderer. Tracked here because a
+    // queued addition is not visible to HasViewProp until the next frame
+    bool                                PropInRenderer;
+    // Built once and kept for every time step, only their input changes
+    vtkSmartPointer<vtkProp>            CurrentTimeStepProp;
+    vtkSmartPointer<vtkAbstractMapper3D> CurrentTimeStepMapper;
+    vtkSmartPointer<vtkVolumeProperty>  VolumeProperty;
+    // Mapper inputs, alternated on every time step. They share the arrays of
+    // the loaded time steps but not their pipeline, so rendering never
+    // updates the loader pipeline, and the front one stays untouched while
+    // the next time step is staged
+    vtkSmartPointer<vtkDataSet>         StagingData[2];
+    int                                 FrontStagingData;
+    // Decimated versions of the polydata time steps, built by the loader
+    // threads, and the mappers of the vtkLODActor that draw them, finest
+    // first. No mappers when the prop is not a vtkLODActor
+    vtkSmartPointer<vtkPolyDataLODCache> LODCache;
+    std::vector< vtkSmartPointer<vtkPolyDataMapper> > LevelOfDetailMappers;
 
     bool                                FirstTimeShown;
     int                                 CurrentTimeStep;
@@ -116,10 +213,10 @@ private:
 msvEntityImpl::msvEntityImpl( msvEntity* publicInterface )
 : PublicInterface( publicInterface )
 , AssignedRenderer( 0 )
-, CurrentTimeStepData( 0 )
-, CurrentTimeStepProp( 0 )
-, CurrentTimeStepMapper( 0 )
-, CurrentTimeStepVolumeProperty( 0 )
+, AssignedThreadSafeRenderer( 0 )
+, PropInRenderer( false )
+, FrontStagingData( 0 )
+, LODCache( vtkSmartPointer<vtkPolyDataLODCache>::New() )
 , FirstTimeShown( false )
 , CurrentTimeStep( 0 )
 , AcumElapsedTime( 0 )
@@ -133,33 +230,9 @@ msvEntityImpl::~msvEntityImpl()
 {
     // First test if we have a renderer, and if so, if we have some
     // volume or actor added to it
-    if( this->AssignedRenderer && this->CurrentTimeStepData )
+    if( this->AssignedRenderer && this->PropInRenderer )
     {
-        if( this->AssignedRenderer->HasViewProp( this->CurrentTimeStepProp ) )
-        {
-            this->RemoveViewPropToRenderer( this->CurrentTimeStepProp );
-        }
-    }
-    DeleteTimeStepData();
-}
-
-void msvEntityImpl::DeleteTimeStepData()
-{
-    if( CurrentTimeStepData != 0 )
-    {
-        CurrentTimeStepData->Delete();
-    }
-    if( CurrentTimeStepProp != 0 )
-    {
-        CurrentTimeStepProp->Delete();
-    }
-    if( CurrentTimeStepMapper != 0 )
-    {
-        CurrentTimeStepMapper->Delete();
-    }
-    if( CurrentTimeStepVolumeProperty != 0 )
-    {
-        CurrentTimeStepVolumeProperty->Delete();
+        this->RemoveViewPropToRenderer( this->CurrentTimeStepProp );
     }
 }
 
@@ -171,39 +244,14 @@ void msvEntityImpl::SetEntityMgr( msvEntityMgr* entityMgr )
 
 void msvEntityImpl::AddDataObject( vtkStructuredPoints* dataObject )
 {
-    vtkStructuredPoints* dataObjectCopy = vtkStructuredPoints::New();
-    dataObjectCopy->DeepCopy( dataObject );
-    vtkVolumeMapper* volumeMapper = vtkGPUVolumeRayCastMapper::New();
-    volumeMapper->SetInput( dataObject );
-    vtkVolumeProperty* volumeProperty = vtkVolumeProperty::New();
-    vtkVolume* volume = vtkVolume::New();
-    volume->SetMapper( volumeMapper );
-    volume->SetProperty( volumeProperty );
-
-/*
-    this->VolumeProperties.push_back( volumeProperty );
-    this->Frames.push_back( dataObjectCopy );
-    this->Mappers.push_back( volumeMapper );
-    this->Props.push_back( volume );
-*/
-    //this->Modified();
+    // The render resources are shared by all the time steps, so adding one
+    // just stages it
+    this->SetCurrentTimeStepData( dataObject );
 }
 
 void msvEntityImpl::AddDataObject( vtkPolyData* dataObject )
 {
-    vtkPolyData* dataObjectCopy = vtkPolyData::New();
-    dataObjectCopy->DeepCopy( dataObject );
-    vtkPolyDataMapper* polyDataMapper = vtkPolyDataMapper::New();
-    polyDataMapper->SetInput( dataObject );
-    vtkActor* actor = vtkActor::New();
-    actor->SetMapper( polyDataMapper );
-
-/*
-    this->Frames.push_back( dataObjectCopy );
-    this->Mappers.push_back( polyDataMapper );
-    this->Props.push_back( actor );
-*/
-    //this->Modified();
+    this->SetCurrentTimeStepData( dataObject );
 }
 
 bool msvEntityImpl::HasAnyTimeStep()
@@ -214,6 +262,7 @@ bool msvEntityImpl::HasAnyTimeStep()
 void msvEntityImpl::SetRenderer( vtkThreadSafeRenderer* assignedRenderer )
 {
     this->AssignedRenderer = assignedRenderer;
+    this->AssignedThreadSafeRenderer = assignedRenderer;
 
     if( this->CurrentTimeStepProp )
     {
@@ -224,11 +273,12 @@ void msvEntityImpl::SetRenderer( vtkThreadSafeRenderer* assignedRenderer )
 void msvEntityImpl::SetRenderer( vtkRenderer* assignedRenderer )
 {
     this->AssignedRenderer = assignedRenderer;
+    vtkThreadSafeRenderer* tsr = dynamic_cast<vtkThreadSafeRenderer*>( this->AssignedRenderer );
+    this->AssignedThreadSafeRenderer = tsr;
 
     if( !this->CurrentTimeStepProp )
         return;
 
-    vtkThreadSafeRenderer* tsr = dynamic_cast<vtkThreadSafeRenderer*>( this->AssignedRenderer );
     if( tsr )
     {
         SetRenderer( tsr );
@@ -246,9 +296,86 @@ void msvEntityImpl::SetTimeStepProvider( vtkTemporalDataSetTimeStepProvider* tim
     this->TimeStepProvider = timeStepProvider;
 }
 
+void msvEntityImpl::SetSceneUpdateQueue( msvDeferredCommandQueue* sceneUpdates )
+{
+    this->SceneUpdates = sceneUpdates;
+}
+
+void msvEntityImpl::SetVolumeProperty( vtkVolumeProperty* volumeProperty )
+{
+    this->VolumeProperty = volumeProperty;
+
+    vtkVolume* volume = vtkVolume::SafeDownCast( this->CurrentTimeStepProp );
+    if( volume )
+    {
+        volume->SetProperty( this->GetVolumeProperty() );
+    }
+}
+
+vtkVolumeProperty* msvEntityImpl::GetVolumeProperty()
+{
+    if( !this->VolumeProperty )
+    {
+        this->VolumeProperty = vtkSmartPointer<vtkVolumeProperty>::New();
+    }
+
+    return this->VolumeProperty;
+}
+
+void msvEntityImpl::SetNumberOfLevelsOfDetail( int numberOfLevels )
+{
+    // The prop is rebuilt with the next time step
+    this->LODCache->SetNumberOfLevels( numberOfLevels );
+}
+
+int msvEntityImpl::GetNumberOfLevelsOfDetail()
+{
+    return this->LODCache->GetNumberOfLevels();
+}
+
+void msvEntityImpl::BuildLevelsOfDetail( vtkPolyData* dataObject, int timeStepNumber )
+{
+    // The cache is keyed by step, a step without number is always drawn at
+    // full resolution
+    if( timeStepNumber == numeric_limits<int>::min() )
+    {
+        return;
+    }
+
+    MSV_TRACE_ZONE( "BuildLevelsOfDetail" );
+    this->LODCache->BuildLevels( timeStepNumber, dataObject );
+}
+
+void msvEntityImpl::ReleaseLevelsOfDetail( int timeStepNumber )
+{
+    this->LODCache->ReleaseLevels( timeStepNumber );
+}
+
+void msvEntityImpl::SubmitSceneUpdate( msvDeferredCommand* command )
+{
+    if( this->SceneUpdates )
+    {
+        this->SceneUpdates->Push( command );
+    }
+    else if( this->AssignedThreadSafeRenderer )
+    {
+        this->AssignedThreadSafeRenderer->QueueSceneUpdate( command );
+    }
+    else
+    {
+        command->Execute();
+        delete command;
+    }
+}
+
 void msvEntityImpl::AddViewPropToRenderer( vtkProp* prop )
 {
-    if( vtkActor::SafeDownCast( prop ) != 0 )
+    this->PropInRenderer = true;
+    if( this->SceneUpdates )
+    {
+        this->SceneUpdates->Push( new msvSwapViewPropCommand( this->AssignedRenderer, 0, prop ) );
+    }
+    else if( vtkActor::SafeDownCast( prop ) != 0 )
     {
         this->AssignedRenderer->AddActor( prop );
     }
@@ -260,7 +387,12 @@ void msvEntityImpl::AddViewPropToRenderer( vtkProp* prop )
 
 void msvEntityImpl::RemoveViewPropToRenderer( vtkProp* prop )
 {
-    if( vtkActor::SafeDownCast( prop ) != 0 )
+    this->PropInRenderer = false;
+    if( this->SceneUpdates )
+    {
+        this->SceneUpdates->Push( new msvSwapViewPropCommand( this->AssignedRenderer, prop, 0 ) );
+    }
+    else if( vtkActor::SafeDownCast( prop ) != 0 )
     {
         this->AssignedRenderer->RemoveActor( prop );
     }
@@ -270,74 +402,133 @@ void msvEntityImpl::RemoveViewPropToRenderer( vtkProp* prop )
     }
 }
 
-void msvEntityImpl::ReplaceCurrentTimeStepData(
-    vtkDataSet* newTimeStepData, vtkProp* newTimeStepProp,
-    vtkAbstractMapper3D* newtTimeStepMapper, vtkVolumeProperty* newTimeStepVolumeProperty )
+void msvEntityImpl::ReplaceRenderResources( vtkProp* newProp, vtkAbstractMapper3D* newMapper )
 {
-    vtkDataSet* oldTimeStepData = this->CurrentTimeStepData;
-    vtkProp* oldTimeStepProp = this->CurrentTimeStepProp;
-    vtkAbstractMapper3D* oldTimeStepMapper = this->CurrentTimeStepMapper;
-    vtkVolumeProperty* oldTimeStepVolumeProperty = this->CurrentTimeStepVolumeProperty;
+    vtkSmartPointer<vtkProp> oldProp = this->CurrentTimeStepProp;
+    bool oldPropInRenderer = this->PropInRenderer;
 
-    this->CurrentTimeStepData = newTimeStepData;
-    this->CurrentTimeStepProp = newTimeStepProp;
-    this->CurrentTimeStepMapper = newtTimeStepMapper;
-    this->CurrentTimeStepVolumeProperty = newTimeStepVolumeProperty;
+    this->CurrentTimeStepProp = newProp;
+    this->CurrentTimeStepMapper = newMapper;
+    this->LevelOfDetailMappers.clear();
+    this->StagingData[0] = 0;
+    this->StagingData[1] = 0;
 
-    if( this->AssignedRenderer )
+    if( !this->AssignedRenderer )
     {
-        if( this->AssignedRenderer->HasViewProp( oldTimeStepProp ) )
-        {
-            this->RemoveViewPropToRenderer( oldTimeStepProp );
-        }
-        AddViewPropToRenderer( this->CurrentTimeStepProp );
+        return;
     }
-    if( oldTimeStepData != 0 )
+    // One step, so no frame shows both props or none
+    if( this->SceneUpdates )
     {
-        oldTimeStepData->Delete();
+        this->SceneUpdates->Push( new msvSwapViewPropCommand( this->AssignedRenderer, oldPropInRenderer ? oldProp.GetPointer() : 0, newProp ) );
+        this->PropInRenderer = true;
     }
-    if( oldTimeStepProp != 0 )
+    else if( this->AssignedThreadSafeRenderer )
     {
-        oldTimeStepProp->Delete();
+        this->AssignedThreadSafeRenderer->SwapViewProp( oldPropInRenderer ? oldProp.GetPointer() : 0, newProp );
+        this->PropInRenderer = true;
     }
-    if( oldTimeStepMapper != 0 )
+    else
     {
-        oldTimeStepMapper->Delete();
+        if( oldPropInRenderer )
+        {
+            this->RemoveViewPropToRenderer( oldProp );
+        }
+        AddViewPropToRenderer( this->CurrentTimeStepProp );
+    }
+}
+
+void msvEntityImpl::StageTimeStepData( vtkDataSet* dataObject, int timeStepNumber )
+{
+    int backStagingData = 1 - this->FrontStagingData;
+    vtkDataSet* stagingData = this->StagingData[backStagingData];
+    if( !stagingData || !stagingData->IsA( dataObject->GetClassName() ) )
+    {
+        this->StagingData[backStagingData].TakeReference( dataObject->NewInstance() );
+        stagingData = this->StagingData[backStagingData];
     }
-    if( oldTimeStepVolumeProperty != 0 )
+
+    this->FrontStagingData = backStagingData;
+
+    msvStageTimeStepCommand* command = new msvStageTimeStepCommand( this->CurrentTimeStepMapper, stagingData, dataObject );
+    if( !this->LevelOfDetailMappers.empty() )
     {
-        oldTimeStepVolumeProperty->Delete();
+        // When the step kept fewer levels than there are mappers, the coarser
+        // mappers draw its coarsest one. Steps without levels, too small or
+        // not built, are drawn at full resolution by all of them
+        int numberOfBuiltLevels = ( timeStepNumber != numeric_limits<int>::min() ) ? this->LODCache->GetNumberOfBuiltLevels( timeStepNumber ) : 0;
+        for( size_t indexLevel = 0; indexLevel < this->LevelOfDetailMappers.size(); indexLevel++ )
+        {
+            vtkSmartPointer<vtkPolyData> levelSP;
+            if( numberOfBuiltLevels > 0 )
+            {
+                levelSP = this->LODCache->GetLevel( timeStepNumber, std::min( static_cast<int>( indexLevel ), numberOfBuiltLevels - 1 ) );
+            }
+            command->AddLevelOfDetail( this->LevelOfDetailMappers[indexLevel], levelSP );
+        }
     }
+
+    this->SubmitSceneUpdate( command );
 }
 
 void msvEntityImpl::SetCurrentTimeStepData( vtkStructuredPoints* dataObject, int timeStepNumber )
 {
-    vtkStructuredPoints* dataObjectCopy = vtkStructuredPoints::New();
-    dataObjectCopy->DeepCopy( dataObject );
-    vtkVolumeMapper* volumeMapper = vtkGPUVolumeRayCastMapper::New();
-    volumeMapper->SetInput( dataObject );
-    vtkVolumeProperty* volumeProperty = vtkVolumeProperty::New();
-    vtkVolume* volume = vtkVolume::New();
-    volume->SetMapper( volumeMapper );
-    volume->SetProperty( volumeProperty );
+    MSV_TRACE_ZONE( "AssignTimeStep" );
 
-    this->ReplaceCurrentTimeStepData( dataObjectCopy, volume, volumeMapper, volumeProperty );
+    if( !vtkVolume::SafeDownCast( this->CurrentTimeStepProp ) )
+    {
+        vtkSmartPointer<vtkGPUVolumeRayCastMapper> volumeMapperSP = vtkSmartPointer<vtkGPUVolumeRayCastMapper>::New();
+        vtkSmartPointer<vtkVolume> volumeSP = vtkSmartPointer<vtkVolume>::New();
+        volumeSP->SetMapper( volumeMapperSP );
+        volumeSP->SetProperty( this->GetVolumeProperty() );
+        this->ReplaceRenderResources( volumeSP, volumeMapperSP );
+    }
+
+    this->StageTimeStepData( dataObject, timeStepNumber );
 }
 
 void msvEntityImpl::SetCurrentTimeStepData( vtkPolyData* dataObject, int timeStepNumber )
 {
+    MSV_TRACE_ZONE( "AssignTimeStep" );
+
     //cout << this->CurrentTimeStep << endl;
     cout << timeStepNumber << endl;
     cout << "dataObject: " << dataObject << endl;
 
-    vtkPolyData* dataObjectCopy = vtkPolyData::New();
-    dataObjectCopy->DeepCopy( dataObject );
-    vtkPolyDataMapper* polyDataMapper = vtkPolyDataMapper::New();
-    polyDataMapper->SetInput( dataObject );
-    vtkActor* actor = vtkActor::New();
-    actor->SetMapper( polyDataMapper );
+    // Rebuilt as well when the number of levels of detail changed
+    int numberOfLevels = this->LODCache->GetNumberOfLevels();
+    vtkActor* actor = vtkActor::SafeDownCast( this->CurrentTimeStepProp );
+    bool isLODActor = ( vtkLODActor::SafeDownCast( actor ) != 0 );
+    if( !actor || ( isLODActor != ( numberOfLevels > 0 ) ) ||
+        ( static_cast<int>( this->LevelOfDetailMappers.size() ) != numberOfLevels ) )
+    {
+        vtkSmartPointer<vtkPolyDataMapper> polyDataMapperSP = vtkSmartPointer<vtkPolyDataMapper>::New();
+        vtkSmartPointer<vtkActor> actorSP;
+        std::vector< vtkSmartPointer<vtkPolyDataMapper> > levelMappers;
+        if( numberOfLevels > 0 )
+        {
+            // Picks the mapper that fits the time allocated to the prop from
+            // the measured draw time of each. The own levels of vtkLODActor,
+            // a point cloud and an outline, are not built once it has these
+            vtkSmartPointer<vtkLODActor> lodActorSP = vtkSmartPointer<vtkLODActor>::New();
+            for( int indexLevel = 0; indexLevel < numberOfLevels; indexLevel++ )
+            {
+                vtkSmartPointer<vtkPolyDataMapper> levelMapperSP = vtkSmartPointer<vtkPolyDataMapper>::New();
+                lodActorSP->AddLODMapper( levelMapperSP );
+                levelMappers.push_back( levelMapperSP );
+            }
+            actorSP = lodActorSP;
+        }
+        else
+        {
+            actorSP = vtkSmartPointer<vtkActor>::New();
+        }
+        actorSP->SetMapper( polyDataMapperSP );
+        this->ReplaceRenderResources( actorSP, polyDataMapperSP );
+        this->LevelOfDetailMappers = levelMappers;
+    }
 
-    this->ReplaceCurrentTimeStepData( dataObjectCopy, actor, polyDataMapper, 0 );
+    this->StageTimeStepData( dataObject, timeStepNumber );
 }
 
 void msvEntityImpl::Tick( long elapsedTime )
@@ -351,7 +542,7 @@ void msvEntityImpl::Tick( long elapsedTime )
 
     // If the entity is not yet assigned to the renderer, there is no need
     // to wait for the next frame period
-    if( !this->FirstTimeShown && !this->AssignedRenderer->HasViewProp( this->CurrentTimeStepProp ) )
+    if( !this->FirstTimeShown && !this->PropInRenderer )
     {
         AddViewPropToRenderer( this->CurrentTimeStepProp );
         this->CurrentTimeStepProp->SetVisibility( 1 );
@@ -391,6 +582,8 @@ void msvEntityImpl::Tick( long elapsedTime )
 
 void msvEntityImpl::PrintSelf( ostream& os, vtkIndent indent )
 {
+    os << indent << "LODCache:" << endl;
+    this->LODCache->PrintSelf( os, indent.GetNextIndent() );
 }
 
 /////////////////////////
@@ -454,6 +647,41 @@ void msvEntity::SetTimeStepProvider( vtkTemporalDataSetTimeStepProvider* timeSte
     this->Impl->SetTimeStepProvider( timeStepProvider );
 }
 
+void msvEntity::SetSceneUpdateQueue( msvDeferredCommandQueue* sceneUpdates )
+{
+    this->Impl->SetSceneUpdateQueue( sceneUpdates );
+}
+
+void msvEntity::SetVolumeProperty( vtkVolumeProperty* volumeProperty )
+{
+    this->Impl->SetVolumeProperty( volumeProperty );
+}
+
+vtkVolumeProperty* msvEntity::GetVolumeProperty()
+{
+    return this->Impl->GetVolumeProperty();
+}
+
+void msvEntity::SetNumberOfLevelsOfDetail( int numberOfLevels )
+{
+    this->Impl->SetNumberOfLevelsOfDetail( numberOfLevels );
+}
+
+int msvEntity::GetNumberOfLevelsOfDetail()
+{
+    return this->Impl->GetNumberOfLevelsOfDetail();
+}
+
+void msvEntity::BuildLevelsOfDetail( vtkPolyData* dataObject, int timeStepNumber )
+{
+    this->Impl->BuildLevelsOfDetail( dataObject, timeStepNumber );
+}
+
+void msvEntity::ReleaseLevelsOfDetail( int timeStepNumber )
+{
+    this->Impl->ReleaseLevelsOfDetail( timeStepNumber );
+}
+
 void msvEntity::Tick( long elapsedTime )
 {
     this->Impl->Tick( elapsedTime );
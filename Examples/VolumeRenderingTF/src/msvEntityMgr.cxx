@@ -36,19 +36,40 @@
 #include <vtkRenderer.h>
 #include <vtkMutexLock.h>
 #include <vtkMultiThreader.h>
+#include <vtkConditionVariable.h>
+#include <vtkDataObject.h>
+#include <vtkTimerLog.h>
+#include <vtkVolumeProperty.h>
 
 
 #include "msvEntity.h"
+#include "msvSPSCRing.h"
+#include "msvDeferredCommandQueue.h"
+#include "msvFrameTrace.h"
+#include "msvAtomic.h"
 
 #include <vector>
 #include <list>
+#include <algorithm>
 #include <exception>
+#include <cmath>
 
 using std::string;
 using std::vector;
 using std::list;
 using std::exception;
 
+// A time step loaded by a worker, waiting for the tick to show it
+struct msvLoadedFrame
+{
+    msvLoadedFrame() : timeStep( -1 ), generation( 0 ) {}
+    int timeStep;
+    // Load generation of the entity when the frame was loaded. Frames of a
+    // cancelled generation still in the ring are dropped by the tick
+    long generation;
+    vtkSmartPointer<vtkDataObject> data;
+};
+
 struct msvEntityInfoEntry
 {
     vtkMutexLock* AccessLock;
@@ -56,11 +77,33 @@ struct msvEntityInfoEntry
     int dataObjectType;
     vtkSmartPointer<vtkMultipleDataReader> multipleDataReader;
     vtkSmartPointer<vtkTemporalDataSetTimeStepProvider> TSProvider;
-    vtkSmartPointer<vtkMultiThreader> multiThreader;
+    // Next step to load. Loads follow each other, so it runs ahead of the
+    // shown step by the frames loaded or in flight
     int firstTimeStepToLoad;
-    int timeStepsToLoad;
+    int currentTimeStep;
+    int availableTimeSteps;
+    // Frames the entity has asked to advance that have not been shown yet
+    int framesDue;
+    // Frames kept loaded ahead of the shown one. When adaptive, the depth
+    // follows the decode time against the playback period, up to the maximum
+    int lookaheadDepth;
+    int maxLookaheadDepth;
+    bool adaptiveLookahead;
+    // Running averages, in seconds, of the decode time of a frame and of the
+    // period between the requests of the entity for its next frame
+    double averageDecodeTime;
+    double averageFramePeriod;
+    double lastRequestTime;
+    // False while a load of the entity is queued or running. At most one is,
+    // so the entity pipeline is only ever updated by one worker at a time
     bool timeStepsLoaded;
-    bool timeStepAssigned;
+    // Filled by the worker serving the entity, drained by Tick. The loads of
+    // an entity are serialised, so there is a single producer at any time
+    msvSPSCRing<msvLoadedFrame> loadedFrames;
+    // Bumped to cancel the loads queued or running for this entity. The
+    // loader workers compare it against the generation stamped on the job.
+    // Only accessed through the msvAtomic operations
+    volatile long loadGeneration;
 };
 
 typedef struct
@@ -71,6 +114,11 @@ typedef struct
     int firstFrameToLoad;
     int framesToLoad;
     int threadID;
+    long generation;
+    // Taken under the entity lock when the job is created, so the loader
+    // queue orders the jobs without reading the entity
+    int visibility;
+    int currentTimeStep;
 } msvEntityMgrThreadData;
 
 #if 0
@@ -96,6 +144,7 @@ public:
     msvEntity* CreateEntityFromDirectory( const std::string& DirectoryName, const std::string& FileWildcard = "*" );
 
     void SetRenderer( vtkRenderer* assignedRenderer );
+    void SetSceneUpdateQueue( msvDeferredCommandQueue* sceneUpdates );
 
     virtual void PrintSelf( ostream& os, vtkIndent indent );
 
@@ -107,11 +156,28 @@ public:
     void RequestSequentialTimeSteps( msvEntity* requesterEntity, int firstTimeStepRequested, int timeStepsRequested );
     void RequestNextSequentialTimeStep( msvEntity* requesterEntity );
 
-    //
-    void TerminatLoadFrameThread( msvEntityMgrThreadData* threadData );
+    void LoadTimeSteps( msvEntityInfoEntry* entityInfoEntry, int firstFrameToLoad, int framesToLoad, int threadID = -1 );
+    void PublishLoadedFrames( msvEntityMgrThreadData* threadData, double decodeTime );
+    // Decimates the loaded polydata steps into the levels of detail of the
+    // entity, before they are published and so while only the worker sees them
+    void BuildLevelsOfDetail( msvEntityMgrThreadData* threadData );
+
+    // Body of every loader worker: takes the most urgent job of the shared
+    // queue until the pool is stopped
+    void RunLoaderWorker( int threadID );
+
+    // Number of persistent loader threads shared by all the entities
+    void SetNumberOfLoaderThreads( int numberOfLoaderThreads );
+    int GetNumberOfLoaderThreads() const;
 
-    void QueueFulfilledRequest( msvEntityMgrThreadData* threadData, int threadID = -1 );
-    void LoadTimeSteps( msvEntityInfoEntry* entityInfoEntry, int firstFrameToLoad, int framesToLoad, bool fromMainThread = true, int threadID = -1 );
+    // Lookahead of the entities
+    void SetEntityLookahead( msvEntity* entity, int maxLookaheadDepth, bool adaptive );
+    int GetEntityLookaheadDepth( msvEntity* entity );
+    void SetDefaultLookaheadDepth( int defaultLookaheadDepth );
+    int GetDefaultLookaheadDepth() const;
+
+    // Volume property shared by the structured points entities
+    vtkVolumeProperty* GetVolumeProperty();
 
 private:
     friend class msvEntityMgr;
@@ -124,7 +190,17 @@ private:
     msvEntityInfoEntry* GetEntityInfoEntry( msvEntity* holdedEntity );
 
     // Sets the correct Current Time Step for the data entity
-    void SetEntityCurrentTimeStep( msvEntityInfoEntry* entityInfoEntry, int currentTimeStep, int cachedTimeStep );
+    void SetEntityCurrentTimeStep( msvEntityInfoEntry* entityInfoEntry, const msvLoadedFrame& loadedFrame );
+
+    // Shows the loaded frames the entity is due. Returns true if the entity
+    // changed its time step; firstTimeStep tells if it was its first one
+    bool ConsumeLoadedFrames( msvEntityInfoEntry* entityInfoEntry, bool& firstTimeStep );
+
+    // Initializes the loading state of a new entry
+    void InitializeLoadState( msvEntityInfoEntry* entityInfoEntry, int availableTimeSteps );
+
+    // Depth from the measured decode time and playback period
+    void UpdateLookaheadDepth( msvEntityInfoEntry* entityInfoEntry );
 
     // Launches a thread to load frames from the data source into the entity
     void PreloadTimeSteps( msvEntityInfoEntry* entityInfoEntry, int firstFrameToPreload, int framesToPreload );
@@ -132,87 +208,85 @@ private:
     void RequestSequentialTimeSteps( msvEntityInfoEntry* entityInfoEntry );
     void FulfillTimeStepRequests();
 
-    bool GetEntityNewDataAvailable();
-    void SetEntityNewDataAvailable( bool available = true );
+    // Loader pool management. Jobs are served by priority, not arrival order
+    void StartLoaderPool();
+    void StopLoaderPool();
+    void EnqueueLoaderJob( msvEntityMgrThreadData* threadData );
+    msvEntityMgrThreadData* DequeueLoaderJob();
+    bool IsLoaderJobMoreUrgent( msvEntityMgrThreadData* a, msvEntityMgrThreadData* b );
+    void DiscardLoaderJob( msvEntityMgrThreadData* threadData );
+
+    // Cooperative cancellation of the queued and running loads of an entity
+    void CancelTimeStepLoads( msvEntityInfoEntry* entityInfoEntry );
+    bool IsLoaderJobCancelled( msvEntityMgrThreadData* threadData );
 
 private:
 
     msvEntityMgr*                       PublicInterface;
     vtkMutexLock*                       TimeStepRequestQueueLock;
-    vtkMutexLock*                       FulfilledTimeStepRequestsLock;
-    vtkMutexLock*                       AlgorithmLock;
     vtkRenderer*                        AssignedRenderer;
+    // Not null when another thread renders AssignedRenderer
+    vtkSmartPointer<msvDeferredCommandQueue> SceneUpdates;
     int                                 NewEntityPreloadTimeSteps;
     //std::vector<msvEntity*>             Entities;
     vector<msvEntityInfoEntry*>         EntityInfoEntries;
     list<msvEntityInfoEntry*>           TimeStepRequestQueue;
-    list<msvEntityMgrThreadData*>       FulfilledTimeStepRequests;
-    bool                                EntityNewDataAvailable;
+
+    vtkMutexLock*                       LoaderQueueLock;
+    vtkConditionVariable*               LoaderQueueCondition;
+    vtkSmartPointer<vtkMultiThreader>   LoaderThreader;
+    vector<int>                         LoaderThreadIDs;
+    list<msvEntityMgrThreadData*>       LoaderJobs;
+    bool                                LoaderShutdown;
+    int                                 NumberOfLoaderThreads;
+    int                                 DefaultLookaheadDepth;
+    vtkSmartPointer<vtkVolumeProperty>  SharedVolumeProperty;
 };
 
+// Upper bound of the default pool size. Loading is mostly I/O bound and
+// every reader already decodes the steps of one request in parallel
+const int DefaultMaxLoaderThreads = 4;
+
+// Capacity of the ring of loaded frames of every entity, and so the deepest
+// lookahead that can be configured
+const int MaxLookaheadDepth = 16;
+
+// Weight of the newest sample in the running averages of the decode time
+// and of the playback period
+const double TimingSmoothing = 0.25;
+
 msvEntityMgrImpl::msvEntityMgrImpl( msvEntityMgr* publicInterface )
 : PublicInterface( publicInterface )
 , TimeStepRequestQueueLock( vtkMutexLock::New() )
-, FulfilledTimeStepRequestsLock( vtkMutexLock::New() )
-, AlgorithmLock( vtkMutexLock::New() )
 , AssignedRenderer( 0 )
 //, NewEntityPreloadTimeSteps( 1 )
 , NewEntityPreloadTimeSteps( 3 )
 //, NewEntityPreloadTimeSteps( 34 )
-, EntityNewDataAvailable( false )
+, LoaderQueueLock( vtkMutexLock::New() )
+, LoaderQueueCondition( vtkConditionVariable::New() )
+, LoaderShutdown( false )
+, NumberOfLoaderThreads( vtkMultiThreader::GetGlobalDefaultNumberOfThreads() )
+, DefaultLookaheadDepth( 8 )
+, SharedVolumeProperty( vtkSmartPointer<vtkVolumeProperty>::New() )
 {
+    if( this->NumberOfLoaderThreads > DefaultMaxLoaderThreads )
+    {
+        this->NumberOfLoaderThreads = DefaultMaxLoaderThreads;
+    }
     //this->TimeStepRequestQueueLock->Register( this );
-    //this->AlgorithmLock->Register( this );
     //this->TimeStepRequestQueueLock->DebugOn();
-    //this->AlgorithmLock->DebugOn();
 }
 
 msvEntityMgrImpl::~msvEntityMgrImpl()
 {
-    this->FulfilledTimeStepRequestsLock->Lock();
-    try
+    // Cancel every load and wait for the workers to leave before touching
+    // the entities they may be loading into
+    vector<msvEntityInfoEntry*>::iterator itEntry;
+    for( itEntry = this->EntityInfoEntries.begin(); itEntry != this->EntityInfoEntries.end(); itEntry++ )
     {
-        FLUSHED_MESSAGE( "  Locked FulfilledTimeStepRequestsLock in msvEntityMgrImpl::~msvEntityMgrImpl" );
-        if( this->FulfilledTimeStepRequests.size() > 0 )
-        {
-            // We are consuming, then lock
-            list<msvEntityMgrThreadData*>::iterator it;
-            for( it = this->FulfilledTimeStepRequests.begin(); it != this->FulfilledTimeStepRequests.end(); it++ )
-            {
-                msvEntityMgrThreadData* threadData = *it; 
-                msvEntityInfoEntry* entityInfoEntry = threadData->entityInfoEntry;
-
-                entityInfoEntry->AccessLock->Lock();
-                try
-                {
-                    //CRASH when active breakpoint
-                    if( entityInfoEntry->multiThreader->IsThreadActive( threadData->threadID ) )
-                    {
-                        FLUSHED_MESSAGE( "Going to terminate thread in msvEntityMgrImpl::~msvEntityMgrImpl" );
-                        entityInfoEntry->multiThreader->TerminateThread( threadData->threadID );
-                        FLUSHED_MESSAGE( "Thread terminated in msvEntityMgrImpl::~msvEntityMgrImpl" );
-                    }
-                    entityInfoEntry->AccessLock->Unlock();
-                }
-                catch( exception& )
-                {
-                    FLUSHED_MESSAGE( "Exception occurred in msvEntityMgrImpl::~msvEntityMgrImpl(LOOP)" );
-                    entityInfoEntry->AccessLock->Unlock();
-                }
-
-                delete threadData;
-            }
-            this->FulfilledTimeStepRequests.clear();
-        }
-        this->FulfilledTimeStepRequestsLock->Unlock();
-        FLUSHED_MESSAGE( "Unlocked FulfilledTimeStepRequestsLock in msvEntityMgrImpl::~msvEntityMgrImpl" );
-    }
-    catch( exception e )
-    {
-        FLUSHED_MESSAGE( "Exception occurred in msvEntityMgrImpl::~msvEntityMgrImpl" );
-        this->FulfilledTimeStepRequestsLock->Unlock();
-        FLUSHED_MESSAGE( "Unlocked FulfilledTimeStepRequestsLock in msvEntityMgrImpl::~msvEntityMgrImpl(CATCH)" );
+        CancelTimeStepLoads( *itEntry );
     }
+    StopLoaderPool();
 
     vector<msvEntityInfoEntry*>::size_type index;
     for( index = 0; index < this->EntityInfoEntries.size(); index++ )
@@ -240,13 +314,13 @@ msvEntityMgrImpl::~msvEntityMgrImpl()
     {
         this->TimeStepRequestQueueLock->Delete();
     }
-    if( this->FulfilledTimeStepRequestsLock != 0 )
+    if( this->LoaderQueueCondition != 0 )
     {
-        this->FulfilledTimeStepRequestsLock->Delete();
+        this->LoaderQueueCondition->Delete();
     }
-    if( this->AlgorithmLock != 0 )
+    if( this->LoaderQueueLock != 0 )
     {
-        this->AlgorithmLock->Delete();
+        this->LoaderQueueLock->Delete();
     }
 }
 
@@ -295,9 +369,11 @@ msvEntity* msvEntityMgrImpl::CreateEntityFromSeries( vtkStringArray* series )
         resultEntity = resultEntityInfoEntry->Entity;
         // Assign the entity manager so the entity can ask for new frames
         resultEntity->SetEntityMgr( this->PublicInterface );
+        resultEntity->SetVolumeProperty( this->SharedVolumeProperty );
+        resultEntity->SetSceneUpdateQueue( this->SceneUpdates );
         resultEntity->SetRenderer( this->AssignedRenderer );
+        PreloadTimeSteps( resultEntityInfoEntry, 0, this->NewEntityPreloadTimeSteps );
     }
-    PreloadTimeSteps( resultEntityInfoEntry, 0, this->NewEntityPreloadTimeSteps );
 
     return resultEntity;
 }
@@ -318,6 +394,7 @@ msvEntityInfoEntry* msvEntityMgrImpl::CreateEntityInfoEntryFromSeries( vtkString
                 multiplePolyDataReaderSP->SetFileNames( series );
                 multiplePolyDataReaderSP->TimeStepWrapOn();
                 temporalDataSetTimeStepProviderSP->SetInputConnection( multiplePolyDataReaderSP->GetOutputPort() );
+                temporalDataSetTimeStepProviderSP->SetArrayPool( multiplePolyDataReaderSP->GetArrayPool() );
                 temporalDataSetTimeStepProviderSP->TimeStepWrapOn();
 
                 resultEntityInfoEntry = new msvEntityInfoEntry;
@@ -325,10 +402,7 @@ msvEntityInfoEntry* msvEntityMgrImpl::CreateEntityInfoEntryFromSeries( vtkString
                 resultEntityInfoEntry->AccessLock = vtkMutexLock::New();
                 resultEntityInfoEntry->multipleDataReader = multiplePolyDataReaderSP;
                 resultEntityInfoEntry->TSProvider = temporalDataSetTimeStepProviderSP;
-                resultEntityInfoEntry->multiThreader = vtkSmartPointer<vtkMultiThreader>::New();
-                // Initially there was not time step request, so the condition is set to true to be able to launch a request
-                resultEntityInfoEntry->timeStepsLoaded = true;
-                resultEntityInfoEntry->timeStepAssigned = true;
+                InitializeLoadState( resultEntityInfoEntry, series->GetNumberOfValues() );
                 this->EntityInfoEntries.push_back( resultEntityInfoEntry );
                 break;
             }
@@ -339,16 +413,15 @@ msvEntityInfoEntry* msvEntityMgrImpl::CreateEntityInfoEntryFromSeries( vtkString
                 multipleStructuredPointsReaderSP->TimeStepWrapOn();
                 vtkSmartPointer<vtkTemporalDataSetTimeStepProvider> temporalDataSetTimeStepProviderSP = vtkSmartPointer<vtkTemporalDataSetTimeStepProvider>::New();
                 temporalDataSetTimeStepProviderSP->SetInputConnection( multipleStructuredPointsReaderSP->GetOutputPort() );
+                temporalDataSetTimeStepProviderSP->SetArrayPool( multipleStructuredPointsReaderSP->GetArrayPool() );
+                temporalDataSetTimeStepProviderSP->TimeStepWrapOn();
 
                 resultEntityInfoEntry = new msvEntityInfoEntry;
                 resultEntityInfoEntry->Entity = msvEntity::New();
                 resultEntityInfoEntry->AccessLock = vtkMutexLock::New();
                 resultEntityInfoEntry->multipleDataReader = multipleStructuredPointsReaderSP;
                 resultEntityInfoEntry->TSProvider = temporalDataSetTimeStepProviderSP;
-                resultEntityInfoEntry->multiThreader = vtkSmartPointer<vtkMultiThreader>::New();
-                // Initially there was not time step request, so the condition is set to true to be able to launch a request
-                resultEntityInfoEntry->timeStepsLoaded = true;
-                resultEntityInfoEntry->timeStepAssigned = true;
+                InitializeLoadState( resultEntityInfoEntry, series->GetNumberOfValues() );
                 this->EntityInfoEntries.push_back( resultEntityInfoEntry );
                 break;
             }
@@ -374,6 +447,24 @@ msvEntityInfoEntry* msvEntityMgrImpl::CreateEntityInfoEntryFromSeries( vtkString
     return resultEntityInfoEntry;
 }
 
+void msvEntityMgrImpl::InitializeLoadState( msvEntityInfoEntry* entityInfoEntry, int availableTimeSteps )
+{
+    entityInfoEntry->firstTimeStepToLoad = 0;
+    entityInfoEntry->currentTimeStep = 0;
+    entityInfoEntry->availableTimeSteps = availableTimeSteps;
+    entityInfoEntry->framesDue = 0;
+    entityInfoEntry->maxLookaheadDepth = this->DefaultLookaheadDepth;
+    entityInfoEntry->lookaheadDepth = 1;
+    entityInfoEntry->adaptiveLookahead = true;
+    entityInfoEntry->averageDecodeTime = 0.0;
+    entityInfoEntry->averageFramePeriod = 0.0;
+    entityInfoEntry->lastRequestTime = 0.0;
+    entityInfoEntry->loadedFrames.SetCapacity( MaxLookaheadDepth );
+    entityInfoEntry->loadGeneration = 0;
+    // Initially there was not time step request, so the condition is set to true to be able to launch a request
+    entityInfoEntry->timeStepsLoaded = true;
+}
+
 msvEntity* msvEntityMgrImpl::CreateEntityFromDirectory( const string& DirectoryName, const string& FileWildcard )
 {
     msvEntity* resultEntity = 0 ;
@@ -411,6 +502,17 @@ msvEntity* msvEntityMgrImpl::CreateEntityFromDirectory( const string& DirectoryN
     return resultEntity;
 }
 
+void msvEntityMgrImpl::SetSceneUpdateQueue( msvDeferredCommandQueue* sceneUpdates )
+{
+    this->SceneUpdates = sceneUpdates;
+
+    vector<msvEntityInfoEntry*>::iterator it;
+    for( it = this->EntityInfoEntries.begin(); it != this->EntityInfoEntries.end(); it++ )
+    {
+        (*it)->Entity->SetSceneUpdateQueue( this->SceneUpdates );
+    }
+}
+
 void msvEntityMgrImpl::SetRenderer( vtkRenderer* assignedRenderer )
 {
      this->AssignedRenderer = assignedRenderer;
@@ -422,28 +524,22 @@ void msvEntityMgrImpl::SetRenderer( vtkRenderer* assignedRenderer )
     }
 }
 
-void msvEntityMgrImpl::SetEntityCurrentTimeStep( msvEntityInfoEntry* entityInfoEntry, int currentTimeStep, int cachedTimeStep )
+void msvEntityMgrImpl::SetEntityCurrentTimeStep( msvEntityInfoEntry* entityInfoEntry, const msvLoadedFrame& loadedFrame )
 {
-    // entityInfoEntry->AccessLock->Lock();
-    // this->AlgorithmLock->Lock();
-    // supposed to be done before calling...
-
-    int nextCachedTimeStep = cachedTimeStep;
-
     switch( entityInfoEntry->dataObjectType )
     {
         case VTK_POLY_DATA:
         {
-            vtkPolyData* polyData = vtkPolyData::SafeDownCast( entityInfoEntry->TSProvider->GetOutput()->GetTimeStep( nextCachedTimeStep ) );
+            vtkPolyData* polyData = vtkPolyData::SafeDownCast( loadedFrame.data );
             if( polyData )
             {
-                entityInfoEntry->Entity->SetCurrentTimeStepData( polyData, currentTimeStep );
+                entityInfoEntry->Entity->SetCurrentTimeStepData( polyData, loadedFrame.timeStep );
             }
             break;
         }
         case VTK_STRUCTURED_POINTS:
         {
-            vtkStructuredPoints* structuredPoints = vtkStructuredPoints::SafeDownCast( entityInfoEntry->TSProvider->GetOutput()->GetTimeStep( 0 ) );
+            vtkStructuredPoints* structuredPoints = vtkStructuredPoints::SafeDownCast( loadedFrame.data );
             if( structuredPoints )
             {
                 entityInfoEntry->Entity->SetCurrentTimeStepData( structuredPoints );
@@ -465,6 +561,75 @@ void msvEntityMgrImpl::SetEntityCurrentTimeStep( msvEntityInfoEntry* entityInfoE
     }
 }
 
+bool msvEntityMgrImpl::ConsumeLoadedFrames( msvEntityInfoEntry* entityInfoEntry, bool& firstTimeStep )
+{
+    firstTimeStep = false;
+
+    entityInfoEntry->AccessLock->Lock();
+    int framesDue = entityInfoEntry->framesDue;
+    long generation = msvAtomicLoad( &entityInfoEntry->loadGeneration );
+    entityInfoEntry->AccessLock->Unlock();
+
+    // One frame per advance of the entity. If it advanced more than once
+    // since the last tick, only the newest of those frames is shown
+    msvLoadedFrame loadedFrame;
+    msvLoadedFrame newestFrame;
+    int poppedFrames = 0;
+    while( poppedFrames < framesDue && entityInfoEntry->loadedFrames.Pop( loadedFrame ) )
+    {
+        if( loadedFrame.generation != generation )
+        {
+            continue;
+        }
+        newestFrame = loadedFrame;
+        poppedFrames++;
+    }
+    if( poppedFrames == 0 )
+    {
+        return false;
+    }
+    if( poppedFrames > 1 )
+    {
+        cout << "Frame Skip!!" << endl;
+    }
+
+    firstTimeStep = !entityInfoEntry->Entity->HasAnyTimeStep();
+    entityInfoEntry->AccessLock->Lock();
+    entityInfoEntry->framesDue -= poppedFrames;
+    entityInfoEntry->currentTimeStep = newestFrame.timeStep;
+    entityInfoEntry->AccessLock->Unlock();
+    SetEntityCurrentTimeStep( entityInfoEntry, newestFrame );
+
+    // Room was made in the ring, so top it up
+    RequestSequentialTimeSteps( entityInfoEntry );
+
+    return true;
+}
+
+void msvEntityMgrImpl::UpdateLookaheadDepth( msvEntityInfoEntry* entityInfoEntry )
+{
+    // Supposed to be called with the AccessLock of the entry locked.
+    // While a frame is shown for a period, the frames decoding meanwhile must
+    // already be loaded, plus the one to show next
+    if( !entityInfoEntry->adaptiveLookahead )
+    {
+        entityInfoEntry->lookaheadDepth = entityInfoEntry->maxLookaheadDepth;
+        return;
+    }
+    if( entityInfoEntry->averageDecodeTime <= 0.0 || entityInfoEntry->averageFramePeriod <= 0.0 )
+    {
+        return;
+    }
+
+    double framesPerPeriod = entityInfoEntry->averageDecodeTime / entityInfoEntry->averageFramePeriod;
+    int lookaheadDepth = static_cast<int>( ceil( framesPerPeriod ) ) + 1;
+    if( lookaheadDepth > entityInfoEntry->maxLookaheadDepth )
+    {
+        lookaheadDepth = entityInfoEntry->maxLookaheadDepth;
+    }
+    entityInfoEntry->lookaheadDepth = lookaheadDepth;
+}
+
 msvEntityInfoEntry* msvEntityMgrImpl::GetEntityInfoEntry( msvEntity* holdedEntity )
 {
     msvEntityInfoEntry* entityInfoEntry( 0 );
@@ -483,10 +648,14 @@ msvEntityInfoEntry* msvEntityMgrImpl::GetEntityInfoEntry( msvEntity* holdedEntit
 
 void msvEntityMgrImpl::RequestSequentialTimeSteps( msvEntityInfoEntry* entityInfoEntry )
 {
-    // Put the request on the Queue
+    // Put the request on the Queue, once: the load reads the entity state
+    // when it is launched, so a pending request is already up to date
     this->TimeStepRequestQueueLock->Lock();
     FLUSHED_MESSAGE( "  Locked TimeStepRequestQueueLock in msvEntityMgrImpl::RequestSequentialTimeSteps" );
-    this->TimeStepRequestQueue.push_back( entityInfoEntry );
+    if( std::find( this->TimeStepRequestQueue.begin(), this->TimeStepRequestQueue.end(), entityInfoEntry ) == this->TimeStepRequestQueue.end() )
+    {
+        this->TimeStepRequestQueue.push_back( entityInfoEntry );
+    }
     this->TimeStepRequestQueueLock->Unlock();
     FLUSHED_MESSAGE( "UNLocked TimeStepRequestQueueLock in msvEntityMgrImpl::RequestSequentialTimeSteps" );
 }
@@ -494,18 +663,35 @@ void msvEntityMgrImpl::RequestSequentialTimeSteps( msvEntityInfoEntry* entityInf
 void msvEntityMgrImpl::RequestSequentialTimeSteps( msvEntity* requesterEntity, int firstTimeStepRequested, int timeStepsRequested )
 {
     msvEntityInfoEntry* entityInfoEntry( GetEntityInfoEntry( requesterEntity ) );
+    if( entityInfoEntry == 0 )
+    {
+        return;
+    }
+
+    // Restarts the loading at the requested step. What is loaded or in flight
+    // belongs to the old position and is cancelled
+    CancelTimeStepLoads( entityInfoEntry );
+
+    // Called from the thread that ticks, the consumer side of the ring, so
+    // the stale frames can be dropped right away
+    msvLoadedFrame staleFrame;
+    while( entityInfoEntry->loadedFrames.Pop( staleFrame ) )
+    {
+    }
+
     // We dont want to asign the time steps requested before the requester thread has updated that data
     // and released the lock
     entityInfoEntry->AccessLock->Lock();
     try
     {
-        if( entityInfoEntry != 0 )
+        entityInfoEntry->firstTimeStepToLoad = firstTimeStepRequested % entityInfoEntry->availableTimeSteps;
+        entityInfoEntry->framesDue = 1;
+        // The requested steps are the initial depth, until there are timings
+        if( timeStepsRequested > entityInfoEntry->maxLookaheadDepth )
         {
-            entityInfoEntry->firstTimeStepToLoad = firstTimeStepRequested;
-            entityInfoEntry->timeStepsToLoad = timeStepsRequested;
-
-            RequestSequentialTimeSteps( entityInfoEntry );
+            timeStepsRequested = entityInfoEntry->maxLookaheadDepth;
         }
+        entityInfoEntry->lookaheadDepth = ( timeStepsRequested > 0 ) ? timeStepsRequested : 1;
         entityInfoEntry->AccessLock->Unlock();
     }
     catch( exception e )
@@ -513,6 +699,9 @@ void msvEntityMgrImpl::RequestSequentialTimeSteps( msvEntity* requesterEntity, i
         FLUSHED_MESSAGE( "Exception occurred in msvEntityMgrImpl::RequestSequentialTimeSteps" );
         entityInfoEntry->AccessLock->Unlock();
     }
+    // Queued without the entity lock, which FulfillTimeStepRequests takes
+    // while holding the queue lock
+    RequestSequentialTimeSteps( entityInfoEntry );
 }
 
 void msvEntityMgrImpl::RequestNextSequentialTimeStep( msvEntity* requesterEntity )
@@ -521,33 +710,21 @@ void msvEntityMgrImpl::RequestNextSequentialTimeStep( msvEntity* requesterEntity
     msvEntityInfoEntry* entityInfoEntry( GetEntityInfoEntry( requesterEntity ) );
     if( entityInfoEntry != 0 )
     {
-        int availableTimeSteps = 34;
-        int chacheSize;
+        double requestTime = vtkTimerLog::GetUniversalTime();
         entityInfoEntry->AccessLock->Lock();
         try
         {
-            this->AlgorithmLock->Lock();
-            try
-            {
-                FLUSHED_MESSAGE( "  Locked AlgorithmLock in msvEntityMgrImpl::RequestNextSequentialTimeStep" );
-                availableTimeSteps = entityInfoEntry->multipleDataReader->GetAvailableTimeSteps();
-                chacheSize = entityInfoEntry->TSProvider->GetCacheSize();
-                int nextTimeStep = entityInfoEntry->TSProvider->GetNextTimeStep();
-                this->AlgorithmLock->Unlock();
-                FLUSHED_MESSAGE( "UNLocked AlgorithmLock in msvEntityMgrImpl::RequestNextSequentialTimeStep" );
-            }
-            catch( exception e )
-            {
-                FLUSHED_MESSAGE( "Exception occurred in msvEntityMgrImpl::RequestNextSequentialTimeStep" );
-                this->AlgorithmLock->Unlock();
-                FLUSHED_MESSAGE( "UNLocked AlgorithmLock in msvEntityMgrImpl::RequestNextSequentialTimeStep(CATCH)" );
-            }
-
-            entityInfoEntry->firstTimeStepToLoad++;
-            if( entityInfoEntry->firstTimeStepToLoad >= availableTimeSteps )
+            // The frame is already loaded or on its way, the entity only has to
+            // be told to show it. The requests pace the playback
+            entityInfoEntry->framesDue++;
+            if( entityInfoEntry->lastRequestTime > 0.0 )
             {
-                entityInfoEntry->firstTimeStepToLoad = 0;
+                double framePeriod = requestTime - entityInfoEntry->lastRequestTime;
+                entityInfoEntry->averageFramePeriod = ( entityInfoEntry->averageFramePeriod > 0.0 )
+                    ? entityInfoEntry->averageFramePeriod + TimingSmoothing * ( framePeriod - entityInfoEntry->averageFramePeriod )
+                    : framePeriod;
             }
+            entityInfoEntry->lastRequestTime = requestTime;
             entityInfoEntry->AccessLock->Unlock();
         }
         catch( exception e )
@@ -559,94 +736,371 @@ void msvEntityMgrImpl::RequestNextSequentialTimeStep( msvEntity* requesterEntity
     }
 }
 
-void msvEntityMgrImpl::TerminatLoadFrameThread( msvEntityMgrThreadData* threadData )
+void msvEntityMgrImpl::LoadTimeSteps( msvEntityInfoEntry* entityInfoEntry, int firstFrameToLoad, int framesToLoad, int threadID )
 {
-    threadData->entityInfoEntry->multiThreader->TerminateThread( threadData->threadID );
-    delete threadData;
+    // Only the worker serving the entity touches its pipeline, so the update
+    // runs without any lock and in parallel with the loads of other entities
+    FLUSHED_MESSAGE2( threadID, "Going to update provider in msvEntityMgrImpl::LoadTimeSteps" );
+    entityInfoEntry->TSProvider->SetNextTimeStep( firstFrameToLoad );
+    entityInfoEntry->TSProvider->SetCacheSize( framesToLoad );
+    entityInfoEntry->TSProvider->Update();
+    FLUSHED_MESSAGE2( threadID, "Provider updated in msvEntityMgrImpl::LoadTimeSteps" );
 }
 
-void msvEntityMgrImpl::QueueFulfilledRequest( msvEntityMgrThreadData* threadData, int threadID )
+void msvEntityMgrImpl::BuildLevelsOfDetail( msvEntityMgrThreadData* threadData )
 {
-    // We are producing, then lock
-    this->FulfilledTimeStepRequestsLock->Lock();
-    try
+    msvEntityInfoEntry* entityInfoEntry = threadData->entityInfoEntry;
+    if( entityInfoEntry->dataObjectType != VTK_POLY_DATA )
     {
-        FLUSHED_MESSAGE2( threadID, "  Locked FulfilledTimeStepRequestsLock in msvEntityMgrImpl::QueueFulfilledRequest" );
-        this->FulfilledTimeStepRequests.push_back( threadData );
-        this->FulfilledTimeStepRequestsLock->Unlock();
-        FLUSHED_MESSAGE2( threadID, "Unlocked FulfilledTimeStepRequestsLock in msvEntityMgrImpl::QueueFulfilledRequest" );
+        return;
     }
-    catch( exception e )
+
+    // The levels live as long as their step is in the window of the provider
+    vtkTemporalDataSetTimeStepProvider* provider = entityInfoEntry->TSProvider;
+    for( int index = 0; index < provider->GetNumberOfEvictedTimeSteps(); index++ )
+    {
+        entityInfoEntry->Entity->ReleaseLevelsOfDetail( provider->GetEvictedTimeStep( index ) );
+    }
+
+    vtkTemporalDataSet* loadedTimeSteps = provider->GetOutput();
+    int framesToBuild = static_cast<int>( loadedTimeSteps->GetNumberOfTimeSteps() );
+    if( framesToBuild > threadData->framesToLoad )
     {
-        FLUSHED_MESSAGE2( threadID, "Exception occurred in msvEntityMgrImpl::QueueFulfilledRequest" );
-        this->FulfilledTimeStepRequestsLock->Unlock();
-        FLUSHED_MESSAGE2( threadID, "Unlocked FulfilledTimeStepRequestsLock in msvEntityMgrImpl::QueueFulfilledRequest" );
+        framesToBuild = threadData->framesToLoad;
+    }
+
+    // Cached steps are skipped by the entity, so a step is decimated once
+    // while it stays in the window
+    for( int index = 0; index < framesToBuild && !IsLoaderJobCancelled( threadData ); index++ )
+    {
+        vtkPolyData* polyData = vtkPolyData::SafeDownCast( loadedTimeSteps->GetTimeStep( index ) );
+        if( polyData )
+        {
+            int timeStep = ( threadData->firstFrameToLoad + index ) % entityInfoEntry->availableTimeSteps;
+            entityInfoEntry->Entity->BuildLevelsOfDetail( polyData, timeStep );
+        }
     }
 }
 
-void msvEntityMgrImpl::LoadTimeSteps( msvEntityInfoEntry* entityInfoEntry, int firstFrameToLoad, int framesToLoad, bool fromMainThread, int threadID )
+void msvEntityMgrImpl::PublishLoadedFrames( msvEntityMgrThreadData* threadData, double decodeTime )
 {
+    msvEntityInfoEntry* entityInfoEntry = threadData->entityInfoEntry;
+    vtkTemporalDataSet* loadedTimeSteps = entityInfoEntry->TSProvider->GetOutput();
+    int framesToPublish = static_cast<int>( loadedTimeSteps->GetNumberOfTimeSteps() );
+    if( framesToPublish > threadData->framesToLoad )
+    {
+        framesToPublish = threadData->framesToLoad;
+    }
+
+    // The provider output starts at the first requested step. The frames keep
+    // their own reference, so later updates of the provider do not affect them
+    for( int index = 0; index < framesToPublish; index++ )
+    {
+        msvLoadedFrame loadedFrame;
+        loadedFrame.timeStep = ( threadData->firstFrameToLoad + index ) % entityInfoEntry->availableTimeSteps;
+        loadedFrame.generation = threadData->generation;
+        loadedFrame.data = loadedTimeSteps->GetTimeStep( index );
+        // The load was only launched with room for its frames
+        if( !entityInfoEntry->loadedFrames.Push( loadedFrame ) )
+        {
+            break;
+        }
+    }
+
     entityInfoEntry->AccessLock->Lock();
-    try
+    if( framesToPublish > 0 )
     {
-        firstFrameToLoad = entityInfoEntry->firstTimeStepToLoad;
-        framesToLoad = entityInfoEntry->timeStepsToLoad;
+        double frameDecodeTime = decodeTime / framesToPublish;
+        entityInfoEntry->averageDecodeTime = ( entityInfoEntry->averageDecodeTime > 0.0 )
+            ? entityInfoEntry->averageDecodeTime + TimingSmoothing * ( frameDecodeTime - entityInfoEntry->averageDecodeTime )
+            : frameDecodeTime;
+    }
+    entityInfoEntry->timeStepsLoaded = true;
+    entityInfoEntry->AccessLock->Unlock();
+}
 
-        this->AlgorithmLock->Lock();
-        try
+VTK_THREAD_RETURN_TYPE TimeStepsLoaderThread( void* arg )
+{
+    vtkMultiThreader::ThreadInfo* threadInfo = static_cast<vtkMultiThreader::ThreadInfo*>( arg );
+    int threadID = threadInfo->ThreadID;
+    msvEntityMgrImpl* entityMgr = static_cast<msvEntityMgrImpl*>( threadInfo->UserData );
+
+    entityMgr->RunLoaderWorker( threadID );
+
+    return VTK_THREAD_RETURN_VALUE;
+}
+
+void msvEntityMgrImpl::RunLoaderWorker( int threadID )
+{
+    for( ;; )
+    {
+        msvEntityMgrThreadData* threadData = 0;
+        this->LoaderQueueLock->Lock();
+        while( !this->LoaderShutdown && this->LoaderJobs.empty() )
         {
-            FLUSHED_MESSAGE2( threadID, "  Locked AlgorithmLock in msvEntityMgrImpl::LoadTimeSteps" );
-            int nextTimeStep = entityInfoEntry->TSProvider->GetNextTimeStep();
-            entityInfoEntry->TSProvider->SetNextTimeStep( firstFrameToLoad );
-            entityInfoEntry->TSProvider->SetCacheSize( framesToLoad );
-        
-            entityInfoEntry->TSProvider->Update();
-            this->AlgorithmLock->Unlock();
-            FLUSHED_MESSAGE2( threadID, "UNLocked AlgorithmLock in msvEntityMgrImpl::LoadTimeSteps" );
+            this->LoaderQueueCondition->Wait( this->LoaderQueueLock );
         }
-        catch( exception e )
+        if( !this->LoaderShutdown )
         {
-            FLUSHED_MESSAGE( "Exception occurred in msvEntityMgrImpl::LoadTimeSteps" );
-            this->AlgorithmLock->Unlock();
-            FLUSHED_MESSAGE2( threadID, "UNLocked AlgorithmLock in msvEntityMgrImpl::LoadTimeSteps(CATCH)" );
+            threadData = DequeueLoaderJob();
         }
-        entityInfoEntry->timeStepsLoaded = true;
-        bool hasAnyTimeStep = entityInfoEntry->Entity->HasAnyTimeStep();
-        // Unlock as soon as possible
-        entityInfoEntry->AccessLock->Unlock();
+        this->LoaderQueueLock->Unlock();
+
+        // Stopped: the pending jobs were discarded by StopLoaderPool
+        if( threadData == 0 )
+        {
+            break;
+        }
+
+        threadData->threadID = threadID;
+        if( IsLoaderJobCancelled( threadData ) )
+        {
+            FLUSHED_MESSAGE2( threadID, "Cancelled job skipped in msvEntityMgrImpl::RunLoaderWorker" );
+            DiscardLoaderJob( threadData );
+            continue;
+        }
+
+        double loadStartTime = vtkTimerLog::GetUniversalTime();
+        LoadTimeSteps( threadData->entityInfoEntry, threadData->firstFrameToLoad, threadData->framesToLoad, threadID );
+        // Timed with the decode, so the lookahead covers the decimation too
+        BuildLevelsOfDetail( threadData );
+        double decodeTime = vtkTimerLog::GetUniversalTime() - loadStartTime;
 
-        if( !fromMainThread && !hasAnyTimeStep )
+        // A cancelled decode leaves the provider output untouched, so there is
+        // nothing to hand to Tick
+        if( IsLoaderJobCancelled( threadData ) )
         {
-            this->SetEntityNewDataAvailable();
+            FLUSHED_MESSAGE2( threadID, "Cancelled job dropped in msvEntityMgrImpl::RunLoaderWorker" );
+            DiscardLoaderJob( threadData );
+            continue;
         }
+
+        PublishLoadedFrames( threadData, decodeTime );
+        delete threadData;
     }
-    catch( exception e )
+}
+
+void msvEntityMgrImpl::StartLoaderPool()
+{
+    // Supposed to be called with LoaderQueueLock locked
+    if( !this->LoaderThreadIDs.empty() )
     {
-        FLUSHED_MESSAGE( "Exception occurred in msvEntityMgrImpl::LoadTimeSteps" );
-        entityInfoEntry->AccessLock->Unlock();
+        return;
+    }
+
+    this->LoaderShutdown = false;
+    this->LoaderThreader = vtkSmartPointer<vtkMultiThreader>::New();
+    for( int index = 0; index < this->NumberOfLoaderThreads; index++ )
+    {
+        int threadID = this->LoaderThreader->SpawnThread( TimeStepsLoaderThread, this );
+        if( threadID < 0 )
+        {
+            break;
+        }
+        this->LoaderThreadIDs.push_back( threadID );
     }
 }
 
-VTK_THREAD_RETURN_TYPE TimeStepsLoaderThread( void* arg )
+void msvEntityMgrImpl::StopLoaderPool()
 {
-    vtkMultiThreader::ThreadInfo* threadInfo = static_cast<vtkMultiThreader::ThreadInfo*>( arg );
-    int threadID = threadInfo->ThreadID;
-    msvEntityMgrThreadData* threadData = static_cast<msvEntityMgrThreadData*>( threadInfo->UserData );
+    list<msvEntityMgrThreadData*> discardedJobs;
+
+    this->LoaderQueueLock->Lock();
+    this->LoaderShutdown = true;
+    discardedJobs.swap( this->LoaderJobs );
+    this->LoaderQueueCondition->Broadcast();
+    this->LoaderQueueLock->Unlock();
+
+    // The workers leave on their own once they see the shutdown flag, so
+    // TerminateThread only joins them
+    vector<int>::iterator itThread;
+    for( itThread = this->LoaderThreadIDs.begin(); itThread != this->LoaderThreadIDs.end(); itThread++ )
+    {
+        this->LoaderThreader->TerminateThread( *itThread );
+    }
+    this->LoaderThreadIDs.clear();
+    this->LoaderThreader = 0;
 
-    msvEntityMgrImpl* entityMgr = threadData->entityMgr;
+    list<msvEntityMgrThreadData*>::iterator itJob;
+    for( itJob = discardedJobs.begin(); itJob != discardedJobs.end(); itJob++ )
+    {
+        DiscardLoaderJob( *itJob );
+    }
+}
+
+void msvEntityMgrImpl::EnqueueLoaderJob( msvEntityMgrThreadData* threadData )
+{
+    this->LoaderQueueLock->Lock();
+    StartLoaderPool();
+    this->LoaderJobs.push_back( threadData );
+    this->LoaderQueueCondition->Signal();
+    this->LoaderQueueLock->Unlock();
+}
+
+msvEntityMgrThreadData* msvEntityMgrImpl::DequeueLoaderJob()
+{
+    // Supposed to be called with LoaderQueueLock locked and a non empty queue.
+    // Ties keep the arrival order
+    list<msvEntityMgrThreadData*>::iterator itMostUrgent = this->LoaderJobs.begin();
+    list<msvEntityMgrThreadData*>::iterator it = itMostUrgent;
+    for( ++it; it != this->LoaderJobs.end(); it++ )
+    {
+        if( IsLoaderJobMoreUrgent( *it, *itMostUrgent ) )
+        {
+            itMostUrgent = it;
+        }
+    }
+    msvEntityMgrThreadData* threadData = *itMostUrgent;
+    this->LoaderJobs.erase( itMostUrgent );
+
+    return threadData;
+}
+
+bool msvEntityMgrImpl::IsLoaderJobMoreUrgent( msvEntityMgrThreadData* a, msvEntityMgrThreadData* b )
+{
+    // Visible entities first, then the job whose first step is the closest
+    // ahead of what its entity was showing, that is, the next needed one.
+    // Both come from the snapshot taken when the jobs were created
+    if( a->visibility != b->visibility )
+    {
+        return a->visibility > b->visibility;
+    }
 
+    int distanceA = a->firstFrameToLoad - a->currentTimeStep;
+    int distanceB = b->firstFrameToLoad - b->currentTimeStep;
+    if( distanceA < 0 )
+    {
+        distanceA += a->entityInfoEntry->availableTimeSteps;
+    }
+    if( distanceB < 0 )
+    {
+        distanceB += b->entityInfoEntry->availableTimeSteps;
+    }
+
+    return distanceA < distanceB;
+}
+
+void msvEntityMgrImpl::DiscardLoaderJob( msvEntityMgrThreadData* threadData )
+{
+    // Nothing is in flight for the entity anymore, so allow new requests.
+    // Steps dropped while still current, as when the pool is stopped, have
+    // to be loaded again; cancelled ones were replaced by a new position
     msvEntityInfoEntry* entityInfoEntry = threadData->entityInfoEntry;
+    entityInfoEntry->AccessLock->Lock();
+    if( !IsLoaderJobCancelled( threadData ) )
+    {
+        entityInfoEntry->firstTimeStepToLoad = threadData->firstFrameToLoad;
+    }
+    entityInfoEntry->timeStepsLoaded = true;
+    entityInfoEntry->AccessLock->Unlock();
 
-    // We set the last parameter to false, because we are not calling from main thread
-    entityMgr->LoadTimeSteps( entityInfoEntry, threadData->firstFrameToLoad, threadData->framesToLoad, false, threadID );
+    delete threadData;
+}
 
-    entityMgr->QueueFulfilledRequest( threadData, threadID );
+void msvEntityMgrImpl::CancelTimeStepLoads( msvEntityInfoEntry* entityInfoEntry )
+{
+    // Queued jobs are skipped when a worker takes them; a running decode is
+    // abandoned by the reader at its next check
+    msvAtomicAdd( &entityInfoEntry->loadGeneration, 1 );
+    entityInfoEntry->multipleDataReader->CancelPendingTimeSteps();
+}
 
-    // We don't need the user data anymore
-    //delete threadData;
-    //threadInfo->UserData = NULL;
+bool msvEntityMgrImpl::IsLoaderJobCancelled( msvEntityMgrThreadData* threadData )
+{
+    return threadData->generation != msvAtomicLoad( &threadData->entityInfoEntry->loadGeneration );
+}
 
-    return VTK_THREAD_RETURN_VALUE;
+void msvEntityMgrImpl::SetNumberOfLoaderThreads( int numberOfLoaderThreads )
+{
+    if( numberOfLoaderThreads < 1 )
+    {
+        numberOfLoaderThreads = 1;
+    }
+    if( numberOfLoaderThreads > VTK_MAX_THREADS )
+    {
+        numberOfLoaderThreads = VTK_MAX_THREADS;
+    }
+    if( numberOfLoaderThreads == this->NumberOfLoaderThreads )
+    {
+        return;
+    }
+
+    // A running pool is stopped; the next request starts it with the new size.
+    // Discarded requests are issued again by the entities on their next tick
+    StopLoaderPool();
+    this->NumberOfLoaderThreads = numberOfLoaderThreads;
+}
+
+int msvEntityMgrImpl::GetNumberOfLoaderThreads() const
+{
+    return this->NumberOfLoaderThreads;
+}
+
+void msvEntityMgrImpl::SetEntityLookahead( msvEntity* entity, int maxLookaheadDepth, bool adaptive )
+{
+    msvEntityInfoEntry* entityInfoEntry( GetEntityInfoEntry( entity ) );
+    if( entityInfoEntry == 0 )
+    {
+        return;
+    }
+    if( maxLookaheadDepth < 1 )
+    {
+        maxLookaheadDepth = 1;
+    }
+    if( maxLookaheadDepth > MaxLookaheadDepth )
+    {
+        maxLookaheadDepth = MaxLookaheadDepth;
+    }
+
+    entityInfoEntry->AccessLock->Lock();
+    entityInfoEntry->maxLookaheadDepth = maxLookaheadDepth;
+    entityInfoEntry->adaptiveLookahead = adaptive;
+    if( entityInfoEntry->lookaheadDepth > maxLookaheadDepth )
+    {
+        entityInfoEntry->lookaheadDepth = maxLookaheadDepth;
+    }
+    UpdateLookaheadDepth( entityInfoEntry );
+    entityInfoEntry->AccessLock->Unlock();
+
+    RequestSequentialTimeSteps( entityInfoEntry );
+}
+
+int msvEntityMgrImpl::GetEntityLookaheadDepth( msvEntity* entity )
+{
+    msvEntityInfoEntry* entityInfoEntry( GetEntityInfoEntry( entity ) );
+    if( entityInfoEntry == 0 )
+    {
+        return 0;
+    }
+
+    entityInfoEntry->AccessLock->Lock();
+    int lookaheadDepth = entityInfoEntry->lookaheadDepth;
+    entityInfoEntry->AccessLock->Unlock();
+
+    return lookaheadDepth;
+}
+
+void msvEntityMgrImpl::SetDefaultLookaheadDepth( int defaultLookaheadDepth )
+{
+    if( defaultLookaheadDepth < 1 )
+    {
+        defaultLookaheadDepth = 1;
+    }
+    if( defaultLookaheadDepth > MaxLookaheadDepth )
+    {
+        defaultLookaheadDepth = MaxLookaheadDepth;
+    }
+    this->DefaultLookaheadDepth = defaultLookaheadDepth;
+}
+
+int msvEntityMgrImpl::GetDefaultLookaheadDepth() const
+{
+    return this->DefaultLookaheadDepth;
+}
+
+vtkVolumeProperty* msvEntityMgrImpl::GetVolumeProperty()
+{
+    return this->SharedVolumeProperty;
 }
 
 void msvEntityMgrImpl::PreloadTimeSteps( msvEntityInfoEntry* entityInfoEntry, int firstTimeStepToPreload, int timeStepsToPreload )
@@ -657,64 +1111,67 @@ void msvEntityMgrImpl::PreloadTimeSteps( msvEntityInfoEntry* entityInfoEntry, in
 
 void msvEntityMgrImpl::FulfillTimeStepRequests()
 {
-    // Launches a thread for every request
+    // Hands to the loader pool the requests of the entities with no load in
+    // flight and less frames loaded than their lookahead. An entity stays
+    // queued until its lookahead is full; nothing here waits for a load
     this->TimeStepRequestQueueLock->Lock();
     try
     {
         FLUSHED_MESSAGE( "  Locked TimeStepRequestQueueLock in msvEntityMgrImpl::FulfillTimeStepRequests" );
-        int requestsLoadedButNotAssigned = 0;
-        while( ( this->TimeStepRequestQueue.size() > 0 ) && requestsLoadedButNotAssigned != this->TimeStepRequestQueue.size() ) 
+        list<msvEntityInfoEntry*>::iterator it = this->TimeStepRequestQueue.begin();
+        while( it != this->TimeStepRequestQueue.end() )
         {
-            bool requestLaunched = false;
-            list<msvEntityInfoEntry*>::iterator it;
-            for( it = this->TimeStepRequestQueue.begin(); it != this->TimeStepRequestQueue.end(); it++ )
-            {
-                msvEntityInfoEntry* entityInfoEntry = *it;
+            msvEntityInfoEntry* entityInfoEntry = *it;
+            msvEntityMgrThreadData* threadData = 0;
+            bool lookaheadFull = false;
 
-                int threadID;
-                entityInfoEntry->AccessLock->Lock();
-                try
+            entityInfoEntry->AccessLock->Lock();
+            try
+            {
+                if( entityInfoEntry->timeStepsLoaded )
                 {
-                    // The previous requested tim esteps where loaded, so we can launch a new one
-                    // We have to be sure that the time step has been asigned also
-                    if( entityInfoEntry->timeStepsLoaded )
+                    UpdateLookaheadDepth( entityInfoEntry );
+                    // Only the consumer side, this thread, can change the size
+                    // while no load is in flight
+                    int framesToLoad = entityInfoEntry->lookaheadDepth - static_cast<int>( entityInfoEntry->loadedFrames.GetSize() );
+                    if( framesToLoad > 0 )
                     {
-                        if( entityInfoEntry->timeStepAssigned )
-                        {
-                            entityInfoEntry->timeStepsLoaded = false;
-                            msvEntityMgrThreadData* threadData = new msvEntityMgrThreadData;
-                            threadData->entityMgr = this;
-                            threadData->entityInfoEntry = entityInfoEntry;
-                            threadData->firstFrameToLoad = entityInfoEntry->firstTimeStepToLoad;
-                            threadData->framesToLoad = 1;
-                            vtkMultiThreader* multiThreader = entityInfoEntry->multiThreader;
-
-                            FLUSHED_MESSAGE( "Going to swpawn thread in msvEntityMgrImpl::FulfillTimeStepRequests" );
-                            threadID = multiThreader->SpawnThread( TimeStepsLoaderThread, threadData );
-                            FLUSHED_MESSAGE( "Thread spawned in msvEntityMgrImpl::FulfillTimeStepRequests" );
-                            threadData->threadID = threadID;
-                            requestLaunched = true;
-                            entityInfoEntry->AccessLock->Unlock();
-                            break;
-                        }
-                        else
-                        {
-                            requestsLoadedButNotAssigned++;
-                        }
+                        entityInfoEntry->timeStepsLoaded = false;
+                        threadData = new msvEntityMgrThreadData;
+                        threadData->entityMgr = this;
+                        threadData->entityInfoEntry = entityInfoEntry;
+                        threadData->firstFrameToLoad = entityInfoEntry->firstTimeStepToLoad;
+                        threadData->framesToLoad = framesToLoad;
+                        threadData->threadID = -1;
+                        threadData->generation = msvAtomicLoad( &entityInfoEntry->loadGeneration );
+                        threadData->visibility = entityInfoEntry->Entity->GetVisibility();
+                        threadData->currentTimeStep = entityInfoEntry->currentTimeStep;
+                        // The next load continues where this one ends
+                        entityInfoEntry->firstTimeStepToLoad = ( entityInfoEntry->firstTimeStepToLoad + framesToLoad ) % entityInfoEntry->availableTimeSteps;
                     }
-                    entityInfoEntry->AccessLock->Unlock();
-                }
-                catch( exception& )
-                {
-                    FLUSHED_MESSAGE( "Exception occurred in msvEntityMgrImpl::FulfillTimeStepRequests" );
-                    entityInfoEntry->AccessLock->Unlock();
+                    lookaheadFull = true;
                 }
+                entityInfoEntry->AccessLock->Unlock();
             }
-            if( requestLaunched )
+            catch( exception& )
             {
-                this->TimeStepRequestQueue.erase( it );
+                FLUSHED_MESSAGE( "Exception occurred in msvEntityMgrImpl::FulfillTimeStepRequests" );
+                entityInfoEntry->AccessLock->Unlock();
+            }
+
+            if( threadData != 0 )
+            {
+                FLUSHED_MESSAGE( "Going to queue loader job in msvEntityMgrImpl::FulfillTimeStepRequests" );
+                EnqueueLoaderJob( threadData );
+            }
+            if( lookaheadFull )
+            {
+                it = this->TimeStepRequestQueue.erase( it );
+            }
+            else
+            {
+                it++;
             }
-            //this->TimeStepRequestQueue.clear();
         }
         this->TimeStepRequestQueueLock->Unlock();
         FLUSHED_MESSAGE( "UNLocked TimeStepRequestQueueLock in msvEntityMgrImpl::FulfillTimeStepRequests" );
@@ -727,115 +1184,38 @@ void msvEntityMgrImpl::FulfillTimeStepRequests()
     }
 }
 
-bool msvEntityMgrImpl::GetEntityNewDataAvailable()
-{
-    bool available;
-
-    this->FulfilledTimeStepRequestsLock->Lock();
-    FLUSHED_MESSAGE( "  Locked FulfilledTimeStepRequestsLock in msvEntityMgrImpl::GetEntityNewDataAvailable" );
-    available = this->EntityNewDataAvailable;
-    this->FulfilledTimeStepRequestsLock->Unlock();
-    FLUSHED_MESSAGE( "Unlocked FulfilledTimeStepRequestsLock in msvEntityMgrImpl::GetEntityNewDataAvailable" );
-
-    return available;
-}
-
-void msvEntityMgrImpl::SetEntityNewDataAvailable( bool available )
-{
-    this->FulfilledTimeStepRequestsLock->Lock();
-    FLUSHED_MESSAGE( "  Locked FulfilledTimeStepRequestsLock in msvEntityMgrImpl::SetEntityNewDataAvailable" );
-    this->EntityNewDataAvailable = available;
-    this->FulfilledTimeStepRequestsLock->Unlock();
-    FLUSHED_MESSAGE( "Unlocked FulfilledTimeStepRequestsLock in msvEntityMgrImpl::SetEntityNewDataAvailable" );
-}
-
 void msvEntityMgrImpl::Tick( long elapsedTime )
 {
-    this->FulfilledTimeStepRequestsLock->Lock();
-    try
+    MSV_TRACE_ZONE( "Tick" );
+
+    // Show what the loaders have finished. Popping from the rings never waits,
+    // so a decode in progress cannot stall the tick
+    bool newEntityShown = false;
+    bool timeStepChanged = false;
+    vector<msvEntityInfoEntry*>::iterator it;
+    for( it = this->EntityInfoEntries.begin(); it != this->EntityInfoEntries.end(); it++ )
     {
-        FLUSHED_MESSAGE( "  Locked FulfilledTimeStepRequestsLock in msvEntityMgrImpl::Tick" );
-        if( this->FulfilledTimeStepRequests.size() > 0 )
+        bool firstTimeStep;
+        if( ConsumeLoadedFrames( *it, firstTimeStep ) )
         {
-            // We are consuming, then lock
-            list<msvEntityMgrThreadData*>::iterator it;
-            for( it = this->FulfilledTimeStepRequests.begin(); it != this->FulfilledTimeStepRequests.end(); it++ )
-            {
-                msvEntityMgrThreadData* threadData = *it; 
-                msvEntityInfoEntry* entityInfoEntry = threadData->entityInfoEntry;
-                entityInfoEntry->AccessLock->Lock();
-                try
-                {
-                    bool frameSkip = false;
-                    int nextTimeStep;
-                    int cacheSize;
-                    int effectiveTimeStep( 0 );
-                    this->AlgorithmLock->Lock();
-                    try
-                    {
-                        nextTimeStep = entityInfoEntry->TSProvider->GetNextTimeStep();
-                        cacheSize = entityInfoEntry->TSProvider->GetCacheSize();
-                        int nextCachedTimeStep = 0;
-                        if( threadData->firstFrameToLoad < nextTimeStep )
-                        {
-                            // FrameSkip happened
-                            cout << "Frame Skip!!" << endl;
-                            frameSkip = true;
-                            effectiveTimeStep = nextTimeStep;
-                            nextCachedTimeStep;
-                        }
-                        else
-                        {
-                            effectiveTimeStep = threadData->firstFrameToLoad;
-                        }
-                        // Correct the frame step that was loaded
-                        entityInfoEntry->firstTimeStepToLoad = effectiveTimeStep;
-                        SetEntityCurrentTimeStep( entityInfoEntry, effectiveTimeStep, nextCachedTimeStep );
-                        entityInfoEntry->timeStepAssigned = true;
-                        this->AlgorithmLock->Unlock();
-                    }
-                    catch( exception e )
-                    {
-                        this->AlgorithmLock->Unlock();
-                    }
-
-                    //entityInfoEntry->timeStepsAssigned = true;
-                    //CRASH when active breakpoint
-                    if( entityInfoEntry->multiThreader->IsThreadActive( threadData->threadID ) )
-                    {
-                        FLUSHED_MESSAGE( "Going to terminate thread in msvEntityMgrImpl::Tick" );
-                        entityInfoEntry->multiThreader->TerminateThread( threadData->threadID );
-                        FLUSHED_MESSAGE( "Thread terminated in msvEntityMgrImpl::Tick" );
-                    }
-                    entityInfoEntry->AccessLock->Unlock();
-                }
-                catch( exception& )
-                {
-                    FLUSHED_MESSAGE( "Exception occurred in msvEntityMgrImpl::Tick(LOOP)" );
-                    entityInfoEntry->AccessLock->Unlock();
-                }
-                
-                delete threadData;
-            }
-            this->FulfilledTimeStepRequests.clear();
+            timeStepChanged = true;
+            newEntityShown = newEntityShown || firstTimeStep;
         }
-        this->FulfilledTimeStepRequestsLock->Unlock();
-        FLUSHED_MESSAGE( "Unlocked FulfilledTimeStepRequestsLock in msvEntityMgrImpl::Tick" );
-    }
-    catch( exception e )
-    {
-        FLUSHED_MESSAGE( "Exception occurred in msvEntityMgrImpl::Tick" );
-        this->FulfilledTimeStepRequestsLock->Unlock();
-        FLUSHED_MESSAGE( "Unlocked FulfilledTimeStepRequestsLock in msvEntityMgrImpl::Tick(CATCH)" );
     }
 
-    if( GetEntityNewDataAvailable() )
+    if( newEntityShown && this->AssignedRenderer )
     {
-        this->AssignedRenderer->ResetCamera();
-        SetEntityNewDataAvailable( false );
+        if( this->SceneUpdates )
+        {
+            // After the time steps queued above reach the scene
+            this->SceneUpdates->Push( new msvDeferredCall0<vtkRenderer>( &vtkRenderer::ResetCamera, this->AssignedRenderer ) );
+        }
+        else
+        {
+            this->AssignedRenderer->ResetCamera();
+        }
     }
 
-    vector<msvEntityInfoEntry*>::iterator it;
     for( it = this->EntityInfoEntries.begin(); it != this->EntityInfoEntries.end(); it++ )
     {
         (*it)->Entity->Tick( elapsedTime );
@@ -843,6 +1223,12 @@ void msvEntityMgrImpl::Tick( long elapsedTime )
 
     // Fulfill pending Requests
     FulfillTimeStepRequests();
+
+    // Lets the frame scheduler know the scene needs a render
+    if( timeStepChanged )
+    {
+        this->PublicInterface->Modified();
+    }
 }
 
 void msvEntityMgrImpl::PrintSelf( ostream& os, vtkIndent indent )
@@ -876,6 +1262,11 @@ void msvEntityMgr::SetRenderer( vtkRenderer* assignedRenderer )
     this->Impl->SetRenderer( assignedRenderer );
 }
 
+void msvEntityMgr::SetSceneUpdateQueue( msvDeferredCommandQueue* sceneUpdates )
+{
+    this->Impl->SetSceneUpdateQueue( sceneUpdates );
+}
+
 void msvEntityMgr::Tick( long elapsedTime )
 {
     this->Impl->Tick( elapsedTime );
@@ -891,6 +1282,41 @@ void msvEntityMgr::RequestNextSequentialTimeStep( msvEntity* requesterEntity )
     this->Impl->RequestNextSequentialTimeStep( requesterEntity );
 }
 
+void msvEntityMgr::SetNumberOfLoaderThreads( int numberOfLoaderThreads )
+{
+    this->Impl->SetNumberOfLoaderThreads( numberOfLoaderThreads );
+}
+
+int msvEntityMgr::GetNumberOfLoaderThreads()
+{
+    return this->Impl->GetNumberOfLoaderThreads();
+}
+
+void msvEntityMgr::SetEntityLookahead( msvEntity* entity, int maxLookaheadDepth, bool adaptive )
+{
+    this->Impl->SetEntityLookahead( entity, maxLookaheadDepth, adaptive );
+}
+
+int msvEntityMgr::GetEntityLookaheadDepth( msvEntity* entity )
+{
+    return this->Impl->GetEntityLookaheadDepth( entity );
+}
+
+void msvEntityMgr::SetDefaultLookaheadDepth( int defaultLookaheadDepth )
+{
+    this->Impl->SetDefaultLookaheadDepth( defaultLookaheadDepth );
+}
+
+int msvEntityMgr::GetDefaultLookaheadDepth()
+{
+    return this->Impl->GetDefaultLookaheadDepth();
+}
+
+vtkVolumeProperty* msvEntityMgr::GetVolumeProperty()
+{
+    return this->Impl->GetVolumeProperty();
+}
+
 void msvEntityMgr::PrintSelf( ostream& os, vtkIndent indent )
 {
     this->Superclass::PrintSelf( os, indent );
@@ -0,0 +1,343 @@
+/*==============================================================================
+
+  Library: MSVTK
+
+  Copyright (c) Computational Image and Simulation Technologies in Biomedicine (CISTIB),
+                Universitat Pompeu Fabra (UPF), Barcelona, Spain
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+#include "msvFrameTrace.h"
+
+#include <vtkCriticalSection.h>
+#include "msvAtomic.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <string.h>
+
+using namespace std;
+
+#if defined( _MSC_VER )
+#define MSV_THREAD_LOCAL __declspec( thread )
+#else
+#define MSV_THREAD_LOCAL __thread
+#endif
+
+namespace
+{
+    const int DefaultMaxEntries = 16384;
+
+    // Zones of one thread. Only the owner writes them. StartedCount counts
+    // the zones whose slot the owner has started to write, Count the ones
+    // it has finished, which tells the readers which slots are complete
+    struct msvTraceRing
+    {
+        std::vector<msvTraceEvent>      Events;
+        volatile long                   StartedCount;
+        volatile long                   Count;
+        int                             ThreadIndex;
+        const char*                     ThreadName;
+    };
+
+    // Guards the list of rings and MaxEntries, never taken while recording
+    vtkSimpleCriticalSection            RingsLock;
+    std::vector<msvTraceRing*>          Rings;
+    int                                 MaxEntries = DefaultMaxEntries;
+    volatile long                       FrameNumber = 0;
+    // Created with the first zone of the thread, so threads that never
+    // record while enabled cost nothing
+    MSV_THREAD_LOCAL msvTraceRing*      ThreadRing = 0;
+    MSV_THREAD_LOCAL const char*        ThreadName = 0;
+
+    // Frees the rings when the program ends
+    struct msvTraceRingsCleanup
+    {
+        ~msvTraceRingsCleanup()
+        {
+            for( size_t index = 0; index < Rings.size(); index++ )
+            {
+                delete Rings[index];
+            }
+            Rings.clear();
+        }
+    };
+    msvTraceRingsCleanup                RingsCleanup;
+
+    msvTraceRing* GetThreadRing()
+    {
+        if( ThreadRing == 0 )
+        {
+            msvTraceRing* ring = new msvTraceRing;
+            ring->StartedCount = 0;
+            ring->Count = 0;
+            ring->ThreadName = ThreadName;
+            RingsLock.Lock();
+            ring->Events.resize( MaxEntries );
+            ring->ThreadIndex = static_cast<int>( Rings.size() );
+            Rings.push_back( ring );
+            RingsLock.Unlock();
+            ThreadRing = ring;
+        }
+        return ThreadRing;
+    }
+
+    // Copies the complete zones of ring, oldest first
+    void CopyRingEvents( msvTraceRing* ring, std::vector<msvTraceEvent>& events )
+    {
+        long size = static_cast<long>( ring->Events.size() );
+        long countBefore = msvAtomicLoad( &ring->Count );
+        long first = max( countBefore - size, 0L );
+        size_t firstCopied = events.size();
+        for( long index = first; index < countBefore; index++ )
+        {
+            events.push_back( ring->Events[index % size] );
+        }
+        // The zones the owner started to overwrite meanwhile may be torn
+        long firstIntact = msvAtomicLoad( &ring->StartedCount ) - size;
+        if( firstIntact > first )
+        {
+            long torn = min( firstIntact - first, countBefore - first );
+            events.erase( events.begin() + firstCopied, events.begin() + firstCopied + torn );
+        }
+    }
+
+    void WriteJSONString( ostream& os, const char* text )
+    {
+        os << '"';
+        for( const char* character = text; *character != '\0'; character++ )
+        {
+            if( *character == '"' || *character == '\\' )
+            {
+                os << '\\';
+            }
+            os << *character;
+        }
+        os << '"';
+    }
+
+    // Nearest rank of the sorted durations
+    double GetPercentile( const std::vector<double>& sortedDurations, double fraction )
+    {
+        size_t rank = static_cast<size_t>( fraction * sortedDurations.size() + 0.999999 );
+        return sortedDurations[min( max( rank, static_cast<size_t>( 1 ) ), sortedDurations.size() ) - 1];
+    }
+}
+
+volatile int msvFrameTrace::Enabled = 0;
+
+msvTraceHistogram::msvTraceHistogram()
+: Count( 0 )
+, Minimum( 0.0 )
+, Maximum( 0.0 )
+, Mean( 0.0 )
+, Median( 0.0 )
+, Percentile95( 0.0 )
+, Percentile99( 0.0 )
+{
+    fill( this->Buckets, this->Buckets + NumberOfBuckets, 0UL );
+}
+
+void msvFrameTrace::SetEnabled( bool enabled )
+{
+    Enabled = enabled ? 1 : 0;
+}
+
+void msvFrameTrace::SetMaxEntries( int maxEntries )
+{
+    RingsLock.Lock();
+    MaxEntries = max( maxEntries, 1 );
+    RingsLock.Unlock();
+}
+
+int msvFrameTrace::GetMaxEntries()
+{
+    RingsLock.Lock();
+    int maxEntries = MaxEntries;
+    RingsLock.Unlock();
+    return maxEntries;
+}
+
+void msvFrameTrace::ResetLog()
+{
+    RingsLock.Lock();
+    for( size_t index = 0; index < Rings.size(); index++ )
+    {
+        std::vector<msvTraceEvent>( MaxEntries ).swap( Rings[index]->Events );
+        Rings[index]->StartedCount = 0;
+        Rings[index]->Count = 0;
+    }
+    RingsLock.Unlock();
+}
+
+void msvFrameTrace::NextFrame()
+{
+    msvAtomicAdd( &FrameNumber, 1 );
+}
+
+unsigned long msvFrameTrace::GetFrameNumber()
+{
+    return static_cast<unsigned long>( msvAtomicLoad( &FrameNumber ) );
+}
+
+void msvFrameTrace::SetThreadName( const char* name )
+{
+    ThreadName = name;
+    if( ThreadRing != 0 )
+    {
+        RingsLock.Lock();
+        ThreadRing->ThreadName = name;
+        RingsLock.Unlock();
+    }
+}
+
+void msvFrameTrace::RecordZone( const char* name, double startTime, double endTime )
+{
+    msvTraceRing* ring = GetThreadRing();
+    // Nobody else writes the counts. The first add warns the readers that
+    // the slot is changing, the second one publishes it
+    long count = ring->Count;
+    msvAtomicAdd( &ring->StartedCount, 1 );
+    msvTraceEvent& event = ring->Events[count % static_cast<long>( ring->Events.size() )];
+    event.Name = name;
+    event.StartTime = startTime;
+    event.Duration = endTime - startTime;
+    event.FrameNumber = static_cast<unsigned long>( FrameNumber );
+    event.ThreadIndex = ring->ThreadIndex;
+    msvAtomicAdd( &ring->Count, 1 );
+}
+
+void msvFrameTrace::GetEvents( std::vector<msvTraceEvent>& events )
+{
+    events.clear();
+    RingsLock.Lock();
+    for( size_t index = 0; index < Rings.size(); index++ )
+    {
+        CopyRingEvents( Rings[index], events );
+    }
+    RingsLock.Unlock();
+}
+
+bool msvFrameTrace::GetHistogram( const char* name, msvTraceHistogram& histogram )
+{
+    histogram = msvTraceHistogram();
+
+    std::vector<msvTraceEvent> events;
+    GetEvents( events );
+    std::vector<double> durations;
+    for( size_t index = 0; index < events.size(); index++ )
+    {
+        if( strcmp( events[index].Name, name ) == 0 )
+        {
+            durations.push_back( events[index].Duration );
+        }
+    }
+    if( durations.empty() )
+    {
+        return false;
+    }
+
+    sort( durations.begin(), durations.end() );
+    double sum = 0.0;
+    for( size_t index = 0; index < durations.size(); index++ )
+    {
+        sum += durations[index];
+        double microseconds = durations[index] * 1.0e6;
+        int bucket = 0;
+        for( double bucketEnd = 2.0; microseconds >= bucketEnd && bucket < msvTraceHistogram::NumberOfBuckets - 1; bucketEnd *= 2.0 )
+        {
+            bucket++;
+        }
+        histogram.Buckets[bucket]++;
+    }
+    histogram.Count = static_cast<unsigned long>( durations.size() );
+    histogram.Minimum = durations.front();
+    histogram.Maximum = durations.back();
+    histogram.Mean = sum / durations.size();
+    histogram.Median = GetPercentile( durations, 0.5 );
+    histogram.Percentile95 = GetPercentile( durations, 0.95 );
+    histogram.Percentile99 = GetPercentile( durations, 0.99 );
+    return true;
+}
+
+bool msvFrameTrace::WriteChromeTrace( const char* fileName )
+{
+    ofstream os( fileName );
+    if( !os )
+    {
+        return false;
+    }
+    WriteChromeTrace( os );
+    return !os.fail();
+}
+
+void msvFrameTrace::WriteChromeTrace( ostream& os )
+{
+    std::vector<msvTraceEvent> events;
+    GetEvents( events );
+
+    std::vector<const char*> threadNames;
+    RingsLock.Lock();
+    for( size_t index = 0; index < Rings.size(); index++ )
+    {
+        threadNames.push_back( Rings[index]->ThreadName );
+    }
+    RingsLock.Unlock();
+
+    // Microseconds from the first zone kept
+    double originTime = 0.0;
+    for( size_t index = 0; index < events.size(); index++ )
+    {
+        if( index == 0 || events[index].StartTime < originTime )
+        {
+            originTime = events[index].StartTime;
+        }
+    }
+
+    ios_base::fmtflags flags = os.flags();
+    streamsize precision = os.precision();
+    os << fixed << setprecision( 3 );
+
+    os << "{\"traceEvents\":[";
+    bool first = true;
+    for( size_t index = 0; index < threadNames.size(); index++ )
+    {
+        if( threadNames[index] == 0 )
+        {
+            continue;
+        }
+        os << ( first ? "\n" : ",\n" );
+        os << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << index << ",\"args\":{\"name\":";
+        WriteJSONString( os, threadNames[index] );
+        os << "}}";
+        first = false;
+    }
+    for( size_t index = 0; index < events.size(); index++ )
+    {
+        const msvTraceEvent& event = events[index];
+        os << ( first ? "\n" : ",\n" );
+        os << "{\"name\":";
+        WriteJSONString( os, event.Name );
+        os << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << event.ThreadIndex
+           << ",\"ts\":" << ( event.StartTime - originTime ) * 1.0e6
+           << ",\"dur\":" << event.Duration * 1.0e6
+           << ",\"args\":{\"frame\":" << event.FrameNumber << "}}";
+        first = false;
+    }
+    os << "\n],\"displayTimeUnit\":\"ms\"}" << endl;
+
+    os.flags( flags );
+    os.precision( precision );
+}
@@ -0,0 +1,182 @@
+/*==============================================================================
+
+  Library: MSVTK
+
+  Copyright (c) Computational Image and Simulation Technologies in Biomedicine (CISTIB),
+                Universitat Pompeu Fabra (UPF), Barcelona, Spain
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#include "msvReadWriteLock.h"
+
+#include <vtkObjectFactory.h>
+#include <vtkMutexLock.h>
+#include <vtkConditionVariable.h>
+#include <vtkTimerLog.h>
+#include "msvFrameTrace.h"
+
+msvLockCounters::msvLockCounters()
+: ReadLocks( 0 )
+, WriteLocks( 0 )
+, ContendedReadLocks( 0 )
+, ContendedWriteLocks( 0 )
+, ReadWaitTime( 0.0 )
+, WriteWaitTime( 0.0 )
+, WriteHoldTime( 0.0 )
+, MaximumWriteHoldTime( 0.0 )
+{
+}
+
+vtkStandardNewMacro( msvReadWriteLock );
+
+msvReadWriteLock::msvReadWriteLock()
+: StateLock( 0 )
+, ReadCondition( 0 )
+, WriteCondition( 0 )
+, ActiveReaders( 0 )
+, WaitingWriters( 0 )
+, WriterActive( false )
+, WriteLockTime( 0.0 )
+{
+    this->StateLock = vtkMutexLock::New();
+    this->ReadCondition = vtkConditionVariable::New();
+    this->WriteCondition = vtkConditionVariable::New();
+}
+
+msvReadWriteLock::~msvReadWriteLock()
+{
+    this->WriteCondition->Delete();
+    this->ReadCondition->Delete();
+    this->StateLock->Delete();
+}
+
+void msvReadWriteLock::LockRead()
+{
+    this->StateLock->Lock();
+    if( this->WriterActive )
+    {
+        // The clock is only read when there is a wait to measure
+        double waitStartTime = vtkTimerLog::GetUniversalTime();
+        while( this->WriterActive )
+        {
+            this->ReadCondition->Wait( this->StateLock );
+        }
+        double waitEndTime = vtkTimerLog::GetUniversalTime();
+        this->Counters.ContendedReadLocks++;
+        this->Counters.ReadWaitTime += waitEndTime - waitStartTime;
+        msvFrameTrace::AddZone( "LockWait", waitStartTime, waitEndTime );
+    }
+    this->ActiveReaders++;
+    this->Counters.ReadLocks++;
+    this->StateLock->Unlock();
+}
+
+void msvReadWriteLock::UnlockRead()
+{
+    this->StateLock->Lock();
+    if( this->ActiveReaders > 0 )
+    {
+        this->ActiveReaders--;
+    }
+    if( this->ActiveReaders == 0 && this->WaitingWriters > 0 )
+    {
+        this->WriteCondition->Signal();
+    }
+    this->StateLock->Unlock();
+}
+
+void msvReadWriteLock::LockWrite()
+{
+    this->StateLock->Lock();
+    if( this->WriterActive || this->ActiveReaders > 0 )
+    {
+        double waitStartTime = vtkTimerLog::GetUniversalTime();
+        this->WaitingWriters++;
+        while( this->WriterActive || this->ActiveReaders > 0 )
+        {
+            this->WriteCondition->Wait( this->StateLock );
+        }
+        this->WaitingWriters--;
+        double waitEndTime = vtkTimerLog::GetUniversalTime();
+        this->Counters.ContendedWriteLocks++;
+        this->Counters.WriteWaitTime += waitEndTime - waitStartTime;
+        msvFrameTrace::AddZone( "LockWait", waitStartTime, waitEndTime );
+    }
+    this->WriterActive = true;
+    this->WriteLockTime = vtkTimerLog::GetUniversalTime();
+    this->Counters.WriteLocks++;
+    this->StateLock->Unlock();
+}
+
+void msvReadWriteLock::UnlockWrite()
+{
+    this->StateLock->Lock();
+    if( !this->WriterActive )
+    {
+        this->StateLock->Unlock();
+        return;
+    }
+    double holdTime = vtkTimerLog::GetUniversalTime() - this->WriteLockTime;
+    this->Counters.WriteHoldTime += holdTime;
+    if( holdTime > this->Counters.MaximumWriteHoldTime )
+    {
+        this->Counters.MaximumWriteHoldTime = holdTime;
+    }
+    this->WriterActive = false;
+    // Readers first, the writers go when they are done
+    this->ReadCondition->Broadcast();
+    if( this->WaitingWriters > 0 )
+    {
+        this->WriteCondition->Signal();
+    }
+    this->StateLock->Unlock();
+}
+
+void msvReadWriteLock::Lock()
+{
+    LockWrite();
+}
+
+void msvReadWriteLock::Unlock()
+{
+    UnlockWrite();
+}
+
+void msvReadWriteLock::GetCounters( msvLockCounters& counters )
+{
+    this->StateLock->Lock();
+    counters = this->Counters;
+    this->StateLock->Unlock();
+}
+
+void msvReadWriteLock::ResetCounters()
+{
+    this->StateLock->Lock();
+    this->Counters = msvLockCounters();
+    this->StateLock->Unlock();
+}
+
+void msvReadWriteLock::PrintSelf( ostream& os, vtkIndent indent )
+{
+    this->Superclass::PrintSelf( os, indent );
+    msvLockCounters counters;
+    GetCounters( counters );
+    os << indent << "ReadLocks: " << counters.ReadLocks << " (" << counters.ContendedReadLocks << " contended)" << endl;
+    os << indent << "WriteLocks: " << counters.WriteLocks << " (" << counters.ContendedWriteLocks << " contended)" << endl;
+    os << indent << "ReadWaitTime: " << counters.ReadWaitTime << endl;
+    os << indent << "WriteWaitTime: " << counters.WriteWaitTime << endl;
+    os << indent << "WriteHoldTime: " << counters.WriteHoldTime << endl;
+    os << indent << "MaximumWriteHoldTime: " << counters.MaximumWriteHoldTime << endl;
+}
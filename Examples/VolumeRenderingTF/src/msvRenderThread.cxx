@@ -0,0 +1,338 @@
+/*==============================================================================
+
+  Library: MSVTK
+
+  Copyright (c) Computational Image and Simulation Technologies in Biomedicine (CISTIB),
+                Universitat Pompeu Fabra (UPF), Barcelona, Spain
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#include "msvRenderThread.h"
+#include "msvFrameTrace.h"
+
+#include <vtkObjectFactory.h>
+#include <vtkRenderWindow.h>
+#include <vtkRenderer.h>
+#include <vtkCamera.h>
+#include <vtkCallbackCommand.h>
+#include <vtkTimerLog.h>
+#include <vtksys/SystemTools.hxx>
+
+#include <algorithm>
+
+using namespace std;
+
+msvViewState::msvViewState()
+: ViewAngle( 30.0 )
+, ParallelScale( 1.0 )
+, ParallelProjection( 0 )
+{
+    // Defaults of vtkCamera
+    this->Position[0] = 0.0;
+    this->Position[1] = 0.0;
+    this->Position[2] = 1.0;
+    this->FocalPoint[0] = 0.0;
+    this->FocalPoint[1] = 0.0;
+    this->FocalPoint[2] = 0.0;
+    this->ViewUp[0] = 0.0;
+    this->ViewUp[1] = 1.0;
+    this->ViewUp[2] = 0.0;
+    this->Size[0] = 0;
+    this->Size[1] = 0;
+}
+
+vtkStandardNewMacro( msvRenderThread );
+
+msvRenderThread::msvRenderThread()
+: ThreadID( -1 )
+, StopRequested( 0 )
+, RenderRequested( 0 )
+, MaximumFrameRate( 60.0 )
+, AppliedCameraMTime( 0 )
+, WatchTag( 0 )
+, SyncingWatchedCamera( false )
+, NumberOfRenderedFrames( 0 )
+, NumberOfAppliedViewStates( 0 )
+, MaximumFrameTime( 0.0 )
+{
+    this->Threader = vtkSmartPointer<vtkMultiThreader>::New();
+    this->SceneUpdates = msvDeferredCommandQueueSP::New();
+    this->WatchCommand = vtkSmartPointer<vtkCallbackCommand>::New();
+    this->WatchCommand->SetCallback( msvRenderThread::OnWatchedCameraModified );
+    this->WatchCommand->SetClientData( this );
+}
+
+msvRenderThread::~msvRenderThread()
+{
+    Stop();
+    WatchCamera( 0 );
+}
+
+void msvRenderThread::SetRenderWindow( vtkRenderWindow* renderWindow )
+{
+    this->RenderWindow = renderWindow;
+}
+
+vtkRenderWindow* msvRenderThread::GetRenderWindow()
+{
+    return this->RenderWindow;
+}
+
+void msvRenderThread::SetRenderer( vtkRenderer* renderer )
+{
+    this->Renderer = renderer;
+}
+
+vtkRenderer* msvRenderThread::GetRenderer()
+{
+    return this->Renderer;
+}
+
+void msvRenderThread::SetMaximumFrameRate( double maximumFrameRate )
+{
+    this->MaximumFrameRate = max( maximumFrameRate, 1.0 );
+}
+
+double msvRenderThread::GetMaximumFrameRate()
+{
+    return this->MaximumFrameRate;
+}
+
+void msvRenderThread::Start()
+{
+    if( IsRunning() || !this->RenderWindow )
+    {
+        return;
+    }
+    this->StopRequested = 0;
+    this->NumberOfRenderedFrames = 0;
+    this->NumberOfAppliedViewStates = 0;
+    this->MaximumFrameTime = 0.0;
+    // The first frame shows whatever the window holds
+    this->RenderRequested = 1;
+    this->ThreadID = this->Threader->SpawnThread( msvRenderThread::RenderLoop, this );
+}
+
+void msvRenderThread::Stop()
+{
+    if( !IsRunning() )
+    {
+        return;
+    }
+    msvAtomicExchange( &this->StopRequested, 1 );
+    this->Threader->TerminateThread( this->ThreadID );
+    this->ThreadID = -1;
+}
+
+bool msvRenderThread::IsRunning()
+{
+    return this->ThreadID >= 0;
+}
+
+void msvRenderThread::PostViewState( const msvViewState& viewState )
+{
+    this->PostedViewStates.Publish( viewState );
+}
+
+void msvRenderThread::WatchCamera( vtkCamera* camera )
+{
+    if( this->WatchedCamera )
+    {
+        this->WatchedCamera->RemoveObserver( this->WatchTag );
+    }
+    this->WatchedCamera = camera;
+    this->WatchTag = 0;
+    if( camera )
+    {
+        this->WatchTag = camera->AddObserver( vtkCommand::ModifiedEvent, this->WatchCommand );
+    }
+}
+
+bool msvRenderThread::SyncWatchedCamera()
+{
+    if( !this->RenderedViewStates.Update() )
+    {
+        return false;
+    }
+    if( this->WatchedCamera )
+    {
+        this->SyncingWatchedCamera = true;
+        ApplyViewState( this->RenderedViewStates.GetFront(), this->WatchedCamera );
+        this->SyncingWatchedCamera = false;
+    }
+    return true;
+}
+
+void msvRenderThread::OnWatchedCameraModified( vtkObject* caller, unsigned long eventId, void* clientData, void* callData )
+{
+    msvRenderThread* self = static_cast<msvRenderThread*>( clientData );
+    vtkCamera* camera = vtkCamera::SafeDownCast( caller );
+    if( self->SyncingWatchedCamera || !camera )
+    {
+        return;
+    }
+    msvViewState viewState;
+    CaptureViewState( camera, viewState );
+    self->PostViewState( viewState );
+}
+
+void msvRenderThread::PostSceneUpdate( msvDeferredCommand* command )
+{
+    this->SceneUpdates->Push( command );
+}
+
+msvDeferredCommandQueue* msvRenderThread::GetSceneUpdates()
+{
+    return this->SceneUpdates;
+}
+
+void msvRenderThread::RequestRender()
+{
+    msvAtomicExchange( &this->RenderRequested, 1 );
+}
+
+void msvRenderThread::CaptureViewState( vtkCamera* camera, msvViewState& viewState )
+{
+    camera->GetPosition( viewState.Position );
+    camera->GetFocalPoint( viewState.FocalPoint );
+    camera->GetViewUp( viewState.ViewUp );
+    viewState.ViewAngle = camera->GetViewAngle();
+    viewState.ParallelScale = camera->GetParallelScale();
+    viewState.ParallelProjection = camera->GetParallelProjection();
+}
+
+void msvRenderThread::ApplyViewState( const msvViewState& viewState, vtkCamera* camera )
+{
+    camera->SetPosition( viewState.Position[0], viewState.Position[1], viewState.Position[2] );
+    camera->SetFocalPoint( viewState.FocalPoint[0], viewState.FocalPoint[1], viewState.FocalPoint[2] );
+    camera->SetViewUp( viewState.ViewUp[0], viewState.ViewUp[1], viewState.ViewUp[2] );
+    camera->SetViewAngle( viewState.ViewAngle );
+    camera->SetParallelScale( viewState.ParallelScale );
+    camera->SetParallelProjection( viewState.ParallelProjection );
+}
+
+bool msvRenderThread::ApplyPostedChanges()
+{
+    MSV_TRACE_ZONE( "ApplyPostedChanges" );
+    bool dirty = ( msvAtomicExchange( &this->RenderRequested, 0 ) != 0 );
+    vtkCamera* camera = this->Renderer ? this->Renderer->GetActiveCamera() : 0;
+
+    if( this->PostedViewStates.Update() )
+    {
+        dirty = true;
+        msvAtomicAdd( &this->NumberOfAppliedViewStates, 1 );
+        const msvViewState& viewState = this->PostedViewStates.GetFront();
+        if( camera )
+        {
+            ApplyViewState( viewState, camera );
+            // The interactor style resets the range on its own renderer,
+            // which does not hold the props
+            this->Renderer->ResetCameraClippingRange();
+        }
+        int* size = this->RenderWindow->GetSize();
+        if( viewState.Size[0] > 0 && viewState.Size[1] > 0 &&
+            ( viewState.Size[0] != size[0] || viewState.Size[1] != size[1] ) )
+        {
+            this->RenderWindow->SetSize( viewState.Size[0], viewState.Size[1] );
+        }
+        if( camera )
+        {
+            this->AppliedCameraMTime = camera->GetMTime();
+        }
+    }
+
+    if( this->SceneUpdates->ApplyAll() > 0 )
+    {
+        dirty = true;
+        // Tell the GUI thread when the updates moved the camera, e.g. reset
+        // it to the bounds of a new entity, so its camera does not undo it
+        if( camera && camera->GetMTime() > this->AppliedCameraMTime )
+        {
+            msvViewState renderedState;
+            CaptureViewState( camera, renderedState );
+            this->RenderedViewStates.Publish( renderedState );
+        }
+    }
+
+    return dirty;
+}
+
+void msvRenderThread::RenderFrame()
+{
+    this->RenderWindow->Render();
+    msvAtomicAdd( &this->NumberOfRenderedFrames, 1 );
+    // Rendering adjusts the camera too, that is no news for the GUI thread
+    if( this->Renderer )
+    {
+        this->AppliedCameraMTime = this->Renderer->GetActiveCamera()->GetMTime();
+    }
+}
+
+VTK_THREAD_RETURN_TYPE msvRenderThread::RenderLoop( void* arg )
+{
+    vtkMultiThreader::ThreadInfo* threadInfo = static_cast<vtkMultiThreader::ThreadInfo*>( arg );
+    static_cast<msvRenderThread*>( threadInfo->UserData )->RenderLoop();
+    return VTK_THREAD_RETURN_VALUE;
+}
+
+void msvRenderThread::RenderLoop()
+{
+    msvFrameTrace::SetThreadName( "Render" );
+    while( msvAtomicLoad( &this->StopRequested ) == 0 )
+    {
+        double frameStartTime = vtkTimerLog::GetUniversalTime();
+        if( ApplyPostedChanges() )
+        {
+            RenderFrame();
+            this->MaximumFrameTime = max( this->MaximumFrameTime, vtkTimerLog::GetUniversalTime() - frameStartTime );
+        }
+
+        // Whatever is posted meanwhile waits for the next frame period
+        double frameTime = vtkTimerLog::GetUniversalTime() - frameStartTime;
+        double waitTime = 1.0 / this->MaximumFrameRate - frameTime;
+        vtksys::SystemTools::Delay( waitTime > 0.0 ? static_cast<unsigned int>( waitTime * 1000.0 ) : 0 );
+    }
+
+    // Whatever was posted before Stop reaches the scene
+    if( ApplyPostedChanges() )
+    {
+        RenderFrame();
+    }
+}
+
+unsigned long msvRenderThread::GetNumberOfRenderedFrames()
+{
+    return static_cast<unsigned long>( msvAtomicLoad( &this->NumberOfRenderedFrames ) );
+}
+
+unsigned long msvRenderThread::GetNumberOfAppliedViewStates()
+{
+    return static_cast<unsigned long>( msvAtomicLoad( &this->NumberOfAppliedViewStates ) );
+}
+
+double msvRenderThread::GetMaximumFrameTime()
+{
+    return this->MaximumFrameTime;
+}
+
+void msvRenderThread::PrintSelf( ostream& os, vtkIndent indent )
+{
+    this->Superclass::PrintSelf( os, indent );
+    os << indent << "Running: " << ( IsRunning() ? "On" : "Off" ) << endl;
+    os << indent << "MaximumFrameRate: " << this->MaximumFrameRate << endl;
+    os << indent << "NumberOfRenderedFrames: " << GetNumberOfRenderedFrames() << endl;
+    os << indent << "NumberOfAppliedViewStates: " << GetNumberOfAppliedViewStates() << endl;
+    os << indent << "MaximumFrameTime: " << this->MaximumFrameTime << endl;
+}
@@ -0,0 +1,197 @@
+/*==============================================================================
+
+  Library: MSVTK
+
+  Copyright (c) Computational Image and Simulation Technologies in Biomedicine (CISTIB),
+                Universitat Pompeu Fabra (UPF), Barcelona, Spain
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#include "vtkDataArrayPool.h"
+
+#include <vtkObjectFactory.h>
+#include <vtkSmartPointer.h>
+#include <vtkCriticalSection.h>
+#include <vtkInformation.h>
+#include <vtkInformationIntegerKey.h>
+#include <vtkDataArray.h>
+#include <vtkDataSet.h>
+#include <vtkPointSet.h>
+#include <vtkPoints.h>
+#include <vtkPointData.h>
+#include <vtkCellData.h>
+
+#include <list>
+#include <vector>
+
+using namespace std;
+
+class vtkDataArrayPoolInternals
+{
+public:
+    vtkSimpleCriticalSection Lock;
+    // Newest at the back
+    list< vtkSmartPointer<vtkDataArray> > FreeArrays;
+    list< vtkSmartPointer<vtkDataObject> > RecycledObjects;
+};
+
+vtkStandardNewMacro( vtkDataArrayPool );
+
+vtkInformationKeyMacro( vtkDataArrayPool, POOLED_ARRAY, Integer );
+
+vtkDataArrayPool::vtkDataArrayPool()
+: MaxFreeArrays( 8 )
+, NumberOfHits( 0 )
+, NumberOfMisses( 0 )
+, RecycledBytes( 0 )
+, Internals( new vtkDataArrayPoolInternals )
+{
+}
+
+vtkDataArrayPool::~vtkDataArrayPool()
+{
+    delete this->Internals;
+}
+
+//----------------------------------------------------------------------------
+vtkDataArray* vtkDataArrayPool::Acquire( int dataType, int numComponents, vtkIdType numTuples )
+{
+    this->Internals->Lock.Lock();
+    this->HarvestRecycledObjects();
+    list< vtkSmartPointer<vtkDataArray> >::reverse_iterator it;
+    for( it = this->Internals->FreeArrays.rbegin(); it != this->Internals->FreeArrays.rend(); ++it )
+    {
+        vtkDataArray* freeArray = *it;
+        if( ( freeArray->GetDataType() == dataType ) &&
+            ( freeArray->GetNumberOfComponents() == numComponents ) &&
+            ( freeArray->GetNumberOfTuples() == numTuples ) )
+        {
+            freeArray->Register( 0 );
+            this->Internals->FreeArrays.erase( --( it.base() ) );
+            this->NumberOfHits++;
+            this->RecycledBytes += static_cast<vtkTypeInt64>( numTuples ) * numComponents * freeArray->GetDataTypeSize();
+            this->Internals->Lock.Unlock();
+
+            freeArray->SetName( 0 );
+            return freeArray;
+        }
+    }
+    this->NumberOfMisses++;
+    this->Internals->Lock.Unlock();
+
+    vtkDataArray* newArray = vtkDataArray::CreateDataArray( dataType );
+    newArray->SetNumberOfComponents( numComponents );
+    newArray->SetNumberOfTuples( numTuples );
+    newArray->GetInformation()->Set( POOLED_ARRAY(), 1 );
+    return newArray;
+}
+
+//----------------------------------------------------------------------------
+void vtkDataArrayPool::Recycle( vtkDataObject* dataObject )
+{
+    if( !dataObject )
+    {
+        return;
+    }
+    this->Internals->Lock.Lock();
+    this->Internals->RecycledObjects.push_back( dataObject );
+    // Steps still referenced elsewhere for long should not pile up
+    while( static_cast<int>( this->Internals->RecycledObjects.size() ) > 2 * this->MaxFreeArrays + 2 )
+    {
+        this->Internals->RecycledObjects.pop_front();
+    }
+    this->Internals->Lock.Unlock();
+}
+
+//----------------------------------------------------------------------------
+void vtkDataArrayPool::HarvestRecycledObjects()
+{
+    // Lock held by the caller
+    list< vtkSmartPointer<vtkDataObject> >::iterator it = this->Internals->RecycledObjects.begin();
+    while( it != this->Internals->RecycledObjects.end() )
+    {
+        // Somebody else may still be using the step, the renderer for instance
+        if( (*it)->GetReferenceCount() > 1 )
+        {
+            ++it;
+            continue;
+        }
+
+        vtkDataSet* dataSet = vtkDataSet::SafeDownCast( *it );
+        if( dataSet )
+        {
+            vector<vtkDataArray*> arrays;
+            for( int indexArray = 0; indexArray < dataSet->GetPointData()->GetNumberOfArrays(); indexArray++ )
+            {
+                arrays.push_back( dataSet->GetPointData()->GetArray( indexArray ) );
+            }
+            for( int indexArray = 0; indexArray < dataSet->GetCellData()->GetNumberOfArrays(); indexArray++ )
+            {
+                arrays.push_back( dataSet->GetCellData()->GetArray( indexArray ) );
+            }
+            vtkPointSet* pointSet = vtkPointSet::SafeDownCast( dataSet );
+            if( pointSet && pointSet->GetPoints() )
+            {
+                arrays.push_back( pointSet->GetPoints()->GetData() );
+            }
+
+            for( size_t indexArray = 0; indexArray < arrays.size(); indexArray++ )
+            {
+                // Only the step holds the array, it goes away with it
+                vtkDataArray* array = arrays[indexArray];
+                if( array && ( array->GetReferenceCount() == 1 ) &&
+                    array->GetInformation()->Has( POOLED_ARRAY() ) )
+                {
+                    this->Internals->FreeArrays.push_back( array );
+                }
+            }
+        }
+        it = this->Internals->RecycledObjects.erase( it );
+    }
+
+    while( static_cast<int>( this->Internals->FreeArrays.size() ) > this->MaxFreeArrays )
+    {
+        this->Internals->FreeArrays.pop_front();
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkDataArrayPool::Clear()
+{
+    this->Internals->Lock.Lock();
+    this->Internals->FreeArrays.clear();
+    this->Internals->RecycledObjects.clear();
+    this->Internals->Lock.Unlock();
+}
+
+//----------------------------------------------------------------------------
+void vtkDataArrayPool::ResetStatistics()
+{
+    this->Internals->Lock.Lock();
+    this->NumberOfHits = 0;
+    this->NumberOfMisses = 0;
+    this->RecycledBytes = 0;
+    this->Internals->Lock.Unlock();
+}
+
+void vtkDataArrayPool::PrintSelf( ostream& os, vtkIndent indent )
+{
+    this->Superclass::PrintSelf( os, indent );
+
+    os << indent << "MaxFreeArrays: " << this->MaxFreeArrays << "\n";
+    os << indent << "NumberOfHits: " << this->NumberOfHits << "\n";
+    os << indent << "NumberOfMisses: " << this->NumberOfMisses << "\n";
+    os << indent << "RecycledBytes: " << this->RecycledBytes << "\n";
+}
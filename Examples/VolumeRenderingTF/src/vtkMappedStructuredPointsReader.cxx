@@ -0,0 +1,465 @@
+/*==============================================================================
+
+  Library: MSVTK
+
+  Copyright (c) Computational Image and Simulation Technologies in Biomedicine (CISTIB),
+                Universitat Pompeu Fabra (UPF), Barcelona, Spain
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#include "vtkMappedStructuredPointsReader.h"
+
+#include <vtkObjectFactory.h>
+#include <vtkSmartPointer.h>
+#include <vtkErrorCode.h>
+#include <vtkInformation.h>
+#include <vtkInformationVector.h>
+#include <vtkInformationObjectBaseKey.h>
+#include <vtkStructuredPoints.h>
+#include <vtkPointData.h>
+#include <vtkDataArray.h>
+#include <vtkByteSwap.h>
+#include "vtkDataArrayPool.h"
+
+#if defined( _WIN32 )
+#include <windows.h>
+#else
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+
+using namespace std;
+
+//----------------------------------------------------------------------------
+// Read only mapping of a whole file, unmapped when the last array using it
+// goes away
+class vtkMappedFileRegion : public vtkObject
+{
+public:
+    static vtkMappedFileRegion* New();
+    vtkTypeMacro( vtkMappedFileRegion, vtkObject );
+
+    bool Map( const char* fileName );
+    const char* GetData() const { return this->Data; }
+    size_t GetSize() const { return this->Size; }
+
+protected:
+    vtkMappedFileRegion();
+    ~vtkMappedFileRegion();
+
+    void Unmap();
+
+    const char* Data;
+    size_t Size;
+#if defined( _WIN32 )
+    HANDLE File;
+    HANDLE Mapping;
+#endif
+
+private:
+    vtkMappedFileRegion( const vtkMappedFileRegion& );  // Not implemented.
+    void operator=( const vtkMappedFileRegion& );  // Not implemented.
+};
+
+vtkStandardNewMacro( vtkMappedFileRegion );
+
+vtkMappedFileRegion::vtkMappedFileRegion()
+: Data( 0 )
+, Size( 0 )
+#if defined( _WIN32 )
+, File( INVALID_HANDLE_VALUE )
+, Mapping( 0 )
+#endif
+{
+}
+
+vtkMappedFileRegion::~vtkMappedFileRegion()
+{
+    this->Unmap();
+}
+
+bool vtkMappedFileRegion::Map( const char* fileName )
+{
+    this->Unmap();
+#if defined( _WIN32 )
+    this->File = CreateFileA( fileName, GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0 );
+    if( this->File == INVALID_HANDLE_VALUE )
+    {
+        return false;
+    }
+    LARGE_INTEGER fileSize;
+    if( !GetFileSizeEx( this->File, &fileSize ) || ( fileSize.QuadPart == 0 ) )
+    {
+        this->Unmap();
+        return false;
+    }
+    this->Mapping = CreateFileMappingA( this->File, 0, PAGE_READONLY, 0, 0, 0 );
+    if( !this->Mapping )
+    {
+        this->Unmap();
+        return false;
+    }
+    this->Data = static_cast<const char*>( MapViewOfFile( this->Mapping, FILE_MAP_READ, 0, 0, 0 ) );
+    if( !this->Data )
+    {
+        this->Unmap();
+        return false;
+    }
+    this->Size = static_cast<size_t>( fileSize.QuadPart );
+#else
+    int fileDescriptor = open( fileName, O_RDONLY );
+    if( fileDescriptor < 0 )
+    {
+        return false;
+    }
+    struct stat fileStat;
+    if( ( fstat( fileDescriptor, &fileStat ) != 0 ) || ( fileStat.st_size == 0 ) )
+    {
+        close( fileDescriptor );
+        return false;
+    }
+    void* data = mmap( 0, static_cast<size_t>( fileStat.st_size ), PROT_READ, MAP_SHARED, fileDescriptor, 0 );
+    // The mapping stays valid once the descriptor is closed
+    close( fileDescriptor );
+    if( data == MAP_FAILED )
+    {
+        return false;
+    }
+    this->Data = static_cast<const char*>( data );
+    this->Size = static_cast<size_t>( fileStat.st_size );
+#endif
+    return true;
+}
+
+void vtkMappedFileRegion::Unmap()
+{
+#if defined( _WIN32 )
+    if( this->Data )
+    {
+        UnmapViewOfFile( this->Data );
+    }
+    if( this->Mapping )
+    {
+        CloseHandle( this->Mapping );
+        this->Mapping = 0;
+    }
+    if( this->File != INVALID_HANDLE_VALUE )
+    {
+        CloseHandle( this->File );
+        this->File = INVALID_HANDLE_VALUE;
+    }
+#else
+    if( this->Data )
+    {
+        munmap( const_cast<char*>( this->Data ), this->Size );
+    }
+#endif
+    this->Data = 0;
+    this->Size = 0;
+}
+
+//----------------------------------------------------------------------------
+namespace
+{
+    // Legacy type names of the scalars that can be used as stored
+    int GetLegacyDataType( const char* typeName )
+    {
+        if( !strcmp( typeName, "unsigned_char" ) )
+        {
+            return VTK_UNSIGNED_CHAR;
+        }
+        else if( !strcmp( typeName, "char" ) )
+        {
+            return VTK_CHAR;
+        }
+        else if( !strcmp( typeName, "unsigned_short" ) )
+        {
+            return VTK_UNSIGNED_SHORT;
+        }
+        else if( !strcmp( typeName, "short" ) )
+        {
+            return VTK_SHORT;
+        }
+        else if( !strcmp( typeName, "unsigned_int" ) )
+        {
+            return VTK_UNSIGNED_INT;
+        }
+        else if( !strcmp( typeName, "int" ) )
+        {
+            return VTK_INT;
+        }
+        else if( !strcmp( typeName, "float" ) )
+        {
+            return VTK_FLOAT;
+        }
+        else if( !strcmp( typeName, "double" ) )
+        {
+            return VTK_DOUBLE;
+        }
+        // bit, long and vtkIdType have no fixed size in the file
+        return -1;
+    }
+}
+
+vtkStandardNewMacro( vtkMappedStructuredPointsReader );
+
+vtkInformationKeyMacro( vtkMappedStructuredPointsReader, MAPPED_FILE_REGION, ObjectBase );
+
+vtkMappedStructuredPointsReader::vtkMappedStructuredPointsReader()
+: MemoryMapping( 1 )
+, ScalarsMapped( 0 )
+, ArrayPool( 0 )
+{
+}
+
+vtkMappedStructuredPointsReader::~vtkMappedStructuredPointsReader()
+{
+    this->SetArrayPool( 0 );
+}
+
+vtkCxxSetObjectMacro( vtkMappedStructuredPointsReader, ArrayPool, vtkDataArrayPool );
+
+//----------------------------------------------------------------------------
+int vtkMappedStructuredPointsReader::RequestData(
+    vtkInformation* request,
+    vtkInformationVector** inputVector,
+    vtkInformationVector* outputVector )
+{
+    this->ScalarsMapped = 0;
+    if( this->MemoryMapping && !this->GetReadFromInputString() && this->ReadBinaryScalars( outputVector ) )
+    {
+        return 1;
+    }
+    return this->Superclass::RequestData( request, inputVector, outputVector );
+}
+
+//----------------------------------------------------------------------------
+bool vtkMappedStructuredPointsReader::ReadBinaryScalars( vtkInformationVector* outputVector )
+{
+    if( !this->OpenVTKFile() || !this->ReadHeader() )
+    {
+        this->CloseVTKFile();
+        return false;
+    }
+    if( this->GetFileType() != VTK_BINARY )
+    {
+        this->CloseVTKFile();
+        return false;
+    }
+
+    char line[256];
+    if( !this->ReadString( line ) || strncmp( this->LowerCase( line ), "dataset", 7 ) ||
+        !this->ReadString( line ) || strncmp( this->LowerCase( line ), "structured_points", 17 ) )
+    {
+        this->CloseVTKFile();
+        return false;
+    }
+
+    // Geometry, up to the point data. Anything else goes through the superclass
+    int dimensions[3] = { -1, -1, -1 };
+    double spacing[3] = { 1.0, 1.0, 1.0 };
+    double origin[3] = { 0.0, 0.0, 0.0 };
+    int numPoints = -1;
+    while( numPoints < 0 )
+    {
+        if( !this->ReadString( line ) )
+        {
+            this->CloseVTKFile();
+            return false;
+        }
+        this->LowerCase( line );
+        bool validKeyword = true;
+        if( !strncmp( line, "dimensions", 10 ) )
+        {
+            validKeyword = this->Read( dimensions ) && this->Read( dimensions + 1 ) && this->Read( dimensions + 2 );
+        }
+        else if( !strncmp( line, "spacing", 7 ) || !strncmp( line, "aspect_ratio", 12 ) )
+        {
+            validKeyword = this->Read( spacing ) && this->Read( spacing + 1 ) && this->Read( spacing + 2 );
+        }
+        else if( !strncmp( line, "origin", 6 ) )
+        {
+            validKeyword = this->Read( origin ) && this->Read( origin + 1 ) && this->Read( origin + 2 );
+        }
+        else if( !strncmp( line, "point_data", 10 ) )
+        {
+            validKeyword = this->Read( &numPoints ) && ( numPoints >= 0 );
+        }
+        else
+        {
+            validKeyword = false;
+        }
+        if( !validKeyword )
+        {
+            this->CloseVTKFile();
+            return false;
+        }
+    }
+    if( ( dimensions[0] < 0 ) || ( numPoints != dimensions[0] * dimensions[1] * dimensions[2] ) )
+    {
+        this->CloseVTKFile();
+        return false;
+    }
+
+    // SCALARS name type [numComp] LOOKUP_TABLE tableName, as vtkDataReader::ReadScalarData
+    char scalarsName[256];
+    char typeName[256];
+    int numComponents = 1;
+    if( !this->ReadString( line ) || strncmp( this->LowerCase( line ), "scalars", 7 ) ||
+        !this->ReadString( scalarsName ) || !this->ReadString( typeName ) || !this->ReadString( line ) )
+    {
+        this->CloseVTKFile();
+        return false;
+    }
+    if( strcmp( this->LowerCase( line ), "lookup_table" ) )
+    {
+        numComponents = atoi( line );
+        if( ( numComponents < 1 ) || !this->ReadString( line ) || strcmp( this->LowerCase( line ), "lookup_table" ) )
+        {
+            this->CloseVTKFile();
+            return false;
+        }
+    }
+    // The table name, then the rest of the line before the binary data
+    if( !this->ReadString( line ) )
+    {
+        this->CloseVTKFile();
+        return false;
+    }
+    this->GetIStream()->getline( line, 256 );
+    streamoff payloadOffset = this->GetIStream()->tellg();
+    this->CloseVTKFile();
+    if( payloadOffset <= 0 )
+    {
+        return false;
+    }
+
+    int dataType = GetLegacyDataType( this->LowerCase( typeName ) );
+    if( dataType < 0 )
+    {
+        return false;
+    }
+    size_t elementSize = static_cast<size_t>( vtkDataArray::GetDataTypeSize( dataType ) );
+    bool mappable = ( static_cast<size_t>( payloadOffset ) % elementSize ) == 0;
+#if !defined( VTK_WORDS_BIGENDIAN )
+    // The file is big endian, multi byte voxels have to be swapped
+    mappable = mappable && ( elementSize == 1 );
+#endif
+    if( !mappable && !this->ArrayPool )
+    {
+        return false;
+    }
+
+    vtkSmartPointer<vtkMappedFileRegion> regionSP = vtkSmartPointer<vtkMappedFileRegion>::New();
+    if( !regionSP->Map( this->GetFileName() ) )
+    {
+        return false;
+    }
+
+    // Only map files that end with the scalars, other attributes would be lost
+    vtkIdType numValues = static_cast<vtkIdType>( numPoints ) * numComponents;
+    size_t payloadEnd = static_cast<size_t>( payloadOffset ) + static_cast<size_t>( numValues ) * elementSize;
+    if( payloadEnd > regionSP->GetSize() )
+    {
+        return false;
+    }
+    for( size_t index = payloadEnd; index < regionSP->GetSize(); index++ )
+    {
+        if( !isspace( static_cast<unsigned char>( regionSP->GetData()[index] ) ) )
+        {
+            return false;
+        }
+    }
+
+    vtkInformation* outInfo = outputVector->GetInformationObject( 0 );
+    vtkStructuredPoints* output = vtkStructuredPoints::SafeDownCast( outInfo->Get( vtkDataObject::DATA_OBJECT() ) );
+    if( !output )
+    {
+        return false;
+    }
+
+    vtkSmartPointer<vtkDataArray> scalarsSP;
+    if( mappable )
+    {
+        // The array never writes nor frees the mapping, save = 1
+        scalarsSP.TakeReference( vtkDataArray::CreateDataArray( dataType ) );
+        scalarsSP->SetNumberOfComponents( numComponents );
+        scalarsSP->SetVoidArray( const_cast<char*>( regionSP->GetData() + payloadOffset ), numValues, 1 );
+        scalarsSP->GetInformation()->Set( MAPPED_FILE_REGION(), regionSP );
+    }
+    else
+    {
+        // Decode into storage recycled from an evicted time step
+        scalarsSP.TakeReference( this->ArrayPool->Acquire( dataType, numComponents, numPoints ) );
+        memcpy( scalarsSP->GetVoidPointer( 0 ), regionSP->GetData() + payloadOffset, static_cast<size_t>( numValues ) * elementSize );
+#if !defined( VTK_WORDS_BIGENDIAN )
+        vtkByteSwap::SwapVoidRange( scalarsSP->GetVoidPointer( 0 ), static_cast<int>( numValues ), static_cast<int>( elementSize ) );
+#endif
+    }
+    scalarsSP->SetName( scalarsName );
+    this->ScalarsMapped = mappable?1:0;
+
+    output->SetDimensions( dimensions );
+    output->SetSpacing( spacing );
+    output->SetOrigin( origin );
+    output->SetScalarType( dataType );
+    output->SetNumberOfScalarComponents( numComponents );
+    output->GetPointData()->SetScalars( scalarsSP );
+
+    this->SetErrorCode( vtkErrorCode::NoError );
+    return true;
+}
+
+//----------------------------------------------------------------------------
+void vtkMappedStructuredPointsReader::PrefetchFile( const char* fileName )
+{
+#if !defined( _WIN32 )
+    int fileDescriptor = open( fileName, O_RDONLY );
+    if( fileDescriptor < 0 )
+    {
+        return;
+    }
+    struct stat fileStat;
+    if( ( fstat( fileDescriptor, &fileStat ) == 0 ) && ( fileStat.st_size > 0 ) )
+    {
+        size_t size = static_cast<size_t>( fileStat.st_size );
+        void* data = mmap( 0, size, PROT_READ, MAP_SHARED, fileDescriptor, 0 );
+        if( data != MAP_FAILED )
+        {
+            // The read ahead goes on in the page cache after unmapping
+            madvise( data, size, MADV_WILLNEED );
+            munmap( data, size );
+        }
+    }
+    close( fileDescriptor );
+#else
+    (void)fileName;
+#endif
+}
+
+void vtkMappedStructuredPointsReader::PrintSelf( ostream& os, vtkIndent indent )
+{
+    this->Superclass::PrintSelf( os, indent );
+
+    os << indent << "MemoryMapping: " << this->MemoryMapping << "\n";
+    os << indent << "ScalarsMapped: " << this->ScalarsMapped << "\n";
+    os << indent << "ArrayPool: " << this->ArrayPool << "\n";
+}
@@ -20,6 +20,8 @@
 ==============================================================================*/
 
 #include "vtkMultipleDataReader.h"
+#include "vtkDataArrayPool.h"
+#include "msvAtomic.h"
 
 #include <vtkObjectFactory.h>
 #include <vtkSmartPointer.h>
@@ -33,20 +35,260 @@
 #include <vtkGlobFileNames.h>
 #include <vtkDataObjectTypes.h>
 #include <vtkTemporalDataSet.h>
+#include <vtkMultiThreader.h>
+#include <vtkCriticalSection.h>
+#include <vtksys/SystemTools.hxx>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#if defined( _WIN32 )
+#include <stdio.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+#include <ctype.h>
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
 
 using namespace std;
 
+namespace
+{
+    // Bytes read from the start of a file to find out its dataset type. A legacy
+    // header is the version line, a title of 256 characters at most, the file
+    // format and the DATASET line, so this is enough for any well formed file.
+    const size_t HeaderSniffSize = 512;
+
+    // Returned by ParseLegacyHeaderType when the header does not fit in the buffer
+    const int HeaderTruncated = -2;
+
+    struct SniffedTypeEntry
+    {
+        time_t ModificationTime;
+        off_t FileSize;
+        int DataObjectType;
+    };
+
+    typedef map<string, SniffedTypeEntry> SniffedTypeMap;
+
+    // Shared by every reader, so the type of a series found when creating an
+    // entity is not sniffed again by the concrete reader
+    SniffedTypeMap SniffedTypes;
+    vtkSimpleCriticalSection SniffedTypesLock;
+
+    bool ReadFileHeader( const char* fileName, char* buffer, size_t size, size_t& bytesRead )
+    {
+        bytesRead = 0;
+#if defined( _WIN32 )
+        FILE* file = fopen( fileName, "rb" );
+        if( !file )
+        {
+            return false;
+        }
+        bytesRead = fread( buffer, 1, size, file );
+        fclose( file );
+#else
+        int fileDescriptor = open( fileName, O_RDONLY );
+        if( fileDescriptor < 0 )
+        {
+            return false;
+        }
+        ssize_t result = pread( fileDescriptor, buffer, size, 0 );
+        close( fileDescriptor );
+        if( result < 0 )
+        {
+            return false;
+        }
+        bytesRead = static_cast<size_t>( result );
+#endif
+        return true;
+    }
+
+    // Reads the next whitespace separated token, lower cased. Returns false if the
+    // token could continue past the end of the buffer
+    bool ReadHeaderToken( const char* buffer, size_t length, size_t& position, string& token )
+    {
+        while( ( position < length ) && isspace( static_cast<unsigned char>( buffer[position] ) ) )
+        {
+            position++;
+        }
+        size_t start = position;
+        while( ( position < length ) && !isspace( static_cast<unsigned char>( buffer[position] ) ) )
+        {
+            position++;
+        }
+        if( position >= length )
+        {
+            return false;
+        }
+        token.resize( position - start );
+        for( size_t index = start; index < position; index++ )
+        {
+            token[index - start] = static_cast<char>( tolower( static_cast<unsigned char>( buffer[index] ) ) );
+        }
+        return true;
+    }
+
+    // Same checks as vtkDataReader::ReadHeader followed by the DATASET keyword
+    int ParseLegacyHeaderType( const char* buffer, size_t length )
+    {
+        const char versionLine[] = "# vtk DataFile";
+        if( length < sizeof( versionLine ) - 1 )
+        {
+            return HeaderTruncated;
+        }
+        if( strncmp( buffer, versionLine, sizeof( versionLine ) - 1 ) )
+        {
+            return -1;
+        }
+
+        // Skip the version and the title lines
+        size_t position = 0;
+        for( int line = 0; line < 2; line++ )
+        {
+            while( ( position < length ) && ( buffer[position] != '\n' ) )
+            {
+                position++;
+            }
+            if( position >= length )
+            {
+                return HeaderTruncated;
+            }
+            position++;
+        }
+
+        string format, keyword, type;
+        if( !ReadHeaderToken( buffer, length, position, format ) ||
+            !ReadHeaderToken( buffer, length, position, keyword ) ||
+            !ReadHeaderToken( buffer, length, position, type ) )
+        {
+            return HeaderTruncated;
+        }
+        if( ( ( format != "ascii" ) && ( format != "binary" ) ) || ( keyword != "dataset" ) )
+        {
+            return -1;
+        }
+
+        if( type == "polydata" )
+        {
+            return VTK_POLY_DATA;
+        }
+        else if( type == "structured_points" )
+        {
+            return VTK_STRUCTURED_POINTS;
+        }
+        else if( type == "structured_grid" )
+        {
+            return VTK_STRUCTURED_GRID;
+        }
+        else if( type == "rectilinear_grid" )
+        {
+            return VTK_RECTILINEAR_GRID;
+        }
+        else if( type == "unstructured_grid" )
+        {
+            return VTK_UNSTRUCTURED_GRID;
+        }
+        return -1;
+    }
+
+    struct SniffSeriesData
+    {
+        vtkMultipleDataReader* Reader;
+        vtkStringArray* Series;
+        int ExpectedType;
+        volatile int Mismatch;
+    };
+
+    // Every thread sniffs one of each NumberOfThreads files. The first file has
+    // already been sniffed by the caller
+    VTK_THREAD_RETURN_TYPE SniffSeriesThread( void* arg )
+    {
+        vtkMultiThreader::ThreadInfo* threadInfo = static_cast<vtkMultiThreader::ThreadInfo*>( arg );
+        SniffSeriesData* sniffData = static_cast<SniffSeriesData*>( threadInfo->UserData );
+
+        vtkIdType numFiles = sniffData->Series->GetNumberOfValues();
+        for( vtkIdType indexFile = 1 + threadInfo->ThreadID;
+             ( indexFile < numFiles ) && !sniffData->Mismatch;
+             indexFile += threadInfo->NumberOfThreads )
+        {
+            if( sniffData->Reader->SniffDataObjectType( sniffData->Series->GetValue( indexFile ) ) != sniffData->ExpectedType )
+            {
+                sniffData->Mismatch = 1;
+            }
+        }
+
+        return VTK_THREAD_RETURN_VALUE;
+    }
+
+    struct DecodeTimeStepsData
+    {
+        volatile long* Generation;
+        long BatchGeneration;
+        vector<int>* FileIndices;
+        vector< vtkSmartPointer<vtkDataReader> >* Readers;
+        vtkStringArray* FileNames;
+        vtkSimpleCriticalSection* NextTimeStepLock;
+        size_t NextTimeStep;
+    };
+
+    // Every thread takes the next pending time step until none is left or the
+    // batch is superseded. Each step is decoded by its own reader
+    VTK_THREAD_RETURN_TYPE DecodeTimeStepsThread( void* arg )
+    {
+        vtkMultiThreader::ThreadInfo* threadInfo = static_cast<vtkMultiThreader::ThreadInfo*>( arg );
+        DecodeTimeStepsData* decodeData = static_cast<DecodeTimeStepsData*>( threadInfo->UserData );
+
+        while( msvAtomicLoad( decodeData->Generation ) == decodeData->BatchGeneration )
+        {
+            decodeData->NextTimeStepLock->Lock();
+            size_t indexTimeStep = decodeData->NextTimeStep++;
+            decodeData->NextTimeStepLock->Unlock();
+            if( indexTimeStep >= decodeData->Readers->size() )
+            {
+                break;
+            }
+
+            vtkDataReader* dataReader = ( *decodeData->Readers )[indexTimeStep];
+            if( dataReader )
+            {
+                dataReader->SetFileName( decodeData->FileNames->GetValue( ( *decodeData->FileIndices )[indexTimeStep] ) );
+                dataReader->Update();
+            }
+        }
+
+        return VTK_THREAD_RETURN_VALUE;
+    }
+}
+
 vtkStandardNewMacro( vtkMultipleDataReader );
 
+const char* vtkMultipleDataReader::DefaultTimeDescriptorName = "TimeSteps.txt";
+
 vtkMultipleDataReader::vtkMultipleDataReader()
 : DirectoryName( 0 )
 , WildCard( 0 )
 , FileNames( 0 )
 , CachedTimeSteps( 0 )
+, TimeStepWrap( 0 )
 , RequestedTimeSteps( 0 )
 , NumRequestedTimeSteps( 0 )
 , DataObjectType( VTK_DATA_OBJECT )
 , NumAvailableTimeSteps( 0 )
+, SeriesTypeCheckPolicy( CheckAllFiles )
+, MaxDecodeThreads( vtkMultiThreader::GetGlobalDefaultNumberOfThreads() )
+, DecodeGeneration( 0 )
+, TimeDescriptorFileName( 0 )
+, ArrayPool( vtkDataArrayPool::New() )
 {
     this->SetNumberOfInputPorts( 0 );
 }
@@ -67,16 +309,19 @@ vtkMultipleDataReader::~vtkMultipleDataReader()
     }
     if( this->RequestedTimeSteps )
     {
-        delete this->RequestedTimeSteps;
+        delete[] this->RequestedTimeSteps;
     }
+    this->SetTimeDescriptorFileName( 0 );
+    this->ArrayPool->Delete();
 }
 
 void vtkMultipleDataReader::SetRequestedTimesTeps( double* timeSteps, int numTimeSteps )
 {
     // TODO?: Compare first?
+    this->CancelPendingTimeSteps();
     if( this->RequestedTimeSteps )
     {
-        delete this->RequestedTimeSteps;
+        delete[] this->RequestedTimeSteps;
     }
     this->NumRequestedTimeSteps = numTimeSteps;
     this->RequestedTimeSteps = new double[this->NumRequestedTimeSteps];
@@ -101,6 +346,11 @@ double* vtkMultipleDataReader::GetRequestedTimesTeps()
     return 0;
 }
 
+void vtkMultipleDataReader::CancelPendingTimeSteps()
+{
+    msvAtomicAdd( &this->DecodeGeneration, 1 );
+}
+
 int vtkMultipleDataReader::ProcessRequest( vtkInformation* request,
                                   vtkInformationVector** inputVector,
                                   vtkInformationVector* outputVector )
@@ -163,20 +413,16 @@ int vtkMultipleDataReader::ReadMetaData( vtkInformation *outInfo )
     if( !this->FileNames )
     {
         this->FileNames = this->GetFileNames();
-        if( !this->FileNames )
-        {
-             numDataTimeSteps = this->FileNames->GetNumberOfTuples();
-             if( numDataTimeSteps <= 0 )
-             {
-                vtkErrorMacro(<< "No filenames were found in " << this->DirectoryName << " with pattern " << this->WildCard);
-                return 0;
-             }
-        }
     }
-    else
+    if( this->FileNames )
     {
         numDataTimeSteps = this->FileNames->GetNumberOfTuples();
     }
+    if( numDataTimeSteps <= 0 )
+    {
+        vtkErrorMacro(<< "No filenames were found in " << this->DirectoryName << " with pattern " << this->WildCard);
+        return 0;
+    }
 
     if( this->GetSeriesDataObjectType( this->FileNames ) != this->DataObjectType )
     {
@@ -186,22 +432,33 @@ int vtkMultipleDataReader::ReadMetaData( vtkInformation *outInfo )
 
 
     this->NumAvailableTimeSteps = numDataTimeSteps;
-    double* dataTimeSteps = new double[numDataTimeSteps];
-    for( int timeStep = 0; timeStep < numDataTimeSteps; timeStep++ )
+    double timeRange[2];
+    if( this->ReadTimeDescriptor() )
     {
-        dataTimeSteps[timeStep] = static_cast<double>( timeStep );
+        outInfo->Set( vtkStreamingDemandDrivenPipeline::TIME_STEPS(), &this->TimeStepValues[0], numDataTimeSteps );
+        timeRange[0] = this->TimeStepValues.front();
+        timeRange[1] = this->TimeStepValues.back();
     }
+    else
+    {
+        double* dataTimeSteps = new double[numDataTimeSteps];
+        for( int timeStep = 0; timeStep < numDataTimeSteps; timeStep++ )
+        {
+            dataTimeSteps[timeStep] = static_cast<double>( timeStep );
+        }
 
-    outInfo->Set( vtkStreamingDemandDrivenPipeline::TIME_STEPS(), dataTimeSteps, numDataTimeSteps );
+        outInfo->Set( vtkStreamingDemandDrivenPipeline::TIME_STEPS(), dataTimeSteps, numDataTimeSteps );
+
+        delete[] dataTimeSteps;
+
+        timeRange[0] = 0.0;
+        timeRange[1] = static_cast<double>( numDataTimeSteps - 1 );
+    }
 
     // Also put time range If not, vtkStreamingDemandDrivenPipeline::NeedToExecuteBasedOnTime will
     // return prematurely
-    // At the moment, we don't have a metadata place where this range is stored, but there should be
-    static double timeRange[] = { 0, 1 };
     outInfo->Set( vtkStreamingDemandDrivenPipeline::TIME_RANGE(), timeRange, 2 );
 
-    delete[] dataTimeSteps;
-
     return 1;
 }
 
@@ -287,48 +544,261 @@ int vtkMultipleDataReader::RequestData(
 
     if( numUpdateTimeSteps )
     {
-        outputData->SetNumberOfTimeSteps( numUpdateTimeSteps );
-
         vtkDebugMacro(<<"Reading vtk structured time steps...");
 
-        vtkSmartPointer<vtkDataReader> dataReaderSP;
-        dataReaderSP.TakeReference( this->GetConcreteReaderInstance() );
-        int indexTimeStep = 0;
-        int leftTimeSteps = numUpdateTimeSteps;
-        while( leftTimeSteps )
+        // Resolve the file of every requested step. Files already in the output are
+        // reused, every other step gets its own reader
+        vector<int> fileIndices( numUpdateTimeSteps, -1 );
+        vector< vtkSmartPointer<vtkDataReader> > dataReaders( numUpdateTimeSteps );
+        vector< vtkSmartPointer<vtkDataObject> > reusedTimeSteps( numUpdateTimeSteps );
+        for( int indexTimeStep = 0; indexTimeStep < numUpdateTimeSteps; indexTimeStep++ )
         {
-            int timeStepToLoad = updateTimeSteps[indexTimeStep];
-            if( this->TimeStepWrap )
+            int timeStepToLoad = this->GetFileIndexForTime( updateTimeSteps[indexTimeStep] );
+            if( timeStepToLoad < 0 )
             {
-                if( timeStepToLoad >= this->NumAvailableTimeSteps )
+                // Error!?
+                vtkErrorMacro(<< "RequestData requested non available time steps and TimeStepWrap is not set in class vtkMultipleDataReader" );
+                continue;
+            }
+            fileIndices[indexTimeStep] = timeStepToLoad;
+
+            vector<int>::const_iterator itLoaded = find( this->LoadedFileIndices.begin(), this->LoadedFileIndices.end(), timeStepToLoad );
+            if( itLoaded != this->LoadedFileIndices.end() )
+            {
+                unsigned int loadedIndex = static_cast<unsigned int>( itLoaded - this->LoadedFileIndices.begin() );
+                if( loadedIndex < outputData->GetNumberOfTimeSteps() )
                 {
-                    timeStepToLoad -= this->NumAvailableTimeSteps;
+                    reusedTimeSteps[indexTimeStep] = outputData->GetTimeStep( loadedIndex );
                 }
             }
+            if( !reusedTimeSteps[indexTimeStep] )
+            {
+                dataReaders[indexTimeStep].TakeReference( this->GetConcreteReaderInstance() );
+            }
+        }
+
+        DecodeTimeStepsData decodeData;
+        vtkSimpleCriticalSection nextTimeStepLock;
+        decodeData.Generation = &this->DecodeGeneration;
+        decodeData.BatchGeneration = msvAtomicLoad( &this->DecodeGeneration );
+        decodeData.FileIndices = &fileIndices;
+        decodeData.Readers = &dataReaders;
+        decodeData.FileNames = this->FileNames;
+        decodeData.NextTimeStepLock = &nextTimeStepLock;
+        decodeData.NextTimeStep = 0;
+
+        int numThreads = ( this->MaxDecodeThreads < numUpdateTimeSteps )?this->MaxDecodeThreads:numUpdateTimeSteps;
+        vtkSmartPointer<vtkMultiThreader> multiThreaderSP = vtkSmartPointer<vtkMultiThreader>::New();
+        multiThreaderSP->SetNumberOfThreads( numThreads );
+        multiThreaderSP->SetSingleMethod( DecodeTimeStepsThread, &decodeData );
+        multiThreaderSP->SingleMethodExecute();
+
+        if( msvAtomicLoad( &this->DecodeGeneration ) != decodeData.BatchGeneration )
+        {
+            // Superseded: the output can't hold the requested steps. Leave it empty,
+            // without time steps, and make sure the next update executes again
+            vtkDebugMacro(<<"Time steps request superseded, discarding...");
+            outputData->Initialize();
+            outputData->GetInformation()->Remove( vtkDataObject::DATA_TIME_STEPS() );
+            this->LoadedFileIndices.clear();
+            this->Modified();
+            return 1;
+        }
+
+        // Assign the timesteps with a file indexed from zero, in request order. A
+        // time with no file is left out of the output and of its DATA_TIME_STEPS,
+        // so no dataset of a previous request is labelled with it
+        vector<double> providedTimes;
+        vector<int> providedFileIndices;
+        for( int indexTimeStep = 0; indexTimeStep < numUpdateTimeSteps; indexTimeStep++ )
+        {
+            if( fileIndices[indexTimeStep] >= 0 )
+            {
+                providedTimes.push_back( updateTimeSteps[indexTimeStep] );
+                providedFileIndices.push_back( fileIndices[indexTimeStep] );
+            }
+        }
+        outputData->SetNumberOfTimeSteps( static_cast<unsigned int>( providedTimes.size() ) );
+        int outputIndex = 0;
+        for( int indexTimeStep = 0; indexTimeStep < numUpdateTimeSteps; indexTimeStep++ )
+        {
+            if( fileIndices[indexTimeStep] < 0 )
+            {
+                continue;
+            }
+            if( reusedTimeSteps[indexTimeStep] )
+            {
+                outputData->SetTimeStep( outputIndex, reusedTimeSteps[indexTimeStep] );
+            }
             else
             {
-                if( timeStepToLoad >= this->NumAvailableTimeSteps )
-                {
-                    // Error!?
-                    vtkErrorMacro(<< "RequestData requested non available time steps and TimeStepWrap is not set in class vtkMultipleDataReader" );
-                }
+                this->SetOutputTimeStep( dataReaders[indexTimeStep], outputData, outputIndex );
             }
+            outputIndex++;
+        }
+        this->LoadedFileIndices.swap( providedFileIndices );
 
-            dataReaderSP->SetFileName( this->FileNames->GetValue( timeStepToLoad ) );
-            dataReaderSP->Update();
+        if( providedTimes.size() )
+        {
+            outputData->GetInformation()->Set( vtkDataObject::DATA_TIME_STEPS(),
+                &providedTimes[0], static_cast<int>( providedTimes.size() ) );
+        }
+        else
+        {
+            outputData->GetInformation()->Remove( vtkDataObject::DATA_TIME_STEPS() );
+        }
+    }
+
+    return 1;
+}
 
-            // Assign the timesteps indexed from zero
-            this->SetOutputTimeStep( dataReaderSP, outputData, indexTimeStep );
+//----------------------------------------------------------------------------
+int vtkMultipleDataReader::GetFileIndexForTime( double time )
+{
+    int numFiles = this->NumAvailableTimeSteps;
+    if( numFiles <= 0 )
+    {
+        return -1;
+    }
 
-            indexTimeStep++;
-            leftTimeSteps--;
+    if( this->TimeStepValues.size() != static_cast<size_t>( numFiles ) )
+    {
+        // The time of every step is its index
+        int fileIndex = static_cast<int>( time );
+        if( this->TimeStepWrap && ( fileIndex >= numFiles ) )
+        {
+            fileIndex %= numFiles;
         }
+        return ( ( fileIndex >= 0 ) && ( fileIndex < numFiles ) )?fileIndex:-1;
+    }
 
-        outputData->GetInformation()->Set( vtkDataObject::DATA_TIME_STEPS(), 
-            updateTimeSteps, numUpdateTimeSteps );
+    double firstTime = this->TimeStepValues.front();
+    double lastTime = this->TimeStepValues.back();
+    if( this->TimeStepWrap && ( time > lastTime ) && ( numFiles > 1 ) )
+    {
+        // The series repeats with a period one mean step longer than its span
+        double period = ( lastTime - firstTime ) * numFiles / ( numFiles - 1 );
+        time = firstTime + fmod( time - firstTime, period );
+    }
+    else if( time > lastTime + 1e-9 * ( fabs( lastTime ) + 1.0 ) )
+    {
+        return -1;
     }
 
-    return 1;
+    // Tolerate the rounding of times computed downstream
+    double tolerance = 1e-9 * ( fabs( time ) + 1.0 );
+    vector<double>::const_iterator it = upper_bound( this->TimeStepValues.begin(), this->TimeStepValues.end(), time + tolerance );
+    if( it == this->TimeStepValues.begin() )
+    {
+        return -1;
+    }
+    return static_cast<int>( it - this->TimeStepValues.begin() ) - 1;
+}
+
+//----------------------------------------------------------------------------
+bool vtkMultipleDataReader::ReadTimeDescriptor()
+{
+    this->TimeStepValues.clear();
+    if( !this->FileNames || ( this->FileNames->GetNumberOfValues() <= 0 ) )
+    {
+        return false;
+    }
+
+    string descriptorName;
+    if( this->TimeDescriptorFileName && *this->TimeDescriptorFileName )
+    {
+        descriptorName = this->TimeDescriptorFileName;
+    }
+    else
+    {
+        descriptorName = vtksys::SystemTools::GetFilenamePath( this->FileNames->GetValue( 0 ) );
+        if( !descriptorName.empty() )
+        {
+            descriptorName += "/";
+        }
+        descriptorName += DefaultTimeDescriptorName;
+        if( !vtksys::SystemTools::FileExists( descriptorName.c_str(), true ) )
+        {
+            return false;
+        }
+    }
+
+    ifstream descriptor( descriptorName.c_str() );
+    if( !descriptor )
+    {
+        vtkErrorMacro(<< "Cannot open time descriptor " << descriptorName );
+        return false;
+    }
+
+    vtkIdType numFiles = this->FileNames->GetNumberOfValues();
+    map<string, vtkIdType> fileIndicesByName;
+    for( vtkIdType indexFile = 0; indexFile < numFiles; indexFile++ )
+    {
+        fileIndicesByName[vtksys::SystemTools::GetFilenameName( this->FileNames->GetValue( indexFile ) )] = indexFile;
+    }
+
+    vector<double> timeStepValues( numFiles, 0.0 );
+    vector<bool> assignedValues( numFiles, false );
+    vtkIdType nextFileIndex = 0;
+    int lineNumber = 0;
+    string line;
+    while( getline( descriptor, line ) )
+    {
+        lineNumber++;
+        istringstream fields( line );
+        string firstField, secondField;
+        if( !( fields >> firstField ) || ( firstField[0] == '#' ) )
+        {
+            continue;
+        }
+
+        vtkIdType fileIndex = nextFileIndex;
+        string timeField = firstField;
+        if( fields >> secondField )
+        {
+            map<string, vtkIdType>::const_iterator it = fileIndicesByName.find( firstField );
+            if( it == fileIndicesByName.end() )
+            {
+                vtkWarningMacro(<< descriptorName << ":" << lineNumber << ": " << firstField << " is not part of the series" );
+                continue;
+            }
+            fileIndex = it->second;
+            timeField = secondField;
+        }
+
+        char* timeEnd = 0;
+        double timeValue = strtod( timeField.c_str(), &timeEnd );
+        if( ( timeEnd == timeField.c_str() ) || ( *timeEnd != '\0' ) )
+        {
+            vtkErrorMacro(<< descriptorName << ":" << lineNumber << ": " << timeField << " is not a time value" );
+            return false;
+        }
+        if( fileIndex >= numFiles )
+        {
+            vtkErrorMacro(<< descriptorName << " has more time values than files in the series" );
+            return false;
+        }
+        timeStepValues[fileIndex] = timeValue;
+        assignedValues[fileIndex] = true;
+        nextFileIndex = fileIndex + 1;
+    }
+
+    for( vtkIdType indexFile = 0; indexFile < numFiles; indexFile++ )
+    {
+        if( !assignedValues[indexFile] )
+        {
+            vtkErrorMacro(<< descriptorName << " has no time for " << this->FileNames->GetValue( indexFile ) );
+            return false;
+        }
+        if( ( indexFile > 0 ) && ( timeStepValues[indexFile] <= timeStepValues[indexFile - 1] ) )
+        {
+            vtkErrorMacro(<< descriptorName << ": times must increase with the file order" );
+            return false;
+        }
+    }
+
+    this->TimeStepValues.swap( timeStepValues );
+    return true;
 }
 
 vtkDataReader* vtkMultipleDataReader::GetConcreteReaderInstance()
@@ -399,26 +869,97 @@ int vtkMultipleDataReader::GetDataObjectType( const vtkStdString& fileName )
     return resultType;
 }
 
-int vtkMultipleDataReader::GetSeriesDataObjectType( vtkStringArray* series )
+//----------------------------------------------------------------------------
+int vtkMultipleDataReader::SniffDataObjectType( const vtkStdString& fileName )
 {
-    int resultType = -1;
-    int auxResultType = -1;
+    struct stat fileStat;
+    if( stat( fileName.c_str(), &fileStat ) != 0 )
+    {
+        return -1;
+    }
 
-    vtkStdString& firstFileName = series->GetValue( 0 );
-    resultType = GetDataObjectType( firstFileName );
-    if( ( ( resultType >= VTK_POLY_DATA ) && ( resultType <= VTK_UNSTRUCTURED_GRID ) ) )
+    SniffedTypesLock.Lock();
+    SniffedTypeMap::const_iterator it = SniffedTypes.find( fileName );
+    if( ( it != SniffedTypes.end() ) &&
+        ( it->second.ModificationTime == fileStat.st_mtime ) &&
+        ( it->second.FileSize == fileStat.st_size ) )
     {
-        auxResultType = resultType;
-        vtkIdType indexFile = 1;
-        while( indexFile < series->GetNumberOfValues() && ( auxResultType == resultType ) )
+        int cachedType = it->second.DataObjectType;
+        SniffedTypesLock.Unlock();
+        return cachedType;
+    }
+    SniffedTypesLock.Unlock();
+
+    int resultType = -1;
+    char buffer[HeaderSniffSize];
+    size_t bytesRead( 0 );
+    if( ReadFileHeader( fileName.c_str(), buffer, HeaderSniffSize, bytesRead ) )
+    {
+        resultType = ParseLegacyHeaderType( buffer, bytesRead );
+        if( resultType == HeaderTruncated )
         {
-            vtkStdString& currentFileName = series->GetValue( indexFile );
-            auxResultType = GetDataObjectType( currentFileName );
-            indexFile++;
+            // A short read means the file ends before the header does. Otherwise
+            // the header is unusually long, so let the data reader parse it
+            resultType = ( bytesRead < HeaderSniffSize )?-1:this->GetDataObjectType( fileName );
         }
     }
 
-    return ( auxResultType == resultType )?resultType:-1;
+    SniffedTypeEntry entry;
+    entry.ModificationTime = fileStat.st_mtime;
+    entry.FileSize = fileStat.st_size;
+    entry.DataObjectType = resultType;
+    SniffedTypesLock.Lock();
+    SniffedTypes[fileName] = entry;
+    SniffedTypesLock.Unlock();
+
+    return resultType;
+}
+
+//----------------------------------------------------------------------------
+int vtkMultipleDataReader::GetSeriesDataObjectType( vtkStringArray* series )
+{
+    if( !series || ( series->GetNumberOfValues() <= 0 ) )
+    {
+        return -1;
+    }
+
+    int resultType = this->SniffDataObjectType( series->GetValue( 0 ) );
+    if( ( resultType < VTK_POLY_DATA ) || ( resultType > VTK_UNSTRUCTURED_GRID ) )
+    {
+        return -1;
+    }
+
+    vtkIdType numFiles = series->GetNumberOfValues();
+    if( ( this->SeriesTypeCheckPolicy == TrustFirstFile ) || ( numFiles == 1 ) )
+    {
+        return resultType;
+    }
+
+    SniffSeriesData sniffData;
+    sniffData.Reader = this;
+    sniffData.Series = series;
+    sniffData.ExpectedType = resultType;
+    sniffData.Mismatch = 0;
+
+    int numThreads = vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+    if( numThreads > numFiles - 1 )
+    {
+        numThreads = static_cast<int>( numFiles - 1 );
+    }
+    vtkSmartPointer<vtkMultiThreader> multiThreaderSP = vtkSmartPointer<vtkMultiThreader>::New();
+    multiThreaderSP->SetNumberOfThreads( numThreads );
+    multiThreaderSP->SetSingleMethod( SniffSeriesThread, &sniffData );
+    multiThreaderSP->SingleMethodExecute();
+
+    return sniffData.Mismatch?-1:resultType;
+}
+
+//----------------------------------------------------------------------------
+void vtkMultipleDataReader::ClearSniffedDataObjectTypes()
+{
+    SniffedTypesLock.Lock();
+    SniffedTypes.clear();
+    SniffedTypesLock.Unlock();
 }
 
 void vtkMultipleDataReader::SetFileNames( vtkStringArray* fileNames )
@@ -441,6 +982,8 @@ void vtkMultipleDataReader::SetFileNames( vtkStringArray* fileNames )
     }
     this->FileNames = vtkStringArray::New();
     this->FileNames->DeepCopy( fileNames );
+    this->LoadedFileIndices.clear();
+    this->Modified();
 }
 
 vtkStringArray* vtkMultipleDataReader::GetFileNames()
@@ -489,5 +1032,8 @@ void vtkMultipleDataReader::PrintSelf( ostream& os, vtkIndent indent )
     os << indent << "RequestedTimeSteps: " << this->RequestedTimeSteps << "\n";
     os << indent << "DataObjectType: " << this->DataObjectType << "\n";
     os << indent << "NumAvailableTimeSteps: " << this->NumAvailableTimeSteps << "\n";
+    os << indent << "TimeDescriptorFileName: " << ( this->TimeDescriptorFileName?this->TimeDescriptorFileName:"(none)" ) << "\n";
+    os << indent << "MaxDecodeThreads: " << this->MaxDecodeThreads << "\n";
+    os << indent << "SeriesTypeCheckPolicy: " << ( ( this->SeriesTypeCheckPolicy == TrustFirstFile )?"TrustFirstFile":"CheckAllFiles" ) << "\n";
 }
 
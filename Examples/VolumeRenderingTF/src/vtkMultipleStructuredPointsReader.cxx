@@ -20,6 +20,7 @@
 ==============================================================================*/
 
 #include "vtkMultipleStructuredPointsReader.h"
+#include "vtkMappedStructuredPointsReader.h"
 
 #include <vtkObjectFactory.h>
 #include <vtkSmartPointer.h>
@@ -43,6 +44,8 @@ using namespace std;
 vtkStandardNewMacro( vtkMultipleStructuredPointsReader );
 
 vtkMultipleStructuredPointsReader::vtkMultipleStructuredPointsReader()
+: MemoryMapping( 1 )
+, PrefetchNextTimeStep( 0 )
 {
     this->DataObjectType = VTK_STRUCTURED_POINTS;
 }
@@ -70,9 +73,35 @@ vtkTemporalDataSet* vtkMultipleStructuredPointsReader::GetOutput(int idx)
     return vtkTemporalDataSet::SafeDownCast(this->GetOutputDataObject(idx));
 }
 
+int vtkMultipleStructuredPointsReader::RequestData(
+    vtkInformation *request,
+    vtkInformationVector **inputVector,
+    vtkInformationVector *outputVector)
+{
+    int result = this->Superclass::RequestData( request, inputVector, outputVector );
+
+    if( result && this->PrefetchNextTimeStep && !this->LoadedFileIndices.empty() && ( this->LoadedFileIndices.back() >= 0 ) )
+    {
+        int nextFileIndex = this->LoadedFileIndices.back() + 1;
+        if( nextFileIndex >= this->NumAvailableTimeSteps )
+        {
+            nextFileIndex = this->TimeStepWrap?0:-1;
+        }
+        if( nextFileIndex >= 0 )
+        {
+            vtkMappedStructuredPointsReader::PrefetchFile( this->FileNames->GetValue( nextFileIndex ) );
+        }
+    }
+
+    return result;
+}
+
 vtkDataReader* vtkMultipleStructuredPointsReader::GetConcreteReaderInstance()
 {
-    return vtkStructuredPointsReader::New();
+    vtkMappedStructuredPointsReader* mappedReader = vtkMappedStructuredPointsReader::New();
+    mappedReader->SetMemoryMapping( this->MemoryMapping );
+    mappedReader->SetArrayPool( this->ArrayPool );
+    return mappedReader;
 }
 
 void vtkMultipleStructuredPointsReader::SetOutputTimeStep( vtkDataReader* pDataReader, vtkTemporalDataSet *outputData, int timeStep )
@@ -88,5 +117,8 @@ void vtkMultipleStructuredPointsReader::SetOutputTimeStep( vtkDataReader* pDataR
 void vtkMultipleStructuredPointsReader::PrintSelf( ostream& os, vtkIndent indent )
 {
     this->Superclass::PrintSelf( os, indent );
+
+    os << indent << "MemoryMapping: " << this->MemoryMapping << "\n";
+    os << indent << "PrefetchNextTimeStep: " << this->PrefetchNextTimeStep << "\n";
 }
 
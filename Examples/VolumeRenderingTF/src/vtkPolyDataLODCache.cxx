@@ -0,0 +1,388 @@
+/*==============================================================================
+
+  Library: MSVTK
+
+  Copyright (c) Computational Image and Simulation Technologies in Biomedicine (CISTIB),
+                Universitat Pompeu Fabra (UPF), Barcelona, Spain
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#include "vtkPolyDataLODCache.h"
+
+#include <vtkObjectFactory.h>
+#include <vtkCriticalSection.h>
+#include <vtkPolyData.h>
+#include <vtkPointData.h>
+#include <vtkIdList.h>
+#include <vtkPointLocator.h>
+#include <vtkQuadricClustering.h>
+#include <vtkPolyDataNormals.h>
+
+#include <algorithm>
+#include <map>
+#include <vector>
+#include <cmath>
+
+using namespace std;
+
+// Upper bound of NumberOfLevels. The coarsest level gets 2^-7 of the
+// divisions of the finest, past which clustering leaves nothing to draw
+const int MaxNumberOfLevels = 8;
+
+class vtkPolyDataLODCacheInternals
+{
+public:
+    vtkPolyDataLODCacheInternals() : Generation( 0 ) {}
+
+    vtkSimpleCriticalSection Lock;
+    // Finest first. A step with no levels is cached too: it was too small
+    map< int, vector< vtkSmartPointer<vtkPolyData> > > Levels;
+    // Bumped when the cache is cleared, so the levels of a build started
+    // before are dropped rather than cached with the old settings
+    int Generation;
+};
+
+vtkStandardNewMacro( vtkPolyDataLODCache );
+
+vtkPolyDataLODCache::vtkPolyDataLODCache()
+: NumberOfLevels( 2 )
+, NumberOfDivisions( 64 )
+, NumberOfBuiltSteps( 0 )
+, NumberOfHits( 0 )
+, Internals( new vtkPolyDataLODCacheInternals )
+{
+}
+
+vtkPolyDataLODCache::~vtkPolyDataLODCache()
+{
+    delete this->Internals;
+}
+
+//----------------------------------------------------------------------------
+void vtkPolyDataLODCache::SetNumberOfLevels( int numberOfLevels )
+{
+    if( numberOfLevels < 0 )
+    {
+        numberOfLevels = 0;
+    }
+    if( numberOfLevels > MaxNumberOfLevels )
+    {
+        numberOfLevels = MaxNumberOfLevels;
+    }
+    this->Internals->Lock.Lock();
+    bool changed = ( numberOfLevels != this->NumberOfLevels );
+    this->NumberOfLevels = numberOfLevels;
+    this->Internals->Lock.Unlock();
+
+    if( changed )
+    {
+        this->Clear();
+        this->Modified();
+    }
+}
+
+int vtkPolyDataLODCache::GetNumberOfLevels()
+{
+    this->Internals->Lock.Lock();
+    int numberOfLevels = this->NumberOfLevels;
+    this->Internals->Lock.Unlock();
+    return numberOfLevels;
+}
+
+//----------------------------------------------------------------------------
+void vtkPolyDataLODCache::SetNumberOfDivisions( int numberOfDivisions )
+{
+    if( numberOfDivisions < 2 )
+    {
+        numberOfDivisions = 2;
+    }
+    this->Internals->Lock.Lock();
+    bool changed = ( numberOfDivisions != this->NumberOfDivisions );
+    this->NumberOfDivisions = numberOfDivisions;
+    this->Internals->Lock.Unlock();
+
+    if( changed )
+    {
+        this->Clear();
+        this->Modified();
+    }
+}
+
+int vtkPolyDataLODCache::GetNumberOfDivisions()
+{
+    this->Internals->Lock.Lock();
+    int numberOfDivisions = this->NumberOfDivisions;
+    this->Internals->Lock.Unlock();
+    return numberOfDivisions;
+}
+
+//----------------------------------------------------------------------------
+bool vtkPolyDataLODCache::BuildLevels( int timeStep, vtkPolyData* polyData )
+{
+    if( !polyData )
+    {
+        return false;
+    }
+
+    this->Internals->Lock.Lock();
+    if( this->Internals->Levels.find( timeStep ) != this->Internals->Levels.end() )
+    {
+        this->NumberOfHits++;
+        this->Internals->Lock.Unlock();
+        return false;
+    }
+    int numberOfLevels = this->NumberOfLevels;
+    int numberOfDivisions = this->NumberOfDivisions;
+    int generation = this->Internals->Generation;
+    this->Internals->Lock.Unlock();
+
+    if( numberOfLevels == 0 )
+    {
+        return false;
+    }
+
+    // Decimated without the lock, the entity keeps reading the other steps
+    vector< vtkSmartPointer<vtkPolyData> > levels;
+    vtkIdType previousNumberOfPoints = polyData->GetNumberOfPoints();
+    for( int indexLevel = 0; indexLevel < numberOfLevels && numberOfDivisions >= 2 && previousNumberOfPoints > 0; indexLevel++ )
+    {
+        vtkSmartPointer<vtkPolyData> levelSP;
+        levelSP.TakeReference( this->Decimate( polyData, numberOfDivisions ) );
+        numberOfDivisions /= 2;
+
+        // Not worth a level of its own, a coarser grid may be
+        if( 2 * levelSP->GetNumberOfPoints() > previousNumberOfPoints )
+        {
+            continue;
+        }
+        levels.push_back( levelSP );
+        previousNumberOfPoints = levelSP->GetNumberOfPoints();
+    }
+
+    this->Internals->Lock.Lock();
+    bool cached = ( generation == this->Internals->Generation );
+    if( cached )
+    {
+        this->Internals->Levels[timeStep] = levels;
+        this->NumberOfBuiltSteps++;
+    }
+    this->Internals->Lock.Unlock();
+
+    return cached;
+}
+
+//----------------------------------------------------------------------------
+vtkPolyData* vtkPolyDataLODCache::Decimate( vtkPolyData* polyData, int numberOfDivisions )
+{
+    // A copy sharing the arrays but not the pipeline, so the filters never
+    // update the one of the loader
+    vtkSmartPointer<vtkPolyData> inputSP = vtkSmartPointer<vtkPolyData>::New();
+    inputSP->ShallowCopy( polyData );
+
+    // Cubic bins: the longest side gets numberOfDivisions
+    double bounds[6];
+    inputSP->GetBounds( bounds );
+    double longestSide = 0.0;
+    for( int axis = 0; axis < 3; axis++ )
+    {
+        longestSide = max( longestSide, bounds[2 * axis + 1] - bounds[2 * axis] );
+    }
+    int divisions[3];
+    for( int axis = 0; axis < 3; axis++ )
+    {
+        double side = bounds[2 * axis + 1] - bounds[2 * axis];
+        divisions[axis] = ( longestSide > 0.0 ) ? static_cast<int>( ceil( numberOfDivisions * side / longestSide ) ) : 2;
+        divisions[axis] = max( divisions[axis], 2 );
+    }
+
+    vtkSmartPointer<vtkQuadricClustering> clusteringSP = vtkSmartPointer<vtkQuadricClustering>::New();
+    clusteringSP->SetInput( inputSP );
+    clusteringSP->AutoAdjustNumberOfDivisionsOff();
+    clusteringSP->SetNumberOfDivisions( divisions );
+    clusteringSP->CopyCellDataOn();
+    clusteringSP->Update();
+    vtkPolyData* output = clusteringSP->GetOutput();
+
+    // Clustering drops the point data, scalars included, so a level colored
+    // by them would not match the step. Every point of the level gets the
+    // average of the input points it is the closest to
+    vtkSmartPointer<vtkPolyData> resampledSP;
+    if( this->HasPointDataToResample( polyData ) && output->GetNumberOfPoints() > 0 )
+    {
+        resampledSP = vtkSmartPointer<vtkPolyData>::New();
+        resampledSP->ShallowCopy( output );
+        this->ResamplePointData( inputSP, resampledSP );
+        output = resampledSP;
+    }
+
+    // Without normals the level would be lit flat, unlike the step
+    vtkSmartPointer<vtkPolyDataNormals> normalsSP;
+    if( polyData->GetPointData()->GetNormals() )
+    {
+        normalsSP = vtkSmartPointer<vtkPolyDataNormals>::New();
+        normalsSP->SetInput( output );
+        normalsSP->SplittingOff();
+        normalsSP->ConsistencyOff();
+        normalsSP->ComputeCellNormalsOff();
+        normalsSP->Update();
+        output = normalsSP->GetOutput();
+    }
+
+    // Detached from the filters, which go away with this call
+    vtkPolyData* level = vtkPolyData::New();
+    level->ShallowCopy( output );
+    return level;
+}
+
+//----------------------------------------------------------------------------
+bool vtkPolyDataLODCache::HasPointDataToResample( vtkPolyData* polyData )
+{
+    // The normals are recomputed rather than averaged
+    vtkPointData* pointData = polyData->GetPointData();
+    for( int indexArray = 0; indexArray < pointData->GetNumberOfArrays(); indexArray++ )
+    {
+        if( pointData->GetAbstractArray( indexArray ) != pointData->GetNormals() )
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void vtkPolyDataLODCache::ResamplePointData( vtkPolyData* input, vtkPolyData* level )
+{
+    vtkIdType numInputPoints = input->GetNumberOfPoints();
+    vtkIdType numLevelPoints = level->GetNumberOfPoints();
+
+    // Cluster of every input point: the closest point of the level
+    vtkSmartPointer<vtkPointLocator> levelLocatorSP = vtkSmartPointer<vtkPointLocator>::New();
+    levelLocatorSP->SetDataSet( level );
+    levelLocatorSP->BuildLocator();
+    vector< vector<vtkIdType> > clusters( numLevelPoints );
+    double point[3];
+    for( vtkIdType indexPoint = 0; indexPoint < numInputPoints; indexPoint++ )
+    {
+        input->GetPoint( indexPoint, point );
+        vtkIdType indexCluster = levelLocatorSP->FindClosestPoint( point );
+        if( indexCluster >= 0 )
+        {
+            clusters[indexCluster].push_back( indexPoint );
+        }
+    }
+
+    vtkPointData* inputPointData = input->GetPointData();
+    vtkPointData* levelPointData = level->GetPointData();
+    levelPointData->Initialize();
+    levelPointData->CopyNormalsOff();
+    levelPointData->InterpolateAllocate( inputPointData, numLevelPoints );
+
+    // A point no input point is closest to takes the closest input point
+    vtkSmartPointer<vtkPointLocator> inputLocatorSP;
+    vtkSmartPointer<vtkIdList> idsSP = vtkSmartPointer<vtkIdList>::New();
+    vector<double> weights;
+    for( vtkIdType indexPoint = 0; indexPoint < numLevelPoints; indexPoint++ )
+    {
+        vector<vtkIdType>& cluster = clusters[indexPoint];
+        if( cluster.empty() )
+        {
+            if( !inputLocatorSP )
+            {
+                inputLocatorSP = vtkSmartPointer<vtkPointLocator>::New();
+                inputLocatorSP->SetDataSet( input );
+                inputLocatorSP->BuildLocator();
+            }
+            level->GetPoint( indexPoint, point );
+            cluster.push_back( inputLocatorSP->FindClosestPoint( point ) );
+        }
+
+        idsSP->SetNumberOfIds( static_cast<vtkIdType>( cluster.size() ) );
+        weights.assign( cluster.size(), 1.0 / cluster.size() );
+        for( size_t indexId = 0; indexId < cluster.size(); indexId++ )
+        {
+            idsSP->SetId( static_cast<vtkIdType>( indexId ), cluster[indexId] );
+        }
+        levelPointData->InterpolatePoint( inputPointData, indexPoint, idsSP, &weights[0] );
+    }
+}
+
+//----------------------------------------------------------------------------
+bool vtkPolyDataLODCache::HasLevels( int timeStep )
+{
+    this->Internals->Lock.Lock();
+    bool hasLevels = ( this->Internals->Levels.find( timeStep ) != this->Internals->Levels.end() );
+    this->Internals->Lock.Unlock();
+    return hasLevels;
+}
+
+int vtkPolyDataLODCache::GetNumberOfBuiltLevels( int timeStep )
+{
+    int numberOfBuiltLevels = 0;
+    this->Internals->Lock.Lock();
+    map< int, vector< vtkSmartPointer<vtkPolyData> > >::iterator it = this->Internals->Levels.find( timeStep );
+    if( it != this->Internals->Levels.end() )
+    {
+        numberOfBuiltLevels = static_cast<int>( it->second.size() );
+    }
+    this->Internals->Lock.Unlock();
+    return numberOfBuiltLevels;
+}
+
+vtkSmartPointer<vtkPolyData> vtkPolyDataLODCache::GetLevel( int timeStep, int level )
+{
+    vtkSmartPointer<vtkPolyData> levelSP;
+    this->Internals->Lock.Lock();
+    map< int, vector< vtkSmartPointer<vtkPolyData> > >::iterator it = this->Internals->Levels.find( timeStep );
+    if( it != this->Internals->Levels.end() && level >= 0 && level < static_cast<int>( it->second.size() ) )
+    {
+        levelSP = it->second[level];
+    }
+    this->Internals->Lock.Unlock();
+    return levelSP;
+}
+
+//----------------------------------------------------------------------------
+void vtkPolyDataLODCache::ReleaseLevels( int timeStep )
+{
+    this->Internals->Lock.Lock();
+    this->Internals->Levels.erase( timeStep );
+    this->Internals->Lock.Unlock();
+}
+
+void vtkPolyDataLODCache::Clear()
+{
+    this->Internals->Lock.Lock();
+    this->Internals->Levels.clear();
+    this->Internals->Generation++;
+    this->Internals->Lock.Unlock();
+}
+
+//----------------------------------------------------------------------------
+void vtkPolyDataLODCache::ResetStatistics()
+{
+    this->Internals->Lock.Lock();
+    this->NumberOfBuiltSteps = 0;
+    this->NumberOfHits = 0;
+    this->Internals->Lock.Unlock();
+}
+
+void vtkPolyDataLODCache::PrintSelf( ostream& os, vtkIndent indent )
+{
+    this->Superclass::PrintSelf( os, indent );
+
+    os << indent << "NumberOfLevels: " << this->NumberOfLevels << "\n";
+    os << indent << "NumberOfDivisions: " << this->NumberOfDivisions << "\n";
+    os << indent << "NumberOfBuiltSteps: " << this->NumberOfBuiltSteps << "\n";
+    os << indent << "NumberOfHits: " << this->NumberOfHits << "\n";
+}
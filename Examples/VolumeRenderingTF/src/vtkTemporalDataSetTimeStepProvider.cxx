@@ -27,6 +27,10 @@
 #include <vtkInformation.h>
 #include <vtkInformationVector.h>
 #include <vtkStreamingDemandDrivenPipeline.h>
+#include <vtkTemporalDataSet.h>
+
+#include <algorithm>
+#include "vtkDataArrayPool.h"
 
 using namespace std;
 
@@ -35,6 +39,11 @@ vtkStandardNewMacro( vtkTemporalDataSetTimeStepProvider );
 vtkTemporalDataSetTimeStepProvider::vtkTemporalDataSetTimeStepProvider()
 : NextTimeStep( 0 )
 , SourceMaxAvailableTimeSteps( 0 )
+, TimeStepWrap( 0 )
+, LastNumberOfRequestedTimeSteps( 0 )
+, WindowHead( 0 )
+, WindowFirstStep( 0 )
+, ArrayPool( 0 )
 {
     this->SetNumberOfInputPorts( 1 );
     this->SetNumberOfInputPorts( 1 );
@@ -42,9 +51,11 @@ vtkTemporalDataSetTimeStepProvider::vtkTemporalDataSetTimeStepProvider()
 
 vtkTemporalDataSetTimeStepProvider::~vtkTemporalDataSetTimeStepProvider()
 {
-
+    this->SetArrayPool( 0 );
 }
 
+vtkCxxSetObjectMacro( vtkTemporalDataSetTimeStepProvider, ArrayPool, vtkDataArrayPool );
+
 /*
 void vtkTemporalDataSetTimeStepProvider::SetNextTimeStep( int NextTimeStep )
 {
@@ -73,13 +84,140 @@ int vtkTemporalDataSetTimeStepProvider::RequestInformation(
     if( sddp )
     {
         int numAvailableTimeSteps( outInfo->Length( vtkStreamingDemandDrivenPipeline::TIME_STEPS() ) );
-        //double* availableTimeSteps( outInfo->Get( vtkStreamingDemandDrivenPipeline::TIME_STEPS() ) );
+        double* availableTimeSteps( outInfo->Get( vtkStreamingDemandDrivenPipeline::TIME_STEPS() ) );
         this->SourceMaxAvailableTimeSteps = numAvailableTimeSteps;
+        if( availableTimeSteps )
+        {
+            this->SourceTimeSteps.assign( availableTimeSteps, availableTimeSteps + numAvailableTimeSteps );
+        }
+        else
+        {
+            this->SourceTimeSteps.clear();
+        }
     }
 
     return 1;
 }
 
+//----------------------------------------------------------------------------
+int vtkTemporalDataSetTimeStepProvider::GetWindowSlot( int windowPosition ) const
+{
+    return ( this->WindowHead + windowPosition ) % static_cast<int>( this->Window.size() );
+}
+
+int vtkTemporalDataSetTimeStepProvider::GetNumberOfEvictedTimeSteps() const
+{
+    return static_cast<int>( this->EvictedSourceIndices.size() );
+}
+
+int vtkTemporalDataSetTimeStepProvider::GetEvictedTimeStep( int index ) const
+{
+    return this->EvictedSourceIndices[index];
+}
+
+//----------------------------------------------------------------------------
+void vtkTemporalDataSetTimeStepProvider::EvictSlot( WindowSlot& slot )
+{
+    if( !slot.Data )
+    {
+        return;
+    }
+    if( this->ArrayPool )
+    {
+        this->ArrayPool->Recycle( slot.Data );
+    }
+    // A step that is still in the window elsewhere keeps what it has downstream
+    if( find( this->WindowSourceIndices.begin(), this->WindowSourceIndices.end(), slot.SourceIndex ) == this->WindowSourceIndices.end() &&
+        find( this->EvictedSourceIndices.begin(), this->EvictedSourceIndices.end(), slot.SourceIndex ) == this->EvictedSourceIndices.end() )
+    {
+        this->EvictedSourceIndices.push_back( slot.SourceIndex );
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkTemporalDataSetTimeStepProvider::UpdateWindow()
+{
+    int windowSize = ( this->CacheSize > 0 )?this->CacheSize:0;
+    this->EvictedSourceIndices.clear();
+
+    // Source index and time of every window position
+    this->WindowSourceIndices.clear();
+    this->WindowTimes.clear();
+    for( int windowPosition = 0; windowPosition < windowSize; windowPosition++ )
+    {
+        // TODO:
+        // Watch that this->NextTimeStep is valid
+        int sourceIndex = this->NextTimeStep + windowPosition;
+        if( ( this->SourceMaxAvailableTimeSteps > 0 ) && ( sourceIndex >= this->SourceMaxAvailableTimeSteps ) )
+        {
+            if( TimeStepWrap )
+            {
+                sourceIndex %= this->SourceMaxAvailableTimeSteps;
+            }
+            else
+            {
+                vtkDebugMacro(<<"Requesting time step beyond maximun available at source!");
+                break;
+            }
+        }
+        // Request the time the source published for that step, not its index
+        double time = static_cast<double>( sourceIndex );
+        if( ( sourceIndex >= 0 ) && ( sourceIndex < static_cast<int>( this->SourceTimeSteps.size() ) ) )
+        {
+            time = this->SourceTimeSteps[sourceIndex];
+        }
+        this->WindowSourceIndices.push_back( sourceIndex );
+        this->WindowTimes.push_back( time );
+    }
+
+    if( static_cast<int>( this->Window.size() ) != windowSize )
+    {
+        // The window was resized, keep the steps that are still inside
+        vector<WindowSlot> oldWindow;
+        oldWindow.swap( this->Window );
+        this->Window.resize( windowSize );
+        this->WindowHead = 0;
+        for( int windowPosition = 0; windowPosition < windowSize; windowPosition++ )
+        {
+            this->Window[windowPosition].SourceIndex = -1;
+        }
+        for( size_t indexSlot = 0; indexSlot < oldWindow.size(); indexSlot++ )
+        {
+            bool kept = false;
+            for( size_t windowPosition = 0; windowPosition < this->WindowSourceIndices.size(); windowPosition++ )
+            {
+                if( oldWindow[indexSlot].Data && ( oldWindow[indexSlot].SourceIndex == this->WindowSourceIndices[windowPosition] ) )
+                {
+                    this->Window[windowPosition] = oldWindow[indexSlot];
+                    kept = true;
+                }
+            }
+            if( !kept )
+            {
+                this->EvictSlot( oldWindow[indexSlot] );
+            }
+        }
+    }
+    else if( windowSize > 0 )
+    {
+        // Slide the ring head along with the window, so the slots of the steps
+        // that are kept do not move
+        int shift = this->NextTimeStep - this->WindowFirstStep;
+        if( this->TimeStepWrap && ( this->SourceMaxAvailableTimeSteps > 0 ) )
+        {
+            // Going from the last step to the first one is a shift by one
+            int numSteps = this->SourceMaxAvailableTimeSteps;
+            shift = ( shift % numSteps + numSteps ) % numSteps;
+            if( shift > numSteps / 2 )
+            {
+                shift -= numSteps;
+            }
+        }
+        this->WindowHead = ( ( this->WindowHead + shift ) % windowSize + windowSize ) % windowSize;
+    }
+    this->WindowFirstStep = this->NextTimeStep;
+}
+
 //----------------------------------------------------------------------------
 int vtkTemporalDataSetTimeStepProvider
 ::RequestUpdateExtent (vtkInformation* request,
@@ -90,76 +228,107 @@ int vtkTemporalDataSetTimeStepProvider
     vtkInformation* outInfo = outputVector->GetInformationObject(0);
     vtkInformation *inInfo = inputVector[0]->GetInformationObject(0);
 
-    int numUpdateTimeSteps = this->CacheSize;
-    if( numUpdateTimeSteps > 0 )
+    this->UpdateWindow();
+
+    int numUpdateTimeSteps = static_cast<int>( this->WindowTimes.size() );
+    if( numUpdateTimeSteps <= 0 )
     {
-        // TODO:
-        // Watch that this->NextTimeStep is valid
-        double* updateTimeSteps = new double[numUpdateTimeSteps];
-        for( int indexCache = 0; indexCache < this->CacheSize; indexCache++ )
+        vtkDebugMacro(<<"CacheSize size is zero, returning...");
+        return 1;
+    }
+    outInfo->Set( vtkStreamingDemandDrivenPipeline::UPDATE_TIME_STEPS(), &this->WindowTimes[0], numUpdateTimeSteps );
+
+    // Only the steps whose slot does not hold them yet are requested upstream
+    this->RequestedTimes.clear();
+    for( int windowPosition = 0; windowPosition < numUpdateTimeSteps; windowPosition++ )
+    {
+        const WindowSlot& slot = this->Window[this->GetWindowSlot( windowPosition )];
+        if( !slot.Data || ( slot.SourceIndex != this->WindowSourceIndices[windowPosition] ) )
         {
-            double requestedTimeStep = this->NextTimeStep + indexCache;
-            if( requestedTimeStep >= this->SourceMaxAvailableTimeSteps )
-            {
-                if( TimeStepWrap )
-                {
-                    requestedTimeStep -= this->SourceMaxAvailableTimeSteps;
-                }
-                else
-                {
-                    vtkDebugMacro(<<"Requesting time step beyond maximun available at source!");
-                }
-            }
-            updateTimeSteps[indexCache] = requestedTimeStep;
+            this->RequestedTimes.push_back( this->WindowTimes[windowPosition] );
         }
-        outInfo->Set( vtkStreamingDemandDrivenPipeline::UPDATE_TIME_STEPS(), updateTimeSteps, numUpdateTimeSteps );
+    }
+    this->LastNumberOfRequestedTimeSteps = static_cast<int>( this->RequestedTimes.size() );
 
-        // We don't need time steps information any longer
-        delete[] updateTimeSteps;
+    // if we need any data
+    if( this->RequestedTimes.size() )
+    {
+        inInfo->Set( vtkStreamingDemandDrivenPipeline::UPDATE_TIME_STEPS(),
+            &this->RequestedTimes[0], static_cast<int>( this->RequestedTimes.size() ) );
     }
+    // otherwise leave the input with what it already has 
     else
     {
-        vtkDebugMacro(<<"CacheSize size is zero, returning...");
+        vtkDataObject *dobj = inInfo->Get(vtkDataObject::DATA_OBJECT());
+        if( dobj )
+        {
+            double *its = dobj->GetInformation()->Get( vtkDataObject::DATA_TIME_STEPS() );
+            int itsSize = dobj->GetInformation()->Length( vtkDataObject::DATA_TIME_STEPS() );
+            inInfo->Set( vtkStreamingDemandDrivenPipeline::UPDATE_TIME_STEPS(), its, itsSize );
+        }
     }
 
-    // From vtkTemporalDataSetCache
-    CacheType::iterator pos;
-    vtkstd::vector<double> reqTimeSteps;
-    if( outInfo->Has(vtkStreamingDemandDrivenPipeline::UPDATE_TIME_STEPS()) )
+    //return this->Superclass::RequestUpdateExtent( request, inputVector, outputVector );
+    return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkTemporalDataSetTimeStepProvider::RequestData(
+    vtkInformation *,
+    vtkInformationVector **inputVector,
+    vtkInformationVector *outputVector)
+{
+    vtkInformation *inInfo = inputVector[0]->GetInformationObject(0);
+    vtkInformation *outInfo = outputVector->GetInformationObject(0);
+    vtkTemporalDataSet *inData = vtkTemporalDataSet::SafeDownCast( inInfo->Get( vtkDataObject::DATA_OBJECT() ) );
+    vtkTemporalDataSet *outData = vtkTemporalDataSet::SafeDownCast( outInfo->Get( vtkDataObject::DATA_OBJECT() ) );
+    if( !inData || !outData )
+    {
+        return 0;
+    }
+
+    // Put the new steps in the slots of the window positions they belong to.
+    // The step that left the window goes to the array pool as its slot is overwritten
+    int numWindowSteps = static_cast<int>( this->WindowTimes.size() );
+    double* inTimes = inData->GetInformation()->Get( vtkDataObject::DATA_TIME_STEPS() );
+    int numInTimes = inData->GetInformation()->Length( vtkDataObject::DATA_TIME_STEPS() );
+    for( int indexIn = 0; inTimes && ( indexIn < numInTimes ); indexIn++ )
     {
-        double *upTimes = outInfo->Get(vtkStreamingDemandDrivenPipeline::UPDATE_TIME_STEPS());
-        int numTimes = outInfo->Length(vtkStreamingDemandDrivenPipeline::UPDATE_TIME_STEPS());
-        int i;
-        for( i = 0; i < numTimes; ++i )
+        for( int windowPosition = 0; windowPosition < numWindowSteps; windowPosition++ )
         {
-            // do we have this time step?
-            pos = this->Cache.find( upTimes[i] );
-            if( pos == this->Cache.end() )
+            WindowSlot& slot = this->Window[this->GetWindowSlot( windowPosition )];
+            if( ( this->WindowTimes[windowPosition] == inTimes[indexIn] ) &&
+                ( !slot.Data || ( slot.SourceIndex != this->WindowSourceIndices[windowPosition] ) ) )
             {
-                reqTimeSteps.push_back( upTimes[i] );
+                this->EvictSlot( slot );
+                slot.SourceIndex = this->WindowSourceIndices[windowPosition];
+                slot.Time = inTimes[indexIn];
+                slot.Data = inData->GetTimeStep( indexIn );
             }
         }
+    }
 
-        // if we need any data
-        if( reqTimeSteps.size() )
+    // The output holds the window in order
+    outData->SetNumberOfTimeSteps( numWindowSteps );
+    for( int windowPosition = 0; windowPosition < numWindowSteps; windowPosition++ )
+    {
+        const WindowSlot& slot = this->Window[this->GetWindowSlot( windowPosition )];
+        if( slot.Data && ( slot.SourceIndex == this->WindowSourceIndices[windowPosition] ) )
         {
-            inInfo->Set( vtkStreamingDemandDrivenPipeline::UPDATE_TIME_STEPS(),
-                &reqTimeSteps[0],static_cast<int>(reqTimeSteps.size()) );
+            outData->SetTimeStep( windowPosition, slot.Data );
         }
-        // otherwise leave the input with what it already has 
         else
         {
-            vtkDataObject *dobj = inInfo->Get(vtkDataObject::DATA_OBJECT());
-            if( dobj )
-            {
-                double *its = dobj->GetInformation()->Get( vtkDataObject::DATA_TIME_STEPS() );
-                int itsSize = dobj->GetInformation()->Length( vtkDataObject::DATA_TIME_STEPS() );
-                inInfo->Set( vtkStreamingDemandDrivenPipeline::UPDATE_TIME_STEPS(), its, itsSize );
-            }
+            // Left empty rather than with the dataset of the step that was there
+            vtkDebugMacro(<<"Time step " << this->WindowTimes[windowPosition] << " not provided by the source");
+            outData->SetTimeStep( windowPosition, 0 );
         }
     }
+    if( numWindowSteps > 0 )
+    {
+        outData->GetInformation()->Set( vtkDataObject::DATA_TIME_STEPS(), &this->WindowTimes[0], numWindowSteps );
+    }
 
-    //return this->Superclass::RequestUpdateExtent( request, inputVector, outputVector );
     return 1;
 }
 
@@ -173,4 +342,8 @@ int vtkTemporalDataSetTimeStepProvider::FillOutputPortInformation(
 void vtkTemporalDataSetTimeStepProvider::PrintSelf( ostream& os, vtkIndent indent )
 {
     this->Superclass::PrintSelf( os, indent );
+
+    os << indent << "NextTimeStep: " << this->NextTimeStep << "\n";
+    os << indent << "TimeStepWrap: " << this->TimeStepWrap << "\n";
+    os << indent << "LastNumberOfRequestedTimeSteps: " << this->LastNumberOfRequestedTimeSteps << "\n";
 }
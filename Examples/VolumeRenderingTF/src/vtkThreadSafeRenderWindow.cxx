@@ -23,7 +23,6 @@
 
 #include <vtkObjectFactory.h>
 #include <vtkRenderWindow.h>
-#include <vtkMutexLock.h>
 #include <vtkMultiThreader.h>
 #include "vtkThreadSafeRenderer.h"
 #include "vtkThreadSafeRenderWindowInteractor.h"
@@ -78,6 +77,10 @@ public:
     }
 
 public:
+    typedef vtkRenderWindow ImplType;
+    typedef msvScalarAccess ScalarAccess;
+    typedef msvCompoundAccess CompoundAccess;
+
     // Description:
     // Constructor and destructor
     vtkThreadSafeRenderWindowImpl( vtkThreadSafeRenderWindow* publicInterface );
@@ -85,6 +88,17 @@ public:
 
     virtual void PrintSelf( ostream& os, vtkIndent indent );
 
+    // Description:
+    // Writes are queued and applied by ApplyPendingWrites, which Render calls
+    // before drawing, or made at once when CompoundAccess does not defer them.
+    // Meanwhile the render shares the lock with the readers. Window system setup (ids, pixel data, making the context current) is
+    // still done at once under the write lock
+    void QueueWrite( msvDeferredCommand* command );
+    void ApplyPendingWrites();
+    int GetNumberOfPendingWrites();
+    void GetLockCounters( msvLockCounters& counters );
+    void ResetLockCounters();
+
     // Description:
     // Add a renderer to the list of renderers.
     virtual void AddRenderer(vtkRenderer *);
@@ -106,9 +120,9 @@ public:
     vtkRendererCollection *GetRenderers()
     {
         vtkRendererCollection* aux( 0 );
-        this->Mutex->Lock();
+        CompoundAccess::LockShared( this->Mutex );
         aux = this->Impl->GetRenderers();
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockShared( this->Mutex );
         return aux;
     };
 
@@ -121,18 +135,18 @@ public:
     // Initialize the rendering process.
     virtual void Start()
     {
-        this->Mutex->Lock();
+        CompoundAccess::LockExclusive( this->Mutex );
         this->Impl->Start();
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockExclusive( this->Mutex );
     }
 
     // Description:
     // Finalize the rendering process.
     virtual void Finalize()
     {
-        this->Mutex->Lock();
+        CompoundAccess::LockExclusive( this->Mutex );
         this->Impl->Finalize();
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockExclusive( this->Mutex );
     }
 
     // Description:
@@ -140,9 +154,9 @@ public:
     // to do things like swapping buffers (if necessary) or similar actions.
     virtual void Frame()
     {
-        this->Mutex->Lock();
+        CompoundAccess::LockExclusive( this->Mutex );
         this->Impl->Frame();
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockExclusive( this->Mutex );
     }
 
     // Description:
@@ -150,9 +164,9 @@ public:
     // Useful for measurement only.
     virtual void WaitForCompletion()
     {
-        this->Mutex->Lock();
+        CompoundAccess::LockExclusive( this->Mutex );
         this->Impl->WaitForCompletion();
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockExclusive( this->Mutex );
     }
 
     // Description:
@@ -173,21 +187,21 @@ public:
     // corner).
     virtual void HideCursor()
     {
-        this->Mutex->Lock();
+        CompoundAccess::LockExclusive( this->Mutex );
         this->Impl->HideCursor();
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockExclusive( this->Mutex );
     }
     virtual void ShowCursor()
     {
-        this->Mutex->Lock();
+        CompoundAccess::LockExclusive( this->Mutex );
         this->Impl->ShowCursor();
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockExclusive( this->Mutex );
     }
     virtual void SetCursorPosition(int x, int y)
     {
-        this->Mutex->Lock();
+        CompoundAccess::LockExclusive( this->Mutex );
         this->Impl->SetCursorPosition( x, y );
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockExclusive( this->Mutex );
     }
 
     // Description:
@@ -199,9 +213,14 @@ public:
     // Turn on/off rendering full screen window size.
     virtual void SetFullScreen(int fullScreen )
     {
-        this->Mutex->Lock();
-        this->Impl->SetFullScreen( fullScreen );
-        this->Mutex->Unlock();
+        if( CompoundAccess::DefersWrites )
+        {
+            QueueWrite( new msvDeferredCall1<vtkRenderWindow, int>( &vtkRenderWindow::SetFullScreen, this->Impl, fullScreen ) );
+        }
+        else
+        {
+            this->Impl->SetFullScreen( fullScreen );
+        }
     }
     vtkSafeGetMacro(FullScreen,int);
     vtkSafeBooleanMacro(FullScreen,int);
@@ -335,9 +354,9 @@ public:
     // once the window is up.
     virtual void WindowRemap()
     {
-        this->Mutex->Lock();
+        CompoundAccess::LockExclusive( this->Mutex );
         this->Impl->WindowRemap();
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockExclusive( this->Mutex );
     }
 
 
@@ -362,18 +381,18 @@ public:
         int front)
     {
         int aux( 0 );
-        this->Mutex->Lock();
+        CompoundAccess::LockExclusive( this->Mutex );
         aux = this->Impl->SetPixelData( x, y, x2, y2, data, front );
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockExclusive( this->Mutex );
         return aux;
     }
     virtual int SetPixelData(int x, int y, int x2, int y2,
         vtkUnsignedCharArray *data, int front)
     {
         int aux( 0 );
-        this->Mutex->Lock();
+        CompoundAccess::LockExclusive( this->Mutex );
         aux = this->Impl->SetPixelData( x, y, x2, y2, data, front );
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockExclusive( this->Mutex );
         return aux;
     }
 
@@ -386,60 +405,60 @@ public:
     virtual float *GetRGBAPixelData(int x, int y, int x2, int y2, int front)
     {
         float* aux( 0 );
-        this->Mutex->Lock();
+        CompoundAccess::LockExclusive( this->Mutex );
         aux = this->Impl->GetRGBAPixelData( x, y, x2, y2, front );
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockExclusive( this->Mutex );
         return aux;
     }
     virtual int GetRGBAPixelData(int x, int y, int x2, int y2, int front,
         vtkFloatArray *data)
     {
         int aux( 0 );
-        this->Mutex->Lock();
+        CompoundAccess::LockExclusive( this->Mutex );
         aux = this->Impl->GetRGBAPixelData( x, y, x2, y2, front, data );
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockExclusive( this->Mutex );
         return aux;
     }
     virtual int SetRGBAPixelData(int x, int y, int x2, int y2, float *data,
         int front, int blend=0)
     {
         int aux( 0 );
-        this->Mutex->Lock();
+        CompoundAccess::LockExclusive( this->Mutex );
         aux = this->Impl->SetRGBAPixelData( x, y, x2, y2, data, front, blend );
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockExclusive( this->Mutex );
         return aux;
     }
     virtual int SetRGBAPixelData(int x, int y, int x2, int y2, vtkFloatArray* data ,
         int front, int blend=0)
     {
         int aux( 0 );
-        this->Mutex->Lock();
+        CompoundAccess::LockExclusive( this->Mutex );
         aux = this->Impl->SetRGBAPixelData( x, y, x2, y2, data, front, blend );
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockExclusive( this->Mutex );
         return aux;
     }
     virtual void ReleaseRGBAPixelData(float *data)
     {
-        this->Mutex->Lock();
+        CompoundAccess::LockExclusive( this->Mutex );
         this->Impl->ReleaseRGBAPixelData( data );
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockExclusive( this->Mutex );
     }
     virtual unsigned char *GetRGBACharPixelData(int x, int y, int x2, int y2,
         int front)
     {
         unsigned char* aux( 0 );
-        this->Mutex->Lock();
+        CompoundAccess::LockExclusive( this->Mutex );
         aux = this->Impl->GetRGBACharPixelData( x, y, x2, y2, front );
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockExclusive( this->Mutex );
         return aux;
     }
     virtual int GetRGBACharPixelData(int x, int y, int x2, int y2, int front,
         vtkUnsignedCharArray *data)
     {
         int aux( 0 );
-        this->Mutex->Lock();
+        CompoundAccess::LockExclusive( this->Mutex );
         aux = this->Impl->GetRGBACharPixelData( x, y, x2, y2, front, data );
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockExclusive( this->Mutex );
         return aux;
     }
     virtual int SetRGBACharPixelData(int x,int y, int x2, int y2,
@@ -447,9 +466,9 @@ public:
         int blend=0)
     {
         int aux( 0 );
-        this->Mutex->Lock();
+        CompoundAccess::LockExclusive( this->Mutex );
         aux = this->Impl->SetRGBACharPixelData( x, y, x2, y2, data, front, blend );
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockExclusive( this->Mutex );
         return aux;
     }
     virtual int SetRGBACharPixelData(int x, int y, int x2, int y2,
@@ -457,9 +476,9 @@ public:
         int blend=0)
     {
         int aux( 0 );
-        this->Mutex->Lock();
+        CompoundAccess::LockExclusive( this->Mutex );
         aux = this->Impl->SetRGBACharPixelData( x, y, x2, y2, data, front, blend );
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockExclusive( this->Mutex );
         return aux;
     }
 
@@ -470,51 +489,51 @@ public:
     virtual float *GetZbufferData(int x, int y, int x2, int y2)
     {
         float* aux( 0 );
-        this->Mutex->Lock();
+        CompoundAccess::LockExclusive( this->Mutex );
         aux = this->Impl->GetZbufferData( x, y, x2, y2 );
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockExclusive( this->Mutex );
         return aux;
     }
     virtual int GetZbufferData(int x, int y, int x2, int y2, float *z)
     {
         int aux( 0 );
-        this->Mutex->Lock();
+        CompoundAccess::LockExclusive( this->Mutex );
         aux = this->Impl->GetZbufferData( x, y, x2, y2, z );
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockExclusive( this->Mutex );
         return aux;
     }
     virtual int GetZbufferData(int x, int y, int x2, int y2,
         vtkFloatArray *z)
     {
         int aux( 0 );
-        this->Mutex->Lock();
+        CompoundAccess::LockExclusive( this->Mutex );
         aux = this->Impl->GetZbufferData( x, y, x2, y2, z );
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockExclusive( this->Mutex );
         return aux;
     }
     virtual int SetZbufferData(int x, int y, int x2, int y2, float *z)
     {
         int aux( 0 );
-        this->Mutex->Lock();
+        CompoundAccess::LockExclusive( this->Mutex );
         aux = this->Impl->SetZbufferData( x, y, x2, y2, z );
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockExclusive( this->Mutex );
         return aux;
     }
     virtual int SetZbufferData(int x, int y, int x2, int y2,
         vtkFloatArray *z)
     {
         int aux( 0 );
-        this->Mutex->Lock();
+        CompoundAccess::LockExclusive( this->Mutex );
         aux = this->Impl->SetZbufferData( x, y, x2, y2, z );
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockExclusive( this->Mutex );
         return aux;
     }
     float GetZbufferDataAtPoint(int x, int y)
     {
         float aux( 0 );
-        this->Mutex->Lock();
+        CompoundAccess::LockExclusive( this->Mutex );
         aux = this->Impl->GetZbufferDataAtPoint( x, y );
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockExclusive( this->Mutex );
         return aux;
     }
 
@@ -569,9 +588,9 @@ public:
     virtual int GetEventPending()
     {
         int aux( 0 );
-        this->Mutex->Lock();
+        CompoundAccess::LockShared( this->Mutex );
         aux = this->Impl->GetEventPending();
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockShared( this->Mutex );
         return aux;
     }
 
@@ -581,9 +600,9 @@ public:
     virtual int  CheckInRenderStatus()
     {
         int aux( 0 );
-        this->Mutex->Lock();
+        CompoundAccess::LockShared( this->Mutex );
         aux = this->Impl->CheckInRenderStatus();
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockShared( this->Mutex );
         return aux;
     }
 
@@ -591,9 +610,9 @@ public:
     // Clear status (after an exception was thrown for example)
     virtual void ClearInRenderStatus()
     {
-        this->Mutex->Lock();
+        CompoundAccess::LockExclusive( this->Mutex );
         this->Impl->ClearInRenderStatus();
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockExclusive( this->Mutex );
     }
 
     // Description:
@@ -631,94 +650,94 @@ public:
     // Dummy stubs for vtkWindow API.
     virtual void SetDisplayId(void *displayId)
     {
-        this->Mutex->Lock();
+        CompoundAccess::LockExclusive( this->Mutex );
         this->Impl->SetDisplayId( displayId );
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockExclusive( this->Mutex );
     }
     virtual void SetWindowId(void *windowId)
     {
-        this->Mutex->Lock();
+        CompoundAccess::LockExclusive( this->Mutex );
         this->Impl->SetWindowId( windowId );
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockExclusive( this->Mutex );
     }
     virtual void SetNextWindowId(void *windowId)
     {
-        this->Mutex->Lock();
+        CompoundAccess::LockExclusive( this->Mutex );
         this->Impl->SetNextWindowId( windowId );
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockExclusive( this->Mutex );
     }
     virtual void SetParentId(void *parentId)
     {
-        this->Mutex->Lock();
+        CompoundAccess::LockExclusive( this->Mutex );
         this->Impl->SetParentId( parentId );
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockExclusive( this->Mutex );
     }
     virtual void *GetGenericDisplayId()
     {
         void* aux( 0 );
-        this->Mutex->Lock();
+        CompoundAccess::LockShared( this->Mutex );
         aux = this->Impl->GetGenericDisplayId();
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockShared( this->Mutex );
         return aux;
     }
     virtual void *GetGenericWindowId()
     {
         void* aux( 0 );
-        this->Mutex->Lock();
+        CompoundAccess::LockShared( this->Mutex );
         aux = this->Impl->GetGenericWindowId();
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockShared( this->Mutex );
         return aux;
     }
     virtual void *GetGenericParentId()
     {
         void* aux( 0 );
-        this->Mutex->Lock();
+        CompoundAccess::LockShared( this->Mutex );
         aux = this->Impl->GetGenericParentId();
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockShared( this->Mutex );
         return aux;
     }
     virtual void *GetGenericContext()
     {
         void* aux( 0 );
-        this->Mutex->Lock();
+        CompoundAccess::LockShared( this->Mutex );
         aux = this->Impl->GetGenericContext();
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockShared( this->Mutex );
         return aux;
     }
     virtual void *GetGenericDrawable()
     {
         void* aux( 0 );
-        this->Mutex->Lock();
+        CompoundAccess::LockShared( this->Mutex );
         aux = this->Impl->GetGenericDrawable();
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockShared( this->Mutex );
         return aux;
     }
     virtual void SetWindowInfo(char *info)
     {
-        this->Mutex->Lock();
+        CompoundAccess::LockExclusive( this->Mutex );
         this->Impl->SetWindowInfo( info );
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockExclusive( this->Mutex );
     }
     virtual void SetNextWindowInfo(char *info)
     {
-        this->Mutex->Lock();
+        CompoundAccess::LockExclusive( this->Mutex );
         this->Impl->SetNextWindowInfo( info );
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockExclusive( this->Mutex );
     }
     virtual void SetParentInfo(char *info )
     {
-        this->Mutex->Lock();
+        CompoundAccess::LockExclusive( this->Mutex );
         this->Impl->SetParentInfo( info );
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockExclusive( this->Mutex );
     }
     // Description:
     // Get the current size of the screen in pixels.
     virtual int  *GetScreenSize()
     {
         int* aux( 0 );
-        this->Mutex->Lock();
+        CompoundAccess::LockShared( this->Mutex );
         aux = this->Impl->GetScreenSize();
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockShared( this->Mutex );
         return aux;
     }
     // Description:
@@ -736,18 +755,18 @@ public:
         int front)
     {
         unsigned char* aux( 0 );
-        this->Mutex->Lock();
+        CompoundAccess::LockExclusive( this->Mutex );
         aux = this->Impl->GetPixelData( x, y, x2, y2, front );
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockExclusive( this->Mutex );
         return aux;
     }
     virtual int GetPixelData(int x, int y, int x2, int y2, int front,
         vtkUnsignedCharArray *data)
     {
         int aux( 0 );
-        this->Mutex->Lock();
+        CompoundAccess::LockExclusive( this->Mutex );
         aux = this->Impl->GetPixelData( x, y, x2, y2, front, data );
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockExclusive( this->Mutex );
         return aux;
     }
 
@@ -756,9 +775,9 @@ public:
     // thread.
     virtual void MakeCurrent()
     {
-        this->Mutex->Lock();
+        CompoundAccess::LockExclusive( this->Mutex );
         this->Impl->MakeCurrent();
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockExclusive( this->Mutex );
     }
 
     // Description:
@@ -767,9 +786,9 @@ public:
     virtual bool IsCurrent()
     {
         bool aux( 0 );
-        this->Mutex->Lock();
+        CompoundAccess::LockShared( this->Mutex );
         this->Impl->IsCurrent();
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockShared( this->Mutex );
         return aux;
     }
 
@@ -779,9 +798,9 @@ public:
     // on the next render.
     virtual void SetForceMakeCurrent()
     {
-        this->Mutex->Lock();
+        CompoundAccess::LockExclusive( this->Mutex );
         this->Impl->SetForceMakeCurrent();
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockExclusive( this->Mutex );
     }
 
     // Description:
@@ -793,9 +812,9 @@ public:
     virtual int SupportsOpenGL()
     {
         int aux( 0 );
-        this->Mutex->Lock();
+        CompoundAccess::LockExclusive( this->Mutex );
         aux = this->Impl->SupportsOpenGL();
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockExclusive( this->Mutex );
         return aux;
     }
 
@@ -804,9 +823,9 @@ public:
     virtual int IsDirect()
     {
         int aux( 0 );
-        this->Mutex->Lock();
+        CompoundAccess::LockShared( this->Mutex );
         aux = this->Impl->IsDirect();
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockShared( this->Mutex );
         return aux;
     }
 
@@ -816,9 +835,9 @@ public:
     virtual int GetDepthBufferSize()
     {
         int aux( 0 );
-        this->Mutex->Lock();
+        CompoundAccess::LockExclusive( this->Mutex );
         aux = this->Impl->GetDepthBufferSize();
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockExclusive( this->Mutex );
         return aux;
     }
 
@@ -829,9 +848,9 @@ public:
     virtual int GetColorBufferSizes(int *rgba)
     {
         int aux( 0 );
-        this->Mutex->Lock();
+        CompoundAccess::LockExclusive( this->Mutex );
         aux = this->Impl->GetColorBufferSizes( rgba );
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockExclusive( this->Mutex );
         return aux;
     }
 
@@ -864,9 +883,9 @@ public:
     // debug mode.
     virtual void CheckGraphicError()
     {
-        this->Mutex->Lock();
+        CompoundAccess::LockExclusive( this->Mutex );
         this->Impl->CheckGraphicError();
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockExclusive( this->Mutex );
     }
 
     // Description:
@@ -874,9 +893,9 @@ public:
     virtual int HasGraphicError()
     {
         int aux( 0 );
-        this->Mutex->Lock();
+        CompoundAccess::LockShared( this->Mutex );
         aux = this->Impl->HasGraphicError();
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockShared( this->Mutex );
         return aux;
     }
 
@@ -885,16 +904,17 @@ public:
     virtual const char *GetLastGraphicErrorString()
     {
         const char* aux( 0 );
-        this->Mutex->Lock();
+        CompoundAccess::LockShared( this->Mutex );
         aux = this->Impl->GetLastGraphicErrorString();
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockShared( this->Mutex );
         return aux;
     }
 
 private:
 
     vtkRenderWindow*                        Impl;
-    vtkMutexLock*                           Mutex;
+    msvReadWriteLock*                       Mutex;
+    msvDeferredCommandQueue*                PendingWrites;
     vtkMultiThreaderIDType                  LockOwnerThreadID;
     vtkRendererCollection*                  ThreadSafeRenderers;
     vtkThreadSafeRenderWindow*              PublicInterface;
@@ -904,27 +924,71 @@ private:
 vtkThreadSafeRenderWindowImpl::vtkThreadSafeRenderWindowImpl( vtkThreadSafeRenderWindow* publicInterface )
 : Impl( 0 )
 , Mutex( 0 )
+, PendingWrites( 0 )
 , LockOwnerThreadID( -1 )
 , PublicInterface( publicInterface )
 , ThreadSafeRenderWindowInteractor( 0 )
 {
-    this->Mutex = vtkMutexLock::New();
+    this->Mutex = msvReadWriteLock::New();
+    this->PendingWrites = msvDeferredCommandQueue::New();
     this->Impl = vtkRenderWindow::New();
 }
 
 vtkThreadSafeRenderWindowImpl::~vtkThreadSafeRenderWindowImpl()
 {
-    this->Mutex->Unlock();
-    this->Mutex->Delete();
+    // Pending writes may hold references to renderers, release them first
+    this->PendingWrites->Delete();
     this->Impl->Delete();
+    this->Mutex->Delete();
 }
 
 void vtkThreadSafeRenderWindowImpl::PrintSelf( ostream& os, vtkIndent indent )
 {
     this->Superclass::PrintSelf( os, indent );
-    this->Mutex->Lock();
+    CompoundAccess::LockShared( this->Mutex );
     this->Impl->PrintSelf( os, indent );
-    this->Mutex->Unlock();
+    CompoundAccess::UnlockShared( this->Mutex );
+    this->Mutex->PrintSelf( os, indent );
+}
+
+void vtkThreadSafeRenderWindowImpl::QueueWrite( msvDeferredCommand* command )
+{
+    if( CompoundAccess::DefersWrites )
+    {
+        this->PendingWrites->Push( command );
+    }
+    else
+    {
+        command->Execute();
+        delete command;
+    }
+}
+
+void vtkThreadSafeRenderWindowImpl::ApplyPendingWrites()
+{
+    // No exclusive lock for the frames without writes
+    if( this->PendingWrites->GetNumberOfPendingCommands() == 0 )
+    {
+        return;
+    }
+    CompoundAccess::LockExclusive( this->Mutex );
+    this->PendingWrites->ApplyAll();
+    CompoundAccess::UnlockExclusive( this->Mutex );
+}
+
+int vtkThreadSafeRenderWindowImpl::GetNumberOfPendingWrites()
+{
+    return this->PendingWrites->GetNumberOfPendingCommands();
+}
+
+void vtkThreadSafeRenderWindowImpl::GetLockCounters( msvLockCounters& counters )
+{
+    this->Mutex->GetCounters( counters );
+}
+
+void vtkThreadSafeRenderWindowImpl::ResetLockCounters()
+{
+    this->Mutex->ResetCounters();
 }
 
 //----------------------------------------------------------------------------
@@ -932,9 +996,9 @@ void vtkThreadSafeRenderWindowImpl::PrintSelf( ostream& os, vtkIndent indent )
 vtkRenderWindowInteractor *vtkThreadSafeRenderWindowImpl::MakeRenderWindowInteractor()
 {
     vtkRenderWindowInteractor* aux( 0 );
-    this->Mutex->Lock();
+    CompoundAccess::LockExclusive( this->Mutex );
     aux = this->Impl->MakeRenderWindowInteractor();
-    this->Mutex->Unlock();
+    CompoundAccess::UnlockExclusive( this->Mutex );
     return aux;
 }
 
@@ -942,7 +1006,7 @@ vtkRenderWindowInteractor *vtkThreadSafeRenderWindowImpl::MakeRenderWindowIntera
 // Set the interactor that will work with this renderer.
 void vtkThreadSafeRenderWindowImpl::SetInteractor(vtkRenderWindowInteractor *rwi)
 {
-    this->Mutex->Lock();
+    CompoundAccess::LockExclusive( this->Mutex );
     vtkThreadSafeRenderWindowInteractor* tsrwi = dynamic_cast<vtkThreadSafeRenderWindowInteractor*>( rwi );
     if( tsrwi != 0 )
     {
@@ -979,23 +1043,33 @@ void vtkThreadSafeRenderWindowImpl::SetInteractor(vtkRenderWindowInteractor *rwi
         // Should assert
         this->Impl->SetInteractor( rwi );
     }
-    this->Mutex->Unlock();
+    CompoundAccess::UnlockExclusive( this->Mutex );
 }
 
 //----------------------------------------------------------------------------
 void vtkThreadSafeRenderWindowImpl::SetSubFrames(int subFrames)
 {
-    this->Mutex->Lock();
-    this->Impl->SetSubFrames( subFrames );
-    this->Mutex->Unlock();
+    if( CompoundAccess::DefersWrites )
+    {
+        QueueWrite( new msvDeferredCall1<vtkRenderWindow, int>( &vtkRenderWindow::SetSubFrames, this->Impl, subFrames ) );
+    }
+    else
+    {
+        this->Impl->SetSubFrames( subFrames );
+    }
 }
 
 //----------------------------------------------------------------------------
 void vtkThreadSafeRenderWindowImpl::SetDesiredUpdateRate(double rate)
 {
-    this->Mutex->Lock();
-    this->Impl->SetDesiredUpdateRate( rate );
-    this->Mutex->Unlock();
+    if( CompoundAccess::DefersWrites )
+    {
+        QueueWrite( new msvDeferredCall1<vtkRenderWindow, double>( &vtkRenderWindow::SetDesiredUpdateRate, this->Impl, rate ) );
+    }
+    else
+    {
+        this->Impl->SetDesiredUpdateRate( rate );
+    }
 }
 
 
@@ -1006,18 +1080,28 @@ void vtkThreadSafeRenderWindowImpl::SetDesiredUpdateRate(double rate)
 //
 void vtkThreadSafeRenderWindowImpl::SetStereoCapableWindow(int capable)
 {
-    this->Mutex->Lock();
-    this->Impl->SetStereoCapableWindow( capable );
-    this->Mutex->Unlock();
+    if( CompoundAccess::DefersWrites )
+    {
+        QueueWrite( new msvDeferredCall1<vtkRenderWindow, int>( &vtkRenderWindow::SetStereoCapableWindow, this->Impl, capable ) );
+    }
+    else
+    {
+        this->Impl->SetStereoCapableWindow( capable );
+    }
 }
 
 //----------------------------------------------------------------------------
 // Turn on stereo rendering
 void vtkThreadSafeRenderWindowImpl::SetStereoRender(int stereo)
 {
-    this->Mutex->Lock();
-    this->Impl->SetStereoRender( stereo );
-    this->Mutex->Unlock();
+    if( CompoundAccess::DefersWrites )
+    {
+        QueueWrite( new msvDeferredCall1<vtkRenderWindow, int>( &vtkRenderWindow::SetStereoRender, this->Impl, stereo ) );
+    }
+    else
+    {
+        this->Impl->SetStereoRender( stereo );
+    }
 }
 
 //----------------------------------------------------------------------------
@@ -1025,9 +1109,15 @@ void vtkThreadSafeRenderWindowImpl::SetStereoRender(int stereo)
 // synchronize this process.
 void vtkThreadSafeRenderWindowImpl::Render()
 {
-    this->Mutex->Lock();
+    ApplyPendingWrites();
+
+    // The render shares the lock with the getters that only read the window
+    // state, the renderers reading the window too. The calls that touch the
+    // GL context (frame buffer readback, buffer sizes) or change the window
+    // take the lock exclusively, so they wait for the frame to end
+    CompoundAccess::LockShared( this->Mutex );
     this->Impl->Render();
-    this->Mutex->Unlock();
+    CompoundAccess::UnlockShared( this->Mutex );
 
     //this->InvokeEvent(vtkCommand::EndEvent,NULL);
 }
@@ -1037,9 +1127,9 @@ protected:
 // Handle rendering any antialiased frames.
 void vtkThreadSafeRenderWindowImpl::DoAARender()
 {
-    this->Mutex->Lock();
+    CompoundAccess::LockExclusive( this->Mutex );
     this->Impl->DoAARender();
-    this->Mutex->Unlock();
+    CompoundAccess::UnlockExclusive( this->Mutex );
 }
 */
 
@@ -1049,9 +1139,9 @@ protected:
 // Handle rendering any focal depth frames.
 void vtkThreadSafeRenderWindowImpl::DoFDRender()
 {
-    this->Mutex->Lock();
+    CompoundAccess::LockExclusive( this->Mutex );
     this->Impl->DoFDRender();
-    this->Mutex->Unlock();
+    CompoundAccess::UnlockExclusive( this->Mutex );
 }
 */
 
@@ -1061,9 +1151,9 @@ protected:
 // Handle rendering the two different views for stereo rendering.
 void vtkThreadSafeRenderWindowImpl::DoStereoRender()
 {
-    this->Mutex->Lock();
+    CompoundAccess::LockExclusive( this->Mutex );
     this->Impl->DoStereoRender();
-    this->Mutex->Unlock();
+    CompoundAccess::UnlockExclusive( this->Mutex );
 }
 */
 
@@ -1071,36 +1161,42 @@ void vtkThreadSafeRenderWindowImpl::DoStereoRender()
 // Add a renderer to the list of renderers.
 void vtkThreadSafeRenderWindowImpl::AddRenderer(vtkRenderer *ren)
 {
-    this->Mutex->Lock();
     vtkThreadSafeRenderer* tsren = dynamic_cast<vtkThreadSafeRenderer*>( ren );
     if( tsren != 0 )
     {
         tsren->SetRenderWindow( this->PublicInterface );
-        this->Impl->AddRenderer( tsren );
+    }
+    // Should assert if it is not thread safe?
+    if( CompoundAccess::DefersWrites )
+    {
+        QueueWrite( new msvDeferredObjectCall<vtkRenderWindow, vtkRenderer>( &vtkRenderWindow::AddRenderer, this->Impl, ren ) );
     }
     else
     {
-        // Should assert?
         this->Impl->AddRenderer( ren );
     }
-    this->Mutex->Unlock();
 }
 
 //----------------------------------------------------------------------------
 // Remove a renderer from the list of renderers.
 void vtkThreadSafeRenderWindowImpl::RemoveRenderer(vtkRenderer *ren)
 {
-    this->Mutex->Lock();
-    this->Impl->RemoveRenderer( ren );
-    this->Mutex->Unlock();
+    if( CompoundAccess::DefersWrites )
+    {
+        QueueWrite( new msvDeferredObjectCall<vtkRenderWindow, vtkRenderer>( &vtkRenderWindow::RemoveRenderer, this->Impl, ren ) );
+    }
+    else
+    {
+        this->Impl->RemoveRenderer( ren );
+    }
 }
 
 int vtkThreadSafeRenderWindowImpl::HasRenderer(vtkRenderer *ren)
 {
     int aux( 0 );
-    this->Mutex->Lock();
+    CompoundAccess::LockShared( this->Mutex );
     aux = this->Impl->HasRenderer( ren );
-    this->Mutex->Unlock();
+    CompoundAccess::UnlockShared( this->Mutex );
     return aux;
 }
 
@@ -1108,9 +1204,9 @@ int vtkThreadSafeRenderWindowImpl::HasRenderer(vtkRenderer *ren)
 int vtkThreadSafeRenderWindowImpl::CheckAbortStatus()
 {
     int aux( 0 );
-    this->Mutex->Lock();
+    CompoundAccess::LockExclusive( this->Mutex );
     aux = this->Impl->CheckAbortStatus();
-    this->Mutex->Unlock();
+    CompoundAccess::UnlockExclusive( this->Mutex );
     return aux;
 }
 
@@ -1119,9 +1215,9 @@ int vtkThreadSafeRenderWindowImpl::CheckAbortStatus()
 // methods, subclasses might need to switch some hardware settings here.
 void vtkThreadSafeRenderWindowImpl::StereoUpdate(void)
 {
-    this->Mutex->Lock();
+    CompoundAccess::LockExclusive( this->Mutex );
     this->Impl->StereoUpdate();
-    this->Mutex->Unlock();
+    CompoundAccess::UnlockExclusive( this->Mutex );
 }
 
 //----------------------------------------------------------------------------
@@ -1129,9 +1225,9 @@ void vtkThreadSafeRenderWindowImpl::StereoUpdate(void)
 // of the left and right eye.
 void vtkThreadSafeRenderWindowImpl::StereoMidpoint(void)
 {
-    this->Mutex->Lock();
+    CompoundAccess::LockExclusive( this->Mutex );
     this->Impl->StereoMidpoint();
-    this->Mutex->Unlock();
+    CompoundAccess::UnlockExclusive( this->Mutex );
 }
 
 //----------------------------------------------------------------------------
@@ -1139,17 +1235,17 @@ void vtkThreadSafeRenderWindowImpl::StereoMidpoint(void)
 // stereo rendering.
 void vtkThreadSafeRenderWindowImpl::StereoRenderComplete(void)
 {
-    this->Mutex->Lock();
+    CompoundAccess::LockExclusive( this->Mutex );
     this->Impl->StereoRenderComplete();
-    this->Mutex->Unlock();
+    CompoundAccess::UnlockExclusive( this->Mutex );
 }
 
 //----------------------------------------------------------------------------
 void vtkThreadSafeRenderWindowImpl::CopyResultFrame(void)
 {
-    this->Mutex->Lock();
+    CompoundAccess::LockExclusive( this->Mutex );
     this->Impl->CopyResultFrame();
-    this->Mutex->Unlock();
+    CompoundAccess::UnlockExclusive( this->Mutex );
 }
 
 
@@ -1158,9 +1254,9 @@ void vtkThreadSafeRenderWindowImpl::CopyResultFrame(void)
 // it might be easier if the GetReference count method were redefined.
 void vtkThreadSafeRenderWindowImpl::UnRegister(vtkObjectBase *o)
 {
-    this->Mutex->Lock();
+    CompoundAccess::LockExclusive( this->Mutex );
     this->Impl->UnRegister( o );
-    this->Mutex->Unlock();
+    CompoundAccess::UnlockExclusive( this->Mutex );
 }
 
 //----------------------------------------------------------------------------
@@ -1175,9 +1271,9 @@ const char *vtkThreadSafeRenderWindowImpl::GetRenderLibrary()
 const char *vtkThreadSafeRenderWindowImpl::GetStereoTypeAsString()
 {
     const char* aux( 0 );
-    this->Mutex->Lock();
+    CompoundAccess::LockShared( this->Mutex );
     aux = this->Impl->GetStereoTypeAsString();
-    this->Mutex->Unlock();
+    CompoundAccess::UnlockShared( this->Mutex );
     return aux;
 }
 
@@ -1236,6 +1332,26 @@ vtkThreadSafeRenderWindow::~vtkThreadSafeRenderWindow()
     delete this->Impl;
 }
 
+void vtkThreadSafeRenderWindow::ApplyPendingWrites()
+{
+    this->Impl->ApplyPendingWrites();
+}
+
+int vtkThreadSafeRenderWindow::GetNumberOfPendingWrites()
+{
+    return this->Impl->GetNumberOfPendingWrites();
+}
+
+void vtkThreadSafeRenderWindow::GetLockCounters( msvLockCounters& counters )
+{
+    this->Impl->GetLockCounters( counters );
+}
+
+void vtkThreadSafeRenderWindow::ResetLockCounters()
+{
+    this->Impl->ResetLockCounters();
+}
+
 // Description:
 // Add a renderer to the list of renderers.
 void vtkThreadSafeRenderWindow::AddRenderer(vtkRenderer *ren)
@@ -23,7 +23,6 @@
 
 #include <vtkObjectFactory.h>
 #include <vtkRenderWindowInteractor.h>
-#include <vtkMutexLock.h>
 #include <vtkMultiThreader.h>
 #include "vtkThreadSafeRenderWindow.h"
 
@@ -39,11 +38,25 @@ using namespace std;
 class vtkThreadSafeRenderWindowInteractorImpl: public vtkObject
 {
 public:
+    typedef vtkRenderWindowInteractor ImplType;
+    typedef msvScalarAccess ScalarAccess;
+    typedef msvCompoundAccess CompoundAccess;
+
     // Description:
     // Constructor and destructor
     vtkThreadSafeRenderWindowInteractorImpl( vtkThreadSafeRenderWindowInteractor* publicInterface );
     ~vtkThreadSafeRenderWindowInteractorImpl();
 
+    // Description:
+    // The interactor does not render, its writes are applied at once
+    void QueueWrite( msvDeferredCommand* command )
+    {
+        CompoundAccess::LockExclusive( this->Mutex );
+        command->Execute();
+        CompoundAccess::UnlockExclusive( this->Mutex );
+        delete command;
+    }
+
     virtual void PrintSelf( ostream& os, vtkIndent indent );
 
     // Description:
@@ -51,15 +64,15 @@ public:
     // interactor will work.
     virtual void Initialize()
     {
-        this->Mutex->Lock();
+        CompoundAccess::LockExclusive( this->Mutex );
         this->Impl->Initialize();
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockExclusive( this->Mutex );
     }
     void ReInitialize()
     {
-        this->Mutex->Lock();
+        CompoundAccess::LockExclusive( this->Mutex );
         this->Impl->ReInitialize();
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockExclusive( this->Mutex );
     }
 
     // Description:
@@ -67,9 +80,9 @@ public:
     // so objects are freed properly.
     virtual void UnRegister(vtkObjectBase *o)
     {
-        this->Mutex->Lock();
+        CompoundAccess::LockExclusive( this->Mutex );
         this->Impl->UnRegister( o );
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockExclusive( this->Mutex );
     }
 
     // Description:
@@ -78,9 +91,9 @@ public:
     // event loop if you want. Initialize should be called before Start.
     virtual void Start()
     {
-        this->Mutex->Lock();
+        CompoundAccess::LockExclusive( this->Mutex );
         this->Impl->Start();
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockExclusive( this->Mutex );
     }
 
     // Description:
@@ -93,15 +106,15 @@ public:
     // when their data is not displayed.
     virtual void Enable()
     {
-        this->Mutex->Lock();
+        CompoundAccess::LockExclusive( this->Mutex );
         this->Impl->Enable();
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockExclusive( this->Mutex );
     }
     virtual void Disable()
     {
-        this->Mutex->Lock();
+        CompoundAccess::LockExclusive( this->Mutex );
         this->Impl->Disable();
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockExclusive( this->Mutex );
     }
     vtkSafeGetMacro(Enabled, int);
 
@@ -117,7 +130,7 @@ public:
     void SetRenderWindow(vtkRenderWindow *aren)
     {
         // TODO
-        this->Mutex->Lock();
+        CompoundAccess::LockExclusive( this->Mutex );
         vtkThreadSafeRenderWindow* tsaren = dynamic_cast<vtkThreadSafeRenderWindow*>( aren );
         if( tsaren != 0 )
         {
@@ -145,7 +158,7 @@ public:
             // Should assert?
             this->Impl->SetRenderWindow( aren );
         }
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockExclusive( this->Mutex );
     }
     vtkSafeGetObjectMacro(RenderWindow,vtkRenderWindow);
 
@@ -154,9 +167,9 @@ public:
     // Window size is measured in pixels.
     virtual void UpdateSize(int x,int y)
     {
-        this->Mutex->Lock();
+        CompoundAccess::LockExclusive( this->Mutex );
         this->Impl->UpdateSize( x, y );
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockExclusive( this->Mutex );
     }
 
     // Description:
@@ -177,73 +190,73 @@ public:
     virtual int CreateTimer(int timerType)
     {
         int aux( 0 );
-        this->Mutex->Lock();
+        CompoundAccess::LockExclusive( this->Mutex );
         aux = this->Impl->CreateTimer( timerType );
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockExclusive( this->Mutex );
         return aux;
     }
     virtual int DestroyTimer()
     {
         int aux( 0 );
-        this->Mutex->Lock();
+        CompoundAccess::LockExclusive( this->Mutex );
         aux = this->Impl->DestroyTimer();
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockExclusive( this->Mutex );
         return aux;
     }
     int CreateRepeatingTimer(unsigned long duration)
     {
         int aux( 0 );
-        this->Mutex->Lock();
+        CompoundAccess::LockExclusive( this->Mutex );
         aux = this->Impl->CreateRepeatingTimer( duration );
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockExclusive( this->Mutex );
         return aux;
     }
     int CreateOneShotTimer(unsigned long duration)
     {
         int aux( 0 );
-        this->Mutex->Lock();
+        CompoundAccess::LockExclusive( this->Mutex );
         aux = this->Impl->CreateOneShotTimer( duration );
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockExclusive( this->Mutex );
         return aux;
     }
     int IsOneShotTimer(int timerId)
     {
         int aux( 0 );
-        this->Mutex->Lock();
+        CompoundAccess::LockShared( this->Mutex );
         aux = this->Impl->IsOneShotTimer( timerId );
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockShared( this->Mutex );
         return aux;
     }
     unsigned long GetTimerDuration(int timerId)
     {
         long aux( 0 );
-        this->Mutex->Lock();
+        CompoundAccess::LockShared( this->Mutex );
         aux = this->Impl->GetTimerDuration( timerId );
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockShared( this->Mutex );
         return aux;
     }
     int ResetTimer(int timerId)
     {
         int aux( 0 );
-        this->Mutex->Lock();
+        CompoundAccess::LockExclusive( this->Mutex );
         aux = this->Impl->ResetTimer( timerId );
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockExclusive( this->Mutex );
         return aux;
     }
     int DestroyTimer(int timerId)
     {
         int aux( 0 );
-        this->Mutex->Lock();
+        CompoundAccess::LockExclusive( this->Mutex );
         aux = this->Impl->DestroyTimer( timerId );
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockExclusive( this->Mutex );
         return aux;
     }
     virtual int GetVTKTimerId(int platformTimerId)
     {
         int aux( 0 );
-        this->Mutex->Lock();
+        CompoundAccess::LockShared( this->Mutex );
         aux = this->Impl->GetVTKTimerId( platformTimerId );
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockShared( this->Mutex );
         return aux;
     }
 
@@ -290,9 +303,9 @@ public:
     // to provide a termination procedure if one is required.
     virtual void TerminateApp(void)
     {
-        this->Mutex->Lock();
+        CompoundAccess::LockExclusive( this->Mutex );
         this->Impl->TerminateApp();
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockExclusive( this->Mutex );
     }
 
     // Description:
@@ -300,9 +313,9 @@ public:
     // is a vtkInteractorStyleSwitch object.
     virtual void SetInteractorStyle(vtkInteractorObserver *observer )
     {
-        this->Mutex->Lock();
+        CompoundAccess::LockExclusive( this->Mutex );
         this->Impl->SetInteractorStyle( observer );
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockExclusive( this->Mutex );
     }
     vtkSafeGetObjectMacro(InteractorStyle,vtkInteractorObserver);
 
@@ -341,9 +354,9 @@ public:
     // instance of vtkProp.
     virtual void SetPicker(vtkAbstractPicker* picker )
     {
-        this->Mutex->Lock();
+        CompoundAccess::LockExclusive( this->Mutex );
         this->Impl->SetPicker( picker );
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockExclusive( this->Mutex );
     }
     vtkSafeGetObjectMacro(Picker,vtkAbstractPicker);
 
@@ -353,9 +366,9 @@ public:
     virtual vtkAbstractPropPicker *CreateDefaultPicker()
     {
         vtkAbstractPropPicker* aux( 0 );
-        this->Mutex->Lock();
+        CompoundAccess::LockExclusive( this->Mutex );
         aux = this->Impl->CreateDefaultPicker();
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockExclusive( this->Mutex );
         return aux;
     }
 
@@ -364,36 +377,36 @@ public:
     // callbacks. They allow for the Style to invoke them.
     virtual void ExitCallback()
     {
-        this->Mutex->Lock();
+        CompoundAccess::LockExclusive( this->Mutex );
         this->Impl->ExitCallback();
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockExclusive( this->Mutex );
     }
     virtual void UserCallback()
     {
-        this->Mutex->Lock();
+        CompoundAccess::LockExclusive( this->Mutex );
         this->Impl->UserCallback();
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockExclusive( this->Mutex );
     }
     virtual void StartPickCallback()
     {
-        this->Mutex->Lock();
+        CompoundAccess::LockExclusive( this->Mutex );
         this->Impl->StartPickCallback();
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockExclusive( this->Mutex );
     }
     virtual void EndPickCallback()
     {
-        this->Mutex->Lock();
+        CompoundAccess::LockExclusive( this->Mutex );
         this->Impl->EndPickCallback();
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockExclusive( this->Mutex );
     }
 
     // Description:
     // Get the current position of the mouse.
     virtual void GetMousePosition(int *x, int *y)
     {
-        this->Mutex->Lock();
+        CompoundAccess::LockShared( this->Mutex );
         this->Impl->GetMousePosition( x, y );
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockShared( this->Mutex );
     }
 
     // Description:
@@ -401,15 +414,15 @@ public:
     // default cursor if you want VTK to display a 3D cursor instead.
     void HideCursor()
     {
-        this->Mutex->Lock();
+        CompoundAccess::LockExclusive( this->Mutex );
         this->Impl->HideCursor();
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockExclusive( this->Mutex );
     }
     void ShowCursor()
     {
-        this->Mutex->Lock();
+        CompoundAccess::LockExclusive( this->Mutex );
         this->Impl->ShowCursor();
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockExclusive( this->Mutex );
     }
 
     // Description:
@@ -417,9 +430,9 @@ public:
     // associated vtkRenderWindow.
     virtual void Render()
     {
-        this->Mutex->Lock();
+        CompoundAccess::LockExclusive( this->Mutex );
         this->Impl->Render();
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockExclusive( this->Mutex );
     }
 
     // Description:
@@ -428,27 +441,27 @@ public:
     // NumberOfFlyFrames. The LOD desired frame rate is used.
     void FlyTo(vtkRenderer *ren, double x, double y, double z)
     {
-        this->Mutex->Lock();
+        CompoundAccess::LockExclusive( this->Mutex );
         this->Impl->FlyTo( ren, x, y, z );
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockExclusive( this->Mutex );
     }
     void FlyTo(vtkRenderer *ren, double *x)
     {
-        this->Mutex->Lock();
+        CompoundAccess::LockExclusive( this->Mutex );
         this->Impl->FlyTo( ren, x );
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockExclusive( this->Mutex );
     }
     void FlyToImage(vtkRenderer *ren, double x, double y)
     {
-        this->Mutex->Lock();
+        CompoundAccess::LockExclusive( this->Mutex );
         this->Impl->FlyToImage( ren, x, y );
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockExclusive( this->Mutex );
     }
     void FlyToImage(vtkRenderer *ren, double *x)
     {
-        this->Mutex->Lock();
+        CompoundAccess::LockExclusive( this->Mutex );
         this->Impl->FlyToImage( ren, x );
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockExclusive( this->Mutex );
     }
 
     // Description:
@@ -474,27 +487,27 @@ public:
     vtkSafeSetVector2Macro(LastEventPosition,int);
     virtual void SetEventPosition(int x, int y)
     {
-        this->Mutex->Lock();
+        CompoundAccess::LockExclusive( this->Mutex );
         this->Impl->SetEventPosition( x, y );
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockExclusive( this->Mutex );
     }
     virtual void SetEventPosition(int pos[2])
     {
-        this->Mutex->Lock();
+        CompoundAccess::LockExclusive( this->Mutex );
         this->Impl->SetEventPosition( pos );
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockExclusive( this->Mutex );
     }
     virtual void SetEventPositionFlipY(int x, int y)
     {
-        this->Mutex->Lock();
+        CompoundAccess::LockExclusive( this->Mutex );
         this->Impl->SetEventPositionFlipY( x, y );
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockExclusive( this->Mutex );
     }
     virtual void SetEventPositionFlipY(int pos[2])
     {
-        this->Mutex->Lock();
+        CompoundAccess::LockExclusive( this->Mutex );
         this->Impl->SetEventPosition( pos );
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockExclusive( this->Mutex );
     }
     vtkSafeSetMacro(AltKey, int);
     vtkSafeGetMacro(AltKey, int);
@@ -519,9 +532,9 @@ public:
         int repeatcount=0,
         const char* keysym=0)
     {
-        this->Mutex->Lock();
+        CompoundAccess::LockExclusive( this->Mutex );
         this->Impl->SetEventInformation( x, y, ctrl, shift, keycode, repeatcount, keysym );
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockExclusive( this->Mutex );
     }
 
     // Description:
@@ -535,9 +548,9 @@ public:
         int repeatcount=0,
         const char* keysym=0)
     {
-        this->Mutex->Lock();
+        CompoundAccess::LockExclusive( this->Mutex );
         this->Impl->SetEventInformationFlipY( x, y, ctrl, shift, keycode, repeatcount, keysym );
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockExclusive( this->Mutex );
     }
 
     // Description:
@@ -548,9 +561,9 @@ public:
         int repeatcount=0,
         const char* keysym=0)
     {
-        this->Mutex->Lock();
+        CompoundAccess::LockExclusive( this->Mutex );
         this->Impl->SetKeyEventInformation( ctrl, shift, keycode, repeatcount, keysym );
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockExclusive( this->Mutex );
     }
 
     // Description:
@@ -575,9 +588,9 @@ public:
     virtual vtkRenderer *FindPokedRenderer(int x,int y)
     {
         vtkRenderer* aux( 0 );
-        this->Mutex->Lock();
+        CompoundAccess::LockExclusive( this->Mutex );
         aux = this->Impl->FindPokedRenderer( x, y );
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockExclusive( this->Mutex );
         return aux;
     }
 
@@ -590,9 +603,9 @@ public:
     vtkObserverMediator *GetObserverMediator()
     {
         vtkObserverMediator* aux( 0 );
-        this->Mutex->Lock();
+        CompoundAccess::LockShared( this->Mutex );
         aux = this->Impl->GetObserverMediator();
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockShared( this->Mutex );
         return aux;
     }
 
@@ -612,112 +625,112 @@ public:
     // corresponding vtk event.
     virtual void MouseMoveEvent()
     {
-        this->Mutex->Lock();
+        CompoundAccess::LockExclusive( this->Mutex );
         //this->Impl->MouseMoveEvent();
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockExclusive( this->Mutex );
     }
     virtual void RightButtonPressEvent()
     {
-        this->Mutex->Lock();
+        CompoundAccess::LockExclusive( this->Mutex );
         //this->Impl->RightButtonPressEvent();
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockExclusive( this->Mutex );
     }
     virtual void RightButtonReleaseEvent()
     {
-        this->Mutex->Lock();
+        CompoundAccess::LockExclusive( this->Mutex );
         //this->Impl->RightButtonReleaseEvent();
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockExclusive( this->Mutex );
     }
     virtual void LeftButtonPressEvent()
     {
-        this->Mutex->Lock();
+        CompoundAccess::LockExclusive( this->Mutex );
         //this->Impl->LeftButtonPressEvent();
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockExclusive( this->Mutex );
     }
     virtual void LeftButtonReleaseEvent()
     {
-        this->Mutex->Lock();
+        CompoundAccess::LockExclusive( this->Mutex );
         //this->Impl->LeftButtonReleaseEvent();
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockExclusive( this->Mutex );
     }
     virtual void MiddleButtonPressEvent()
     {
-        this->Mutex->Lock();
+        CompoundAccess::LockExclusive( this->Mutex );
         //this->Impl->MiddleButtonPressEvent();
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockExclusive( this->Mutex );
     }
     virtual void MiddleButtonReleaseEvent()
     {
-        this->Mutex->Lock();
+        CompoundAccess::LockExclusive( this->Mutex );
         //this->Impl->MiddleButtonReleaseEvent();
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockExclusive( this->Mutex );
     }
     virtual void MouseWheelForwardEvent()
     {
-        this->Mutex->Lock();
+        CompoundAccess::LockExclusive( this->Mutex );
         //this->Impl->MouseWheelForwardEvent();
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockExclusive( this->Mutex );
     }
     virtual void MouseWheelBackwardEvent()
     {
-        this->Mutex->Lock();
+        CompoundAccess::LockExclusive( this->Mutex );
         //this->Impl->MouseWheelBackwardEvent();
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockExclusive( this->Mutex );
     }
     virtual void ExposeEvent()
     {
-        this->Mutex->Lock();
+        CompoundAccess::LockExclusive( this->Mutex );
         //this->Impl->ExposeEvent();
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockExclusive( this->Mutex );
     }
     virtual void ConfigureEvent()
     {
-        this->Mutex->Lock();
+        CompoundAccess::LockExclusive( this->Mutex );
         //this->Impl->ConfigureEvent();
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockExclusive( this->Mutex );
     }
     virtual void EnterEvent()
     {
-        this->Mutex->Lock();
+        CompoundAccess::LockExclusive( this->Mutex );
         //this->Impl->EnterEvent();
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockExclusive( this->Mutex );
     }
     virtual void LeaveEvent()
     {
-        this->Mutex->Lock();
+        CompoundAccess::LockExclusive( this->Mutex );
         //this->Impl->LeaveEvent();
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockExclusive( this->Mutex );
     }
     virtual void KeyPressEvent()
     {
-        this->Mutex->Lock();
+        CompoundAccess::LockExclusive( this->Mutex );
         //this->Impl->KeyPressEvent();
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockExclusive( this->Mutex );
     }
     virtual void KeyReleaseEvent()
     {
-        this->Mutex->Lock();
+        CompoundAccess::LockExclusive( this->Mutex );
         //this->Impl->KeyReleaseEvent();
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockExclusive( this->Mutex );
     }
     virtual void CharEvent()
     {
-        this->Mutex->Lock();
+        CompoundAccess::LockExclusive( this->Mutex );
         //this->Impl->CharEvent();
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockExclusive( this->Mutex );
     }
     virtual void ExitEvent()
     {
-        this->Mutex->Lock();
+        CompoundAccess::LockExclusive( this->Mutex );
         //this->Impl->ExitEvent();
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockExclusive( this->Mutex );
     }
 
 
 private:
 
     vtkRenderWindowInteractor*              Impl;
-    vtkMutexLock*                           Mutex;
+    msvReadWriteLock*                       Mutex;
     vtkMultiThreaderIDType                  LockOwnerThreadID;
     vtkThreadSafeRenderWindowInteractor*    PublicInterface;
     vtkThreadSafeRenderWindow*              ThreadSafeRenderWindow;
@@ -732,23 +745,22 @@ vtkThreadSafeRenderWindowInteractorImpl::vtkThreadSafeRenderWindowInteractorImpl
 , PublicInterface( publicInterface )
 , ThreadSafeRenderWindow( 0 )
 {
-    this->Mutex = vtkMutexLock::New();
+    this->Mutex = msvReadWriteLock::New();
     this->Impl = vtkRenderWindowInteractor::New();
 }
 
 vtkThreadSafeRenderWindowInteractorImpl::~vtkThreadSafeRenderWindowInteractorImpl()
 {
-    this->Mutex->Unlock();
-    this->Mutex->Delete();
     this->Impl->Delete();
+    this->Mutex->Delete();
 }
 
 void vtkThreadSafeRenderWindowInteractorImpl::PrintSelf( ostream& os, vtkIndent indent )
 {
     this->Superclass::PrintSelf( os, indent );
-    this->Mutex->Lock();
+    CompoundAccess::LockShared( this->Mutex );
     this->Impl->PrintSelf( os, indent );
-    this->Mutex->Unlock();
+    CompoundAccess::UnlockShared( this->Mutex );
 }
 
 
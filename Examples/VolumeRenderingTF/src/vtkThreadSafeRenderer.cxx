@@ -23,14 +23,57 @@
 
 #include <vtkObjectFactory.h>
 #include <vtkRenderer.h>
-#include <vtkMutexLock.h>
 #include <vtkMultiThreader.h>
+#include <vtkActor.h>
+#include <vtkActorCollection.h>
+#include <vtkVolume.h>
+#include <vtkVolumeCollection.h>
+#include <vtkCamera.h>
+#include <vtkLight.h>
+#include <vtkLightCollection.h>
+#include <vtkCuller.h>
 #include "vtkThreadSafeRenderWindow.h"
+#include "msvSceneCommands.h"
 
 #include <vector>
 
 using namespace std;
 
+// ResetCamera and ResetCameraClippingRange to a bounding box, deferred
+class vtkResetCameraToBoundsCommand : public msvDeferredCommand
+{
+public:
+    vtkResetCameraToBoundsCommand( vtkRenderer* renderer, bool clippingRangeOnly,
+        double xmin, double xmax, double ymin, double ymax, double zmin, double zmax )
+    : Renderer( renderer )
+    , ClippingRangeOnly( clippingRangeOnly )
+    {
+        this->Bounds[0] = xmin;
+        this->Bounds[1] = xmax;
+        this->Bounds[2] = ymin;
+        this->Bounds[3] = ymax;
+        this->Bounds[4] = zmin;
+        this->Bounds[5] = zmax;
+    }
+
+    virtual void Execute()
+    {
+        if( this->ClippingRangeOnly )
+        {
+            this->Renderer->ResetCameraClippingRange( this->Bounds );
+        }
+        else
+        {
+            this->Renderer->ResetCamera( this->Bounds );
+        }
+    }
+
+private:
+    vtkRenderer*                        Renderer;
+    bool                                ClippingRangeOnly;
+    double                              Bounds[6];
+};
+
 ////////////////////////////
 // Private Implementor class
 ////////////////////////////
@@ -38,6 +81,10 @@ using namespace std;
 class vtkThreadSafeRendererImpl: public vtkObject
 {
 public:
+    typedef vtkRenderer ImplType;
+    typedef msvScalarAccess ScalarAccess;
+    typedef msvCompoundAccess CompoundAccess;
+
     // Description:
     // Constructor and destructor
     vtkThreadSafeRendererImpl( vtkThreadSafeRenderer* publicInterface );
@@ -47,6 +94,20 @@ public:
     void UnlockRenderer();
     vtkRenderer* SafeGetRenderer();
 
+    // Description:
+    // Writes are queued and applied by ApplyPendingWrites, which Render calls
+    // before drawing, or made at once when CompoundAccess does not defer them.
+    // Meanwhile the render shares the lock with the readers
+    void QueueWrite( msvDeferredCommand* command );
+    void ApplyPendingWrites();
+    int GetNumberOfPendingWrites();
+    void GetLockCounters( msvLockCounters& counters );
+    void ResetLockCounters();
+
+    // Scene updates recorded by other threads, applied with the writes
+    void SwapViewProp( vtkProp* oldProp, vtkProp* newProp );
+    void QueueSceneUpdate( msvDeferredCommand* command );
+
     virtual void PrintSelf( ostream& os, vtkIndent indent );
 
     // Description:
@@ -75,9 +136,9 @@ public:
     vtkLightCollection *GetLights()
     {
         vtkLightCollection* aux( 0 );
-        this->Mutex->Lock();
+        CompoundAccess::LockShared( this->Mutex );
         aux = this->Impl->GetLights();
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockShared( this->Mutex );
         return aux;
     }
 
@@ -222,9 +283,9 @@ public:
     // Create an image. Subclasses of vtkRenderer must implement this method.
     virtual void DeviceRender()
     {
-        this->Mutex->Lock();
+        CompoundAccess::LockExclusive( this->Mutex );
         this->Impl->DeviceRender();
-        this->Mutex->Unlock();
+        CompoundAccess::UnlockExclusive( this->Mutex );
     };
 
     // Description:
@@ -306,9 +367,9 @@ public:
     vtkRenderWindow *GetRenderWindow()
     {
       vtkRenderWindow* aux( 0 );
-      this->Mutex->Lock();
+      CompoundAccess::LockShared( this->Mutex );
       aux = this->Impl->GetRenderWindow();
-      this->Mutex->Unlock();
+      CompoundAccess::UnlockShared( this->Mutex );
       return aux;
     }
 
@@ -415,9 +476,9 @@ public:
     int IsActiveCameraCreated()
     {
       int aux( 0 );
-      this->Mutex->Lock();
+      CompoundAccess::LockShared( this->Mutex );
       aux = this->Impl->IsActiveCameraCreated();
-      this->Mutex->Unlock();
+      CompoundAccess::UnlockShared( this->Mutex );
       return aux;
     }
 
@@ -496,10 +557,23 @@ public:
     // Return the Z value for the last picked Prop.
     virtual double GetPickedZ();
 
+private:
+    // Supposed to be called with the write lock held. The collections handed
+    // out before are kept until the next publication, for the readers still
+    // walking them
+    void PublishSnapshot();
+
 private:
 
     vtkRenderer*                        Impl;
-    vtkMutexLock*                       Mutex;
+    msvReadWriteLock*                   Mutex;
+    msvDeferredCommandQueue*            PendingWrites;
+    // Built between frames, GetActors and GetVolumes of the renderer rebuild
+    // their collections and cannot be shared by readers
+    vtkSmartPointer<vtkActorCollection> PublishedActors;
+    vtkSmartPointer<vtkVolumeCollection> PublishedVolumes;
+    vtkSmartPointer<vtkActorCollection> RetiredActors;
+    vtkSmartPointer<vtkVolumeCollection> RetiredVolumes;
     vtkMultiThreaderIDType              LockOwnerThreadID;
     vtkThreadSafeRenderWindow*          ThreadSafeRenderWindow;
     vtkThreadSafeRenderer*              PublicInterface;
@@ -510,34 +584,132 @@ private:
 vtkThreadSafeRendererImpl::vtkThreadSafeRendererImpl( vtkThreadSafeRenderer* publicInterface )
 : Impl( 0 )
 , Mutex( 0 )
+, PendingWrites( 0 )
 , LockOwnerThreadID( -1 )
 , PublicInterface( publicInterface )
 {
-    this->Mutex = vtkMutexLock::New();
+    this->Mutex = msvReadWriteLock::New();
+    this->PendingWrites = msvDeferredCommandQueue::New();
     this->Impl = vtkRenderer::New();
+    PublishSnapshot();
 }
 
 vtkThreadSafeRendererImpl::~vtkThreadSafeRendererImpl()
 {
-    this->Mutex->Unlock();
-    this->Mutex->Delete();
+    // Pending writes may hold references to props, release them first
+    this->PendingWrites->Delete();
     this->Impl->Delete();
+    this->Mutex->Delete();
 }
 
 void vtkThreadSafeRendererImpl::PrintSelf( ostream& os, vtkIndent indent )
 {
     this->Superclass::PrintSelf( os, indent );
-    this->Mutex->Lock();
+    CompoundAccess::LockShared( this->Mutex );
     this->Impl->PrintSelf( os, indent );
-    this->Mutex->Unlock();
+    CompoundAccess::UnlockShared( this->Mutex );
+    this->Mutex->PrintSelf( os, indent );
+}
+
+void vtkThreadSafeRendererImpl::QueueWrite( msvDeferredCommand* command )
+{
+    if( CompoundAccess::DefersWrites )
+    {
+        this->PendingWrites->Push( command );
+    }
+    else
+    {
+        command->Execute();
+        delete command;
+    }
+}
+
+void vtkThreadSafeRendererImpl::ApplyPendingWrites()
+{
+    // The usual frame has nothing to apply, and then it takes no exclusive
+    // lock at all. A write pushed right after the check waits for the next
+    // frame
+    if( this->PendingWrites->GetNumberOfPendingCommands() == 0 )
+    {
+        return;
+    }
+    CompoundAccess::LockExclusive( this->Mutex );
+    if( this->PendingWrites->ApplyAll() > 0 )
+    {
+        PublishSnapshot();
+    }
+    CompoundAccess::UnlockExclusive( this->Mutex );
+}
+
+void vtkThreadSafeRendererImpl::SwapViewProp( vtkProp* oldProp, vtkProp* newProp )
+{
+    QueueWrite( new msvSwapViewPropCommand( this->Impl, oldProp, newProp ) );
+}
+
+void vtkThreadSafeRendererImpl::QueueSceneUpdate( msvDeferredCommand* command )
+{
+    QueueWrite( command );
+}
+
+int vtkThreadSafeRendererImpl::GetNumberOfPendingWrites()
+{
+    return this->PendingWrites->GetNumberOfPendingCommands();
+}
+
+void vtkThreadSafeRendererImpl::GetLockCounters( msvLockCounters& counters )
+{
+    this->Mutex->GetCounters( counters );
+}
+
+void vtkThreadSafeRendererImpl::ResetLockCounters()
+{
+    this->Mutex->ResetCounters();
+}
+
+void vtkThreadSafeRendererImpl::PublishSnapshot()
+{
+    this->RetiredActors = this->PublishedActors;
+    this->RetiredVolumes = this->PublishedVolumes;
+
+    vtkSmartPointer<vtkActorCollection> actors = vtkSmartPointer<vtkActorCollection>::New();
+    vtkActorCollection* currentActors = this->Impl->GetActors();
+    vtkCollectionSimpleIterator actorIt;
+    currentActors->InitTraversal( actorIt );
+    vtkActor* actor = currentActors->GetNextActor( actorIt );
+    while( actor != 0 )
+    {
+        actors->AddItem( actor );
+        actor = currentActors->GetNextActor( actorIt );
+    }
+
+    vtkSmartPointer<vtkVolumeCollection> volumes = vtkSmartPointer<vtkVolumeCollection>::New();
+    vtkVolumeCollection* currentVolumes = this->Impl->GetVolumes();
+    vtkCollectionSimpleIterator volumeIt;
+    currentVolumes->InitTraversal( volumeIt );
+    vtkVolume* volume = currentVolumes->GetNextVolume( volumeIt );
+    while( volume != 0 )
+    {
+        volumes->AddItem( volume );
+        volume = currentVolumes->GetNextVolume( volumeIt );
+    }
+
+    this->PublishedActors = actors;
+    this->PublishedVolumes = volumes;
 }
 
 // Concrete render method.
 void vtkThreadSafeRendererImpl::Render(void)
 {
-    this->Mutex->Lock();
+    ApplyPendingWrites();
+
+    // The render shares the lock with the getters that only read the renderer
+    // state. The calls that touch the GL context, update the pipeline or
+    // change the renderer (GetZ, ComputeVisiblePropBounds, picking, camera
+    // creation, coordinate conversions) take the lock exclusively, so they
+    // wait for the frame to end
+    CompoundAccess::LockShared( this->Mutex );
     this->Impl->Render();
-    this->Mutex->Unlock();
+    CompoundAccess::UnlockShared( this->Mutex );
 }
 
 // ----------------------------------------------------------------------------
@@ -548,27 +720,27 @@ void vtkThreadSafeRendererImpl::Render(void)
 // override this method.
 void vtkThreadSafeRendererImpl::DeviceRenderTranslucentPolygonalGeometry()
 {
-    this->Mutex->Lock();
+    CompoundAccess::LockExclusive( this->Mutex );
     this->Impl->DeviceRenderTranslucentPolygonalGeometry();
-    this->Mutex->Unlock();
+    CompoundAccess::UnlockExclusive( this->Mutex );
 }
 
 // ----------------------------------------------------------------------------
 double vtkThreadSafeRendererImpl::GetAllocatedRenderTime()
 {
     double aux( 0 );
-    this->Mutex->Lock();
+    CompoundAccess::LockShared( this->Mutex );
     aux = this->Impl->GetAllocatedRenderTime();
-    this->Mutex->Unlock();
+    CompoundAccess::UnlockShared( this->Mutex );
     return aux;
 }
 
 double vtkThreadSafeRendererImpl::GetTimeFactor()
 {
     double aux( 0 );
-    this->Mutex->Lock();
+    CompoundAccess::LockShared( this->Mutex );
     aux = this->Impl->GetTimeFactor();
-    this->Mutex->Unlock();
+    CompoundAccess::UnlockShared( this->Mutex );
     return aux;
 }
 
@@ -577,9 +749,9 @@ double vtkThreadSafeRendererImpl::GetTimeFactor()
 //protected:
 int vtkThreadSafeRendererImpl::UpdateCamera()
 {
-    this->Mutex->Lock();
+    CompoundAccess::LockExclusive( this->Mutex );
     this->Impl->UpdateCamera();
-    this->Mutex->Unlock();
+    CompoundAccess::UnlockExclusive( this->Mutex );
 
     return 1;
 }
@@ -588,9 +760,9 @@ int vtkThreadSafeRendererImpl::UpdateCamera()
 int vtkThreadSafeRendererImpl::UpdateLightsGeometryToFollowCamera()
 {
     int aux( 0 );
-    this->Mutex->Lock();
+    CompoundAccess::LockExclusive( this->Mutex );
     aux = this->Impl->UpdateLightsGeometryToFollowCamera();
-    this->Mutex->Unlock();
+    CompoundAccess::UnlockExclusive( this->Mutex );
     return aux;
 }
 
@@ -598,9 +770,9 @@ int vtkThreadSafeRendererImpl::UpdateLightsGeometryToFollowCamera()
 //protected:
 int vtkThreadSafeRendererImpl::UpdateLightGeometry()
 {
-    this->Mutex->Lock();
+    CompoundAccess::LockExclusive( this->Mutex );
     this->Impl->UpdateLightGeometry();
-    this->Mutex->Unlock();
+    CompoundAccess::UnlockExclusive( this->Mutex );
 }
 */
 
@@ -610,9 +782,9 @@ int vtkThreadSafeRendererImpl::UpdateLightGeometry()
 //protected:
 void vtkThreadSafeRendererImpl::AllocateTime()
 {
-    this->Mutex->Lock();
+    CompoundAccess::LockExclusive( this->Mutex );
     this->Impl->AllocateTime();
-    this->Mutex->Unlock();
+    CompoundAccess::UnlockExclusive( this->Mutex );
 }
 */
 
@@ -623,9 +795,9 @@ void vtkThreadSafeRendererImpl::AllocateTime()
 int vtkThreadSafeRendererImpl::UpdateGeometry()
 {
     int aux( 0 );
-    this->Mutex->Lock();
+    CompoundAccess::LockExclusive( this->Mutex );
     aux = this->Impl->UpdateGeometry();
-    this->Mutex->Unlock();
+    CompoundAccess::UnlockExclusive( this->Mutex );
     return aux;
 }
 */
@@ -642,9 +814,9 @@ int vtkThreadSafeRendererImpl::UpdateGeometry()
 int vtkThreadSafeRendererImpl::UpdateTranslucentPolygonalGeometry()
 {
     int aux( 0 );
-    this->Mutex->Lock();
+    CompoundAccess::LockExclusive( this->Mutex );
     aux = this->Impl->UpdateTranslucentPolygonalGeometry();
-    this->Mutex->Unlock();
+    CompoundAccess::UnlockExclusive( this->Mutex );
     return aux;
 }
 */
@@ -653,27 +825,32 @@ int vtkThreadSafeRendererImpl::UpdateTranslucentPolygonalGeometry()
 vtkWindow *vtkThreadSafeRendererImpl::GetVTKWindow()
 {
     vtkWindow* aux( 0 );
-    this->Mutex->Lock();
+    CompoundAccess::LockShared( this->Mutex );
     aux = this->Impl->GetVTKWindow();
-    this->Mutex->Unlock();
+    CompoundAccess::UnlockShared( this->Mutex );
     return aux;
 }
 
 // Specify the camera to use for this renderer.
 void vtkThreadSafeRendererImpl::SetActiveCamera(vtkCamera *cam)
 {
-    this->Mutex->Lock();
-    this->Impl->SetActiveCamera( cam );
-    this->Mutex->Unlock();
+    if( CompoundAccess::DefersWrites )
+    {
+        QueueWrite( new msvDeferredObjectCall<vtkRenderer, vtkCamera>( &vtkRenderer::SetActiveCamera, this->Impl, cam ) );
+    }
+    else
+    {
+        this->Impl->SetActiveCamera( cam );
+    }
 }
 
 //----------------------------------------------------------------------------
 vtkCamera* vtkThreadSafeRendererImpl::MakeCamera()
 {
     vtkCamera* aux( 0 );
-    this->Mutex->Lock();
+    CompoundAccess::LockExclusive( this->Mutex );
     aux = this->Impl->MakeCamera();
-    this->Mutex->Unlock();
+    CompoundAccess::UnlockExclusive( this->Mutex );
 
     //this->InvokeEvent(vtkCommand::CreateCameraEvent, cam);
     return aux;
@@ -683,9 +860,21 @@ vtkCamera* vtkThreadSafeRendererImpl::MakeCamera()
 vtkCamera *vtkThreadSafeRendererImpl::GetActiveCamera()
 {
     vtkCamera* aux( 0 );
-    this->Mutex->Lock();
+    CompoundAccess::LockShared( this->Mutex );
+    if( this->Impl->IsActiveCameraCreated() )
+    {
+        aux = this->Impl->GetActiveCamera();
+    }
+    CompoundAccess::UnlockShared( this->Mutex );
+    if( aux != 0 )
+    {
+        return aux;
+    }
+
+    // Creating the camera is a write, but the caller needs it now
+    CompoundAccess::LockExclusive( this->Mutex );
     aux = this->Impl->GetActiveCamera();
-    this->Mutex->Unlock();
+    CompoundAccess::UnlockExclusive( this->Mutex );
     return aux;
 }
 
@@ -693,9 +882,9 @@ vtkCamera *vtkThreadSafeRendererImpl::GetActiveCamera()
 /*vtkCamera *vtkThreadSafeRendererImpl::GetActiveCameraAndResetIfCreated()
 {
     vtkCamera* aux( 0 );
-    this->Mutex->Lock();
+    CompoundAccess::LockExclusive( this->Mutex );
     aux = this->Impl->GetActiveCameraAndResetIfCreated();
-    this->Mutex->Unlock();
+    CompoundAccess::UnlockExclusive( this->Mutex );
     return aux;
 }
 */
@@ -703,134 +892,199 @@ vtkCamera *vtkThreadSafeRendererImpl::GetActiveCamera()
 //----------------------------------------------------------------------------
 void vtkThreadSafeRendererImpl::AddActor(vtkProp* p)
 {
-    this->Mutex->Lock();
-    this->Impl->AddActor( p );
-    this->Mutex->Unlock();
+    if( CompoundAccess::DefersWrites )
+    {
+        QueueWrite( new msvDeferredObjectCall<vtkRenderer, vtkProp>( &vtkRenderer::AddActor, this->Impl, p ) );
+    }
+    else
+    {
+        this->Impl->AddActor( p );
+    }
 }
 
 //----------------------------------------------------------------------------
 void vtkThreadSafeRendererImpl::AddVolume(vtkProp* p)
 {
-    this->Mutex->Lock();
-    this->Impl->AddVolume( p );
-    this->Mutex->Unlock();
+    if( CompoundAccess::DefersWrites )
+    {
+        QueueWrite( new msvDeferredObjectCall<vtkRenderer, vtkProp>( &vtkRenderer::AddVolume, this->Impl, p ) );
+    }
+    else
+    {
+        this->Impl->AddVolume( p );
+    }
 }
 
 //----------------------------------------------------------------------------
 void vtkThreadSafeRendererImpl::RemoveActor(vtkProp* p)
 {
-    this->Mutex->Lock();
-    this->Impl->RemoveActor( p );
-    this->Mutex->Unlock();
+    if( CompoundAccess::DefersWrites )
+    {
+        QueueWrite( new msvDeferredObjectCall<vtkRenderer, vtkProp>( &vtkRenderer::RemoveActor, this->Impl, p ) );
+    }
+    else
+    {
+        this->Impl->RemoveActor( p );
+    }
 }
 
 //----------------------------------------------------------------------------
 void vtkThreadSafeRendererImpl::RemoveVolume(vtkProp* p)
 {
-    this->Mutex->Lock();
-    this->Impl->RemoveVolume( p );
-    this->Mutex->Unlock();
+    if( CompoundAccess::DefersWrites )
+    {
+        QueueWrite( new msvDeferredObjectCall<vtkRenderer, vtkProp>( &vtkRenderer::RemoveVolume, this->Impl, p ) );
+    }
+    else
+    {
+        this->Impl->RemoveVolume( p );
+    }
 }
 
 // Add a light to the list of lights.
 void vtkThreadSafeRendererImpl::AddLight(vtkLight *light)
 {
-    this->Mutex->Lock();
-    this->Impl->AddLight( light );
-    this->Mutex->Unlock();
+    if( CompoundAccess::DefersWrites )
+    {
+        QueueWrite( new msvDeferredObjectCall<vtkRenderer, vtkLight>( &vtkRenderer::AddLight, this->Impl, light ) );
+    }
+    else
+    {
+        this->Impl->AddLight( light );
+    }
 }
 
 // look through the props and get all the actors
 vtkActorCollection *vtkThreadSafeRendererImpl::GetActors()
 {
+    // Without deferred writes there is no other reader to publish for
+    if( !CompoundAccess::DefersWrites )
+    {
+        return this->Impl->GetActors();
+    }
     vtkActorCollection* aux( 0 );
-    this->Mutex->Lock();
-    aux = this->Impl->GetActors();
-    this->Mutex->Unlock();
+    CompoundAccess::LockShared( this->Mutex );
+    aux = this->PublishedActors;
+    CompoundAccess::UnlockShared( this->Mutex );
     return aux;
 }
 
 // look through the props and get all the volumes
 vtkVolumeCollection *vtkThreadSafeRendererImpl::GetVolumes()
 {
+    // Without deferred writes there is no other reader to publish for
+    if( !CompoundAccess::DefersWrites )
+    {
+        return this->Impl->GetVolumes();
+    }
     vtkVolumeCollection* aux( 0 );
-    this->Mutex->Lock();
-    aux = this->Impl->GetVolumes();
-    this->Mutex->Unlock();
+    CompoundAccess::LockShared( this->Mutex );
+    aux = this->PublishedVolumes;
+    CompoundAccess::UnlockShared( this->Mutex );
     return aux;
 }
 
 // Remove a light from the list of lights.
 void vtkThreadSafeRendererImpl::RemoveLight(vtkLight *light)
 {
-    this->Mutex->Lock();
-    this->Impl->RemoveLight( light );
-    this->Mutex->Unlock();
+    if( CompoundAccess::DefersWrites )
+    {
+        QueueWrite( new msvDeferredObjectCall<vtkRenderer, vtkLight>( &vtkRenderer::RemoveLight, this->Impl, light ) );
+    }
+    else
+    {
+        this->Impl->RemoveLight( light );
+    }
 }
 
 // Remove all lights from the list of lights.
 void vtkThreadSafeRendererImpl::RemoveAllLights()
 {
-    this->Mutex->Lock();
-    this->Impl->RemoveAllLights();
-    this->Mutex->Unlock();
+    if( CompoundAccess::DefersWrites )
+    {
+        QueueWrite( new msvDeferredCall0<vtkRenderer>( &vtkRenderer::RemoveAllLights, this->Impl ) );
+    }
+    else
+    {
+        this->Impl->RemoveAllLights();
+    }
 }
 
 // Add an culler to the list of cullers.
 void vtkThreadSafeRendererImpl::AddCuller(vtkCuller *culler)
 {
-    this->Mutex->Lock();
-    this->Impl->AddCuller( culler );
-    this->Mutex->Unlock();
+    if( CompoundAccess::DefersWrites )
+    {
+        QueueWrite( new msvDeferredObjectCall<vtkRenderer, vtkCuller>( &vtkRenderer::AddCuller, this->Impl, culler ) );
+    }
+    else
+    {
+        this->Impl->AddCuller( culler );
+    }
 }
 
 // Remove an actor from the list of cullers.
 void vtkThreadSafeRendererImpl::RemoveCuller(vtkCuller *culler)
 {
-    this->Mutex->Lock();
-    this->Impl->RemoveCuller( culler );
-    this->Mutex->Unlock();
+    if( CompoundAccess::DefersWrites )
+    {
+        QueueWrite( new msvDeferredObjectCall<vtkRenderer, vtkCuller>( &vtkRenderer::RemoveCuller, this->Impl, culler ) );
+    }
+    else
+    {
+        this->Impl->RemoveCuller( culler );
+    }
 }
 
 // ----------------------------------------------------------------------------
 void vtkThreadSafeRendererImpl::SetLightCollection(vtkLightCollection *lights)
 {
-    this->Mutex->Lock();
-    this->Impl->SetLightCollection( lights );
-    this->Mutex->Unlock();
+    if( CompoundAccess::DefersWrites )
+    {
+        QueueWrite( new msvDeferredObjectCall<vtkRenderer, vtkLightCollection>( &vtkRenderer::SetLightCollection, this->Impl, lights ) );
+    }
+    else
+    {
+        this->Impl->SetLightCollection( lights );
+    }
 }
 
 // ----------------------------------------------------------------------------
 vtkLight *vtkThreadSafeRendererImpl::MakeLight()
 {
     vtkLight* aux( 0 );
-    this->Mutex->Lock();
+    CompoundAccess::LockExclusive( this->Mutex );
     aux = this->Impl->MakeLight();
-    this->Mutex->Unlock();
+    CompoundAccess::UnlockExclusive( this->Mutex );
     return aux;
 }
 
 void vtkThreadSafeRendererImpl::CreateLight(void)
 {
-    this->Mutex->Lock();
-    this->Impl->CreateLight();
-    this->Mutex->Unlock();
+    if( CompoundAccess::DefersWrites )
+    {
+        QueueWrite( new msvDeferredCall0<vtkRenderer>( &vtkRenderer::CreateLight, this->Impl ) );
+    }
+    else
+    {
+        this->Impl->CreateLight();
+    }
 }
 
 // Compute the bounds of the visible props
 void vtkThreadSafeRendererImpl::ComputeVisiblePropBounds( double allBounds[6] )
 {
-    this->Mutex->Lock();
+    CompoundAccess::LockExclusive( this->Mutex );
     this->Impl->ComputeVisiblePropBounds( allBounds );
-    this->Mutex->Unlock();
+    CompoundAccess::UnlockExclusive( this->Mutex );
 }
 
 double *vtkThreadSafeRendererImpl::ComputeVisiblePropBounds()
 {
     double* aux( 0 );
-    this->Mutex->Lock();
+    CompoundAccess::LockExclusive( this->Mutex );
     aux = this->Impl->ComputeVisiblePropBounds();
-    this->Mutex->Unlock();
+    CompoundAccess::UnlockExclusive( this->Mutex );
     return aux;
 }
 
@@ -840,9 +1094,14 @@ double *vtkThreadSafeRendererImpl::ComputeVisiblePropBounds()
 // camera position to focal point) so that all of the actors can be seen.
 void vtkThreadSafeRendererImpl::ResetCamera()
 {
-    this->Mutex->Lock();
-    this->Impl->ResetCamera();
-    this->Mutex->Unlock();
+    if( CompoundAccess::DefersWrites )
+    {
+        QueueWrite( new msvDeferredCall0<vtkRenderer>( &vtkRenderer::ResetCamera, this->Impl ) );
+    }
+    else
+    {
+        this->Impl->ResetCamera();
+    }
 
     // Here to let parallel/distributed compositing intercept
     // and do the right thing.
@@ -853,9 +1112,14 @@ void vtkThreadSafeRendererImpl::ResetCamera()
 // visible actors
 void vtkThreadSafeRendererImpl::ResetCameraClippingRange()
 {
-    this->Mutex->Lock();
-    this->Impl->ResetCameraClippingRange();
-    this->Mutex->Unlock();
+    if( CompoundAccess::DefersWrites )
+    {
+        QueueWrite( new msvDeferredCall0<vtkRenderer>( &vtkRenderer::ResetCameraClippingRange, this->Impl ) );
+    }
+    else
+    {
+        this->Impl->ResetCameraClippingRange();
+    }
 
     // Here to let parallel/distributed compositing intercept
     // and do the right thing.
@@ -872,9 +1136,14 @@ void vtkThreadSafeRendererImpl::ResetCameraClippingRange()
 // be reset to one of the three coordinate axes.
 void vtkThreadSafeRendererImpl::ResetCamera(double bounds[6])
 {
-    this->Mutex->Lock();
-    this->Impl->ResetCamera( bounds );
-    this->Mutex->Unlock();
+    if( CompoundAccess::DefersWrites )
+    {
+        QueueWrite( new vtkResetCameraToBoundsCommand( this->Impl, false, bounds[0], bounds[1], bounds[2], bounds[3], bounds[4], bounds[5] ) );
+    }
+    else
+    {
+        this->Impl->ResetCamera( bounds );
+    }
 }
 
 // Alternative version of ResetCamera(bounds[6]);
@@ -882,17 +1151,27 @@ void vtkThreadSafeRendererImpl::ResetCamera(double xmin, double xmax,
                               double ymin, double ymax,
                               double zmin, double zmax)
 {
-    this->Mutex->Lock();
-    this->Impl->ResetCamera( xmin, xmax, ymin, ymax, zmin, zmax );
-    this->Mutex->Unlock();
+    if( CompoundAccess::DefersWrites )
+    {
+        QueueWrite( new vtkResetCameraToBoundsCommand( this->Impl, false, xmin, xmax, ymin, ymax, zmin, zmax ) );
+    }
+    else
+    {
+        this->Impl->ResetCamera( xmin, xmax, ymin, ymax, zmin, zmax );
+    }
 }
 
 // Reset the camera clipping range to include this entire bounding box
 void vtkThreadSafeRendererImpl::ResetCameraClippingRange( double bounds[6] )
 {
-    this->Mutex->Lock();
-    this->Impl->ResetCameraClippingRange( bounds );
-    this->Mutex->Unlock();
+    if( CompoundAccess::DefersWrites )
+    {
+        QueueWrite( new vtkResetCameraToBoundsCommand( this->Impl, true, bounds[0], bounds[1], bounds[2], bounds[3], bounds[4], bounds[5] ) );
+    }
+    else
+    {
+        this->Impl->ResetCameraClippingRange( bounds );
+    }
 }
 
 // Alternative version of ResetCameraClippingRange(bounds[6]);
@@ -900,9 +1179,14 @@ void vtkThreadSafeRendererImpl::ResetCameraClippingRange(double xmin, double xma
                                            double ymin, double ymax,
                                            double zmin, double zmax)
 {
-    this->Mutex->Lock();
-    this->Impl->ResetCameraClippingRange( xmin, xmax, ymin, ymax, zmin, zmax );
-    this->Mutex->Unlock();
+    if( CompoundAccess::DefersWrites )
+    {
+        QueueWrite( new vtkResetCameraToBoundsCommand( this->Impl, true, xmin, xmax, ymin, ymax, zmin, zmax ) );
+    }
+    else
+    {
+        this->Impl->ResetCameraClippingRange( xmin, xmax, ymin, ymax, zmin, zmax );
+    }
 }
 
 // Specify the rendering window in which to draw. This is automatically set
@@ -911,7 +1195,7 @@ void vtkThreadSafeRendererImpl::ResetCameraClippingRange(double xmin, double xma
 // no reference counting!
 void vtkThreadSafeRendererImpl::SetRenderWindow(vtkRenderWindow *renwin)
 {
-    this->Mutex->Lock();
+    CompoundAccess::LockExclusive( this->Mutex );
     vtkThreadSafeRenderWindow* tsrenwin = dynamic_cast<vtkThreadSafeRenderWindow*>( renwin );
     if( tsrenwin != 0 )
     {
@@ -924,16 +1208,16 @@ void vtkThreadSafeRendererImpl::SetRenderWindow(vtkRenderWindow *renwin)
         this->Impl->SetRenderWindow( renwin );
     }
     //this->Impl->SetRenderWindow( renwin );
-    this->Mutex->Unlock();
+    CompoundAccess::UnlockExclusive( this->Mutex );
 }
 
 // Given a pixel location, return the Z value
 double vtkThreadSafeRendererImpl::GetZ( int x, int y )
 {
     double aux( 0 );
-    this->Mutex->Lock();
+    CompoundAccess::LockExclusive( this->Mutex );
     aux = this->Impl->GetZ( x, y );
-    this->Mutex->Unlock();
+    CompoundAccess::UnlockExclusive( this->Mutex );
     return aux;
 }
 
@@ -941,67 +1225,67 @@ double vtkThreadSafeRendererImpl::GetZ( int x, int y )
 // Convert view point coordinates to world coordinates.
 void vtkThreadSafeRendererImpl::ViewToWorld()
 {
-    this->Mutex->Lock();
+    CompoundAccess::LockExclusive( this->Mutex );
     this->Impl->ViewToWorld();
-    this->Mutex->Unlock();
+    CompoundAccess::UnlockExclusive( this->Mutex );
 }
 
 void vtkThreadSafeRendererImpl::ViewToWorld(double &x, double &y, double &z)
 {
-    this->Mutex->Lock();
+    CompoundAccess::LockExclusive( this->Mutex );
     this->Impl->ViewToWorld( x, y, z );
-    this->Mutex->Unlock();
+    CompoundAccess::UnlockExclusive( this->Mutex );
 }
 
 // Convert world point coordinates to view coordinates.
 void vtkThreadSafeRendererImpl::WorldToView()
 {
-    this->Mutex->Lock();
+    CompoundAccess::LockExclusive( this->Mutex );
     this->Impl->WorldToView();
-    this->Mutex->Unlock();
+    CompoundAccess::UnlockExclusive( this->Mutex );
 }
 
 // Convert world point coordinates to view coordinates.
 void vtkThreadSafeRendererImpl::WorldToView(double &x, double &y, double &z)
 {
-    this->Mutex->Lock();
+    CompoundAccess::LockExclusive( this->Mutex );
     this->Impl->WorldToView( x, y, z );
-    this->Mutex->Unlock();
+    CompoundAccess::UnlockExclusive( this->Mutex );
 }
 
 /*
 void vtkThreadSafeRendererImpl::PrintSelf(ostream& os, vtkIndent indent)
 {
-    this->Mutex->Lock();
+    CompoundAccess::LockShared( this->Mutex );
     this->Impl->PrintSelf( os, indent );
-    this->Mutex->Unlock();
+    CompoundAccess::UnlockShared( this->Mutex );
 }
 */
 
 int vtkThreadSafeRendererImpl::VisibleActorCount()
 {
     int aux( 0 );
-    this->Mutex->Lock();
+    CompoundAccess::LockShared( this->Mutex );
     aux = this->Impl->VisibleActorCount();
-    this->Mutex->Unlock();
+    CompoundAccess::UnlockShared( this->Mutex );
     return aux;
 }
 
 int vtkThreadSafeRendererImpl::VisibleVolumeCount()
 {
     int aux( 0 );
-    this->Mutex->Lock();
+    CompoundAccess::LockShared( this->Mutex );
     aux = this->Impl->VisibleVolumeCount();
-    this->Mutex->Unlock();
+    CompoundAccess::UnlockShared( this->Mutex );
     return aux;
 }
 
 unsigned long int vtkThreadSafeRendererImpl::GetMTime()
 {
     unsigned long int aux( 0 );
-    this->Mutex->Lock();
+    CompoundAccess::LockShared( this->Mutex );
     aux = this->Impl->GetMTime();
-    this->Mutex->Unlock();
+    CompoundAccess::UnlockShared( this->Mutex );
     return aux;
 }
 
@@ -1010,9 +1294,9 @@ vtkAssemblyPath* vtkThreadSafeRendererImpl::PickProp(double selectionX1, double
                                        double selectionX2, double selectionY2)
 {
     vtkAssemblyPath* aux( 0 );
-    this->Mutex->Lock();
+    CompoundAccess::LockExclusive( this->Mutex );
     aux = this->Impl->PickProp( selectionX1, selectionY1, selectionX2, selectionY2 );
-    this->Mutex->Unlock();
+    CompoundAccess::UnlockExclusive( this->Mutex );
     return aux;
 }
 
@@ -1023,9 +1307,9 @@ vtkAssemblyPath* vtkThreadSafeRendererImpl::PickProp(double selectionX1, double
 //protected:
 void vtkThreadSafeRendererImpl::PickRender(vtkPropCollection *props)
 {
-    this->Mutex->Lock();
+    CompoundAccess::LockExclusive( this->Mutex );
     this->Impl->PickRender( props );
-    this->Mutex->Unlock();
+    CompoundAccess::UnlockExclusive( this->Mutex );
 }
 */
 /*
@@ -1033,27 +1317,27 @@ void vtkThreadSafeRendererImpl::PickRender(vtkPropCollection *props)
 void vtkThreadSafeRendererImpl::PickGeometry()
 {
 
-    this->Mutex->Lock();
+    CompoundAccess::LockExclusive( this->Mutex );
     this->Impl->PickGeometry( props );
-    this->Mutex->Unlock();
+    CompoundAccess::UnlockExclusive( this->Mutex );
 }
 */
 
 int  vtkThreadSafeRendererImpl::Transparent()
 {
     int aux( 0 );
-    this->Mutex->Lock();
+    CompoundAccess::LockShared( this->Mutex );
     aux = this->Impl->Transparent();
-    this->Mutex->Unlock();
+    CompoundAccess::UnlockShared( this->Mutex );
     return aux;
 }
 
 double vtkThreadSafeRendererImpl::GetTiledAspectRatio()
 {
     double aux( 0 );
-    this->Mutex->Lock();
+    CompoundAccess::LockShared( this->Mutex );
     aux = this->Impl->GetTiledAspectRatio();
-    this->Mutex->Unlock();
+    CompoundAccess::UnlockShared( this->Mutex );
     return aux;
 }
 
@@ -1063,9 +1347,9 @@ double vtkThreadSafeRendererImpl::GetTiledAspectRatio()
 int vtkThreadSafeRendererImpl::UpdateGeometryForSelection()
 {
     int aux( 0 );
-    this->Mutex->Lock();
+    CompoundAccess::LockExclusive( this->Mutex );
     aux = this->Impl->UpdateGeometryForSelection();
-    this->Mutex->Unlock();
+    CompoundAccess::UnlockExclusive( this->Mutex );
     return aux;
 }
 
@@ -1075,9 +1359,9 @@ vtkPainter* vtkThreadSafeRendererImpl::SwapInSelectablePainter(
     int &orig_visibility)
 {
     vtkPainter* aux( 0 );
-    this->Mutex->Lock();
+    CompoundAccess::LockExclusive( this->Mutex );
     aux = this->Impl->SwapInSelectablePainter( prop, orig_visibility );
-    this->Mutex->Unlock();
+    CompoundAccess::UnlockExclusive( this->Mutex );
     return aux;
 }
 
@@ -1087,9 +1371,9 @@ void vtkThreadSafeRendererImpl::SwapOutSelectablePainter(
     vtkPainter* orig_painter,
     int orig_visibility)
 {
-    this->Mutex->Lock();
+    CompoundAccess::LockExclusive( this->Mutex );
     this->Impl->SwapOutSelectablePainter( prop, orig_painter, orig_visibility );
-    this->Mutex->Unlock();
+    CompoundAccess::UnlockExclusive( this->Mutex );
 }
 */
 #endif  // #if !defined(VTK_LEGACY_REMOVE)
@@ -1097,9 +1381,9 @@ void vtkThreadSafeRendererImpl::SwapOutSelectablePainter(
 double vtkThreadSafeRendererImpl::GetPickedZ()
 {
     double aux( 0 );
-    this->Mutex->Lock();
+    CompoundAccess::LockShared( this->Mutex );
     aux = this->Impl->GetPickedZ();
-    this->Mutex->Unlock();
+    CompoundAccess::UnlockShared( this->Mutex );
     return aux;
 }
 
@@ -1119,6 +1403,36 @@ vtkThreadSafeRenderer::~vtkThreadSafeRenderer()
     delete this->Impl;
 }
 
+void vtkThreadSafeRenderer::ApplyPendingWrites()
+{
+    this->Impl->ApplyPendingWrites();
+}
+
+void vtkThreadSafeRenderer::SwapViewProp( vtkProp* oldProp, vtkProp* newProp )
+{
+    this->Impl->SwapViewProp( oldProp, newProp );
+}
+
+void vtkThreadSafeRenderer::QueueSceneUpdate( msvDeferredCommand* command )
+{
+    this->Impl->QueueSceneUpdate( command );
+}
+
+int vtkThreadSafeRenderer::GetNumberOfPendingWrites()
+{
+    return this->Impl->GetNumberOfPendingWrites();
+}
+
+void vtkThreadSafeRenderer::GetLockCounters( msvLockCounters& counters )
+{
+    this->Impl->GetLockCounters( counters );
+}
+
+void vtkThreadSafeRenderer::ResetLockCounters()
+{
+    this->Impl->ResetLockCounters();
+}
+
 // Description:
 // Add/Remove different types of props to the renderer.
 // These methods are all synonyms to AddViewProp and RemoveViewProp.
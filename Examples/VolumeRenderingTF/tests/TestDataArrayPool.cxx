@@ -0,0 +1,113 @@
+/*==============================================================================
+
+  Library: MSVTK
+
+  Copyright (c) Computational Image and Simulation Technologies in Biomedicine (CISTIB),
+                Universitat Pompeu Fabra (UPF), Barcelona, Spain
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#include <gtest/gtest.h>
+
+#include <vtkSmartPointer.h>
+#include <vtkImageData.h>
+#include <vtkPointData.h>
+#include <vtkDataArray.h>
+#include <vtkShortArray.h>
+#include "vtkDataArrayPool.h"
+
+// An evicted volume holding a pooled array of the given shape
+vtkSmartPointer<vtkImageData> CreateVolume( vtkDataArrayPool* pool, vtkIdType numTuples )
+{
+    vtkSmartPointer<vtkImageData> volumeSP = vtkSmartPointer<vtkImageData>::New();
+    vtkSmartPointer<vtkDataArray> scalarsSP;
+    scalarsSP.TakeReference( pool->Acquire( VTK_SHORT, 1, numTuples ) );
+    volumeSP->GetPointData()->SetScalars( scalarsSP );
+    return volumeSP;
+}
+
+TEST( TestDataArrayPool, TestEvictedArrayIsReused )
+{
+    vtkSmartPointer<vtkDataArrayPool> poolSP = vtkSmartPointer<vtkDataArrayPool>::New();
+    vtkSmartPointer<vtkImageData> volumeSP = CreateVolume( poolSP, 1000 );
+    vtkDataArray* evictedScalars = volumeSP->GetPointData()->GetScalars();
+    EXPECT_EQ( 0, poolSP->GetNumberOfHits() );
+    EXPECT_EQ( 1, poolSP->GetNumberOfMisses() );
+
+    poolSP->Recycle( volumeSP );
+    volumeSP = 0;
+
+    vtkDataArray* recycledScalars = poolSP->Acquire( VTK_SHORT, 1, 1000 );
+    EXPECT_EQ( evictedScalars, recycledScalars );
+    EXPECT_EQ( 1000, recycledScalars->GetNumberOfTuples() );
+    EXPECT_EQ( 1, poolSP->GetNumberOfHits() );
+    EXPECT_EQ( 1000 * static_cast<vtkTypeInt64>( sizeof( short ) ), poolSP->GetRecycledBytes() );
+    recycledScalars->Delete();
+}
+
+TEST( TestDataArrayPool, TestOtherShapesMiss )
+{
+    vtkSmartPointer<vtkDataArrayPool> poolSP = vtkSmartPointer<vtkDataArrayPool>::New();
+    poolSP->Recycle( CreateVolume( poolSP, 1000 ) );
+
+    vtkSmartPointer<vtkDataArray> otherSP;
+    otherSP.TakeReference( poolSP->Acquire( VTK_SHORT, 1, 999 ) );
+    otherSP.TakeReference( poolSP->Acquire( VTK_FLOAT, 1, 1000 ) );
+    otherSP.TakeReference( poolSP->Acquire( VTK_SHORT, 2, 1000 ) );
+    EXPECT_EQ( 0, poolSP->GetNumberOfHits() );
+    EXPECT_EQ( 4, poolSP->GetNumberOfMisses() );
+}
+
+TEST( TestDataArrayPool, TestReferencedStepsAreNotRecycled )
+{
+    vtkSmartPointer<vtkDataArrayPool> poolSP = vtkSmartPointer<vtkDataArrayPool>::New();
+
+    // Still rendered somewhere
+    vtkSmartPointer<vtkImageData> renderedSP = CreateVolume( poolSP, 1000 );
+    poolSP->Recycle( renderedSP );
+
+    // Array shared with another data set
+    vtkSmartPointer<vtkImageData> sharedSP = CreateVolume( poolSP, 1000 );
+    vtkSmartPointer<vtkDataArray> sharedScalarsSP = sharedSP->GetPointData()->GetScalars();
+    poolSP->Recycle( sharedSP );
+    sharedSP = 0;
+
+    vtkSmartPointer<vtkDataArray> acquiredSP;
+    acquiredSP.TakeReference( poolSP->Acquire( VTK_SHORT, 1, 1000 ) );
+    EXPECT_EQ( 0, poolSP->GetNumberOfHits() );
+    EXPECT_NE( renderedSP->GetPointData()->GetScalars(), acquiredSP.GetPointer() );
+    EXPECT_NE( sharedScalarsSP.GetPointer(), acquiredSP.GetPointer() );
+
+    // Once the renderer lets it go, it is recycled
+    renderedSP = 0;
+    acquiredSP.TakeReference( poolSP->Acquire( VTK_SHORT, 1, 1000 ) );
+    EXPECT_EQ( 1, poolSP->GetNumberOfHits() );
+}
+
+TEST( TestDataArrayPool, TestArraysNotFromThePoolAreIgnored )
+{
+    vtkSmartPointer<vtkDataArrayPool> poolSP = vtkSmartPointer<vtkDataArrayPool>::New();
+    vtkSmartPointer<vtkImageData> volumeSP = vtkSmartPointer<vtkImageData>::New();
+    vtkSmartPointer<vtkShortArray> scalarsSP = vtkSmartPointer<vtkShortArray>::New();
+    scalarsSP->SetNumberOfTuples( 1000 );
+    volumeSP->GetPointData()->SetScalars( scalarsSP );
+    scalarsSP = 0;
+    poolSP->Recycle( volumeSP );
+    volumeSP = 0;
+
+    vtkSmartPointer<vtkDataArray> acquiredSP;
+    acquiredSP.TakeReference( poolSP->Acquire( VTK_SHORT, 1, 1000 ) );
+    EXPECT_EQ( 0, poolSP->GetNumberOfHits() );
+}
@@ -0,0 +1,174 @@
+/*==============================================================================
+
+  Library: MSVTK
+
+  Copyright (c) Computational Image and Simulation Technologies in Biomedicine (CISTIB),
+                Universitat Pompeu Fabra (UPF), Barcelona, Spain
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#include <gtest/gtest.h>
+
+#include <vtkSmartPointer.h>
+#include <vtkObject.h>
+#include <vtkMultiThreader.h>
+#include "msvDeferredCommandQueue.h"
+
+#include <string>
+#include <vector>
+
+const int ProducerThreads = 8;
+const int CommandsPerProducer = 20000;
+
+class DeferredTarget
+{
+public:
+    DeferredTarget() : Value( 0 ), Name( "unset" ) {}
+    void AppendDigit( int digit ) { this->Value = this->Value * 10 + digit; }
+    void SetPair( int first, int second ) { AppendDigit( first ); AppendDigit( second ); }
+    void SetName( const char* name ) { this->Name = name ? name : "null"; }
+    void SetObject( vtkObject* object ) { this->Object = object; }
+    void Reset() { this->Value = 0; }
+
+    int                                 Value;
+    std::string                         Name;
+    vtkSmartPointer<vtkObject>          Object;
+};
+
+TEST( TestDeferredCommandQueue, TestAppliesInOrder )
+{
+    msvDeferredCommandQueueSP queueSP = msvDeferredCommandQueueSP::New();
+    DeferredTarget target;
+
+    queueSP->Push( new msvDeferredCall1<DeferredTarget, int>( &DeferredTarget::AppendDigit, &target, 1 ) );
+    queueSP->Push( new msvDeferredCall2<DeferredTarget, int>( &DeferredTarget::SetPair, &target, 2, 3 ) );
+    EXPECT_EQ( 2, queueSP->GetNumberOfPendingCommands() );
+    EXPECT_EQ( 0, target.Value );
+
+    EXPECT_EQ( 2, queueSP->ApplyAll() );
+    EXPECT_EQ( 123, target.Value );
+    EXPECT_EQ( 0, queueSP->GetNumberOfPendingCommands() );
+    EXPECT_EQ( 2u, queueSP->GetNumberOfAppliedCommands() );
+
+    queueSP->Push( new msvDeferredCall0<DeferredTarget>( &DeferredTarget::Reset, &target ) );
+    queueSP->Clear();
+    EXPECT_EQ( 0, queueSP->ApplyAll() );
+    EXPECT_EQ( 123, target.Value );
+}
+
+TEST( TestDeferredCommandQueue, TestCopiesTheArguments )
+{
+    msvDeferredCommandQueueSP queueSP = msvDeferredCommandQueueSP::New();
+    DeferredTarget target;
+
+    char name[] = "first";
+    queueSP->Push( new msvDeferredStringCall<DeferredTarget>( &DeferredTarget::SetName, &target, name ) );
+    name[0] = 'x';
+
+    // The object outlives the reference of the caller until the call is made
+    vtkObject* object = vtkObject::New();
+    queueSP->Push( new msvDeferredObjectCall<DeferredTarget, vtkObject>( &DeferredTarget::SetObject, &target, object ) );
+    object->Delete();
+
+    queueSP->ApplyAll();
+    EXPECT_EQ( "first", target.Name );
+    EXPECT_EQ( object, target.Object.GetPointer() );
+    EXPECT_EQ( 1, target.Object->GetReferenceCount() );
+}
+
+// Checks that the commands of each producer arrive once and in order
+class SequenceCommand : public msvDeferredCommand
+{
+public:
+    SequenceCommand( std::vector<int>* nextSequence, int producer, int sequence )
+    : NextSequence( nextSequence )
+    , Producer( producer )
+    , Sequence( sequence )
+    {
+    }
+
+    virtual void Execute()
+    {
+        int& expected = ( *this->NextSequence )[this->Producer];
+        if( this->Sequence == expected )
+        {
+            expected++;
+        }
+        else
+        {
+            // Flags the producer as out of order for good
+            expected = -CommandsPerProducer - 1;
+        }
+    }
+
+private:
+    std::vector<int>*                   NextSequence;
+    int                                 Producer;
+    int                                 Sequence;
+};
+
+struct ProducerData
+{
+    msvDeferredCommandQueue*            Queue;
+    std::vector<int>*                   NextSequence;
+};
+
+VTK_THREAD_RETURN_TYPE PushCommands( void* arg )
+{
+    vtkMultiThreader::ThreadInfo* threadInfo = static_cast<vtkMultiThreader::ThreadInfo*>( arg );
+    ProducerData* data = static_cast<ProducerData*>( threadInfo->UserData );
+    for( int i = 0; i < CommandsPerProducer; i++ )
+    {
+        data->Queue->Push( new SequenceCommand( data->NextSequence, threadInfo->ThreadID, i ) );
+    }
+    return VTK_THREAD_RETURN_VALUE;
+}
+
+VTK_THREAD_RETURN_TYPE ApplyCommands( void* arg )
+{
+    vtkMultiThreader::ThreadInfo* threadInfo = static_cast<vtkMultiThreader::ThreadInfo*>( arg );
+    ProducerData* data = static_cast<ProducerData*>( threadInfo->UserData );
+    int applied = 0;
+    while( applied < ProducerThreads * CommandsPerProducer )
+    {
+        applied += data->Queue->ApplyAll();
+    }
+    return VTK_THREAD_RETURN_VALUE;
+}
+
+TEST( TestDeferredCommandQueue, TestManyProducerThreads )
+{
+    msvDeferredCommandQueueSP queueSP = msvDeferredCommandQueueSP::New();
+    std::vector<int> nextSequence( ProducerThreads, 0 );
+    ProducerData data = { queueSP, &nextSequence };
+
+    vtkSmartPointer<vtkMultiThreader> multiThreaderSP = vtkSmartPointer<vtkMultiThreader>::New();
+    multiThreaderSP->SetNumberOfThreads( ProducerThreads );
+    multiThreaderSP->SetSingleMethod( PushCommands, &data );
+
+    // The producers run in SingleMethodExecute while a second threader
+    // drains the queue, like a render thread between frames
+    vtkSmartPointer<vtkMultiThreader> consumerThreaderSP = vtkSmartPointer<vtkMultiThreader>::New();
+    int consumerID = consumerThreaderSP->SpawnThread( ApplyCommands, &data );
+    multiThreaderSP->SingleMethodExecute();
+    consumerThreaderSP->TerminateThread( consumerID );
+
+    for( int i = 0; i < ProducerThreads; i++ )
+    {
+        EXPECT_EQ( CommandsPerProducer, nextSequence[i] );
+    }
+    EXPECT_EQ( 0, queueSP->GetNumberOfPendingCommands() );
+    EXPECT_EQ( static_cast<unsigned long>( ProducerThreads * CommandsPerProducer ), queueSP->GetNumberOfAppliedCommands() );
+}
@@ -0,0 +1,154 @@
+/*==============================================================================
+
+  Library: MSVTK
+
+  Copyright (c) Computational Image and Simulation Technologies in Biomedicine (CISTIB),
+                Universitat Pompeu Fabra (UPF), Barcelona, Spain
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#include <gtest/gtest.h>
+
+#include <vtkSmartPointer.h>
+#include <vtkObject.h>
+#include <vtkCommand.h>
+#include <vtkTimerLog.h>
+#include <vtksys/SystemTools.hxx>
+#include "msvFrameScheduler.h"
+
+#include <iostream>
+
+const double FrameRate = 60.0;
+const double BenchmarkDuration = 0.5;
+
+TEST( TestFrameScheduler, TestRendersOnlyWhenDirty )
+{
+    msvFrameSchedulerSP scheduler = msvFrameSchedulerSP::New();
+    vtkSmartPointer<vtkObject> watched = vtkSmartPointer<vtkObject>::New();
+    scheduler->SetMaximumFrameRate( FrameRate );
+    scheduler->Watch( watched );
+
+    // The first frame is always due
+    EXPECT_TRUE( scheduler->IsFrameDue( 0.0 ) );
+    scheduler->FrameRendered( 0.0 );
+    EXPECT_FALSE( scheduler->IsDirty() );
+    EXPECT_FALSE( scheduler->IsFrameDue( 1.0 ) );
+    EXPECT_DOUBLE_EQ( 1.0 / FrameRate, scheduler->GetTimeToNextFrame( 1.0 ) );
+
+    watched->Modified();
+    EXPECT_TRUE( scheduler->IsDirty() );
+    EXPECT_TRUE( scheduler->IsFrameDue( 1.0 ) );
+
+    // Capped at the frame rate
+    scheduler->FrameRendered( 1.0 );
+    watched->Modified();
+    EXPECT_FALSE( scheduler->IsFrameDue( 1.0 + 0.5 / FrameRate ) );
+    EXPECT_TRUE( scheduler->IsFrameDue( 1.0 + 1.0 / FrameRate ) );
+
+    EXPECT_EQ( 2, scheduler->GetNumberOfRenderedFrames() );
+    EXPECT_EQ( 5, scheduler->GetNumberOfIdleChecks() );
+    EXPECT_EQ( 2, scheduler->GetNumberOfSkippedChecks() );
+
+    scheduler->Unwatch( watched );
+    scheduler->FrameRendered( 2.0 );
+    watched->Modified();
+    EXPECT_FALSE( scheduler->IsDirty() );
+}
+
+TEST( TestFrameScheduler, TestIgnoresChangesMadeByTheRender )
+{
+    msvFrameSchedulerSP scheduler = msvFrameSchedulerSP::New();
+    vtkSmartPointer<vtkObject> renderTarget = vtkSmartPointer<vtkObject>::New();
+    vtkSmartPointer<vtkObject> watched = vtkSmartPointer<vtkObject>::New();
+    scheduler->SetRenderTarget( renderTarget );
+    scheduler->Watch( watched );
+
+    renderTarget->InvokeEvent( vtkCommand::StartEvent );
+    watched->Modified();
+    renderTarget->InvokeEvent( vtkCommand::EndEvent );
+
+    EXPECT_FALSE( scheduler->IsDirty() );
+    EXPECT_EQ( 1, scheduler->GetNumberOfRenderedFrames() );
+
+    watched->Modified();
+    EXPECT_TRUE( scheduler->IsDirty() );
+}
+
+TEST( TestFrameScheduler, TestWatchedObjectsMayDieFirst )
+{
+    msvFrameSchedulerSP scheduler = msvFrameSchedulerSP::New();
+    vtkSmartPointer<vtkObject> watched = vtkSmartPointer<vtkObject>::New();
+    scheduler->Watch( watched, vtkCommand::ExposeEvent );
+    scheduler->SetRenderTarget( watched );
+    watched = 0;
+    scheduler->UnwatchAll();
+    scheduler->SetRenderTarget( 0 );
+}
+
+// Runs the idle loop of MainApp for a while, with a scene that changes every
+// changePeriod seconds, or never if it is 0. Returns the CPU usage
+double RunIdleLoop( msvFrameScheduler* scheduler, vtkObject* scene, double changePeriod, bool renderOnEveryIdle )
+{
+    scheduler->ResetStatistics();
+    double startTime = vtkTimerLog::GetUniversalTime();
+    double lastChangeTime = startTime;
+    double currentTime = startTime;
+    while( currentTime - startTime < BenchmarkDuration )
+    {
+        if( changePeriod > 0.0 && currentTime - lastChangeTime >= changePeriod )
+        {
+            scene->Modified();
+            lastChangeTime = currentTime;
+        }
+        if( renderOnEveryIdle || scheduler->IsFrameDue( currentTime ) )
+        {
+            scheduler->FrameRendered( currentTime );
+        }
+        if( !renderOnEveryIdle )
+        {
+            double timeToNextFrame = scheduler->GetTimeToNextFrame( vtkTimerLog::GetUniversalTime() );
+            vtksys::SystemTools::Delay( static_cast<unsigned int>( timeToNextFrame * 1000.0 ) );
+        }
+        currentTime = vtkTimerLog::GetUniversalTime();
+    }
+    return scheduler->GetCPUUsage();
+}
+
+TEST( TestFrameScheduler, BenchmarkIdleCPUUsage )
+{
+    msvFrameSchedulerSP scheduler = msvFrameSchedulerSP::New();
+    vtkSmartPointer<vtkObject> scene = vtkSmartPointer<vtkObject>::New();
+    scheduler->SetMaximumFrameRate( FrameRate );
+    scheduler->Watch( scene );
+
+    double everyIdleUsage = RunIdleLoop( scheduler, scene, 0.0, true );
+    int everyIdleFrames = scheduler->GetNumberOfRenderedFrames();
+
+    double staticUsage = RunIdleLoop( scheduler, scene, 0.0, false );
+    int staticFrames = scheduler->GetNumberOfRenderedFrames();
+
+    double animatedUsage = RunIdleLoop( scheduler, scene, 0.5 / FrameRate, false );
+    int animatedFrames = scheduler->GetNumberOfRenderedFrames();
+
+    std::cout << "Render on every idle: " << everyIdleFrames << " frames, CPU usage " << everyIdleUsage * 100.0 << "%" << std::endl;
+    std::cout << "Demand driven, static scene: " << staticFrames << " frames, CPU usage " << staticUsage * 100.0 << "%" << std::endl;
+    std::cout << "Demand driven, changing scene: " << animatedFrames << " frames, CPU usage " << animatedUsage * 100.0 << "%" << std::endl;
+
+    // At most the pending first frame when nothing changes
+    EXPECT_LE( staticFrames, 1 );
+    EXPECT_LE( animatedFrames, static_cast<int>( BenchmarkDuration * FrameRate ) + 1 );
+    EXPECT_GT( animatedFrames, 0 );
+    EXPECT_LT( staticUsage, everyIdleUsage );
+}
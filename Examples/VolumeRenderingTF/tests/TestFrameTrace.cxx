@@ -0,0 +1,262 @@
+/*==============================================================================
+
+  Library: MSVTK
+
+  Copyright (c) Computational Image and Simulation Technologies in Biomedicine (CISTIB),
+                Universitat Pompeu Fabra (UPF), Barcelona, Spain
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+#include <gtest/gtest.h>
+
+#include <vtkSmartPointer.h>
+#include <vtkMultiThreader.h>
+#include <vtkTimerLog.h>
+#include <vtksys/SystemTools.hxx>
+#include "msvFrameTrace.h"
+
+#include <sstream>
+#include <string>
+#include <vector>
+#include <string.h>
+
+const int WorkerThreads = 4;
+const int ZonesPerThread = 1000;
+const int StressZones = 200000;
+const int BenchmarkZones = 1000000;
+
+// Every test starts from an empty, enabled trace
+void RestartTrace( int maxEntries = 16384 )
+{
+    msvFrameTrace::EnableOff();
+    msvFrameTrace::SetMaxEntries( maxEntries );
+    msvFrameTrace::ResetLog();
+    msvFrameTrace::EnableOn();
+}
+
+int CountZones( const std::vector<msvTraceEvent>& events, const char* name )
+{
+    int count = 0;
+    for( size_t index = 0; index < events.size(); index++ )
+    {
+        count += ( strcmp( events[index].Name, name ) == 0 ) ? 1 : 0;
+    }
+    return count;
+}
+
+TEST( TestFrameTrace, TestRecordsScopedZones )
+{
+    RestartTrace();
+    msvFrameTrace::NextFrame();
+    unsigned long frameNumber = msvFrameTrace::GetFrameNumber();
+    {
+        MSV_TRACE_ZONE( "Outer" );
+        {
+            MSV_TRACE_ZONE( "Inner" );
+            vtksys::SystemTools::Delay( 10 );
+        }
+    }
+
+    std::vector<msvTraceEvent> events;
+    msvFrameTrace::GetEvents( events );
+    ASSERT_EQ( 2u, events.size() );
+    // Zones are recorded when they end
+    EXPECT_EQ( 0, strcmp( "Inner", events[0].Name ) );
+    EXPECT_EQ( 0, strcmp( "Outer", events[1].Name ) );
+    EXPECT_GE( events[0].Duration, 0.005 );
+    EXPECT_GE( events[1].Duration, events[0].Duration );
+    EXPECT_LE( events[1].StartTime, events[0].StartTime );
+    EXPECT_EQ( frameNumber, events[0].FrameNumber );
+    EXPECT_EQ( events[0].ThreadIndex, events[1].ThreadIndex );
+}
+
+TEST( TestFrameTrace, TestDisabledRecordsNothing )
+{
+    RestartTrace();
+    msvFrameTrace::EnableOff();
+    {
+        MSV_TRACE_ZONE( "Ignored" );
+    }
+    msvFrameTrace::AddZone( "Ignored", 0.0, 1.0 );
+
+    std::vector<msvTraceEvent> events;
+    msvFrameTrace::GetEvents( events );
+    EXPECT_TRUE( events.empty() );
+}
+
+TEST( TestFrameTrace, TestKeepsTheLatestZones )
+{
+    RestartTrace( 4 );
+    for( int i = 0; i < 10; i++ )
+    {
+        msvFrameTrace::AddZone( "Zone", i, i + 1.0 );
+    }
+
+    std::vector<msvTraceEvent> events;
+    msvFrameTrace::GetEvents( events );
+    ASSERT_EQ( 4u, events.size() );
+    for( size_t index = 0; index < events.size(); index++ )
+    {
+        EXPECT_DOUBLE_EQ( 6.0 + index, events[index].StartTime );
+    }
+}
+
+TEST( TestFrameTrace, TestHistogram )
+{
+    RestartTrace();
+    // 1 to 100 milliseconds
+    for( int i = 1; i <= 100; i++ )
+    {
+        msvFrameTrace::AddZone( "Render", 0.0, i * 0.001 );
+    }
+    msvFrameTrace::AddZone( "Swap", 0.0, 0.5 );
+
+    msvTraceHistogram histogram;
+    EXPECT_FALSE( msvFrameTrace::GetHistogram( "Missing", histogram ) );
+    ASSERT_TRUE( msvFrameTrace::GetHistogram( "Render", histogram ) );
+    EXPECT_EQ( 100u, histogram.Count );
+    EXPECT_DOUBLE_EQ( 0.001, histogram.Minimum );
+    EXPECT_DOUBLE_EQ( 0.1, histogram.Maximum );
+    EXPECT_NEAR( 0.0505, histogram.Mean, 1.0e-9 );
+    EXPECT_DOUBLE_EQ( 0.05, histogram.Median );
+    EXPECT_DOUBLE_EQ( 0.095, histogram.Percentile95 );
+    EXPECT_DOUBLE_EQ( 0.099, histogram.Percentile99 );
+
+    // 1 ms falls in the bucket from 512 to 1024 microseconds, 100 ms in the
+    // one from 65536 to 131072
+    unsigned long bucketTotal = 0;
+    for( int bucket = 0; bucket < msvTraceHistogram::NumberOfBuckets; bucket++ )
+    {
+        bucketTotal += histogram.Buckets[bucket];
+    }
+    EXPECT_EQ( histogram.Count, bucketTotal );
+    EXPECT_EQ( 1u, histogram.Buckets[9] );
+    EXPECT_GT( histogram.Buckets[16], 0u );
+}
+
+TEST( TestFrameTrace, TestWritesChromeTrace )
+{
+    RestartTrace();
+    msvFrameTrace::SetThreadName( "Main" );
+    msvFrameTrace::AddZone( "Tick", 1.0, 1.002 );
+    msvFrameTrace::AddZone( "Render", 1.002, 1.010 );
+
+    std::ostringstream os;
+    msvFrameTrace::WriteChromeTrace( os );
+    std::string trace = os.str();
+    EXPECT_EQ( 0u, trace.find( "{\"traceEvents\":[" ) );
+    EXPECT_NE( std::string::npos, trace.find( "\"args\":{\"name\":\"Main\"}" ) );
+    // Microseconds from the first zone
+    EXPECT_NE( std::string::npos, trace.find( "{\"name\":\"Tick\",\"ph\":\"X\"" ) );
+    EXPECT_NE( std::string::npos, trace.find( "\"ts\":0.000,\"dur\":2000.000" ) );
+    EXPECT_NE( std::string::npos, trace.find( "\"ts\":2000.000,\"dur\":8000.000" ) );
+    EXPECT_NE( std::string::npos, trace.find( "],\"displayTimeUnit\":\"ms\"}" ) );
+}
+
+VTK_THREAD_RETURN_TYPE RecordWorkerZones( void* arg )
+{
+    msvFrameTrace::SetThreadName( "Worker" );
+    for( int i = 0; i < ZonesPerThread; i++ )
+    {
+        MSV_TRACE_ZONE( "Work" );
+    }
+    return VTK_THREAD_RETURN_VALUE;
+}
+
+TEST( TestFrameTrace, TestEachThreadRecordsApart )
+{
+    RestartTrace();
+    vtkSmartPointer<vtkMultiThreader> multiThreaderSP = vtkSmartPointer<vtkMultiThreader>::New();
+    multiThreaderSP->SetNumberOfThreads( WorkerThreads );
+    multiThreaderSP->SetSingleMethod( RecordWorkerZones, 0 );
+    multiThreaderSP->SingleMethodExecute();
+
+    std::vector<msvTraceEvent> events;
+    msvFrameTrace::GetEvents( events );
+    EXPECT_EQ( WorkerThreads * ZonesPerThread, CountZones( events, "Work" ) );
+
+    // The zones of a thread are together, oldest first
+    int threadChanges = 0;
+    for( size_t index = 1; index < events.size(); index++ )
+    {
+        if( events[index].ThreadIndex != events[index - 1].ThreadIndex )
+        {
+            threadChanges++;
+        }
+        else
+        {
+            EXPECT_LE( events[index - 1].StartTime, events[index].StartTime );
+        }
+    }
+    EXPECT_LE( threadChanges, WorkerThreads );
+}
+
+VTK_THREAD_RETURN_TYPE RecordStressZones( void* arg )
+{
+    // The duration tells whether a copied zone is torn
+    for( int i = 1; i <= StressZones; i++ )
+    {
+        msvFrameTrace::AddZone( "Stress", i, 2.0 * i );
+    }
+    return VTK_THREAD_RETURN_VALUE;
+}
+
+TEST( TestFrameTrace, TestReadsWhileRecording )
+{
+    RestartTrace( 64 );
+    vtkSmartPointer<vtkMultiThreader> multiThreaderSP = vtkSmartPointer<vtkMultiThreader>::New();
+    int threadID = multiThreaderSP->SpawnThread( RecordStressZones, 0 );
+
+    std::vector<msvTraceEvent> events;
+    double lastStartTime = 0.0;
+    while( lastStartTime < StressZones )
+    {
+        msvFrameTrace::GetEvents( events );
+        for( size_t index = 0; index < events.size(); index++ )
+        {
+            if( strcmp( events[index].Name, "Stress" ) != 0 )
+            {
+                continue;
+            }
+            ASSERT_EQ( events[index].StartTime, events[index].Duration );
+            lastStartTime = events[index].StartTime;
+        }
+    }
+    multiThreaderSP->TerminateThread( threadID );
+}
+
+double GetZoneCost( bool enabled )
+{
+    RestartTrace();
+    msvFrameTrace::SetEnabled( enabled );
+    double startTime = vtkTimerLog::GetUniversalTime();
+    for( int i = 0; i < BenchmarkZones; i++ )
+    {
+        MSV_TRACE_ZONE( "Benchmark" );
+    }
+    return ( vtkTimerLog::GetUniversalTime() - startTime ) / BenchmarkZones;
+}
+
+TEST( TestFrameTrace, BenchmarkZoneCost )
+{
+    double disabledCost = GetZoneCost( false );
+    double enabledCost = GetZoneCost( true );
+    msvFrameTrace::EnableOff();
+
+    std::cout << "Zone cost, disabled: " << disabledCost * 1.0e9 << " ns, enabled: " << enabledCost * 1.0e9 << " ns" << std::endl;
+
+    // A handful of zones per frame stay far under 1% of a 16 ms frame
+    EXPECT_LT( enabledCost * 10.0, 0.01 * 0.016 );
+    EXPECT_LT( disabledCost, enabledCost );
+}
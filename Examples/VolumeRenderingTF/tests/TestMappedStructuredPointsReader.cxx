@@ -0,0 +1,143 @@
+/*==============================================================================
+
+  Library: MSVTK
+
+  Copyright (c) Computational Image and Simulation Technologies in Biomedicine (CISTIB),
+                Universitat Pompeu Fabra (UPF), Barcelona, Spain
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#include <gtest/gtest.h>
+
+#include <vtkSmartPointer.h>
+#include <vtkImageData.h>
+#include <vtkStructuredPoints.h>
+#include <vtkStructuredPointsReader.h>
+#include <vtkStructuredPointsWriter.h>
+#include <vtkPointData.h>
+#include <vtkDataArray.h>
+#include <vtkInformation.h>
+#include <vtksys/SystemTools.hxx>
+#include "vtkMappedStructuredPointsReader.h"
+
+#include <string>
+using namespace std;
+
+class TestMappedStructuredPointsReader : public ::testing::Test
+{
+protected:
+    virtual void SetUp()
+    {
+        m_FileName = vtksys::SystemTools::GetCurrentWorkingDirectory() + "/TestMappedStructuredPointsReader.vtk";
+    }
+
+    virtual void TearDown()
+    {
+        vtksys::SystemTools::RemoveFile( m_FileName.c_str() );
+    }
+
+    void WriteVolume( int scalarType, int fileType )
+    {
+        vtkSmartPointer<vtkImageData> volumeSP = vtkSmartPointer<vtkImageData>::New();
+        volumeSP->SetDimensions( 7, 5, 3 );
+        volumeSP->SetSpacing( 0.5, 1.0, 2.0 );
+        volumeSP->SetOrigin( -1.0, 0.0, 10.0 );
+        volumeSP->SetScalarType( scalarType );
+        volumeSP->SetNumberOfScalarComponents( 1 );
+        volumeSP->AllocateScalars();
+        vtkDataArray* scalars = volumeSP->GetPointData()->GetScalars();
+        for( vtkIdType indexPoint = 0; indexPoint < scalars->GetNumberOfTuples(); indexPoint++ )
+        {
+            scalars->SetComponent( indexPoint, 0, indexPoint % 97 );
+        }
+
+        vtkSmartPointer<vtkStructuredPointsWriter> writerSP = vtkSmartPointer<vtkStructuredPointsWriter>::New();
+        writerSP->SetInput( volumeSP );
+        writerSP->SetFileName( m_FileName.c_str() );
+        writerSP->SetFileType( fileType );
+        writerSP->Write();
+    }
+
+    // Compares the mapped read against vtkStructuredPointsReader
+    void ExpectSameAsLegacyReader( vtkStructuredPoints* mapped )
+    {
+        vtkSmartPointer<vtkStructuredPointsReader> legacyReaderSP = vtkSmartPointer<vtkStructuredPointsReader>::New();
+        legacyReaderSP->SetFileName( m_FileName.c_str() );
+        legacyReaderSP->Update();
+        vtkStructuredPoints* legacy = legacyReaderSP->GetOutput();
+
+        int mappedDimensions[3];
+        int legacyDimensions[3];
+        mapped->GetDimensions( mappedDimensions );
+        legacy->GetDimensions( legacyDimensions );
+        for( int axis = 0; axis < 3; axis++ )
+        {
+            EXPECT_EQ( legacyDimensions[axis], mappedDimensions[axis] );
+            EXPECT_DOUBLE_EQ( legacy->GetSpacing()[axis], mapped->GetSpacing()[axis] );
+            EXPECT_DOUBLE_EQ( legacy->GetOrigin()[axis], mapped->GetOrigin()[axis] );
+        }
+
+        vtkDataArray* mappedScalars = mapped->GetPointData()->GetScalars();
+        vtkDataArray* legacyScalars = legacy->GetPointData()->GetScalars();
+        ASSERT_TRUE( mappedScalars != 0 );
+        ASSERT_EQ( legacyScalars->GetNumberOfTuples(), mappedScalars->GetNumberOfTuples() );
+        EXPECT_EQ( legacyScalars->GetDataType(), mappedScalars->GetDataType() );
+        for( vtkIdType indexPoint = 0; indexPoint < legacyScalars->GetNumberOfTuples(); indexPoint++ )
+        {
+            EXPECT_EQ( legacyScalars->GetComponent( indexPoint, 0 ), mappedScalars->GetComponent( indexPoint, 0 ) );
+        }
+    }
+
+    string m_FileName;
+};
+
+TEST_F( TestMappedStructuredPointsReader, TestBinaryBytesAreMapped )
+{
+    WriteVolume( VTK_UNSIGNED_CHAR, VTK_BINARY );
+
+    vtkSmartPointer<vtkMappedStructuredPointsReader> readerSP = vtkSmartPointer<vtkMappedStructuredPointsReader>::New();
+    readerSP->SetFileName( m_FileName.c_str() );
+    readerSP->Update();
+
+    EXPECT_EQ( 1, readerSP->GetScalarsMapped() );
+    vtkDataArray* scalars = readerSP->GetOutput()->GetPointData()->GetScalars();
+    ASSERT_TRUE( scalars != 0 );
+    EXPECT_TRUE( scalars->GetInformation()->Has( vtkMappedStructuredPointsReader::MAPPED_FILE_REGION() ) );
+    ExpectSameAsLegacyReader( readerSP->GetOutput() );
+}
+
+TEST_F( TestMappedStructuredPointsReader, TestAsciiFallsBackToReader )
+{
+    WriteVolume( VTK_UNSIGNED_CHAR, VTK_ASCII );
+
+    vtkSmartPointer<vtkMappedStructuredPointsReader> readerSP = vtkSmartPointer<vtkMappedStructuredPointsReader>::New();
+    readerSP->SetFileName( m_FileName.c_str() );
+    readerSP->Update();
+
+    EXPECT_EQ( 0, readerSP->GetScalarsMapped() );
+    ExpectSameAsLegacyReader( readerSP->GetOutput() );
+}
+
+TEST_F( TestMappedStructuredPointsReader, TestShortsMatchReader )
+{
+    // Mapped on big endian hosts only, the values must match either way
+    WriteVolume( VTK_SHORT, VTK_BINARY );
+
+    vtkSmartPointer<vtkMappedStructuredPointsReader> readerSP = vtkSmartPointer<vtkMappedStructuredPointsReader>::New();
+    readerSP->SetFileName( m_FileName.c_str() );
+    readerSP->Update();
+
+    ExpectSameAsLegacyReader( readerSP->GetOutput() );
+}
@@ -0,0 +1,176 @@
+/*==============================================================================
+
+  Library: MSVTK
+
+  Copyright (c) Computational Image and Simulation Technologies in Biomedicine (CISTIB),
+                Universitat Pompeu Fabra (UPF), Barcelona, Spain
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#include <gtest/gtest.h>
+
+#include <vtkSmartPointer.h>
+#include <vtkStringArray.h>
+#include <vtkSphereSource.h>
+#include <vtkPolyDataWriter.h>
+#include <vtkPolyData.h>
+#include <vtkTemporalDataSet.h>
+#include <vtkInformation.h>
+#include <vtkStreamingDemandDrivenPipeline.h>
+#include <vtksys/SystemTools.hxx>
+#include "vtkMultipleDataReader.h"
+#include "vtkMultiplePolyDataReader.h"
+
+#include <fstream>
+#include <sstream>
+#include <string>
+using namespace std;
+
+const int NumFiles = 5;
+
+// Writes a small series of spheres with increasing resolution in the working
+// directory, with a descriptor giving the cardiac phase of every file in ms
+class TestMultiplePolyDataReader : public ::testing::Test
+{
+public:
+    TestMultiplePolyDataReader()
+    : m_MultiplePolyDataReaderSP( 0 )
+    , m_FileNamesSP( 0 )
+    {
+
+    }
+protected:
+    virtual void SetUp()
+    {
+        m_SeriesFolder = vtksys::SystemTools::GetCurrentWorkingDirectory() + "/TestMultiplePolyDataReaderSeries";
+        vtksys::SystemTools::RemoveADirectory( m_SeriesFolder.c_str() );
+        vtksys::SystemTools::MakeDirectory( m_SeriesFolder.c_str() );
+
+        m_FileNamesSP = vtkSmartPointer<vtkStringArray>::New();
+        vtkSmartPointer<vtkSphereSource> sphereSP = vtkSmartPointer<vtkSphereSource>::New();
+        vtkSmartPointer<vtkPolyDataWriter> writerSP = vtkSmartPointer<vtkPolyDataWriter>::New();
+        writerSP->SetInputConnection( sphereSP->GetOutputPort() );
+        for( int indexFile = 0; indexFile < NumFiles; indexFile++ )
+        {
+            ostringstream fileName;
+            fileName << m_SeriesFolder << "/phase" << indexFile << ".vtk";
+            sphereSP->SetThetaResolution( 8 + indexFile );
+            writerSP->SetFileName( fileName.str().c_str() );
+            writerSP->Write();
+            m_FileNamesSP->InsertNextValue( fileName.str() );
+        }
+
+        ofstream descriptor( ( m_SeriesFolder + "/" + vtkMultipleDataReader::DefaultTimeDescriptorName ).c_str() );
+        descriptor << "# phase (ms)" << endl;
+        for( int indexFile = 0; indexFile < NumFiles; indexFile++ )
+        {
+            descriptor << PhaseTime( indexFile ) << endl;
+        }
+        descriptor.close();
+
+        m_MultiplePolyDataReaderSP = vtkSmartPointer<vtkMultiplePolyDataReader>::New();
+        m_MultiplePolyDataReaderSP->SetFileNames( m_FileNamesSP );
+    }
+
+    virtual void TearDown()
+    {
+        m_MultiplePolyDataReaderSP = 0;
+        vtksys::SystemTools::RemoveADirectory( m_SeriesFolder.c_str() );
+    }
+
+    static double PhaseTime( int indexFile )
+    {
+        return 40.0 * indexFile;
+    }
+
+    string m_SeriesFolder;
+    vtkSmartPointer<vtkMultiplePolyDataReader> m_MultiplePolyDataReaderSP;
+    vtkSmartPointer<vtkStringArray> m_FileNamesSP;
+};
+
+TEST_F( TestMultiplePolyDataReader, TestTimeDescriptorMetaData )
+{
+    m_MultiplePolyDataReaderSP->UpdateInformation();
+    vtkInformation* outInfo = m_MultiplePolyDataReaderSP->GetOutputInformation( 0 );
+
+    ASSERT_EQ( NumFiles, outInfo->Length( vtkStreamingDemandDrivenPipeline::TIME_STEPS() ) );
+    double* timeSteps = outInfo->Get( vtkStreamingDemandDrivenPipeline::TIME_STEPS() );
+    for( int indexFile = 0; indexFile < NumFiles; indexFile++ )
+    {
+        EXPECT_DOUBLE_EQ( PhaseTime( indexFile ), timeSteps[indexFile] );
+    }
+    double* timeRange = outInfo->Get( vtkStreamingDemandDrivenPipeline::TIME_RANGE() );
+    EXPECT_DOUBLE_EQ( PhaseTime( 0 ), timeRange[0] );
+    EXPECT_DOUBLE_EQ( PhaseTime( NumFiles - 1 ), timeRange[1] );
+}
+
+TEST_F( TestMultiplePolyDataReader, TestGetFileIndexForTime )
+{
+    m_MultiplePolyDataReaderSP->UpdateInformation();
+
+    EXPECT_EQ( 0, m_MultiplePolyDataReaderSP->GetFileIndexForTime( 0.0 ) );
+    EXPECT_EQ( 0, m_MultiplePolyDataReaderSP->GetFileIndexForTime( 39.0 ) );
+    EXPECT_EQ( 1, m_MultiplePolyDataReaderSP->GetFileIndexForTime( 40.0 ) );
+    EXPECT_EQ( NumFiles - 1, m_MultiplePolyDataReaderSP->GetFileIndexForTime( PhaseTime( NumFiles - 1 ) ) );
+    EXPECT_EQ( -1, m_MultiplePolyDataReaderSP->GetFileIndexForTime( -1.0 ) );
+    EXPECT_EQ( -1, m_MultiplePolyDataReaderSP->GetFileIndexForTime( 1000.0 ) );
+
+    // The series repeats every NumFiles * 40 ms
+    m_MultiplePolyDataReaderSP->TimeStepWrapOn();
+    EXPECT_EQ( 0, m_MultiplePolyDataReaderSP->GetFileIndexForTime( PhaseTime( NumFiles ) ) );
+    EXPECT_EQ( 2, m_MultiplePolyDataReaderSP->GetFileIndexForTime( PhaseTime( NumFiles + 2 ) ) );
+}
+
+TEST_F( TestMultiplePolyDataReader, TestLoadedFilesAreNotReadAgain )
+{
+    double firstRequest[] = { PhaseTime( 1 ), PhaseTime( 2 ) };
+    m_MultiplePolyDataReaderSP->SetRequestedTimesTeps( firstRequest, 2 );
+    m_MultiplePolyDataReaderSP->Update();
+    vtkTemporalDataSet* output = m_MultiplePolyDataReaderSP->GetOutput();
+    ASSERT_EQ( 2u, output->GetNumberOfTimeSteps() );
+    vtkDataObject* secondPhase = output->GetTimeStep( 1 );
+
+    // Slide the window by one: the second phase must be the same object
+    double secondRequest[] = { PhaseTime( 2 ), PhaseTime( 3 ) };
+    m_MultiplePolyDataReaderSP->SetRequestedTimesTeps( secondRequest, 2 );
+    m_MultiplePolyDataReaderSP->Update();
+    output = m_MultiplePolyDataReaderSP->GetOutput();
+    ASSERT_EQ( 2u, output->GetNumberOfTimeSteps() );
+    EXPECT_EQ( secondPhase, output->GetTimeStep( 0 ) );
+    vtkPolyData* thirdPhase = vtkPolyData::SafeDownCast( output->GetTimeStep( 1 ) );
+    ASSERT_TRUE( thirdPhase != 0 );
+    EXPECT_NE( secondPhase, thirdPhase );
+}
+
+TEST_F( TestMultiplePolyDataReader, TestOutOfRangeTimeIsLeftOut )
+{
+    double firstRequest[] = { PhaseTime( 1 ), PhaseTime( 2 ) };
+    m_MultiplePolyDataReaderSP->SetRequestedTimesTeps( firstRequest, 2 );
+    m_MultiplePolyDataReaderSP->Update();
+    vtkTemporalDataSet* output = m_MultiplePolyDataReaderSP->GetOutput();
+    ASSERT_EQ( 2u, output->GetNumberOfTimeSteps() );
+    vtkDataObject* secondPhase = output->GetTimeStep( 1 );
+
+    // Without TimeStepWrap the first time has no file: only the second one is
+    // in the output, with its own time
+    double secondRequest[] = { PhaseTime( NumFiles + 1 ), PhaseTime( 2 ) };
+    m_MultiplePolyDataReaderSP->SetRequestedTimesTeps( secondRequest, 2 );
+    m_MultiplePolyDataReaderSP->Update();
+    output = m_MultiplePolyDataReaderSP->GetOutput();
+    ASSERT_EQ( 1u, output->GetNumberOfTimeSteps() );
+    EXPECT_EQ( secondPhase, output->GetTimeStep( 0 ) );
+    ASSERT_EQ( 1, output->GetInformation()->Length( vtkDataObject::DATA_TIME_STEPS() ) );
+    EXPECT_DOUBLE_EQ( PhaseTime( 2 ), output->GetInformation()->Get( vtkDataObject::DATA_TIME_STEPS() )[0] );
+}
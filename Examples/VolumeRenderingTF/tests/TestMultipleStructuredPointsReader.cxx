@@ -24,7 +24,13 @@
 #include "BuildConfig.h"
 
 #include <vtkSmartPointer.h>
+#include <vtkStdString.h>
 #include <vtkStringArray.h>
+#include <vtkStructuredPointsReader.h>
+#include <vtkStructuredPoints.h>
+#include <vtkTemporalDataSet.h>
+#include <vtkPointData.h>
+#include <vtkDataArray.h>
 #include "vtkMultipleDataReader.h"
 #include "vtkMultipleStructuredPointsReader.h"
 
@@ -94,3 +100,49 @@ TEST_F( TestMultipleStructuredPointsReader, TestGetFileNamesSeriesType )
     */
 }
 
+
+TEST_F( TestMultipleStructuredPointsReader, TestSniffedTypeMatchesReaderType )
+{
+    vtkMultipleDataReader::ClearSniffedDataObjectTypes();
+    for( vtkIdType indexFile = 0; indexFile < m_FileNamesSP->GetNumberOfValues(); indexFile++ )
+    {
+        vtkStdString& fileName = m_FileNamesSP->GetValue( indexFile );
+        int readType = m_MultipleStructuredPointsReaderSP->GetDataObjectType( fileName );
+        // Twice, the second one comes from the cache
+        EXPECT_EQ( readType, m_MultipleStructuredPointsReaderSP->SniffDataObjectType( fileName ) );
+        EXPECT_EQ( readType, m_MultipleStructuredPointsReaderSP->SniffDataObjectType( fileName ) );
+    }
+}
+
+TEST_F( TestMultipleStructuredPointsReader, TestGetFileNamesSeriesTypeTrustFirstFile )
+{
+    vtkMultipleDataReader::ClearSniffedDataObjectTypes();
+    m_MultipleStructuredPointsReaderSP->SetSeriesTypeCheckPolicyToTrustFirstFile();
+    EXPECT_EQ( VTK_STRUCTURED_POINTS, m_MultipleStructuredPointsReaderSP->GetSeriesDataObjectType( m_FileNamesSP ) );
+    m_MultipleStructuredPointsReaderSP->SetSeriesTypeCheckPolicyToCheckAllFiles();
+    EXPECT_EQ( VTK_STRUCTURED_POINTS, m_MultipleStructuredPointsReaderSP->GetSeriesDataObjectType( m_FileNamesSP ) );
+}
+
+TEST_F( TestMultipleStructuredPointsReader, TestParallelDecodeKeepsRequestOrder )
+{
+    m_MultipleStructuredPointsReaderSP->SetFileNames( m_FileNamesSP );
+    m_MultipleStructuredPointsReaderSP->SetMaxDecodeThreads( 4 );
+    double requestedTimeSteps[] = { 5, 0, 3 };
+    m_MultipleStructuredPointsReaderSP->SetRequestedTimesTeps( requestedTimeSteps, 3 );
+    m_MultipleStructuredPointsReaderSP->Update();
+
+    vtkTemporalDataSet* output = m_MultipleStructuredPointsReaderSP->GetOutput();
+    ASSERT_EQ( 3u, output->GetNumberOfTimeSteps() );
+    for( unsigned int indexTimeStep = 0; indexTimeStep < 3; indexTimeStep++ )
+    {
+        vtkSmartPointer<vtkStructuredPointsReader> singleReaderSP = vtkSmartPointer<vtkStructuredPointsReader>::New();
+        singleReaderSP->SetFileName( m_FileNamesSP->GetValue( static_cast<vtkIdType>( requestedTimeSteps[indexTimeStep] ) ) );
+        singleReaderSP->Update();
+
+        vtkStructuredPoints* timeStep = vtkStructuredPoints::SafeDownCast( output->GetTimeStep( indexTimeStep ) );
+        ASSERT_TRUE( timeStep != 0 );
+        EXPECT_EQ( singleReaderSP->GetOutput()->GetNumberOfPoints(), timeStep->GetNumberOfPoints() );
+        EXPECT_EQ( singleReaderSP->GetOutput()->GetPointData()->GetScalars()->GetRange()[1],
+                   timeStep->GetPointData()->GetScalars()->GetRange()[1] );
+    }
+}
@@ -0,0 +1,192 @@
+/*==============================================================================
+
+  Library: MSVTK
+
+  Copyright (c) Computational Image and Simulation Technologies in Biomedicine (CISTIB),
+                Universitat Pompeu Fabra (UPF), Barcelona, Spain
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#include <gtest/gtest.h>
+
+#include <vtkSmartPointer.h>
+#include <vtkPolyData.h>
+#include <vtkPointData.h>
+#include <vtkCellData.h>
+#include <vtkFloatArray.h>
+#include <vtkSphereSource.h>
+#include "vtkPolyDataLODCache.h"
+
+// A time step with about 40000 points and their normals
+vtkSmartPointer<vtkPolyData> CreateTimeStep()
+{
+    vtkSmartPointer<vtkSphereSource> sphereSP = vtkSmartPointer<vtkSphereSource>::New();
+    sphereSP->SetThetaResolution( 200 );
+    sphereSP->SetPhiResolution( 200 );
+    sphereSP->Update();
+    vtkSmartPointer<vtkPolyData> timeStepSP = vtkSmartPointer<vtkPolyData>::New();
+    timeStepSP->ShallowCopy( sphereSP->GetOutput() );
+    return timeStepSP;
+}
+
+TEST( TestPolyDataLODCache, TestLevelsGetCoarser )
+{
+    vtkSmartPointer<vtkPolyDataLODCache> cacheSP = vtkSmartPointer<vtkPolyDataLODCache>::New();
+    vtkSmartPointer<vtkPolyData> timeStepSP = CreateTimeStep();
+    EXPECT_FALSE( cacheSP->HasLevels( 3 ) );
+    EXPECT_TRUE( cacheSP->GetLevel( 3, 0 ) == 0 );
+
+    EXPECT_TRUE( cacheSP->BuildLevels( 3, timeStepSP ) );
+    EXPECT_TRUE( cacheSP->HasLevels( 3 ) );
+    ASSERT_EQ( 2, cacheSP->GetNumberOfBuiltLevels( 3 ) );
+
+    vtkSmartPointer<vtkPolyData> fineSP = cacheSP->GetLevel( 3, 0 );
+    vtkSmartPointer<vtkPolyData> coarseSP = cacheSP->GetLevel( 3, 1 );
+    ASSERT_TRUE( fineSP != 0 );
+    ASSERT_TRUE( coarseSP != 0 );
+    EXPECT_LE( 2 * fineSP->GetNumberOfPoints(), timeStepSP->GetNumberOfPoints() );
+    EXPECT_LE( 2 * coarseSP->GetNumberOfPoints(), fineSP->GetNumberOfPoints() );
+    EXPECT_GT( coarseSP->GetNumberOfPolys(), 0 );
+    EXPECT_TRUE( fineSP->GetPointData()->GetNormals() != 0 );
+    EXPECT_TRUE( cacheSP->GetLevel( 3, 2 ) == 0 );
+
+    // Other steps are not affected
+    EXPECT_FALSE( cacheSP->HasLevels( 4 ) );
+}
+
+TEST( TestPolyDataLODCache, TestCachedStepsAreNotDecimatedAgain )
+{
+    vtkSmartPointer<vtkPolyDataLODCache> cacheSP = vtkSmartPointer<vtkPolyDataLODCache>::New();
+    vtkSmartPointer<vtkPolyData> timeStepSP = CreateTimeStep();
+
+    // Two loops over three steps
+    for( int loop = 0; loop < 2; loop++ )
+    {
+        for( int timeStep = 0; timeStep < 3; timeStep++ )
+        {
+            cacheSP->BuildLevels( timeStep, timeStepSP );
+        }
+    }
+    EXPECT_EQ( 3, cacheSP->GetNumberOfBuiltSteps() );
+    EXPECT_EQ( 3, cacheSP->GetNumberOfHits() );
+
+    vtkSmartPointer<vtkPolyData> levelSP = cacheSP->GetLevel( 0, 0 );
+    EXPECT_FALSE( cacheSP->BuildLevels( 0, timeStepSP ) );
+    EXPECT_EQ( levelSP.GetPointer(), cacheSP->GetLevel( 0, 0 ).GetPointer() );
+}
+
+TEST( TestPolyDataLODCache, TestReleasedStepsAreDecimatedAgain )
+{
+    vtkSmartPointer<vtkPolyDataLODCache> cacheSP = vtkSmartPointer<vtkPolyDataLODCache>::New();
+    vtkSmartPointer<vtkPolyData> timeStepSP = CreateTimeStep();
+    cacheSP->BuildLevels( 0, timeStepSP );
+    cacheSP->BuildLevels( 1, timeStepSP );
+
+    // Only the released step goes
+    cacheSP->ReleaseLevels( 0 );
+    EXPECT_FALSE( cacheSP->HasLevels( 0 ) );
+    EXPECT_TRUE( cacheSP->GetLevel( 0, 0 ) == 0 );
+    EXPECT_TRUE( cacheSP->HasLevels( 1 ) );
+
+    // Steps without levels are ignored
+    cacheSP->ReleaseLevels( 5 );
+    EXPECT_TRUE( cacheSP->HasLevels( 1 ) );
+
+    EXPECT_TRUE( cacheSP->BuildLevels( 0, timeStepSP ) );
+    EXPECT_EQ( 3, cacheSP->GetNumberOfBuiltSteps() );
+    EXPECT_EQ( 2, cacheSP->GetNumberOfBuiltLevels( 0 ) );
+}
+
+TEST( TestPolyDataLODCache, TestSettingsClearTheCache )
+{
+    vtkSmartPointer<vtkPolyDataLODCache> cacheSP = vtkSmartPointer<vtkPolyDataLODCache>::New();
+    vtkSmartPointer<vtkPolyData> timeStepSP = CreateTimeStep();
+    cacheSP->BuildLevels( 0, timeStepSP );
+
+    cacheSP->SetNumberOfLevels( 1 );
+    EXPECT_FALSE( cacheSP->HasLevels( 0 ) );
+    EXPECT_TRUE( cacheSP->BuildLevels( 0, timeStepSP ) );
+    EXPECT_EQ( 1, cacheSP->GetNumberOfBuiltLevels( 0 ) );
+
+    cacheSP->SetNumberOfDivisions( 16 );
+    EXPECT_FALSE( cacheSP->HasLevels( 0 ) );
+
+    // No levels, nothing to build
+    cacheSP->SetNumberOfLevels( 0 );
+    EXPECT_FALSE( cacheSP->BuildLevels( 0, timeStepSP ) );
+    EXPECT_FALSE( cacheSP->HasLevels( 0 ) );
+
+    cacheSP->SetNumberOfLevels( 100 );
+    EXPECT_EQ( 8, cacheSP->GetNumberOfLevels() );
+}
+
+TEST( TestPolyDataLODCache, TestLevelsKeepTheScalars )
+{
+    vtkSmartPointer<vtkPolyDataLODCache> cacheSP = vtkSmartPointer<vtkPolyDataLODCache>::New();
+    vtkSmartPointer<vtkPolyData> timeStepSP = CreateTimeStep();
+
+    // Point scalars: the height of the point. Cell scalars: the cell id
+    vtkSmartPointer<vtkFloatArray> heightsSP = vtkSmartPointer<vtkFloatArray>::New();
+    heightsSP->SetName( "Height" );
+    heightsSP->SetNumberOfTuples( timeStepSP->GetNumberOfPoints() );
+    for( vtkIdType indexPoint = 0; indexPoint < timeStepSP->GetNumberOfPoints(); indexPoint++ )
+    {
+        heightsSP->SetValue( indexPoint, static_cast<float>( timeStepSP->GetPoint( indexPoint )[2] ) );
+    }
+    timeStepSP->GetPointData()->SetScalars( heightsSP );
+    vtkSmartPointer<vtkFloatArray> cellIdsSP = vtkSmartPointer<vtkFloatArray>::New();
+    cellIdsSP->SetName( "CellId" );
+    cellIdsSP->SetNumberOfTuples( timeStepSP->GetNumberOfCells() );
+    for( vtkIdType indexCell = 0; indexCell < timeStepSP->GetNumberOfCells(); indexCell++ )
+    {
+        cellIdsSP->SetValue( indexCell, static_cast<float>( indexCell ) );
+    }
+    timeStepSP->GetCellData()->SetScalars( cellIdsSP );
+
+    EXPECT_TRUE( cacheSP->BuildLevels( 0, timeStepSP ) );
+    vtkSmartPointer<vtkPolyData> coarseSP = cacheSP->GetLevel( 0, 1 );
+    ASSERT_TRUE( coarseSP != 0 );
+    EXPECT_TRUE( coarseSP->GetPointData()->GetNormals() != 0 );
+    EXPECT_TRUE( coarseSP->GetCellData()->GetArray( "CellId" ) != 0 );
+
+    // The averaged heights follow the points of the level
+    vtkDataArray* levelHeights = coarseSP->GetPointData()->GetArray( "Height" );
+    ASSERT_TRUE( levelHeights != 0 );
+    ASSERT_EQ( coarseSP->GetNumberOfPoints(), levelHeights->GetNumberOfTuples() );
+    double bounds[6];
+    coarseSP->GetBounds( bounds );
+    double binSize = ( bounds[5] - bounds[4] ) / ( cacheSP->GetNumberOfDivisions() / 2 );
+    for( vtkIdType indexPoint = 0; indexPoint < coarseSP->GetNumberOfPoints(); indexPoint++ )
+    {
+        EXPECT_NEAR( coarseSP->GetPoint( indexPoint )[2], levelHeights->GetTuple1( indexPoint ), 2 * binSize );
+    }
+}
+
+TEST( TestPolyDataLODCache, TestSmallStepsGetNoLevels )
+{
+    vtkSmartPointer<vtkPolyDataLODCache> cacheSP = vtkSmartPointer<vtkPolyDataLODCache>::New();
+    vtkSmartPointer<vtkSphereSource> sphereSP = vtkSmartPointer<vtkSphereSource>::New();
+    sphereSP->SetThetaResolution( 4 );
+    sphereSP->SetPhiResolution( 4 );
+    sphereSP->Update();
+    vtkSmartPointer<vtkPolyData> timeStepSP = vtkSmartPointer<vtkPolyData>::New();
+    timeStepSP->ShallowCopy( sphereSP->GetOutput() );
+
+    // Cached anyway, so it is not tried again
+    EXPECT_TRUE( cacheSP->BuildLevels( 0, timeStepSP ) );
+    EXPECT_TRUE( cacheSP->HasLevels( 0 ) );
+    EXPECT_EQ( 0, cacheSP->GetNumberOfBuiltLevels( 0 ) );
+    EXPECT_TRUE( cacheSP->GetLevel( 0, 0 ) == 0 );
+}
@@ -0,0 +1,118 @@
+/*==============================================================================
+
+  Library: MSVTK
+
+  Copyright (c) Computational Image and Simulation Technologies in Biomedicine (CISTIB),
+                Universitat Pompeu Fabra (UPF), Barcelona, Spain
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#include <gtest/gtest.h>
+
+#include <vtkSmartPointer.h>
+#include <vtkMultiThreader.h>
+#include <vtksys/SystemTools.hxx>
+#include "msvReadWriteLock.h"
+
+const unsigned long WaitMillis = 50;
+
+struct LockTestData
+{
+    msvReadWriteLock*                   Lock;
+    volatile int                        Done;
+};
+
+VTK_THREAD_RETURN_TYPE ReadOnce( void* arg )
+{
+    vtkMultiThreader::ThreadInfo* threadInfo = static_cast<vtkMultiThreader::ThreadInfo*>( arg );
+    LockTestData* data = static_cast<LockTestData*>( threadInfo->UserData );
+    data->Lock->LockRead();
+    data->Done = 1;
+    data->Lock->UnlockRead();
+    return VTK_THREAD_RETURN_VALUE;
+}
+
+VTK_THREAD_RETURN_TYPE WriteOnce( void* arg )
+{
+    vtkMultiThreader::ThreadInfo* threadInfo = static_cast<vtkMultiThreader::ThreadInfo*>( arg );
+    LockTestData* data = static_cast<LockTestData*>( threadInfo->UserData );
+    data->Lock->LockWrite();
+    data->Done = 1;
+    data->Lock->UnlockWrite();
+    return VTK_THREAD_RETURN_VALUE;
+}
+
+TEST( TestReadWriteLock, TestReadersShareTheLock )
+{
+    msvReadWriteLockSP lockSP = msvReadWriteLockSP::New();
+    vtkSmartPointer<vtkMultiThreader> multiThreaderSP = vtkSmartPointer<vtkMultiThreader>::New();
+    LockTestData data = { lockSP, 0 };
+
+    // Like a render holding the lock for a whole frame
+    lockSP->LockRead();
+    int threadID = multiThreaderSP->SpawnThread( ReadOnce, &data );
+    multiThreaderSP->TerminateThread( threadID );
+    EXPECT_EQ( 1, data.Done );
+
+    // A thread holding the read lock may take it again
+    lockSP->LockRead();
+    lockSP->UnlockRead();
+    lockSP->UnlockRead();
+
+    msvLockCounters counters;
+    lockSP->GetCounters( counters );
+    EXPECT_EQ( 3u, counters.ReadLocks );
+    EXPECT_EQ( 0u, counters.ContendedReadLocks );
+}
+
+TEST( TestReadWriteLock, TestWriterExcludesEveryone )
+{
+    msvReadWriteLockSP lockSP = msvReadWriteLockSP::New();
+    vtkSmartPointer<vtkMultiThreader> multiThreaderSP = vtkSmartPointer<vtkMultiThreader>::New();
+
+    // A writer waits for the readers
+    LockTestData writerData = { lockSP, 0 };
+    lockSP->LockRead();
+    int threadID = multiThreaderSP->SpawnThread( WriteOnce, &writerData );
+    vtksys::SystemTools::Delay( WaitMillis );
+    EXPECT_EQ( 0, writerData.Done );
+    lockSP->UnlockRead();
+    multiThreaderSP->TerminateThread( threadID );
+    EXPECT_EQ( 1, writerData.Done );
+
+    // And readers wait for the writer
+    LockTestData readerData = { lockSP, 0 };
+    lockSP->LockWrite();
+    threadID = multiThreaderSP->SpawnThread( ReadOnce, &readerData );
+    vtksys::SystemTools::Delay( WaitMillis );
+    EXPECT_EQ( 0, readerData.Done );
+    lockSP->UnlockWrite();
+    multiThreaderSP->TerminateThread( threadID );
+    EXPECT_EQ( 1, readerData.Done );
+
+    msvLockCounters counters;
+    lockSP->GetCounters( counters );
+    EXPECT_EQ( 1u, counters.ContendedReadLocks );
+    EXPECT_EQ( 1u, counters.ContendedWriteLocks );
+    EXPECT_EQ( 2u, counters.WriteLocks );
+    EXPECT_GT( counters.WriteWaitTime, 0.0 );
+    EXPECT_GT( counters.ReadWaitTime, 0.0 );
+    EXPECT_GE( counters.MaximumWriteHoldTime, WaitMillis / 1000.0 * 0.5 );
+
+    lockSP->ResetCounters();
+    lockSP->GetCounters( counters );
+    EXPECT_EQ( 0u, counters.WriteLocks );
+    EXPECT_EQ( 0.0, counters.WriteHoldTime );
+}
@@ -0,0 +1,172 @@
+/*==============================================================================
+
+  Library: MSVTK
+
+  Copyright (c) Computational Image and Simulation Technologies in Biomedicine (CISTIB),
+                Universitat Pompeu Fabra (UPF), Barcelona, Spain
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#include <gtest/gtest.h>
+
+#include <vtkSmartPointer.h>
+#include <vtkCommand.h>
+#include <vtkCallbackCommand.h>
+#include <vtkRenderer.h>
+#include <vtkRenderWindow.h>
+#include <vtkCamera.h>
+#include <vtkSphereSource.h>
+#include <vtkPolyDataMapper.h>
+#include <vtkActor.h>
+#include <vtkTimerLog.h>
+#include <vtksys/SystemTools.hxx>
+#include "msvRenderThread.h"
+
+#include <iostream>
+#include <algorithm>
+
+const int HeavyFrameMillis = 40;
+const int PostedViewStates = 50;
+const double WaitTimeout = 10.0;
+
+// Makes every frame as slow as a big volume
+void RenderHeavyFrame( vtkObject* caller, unsigned long eventId, void* clientData, void* callData )
+{
+    vtksys::SystemTools::Delay( HeavyFrameMillis );
+}
+
+bool WaitForFrames( msvRenderThread* renderThread, unsigned long frames )
+{
+    double startTime = vtkTimerLog::GetUniversalTime();
+    while( renderThread->GetNumberOfRenderedFrames() < frames )
+    {
+        if( vtkTimerLog::GetUniversalTime() - startTime > WaitTimeout )
+        {
+            return false;
+        }
+        vtksys::SystemTools::Delay( 1 );
+    }
+    return true;
+}
+
+class TestRenderThread : public ::testing::Test
+{
+protected:
+    virtual void SetUp()
+    {
+        this->Renderer = vtkSmartPointer<vtkRenderer>::New();
+        this->RenderWindow = vtkSmartPointer<vtkRenderWindow>::New();
+        this->RenderWindow->SetOffScreenRendering( 1 );
+        this->RenderWindow->SetSize( 64, 64 );
+        this->RenderWindow->AddRenderer( this->Renderer );
+
+        vtkSmartPointer<vtkSphereSource> sphere = vtkSmartPointer<vtkSphereSource>::New();
+        vtkSmartPointer<vtkPolyDataMapper> mapper = vtkSmartPointer<vtkPolyDataMapper>::New();
+        mapper->SetInputConnection( sphere->GetOutputPort() );
+        this->Actor = vtkSmartPointer<vtkActor>::New();
+        this->Actor->SetMapper( mapper );
+
+        this->RenderThread = msvRenderThreadSP::New();
+        this->RenderThread->SetRenderWindow( this->RenderWindow );
+        this->RenderThread->SetRenderer( this->Renderer );
+    }
+
+    virtual void TearDown()
+    {
+        this->RenderThread->Stop();
+    }
+
+    vtkSmartPointer<vtkRenderer>        Renderer;
+    vtkSmartPointer<vtkRenderWindow>    RenderWindow;
+    vtkSmartPointer<vtkActor>           Actor;
+    msvRenderThreadSP                   RenderThread;
+};
+
+TEST_F( TestRenderThread, TestPostingNeverWaitsForHeavyFrames )
+{
+    vtkSmartPointer<vtkCallbackCommand> heavyFrame = vtkSmartPointer<vtkCallbackCommand>::New();
+    heavyFrame->SetCallback( RenderHeavyFrame );
+    this->Renderer->AddObserver( vtkCommand::StartEvent, heavyFrame );
+
+    this->RenderThread->PostSceneUpdate( new msvDeferredObjectCall<vtkRenderer, vtkProp>( &vtkRenderer::AddViewProp, this->Renderer, this->Actor ) );
+    this->RenderThread->Start();
+    ASSERT_TRUE( WaitForFrames( this->RenderThread, 1 ) );
+    EXPECT_TRUE( this->Renderer->HasViewProp( this->Actor ) != 0 );
+
+    // Like the interactor moving the camera on every mouse event
+    vtkSmartPointer<vtkCamera> interactionCamera = vtkSmartPointer<vtkCamera>::New();
+    msvViewState viewState;
+    double maximumPostTime = 0.0;
+    for( int i = 0; i < PostedViewStates; i++ )
+    {
+        interactionCamera->Azimuth( 5.0 );
+        msvRenderThread::CaptureViewState( interactionCamera, viewState );
+        double postStartTime = vtkTimerLog::GetUniversalTime();
+        this->RenderThread->PostViewState( viewState );
+        maximumPostTime = std::max( maximumPostTime, vtkTimerLog::GetUniversalTime() - postStartTime );
+        vtksys::SystemTools::Delay( 2 );
+    }
+    this->RenderThread->Stop();
+
+    std::cout << "Frames: " << this->RenderThread->GetNumberOfRenderedFrames()
+              << ", view states applied: " << this->RenderThread->GetNumberOfAppliedViewStates() << "/" << PostedViewStates
+              << ", longest frame: " << this->RenderThread->GetMaximumFrameTime() * 1000.0 << " ms"
+              << ", longest post: " << maximumPostTime * 1000.0 << " ms" << std::endl;
+
+    // The GUI thread never waited for a frame, and the states posted during
+    // a frame collapsed into the newest one
+    EXPECT_LT( maximumPostTime, HeavyFrameMillis / 1000.0 / 4.0 );
+    EXPECT_GE( this->RenderThread->GetMaximumFrameTime(), HeavyFrameMillis / 1000.0 );
+    EXPECT_LT( this->RenderThread->GetNumberOfAppliedViewStates(), static_cast<unsigned long>( PostedViewStates ) );
+
+    // The last one posted is the one rendered last
+    double position[3];
+    this->Renderer->GetActiveCamera()->GetPosition( position );
+    EXPECT_DOUBLE_EQ( viewState.Position[0], position[0] );
+    EXPECT_DOUBLE_EQ( viewState.Position[1], position[1] );
+    EXPECT_DOUBLE_EQ( viewState.Position[2], position[2] );
+}
+
+TEST_F( TestRenderThread, TestWatchedCameraFollowsSceneResets )
+{
+    vtkSmartPointer<vtkCamera> interactionCamera = vtkSmartPointer<vtkCamera>::New();
+    this->RenderThread->WatchCamera( interactionCamera );
+    this->RenderThread->Start();
+    ASSERT_TRUE( WaitForFrames( this->RenderThread, 1 ) );
+
+    // Moving the watched camera posts it
+    interactionCamera->SetPosition( 0.0, 0.0, 10.0 );
+    this->RenderThread->RequestRender();
+    ASSERT_TRUE( WaitForFrames( this->RenderThread, 2 ) );
+    EXPECT_LE( 1u, this->RenderThread->GetNumberOfAppliedViewStates() );
+
+    // A scene update that resets the camera is handed back
+    this->RenderThread->PostSceneUpdate( new msvDeferredObjectCall<vtkRenderer, vtkProp>( &vtkRenderer::AddViewProp, this->Renderer, this->Actor ) );
+    this->RenderThread->PostSceneUpdate( new msvDeferredCall0<vtkRenderer>( &vtkRenderer::ResetCamera, this->Renderer ) );
+    ASSERT_TRUE( WaitForFrames( this->RenderThread, 3 ) );
+
+    unsigned long appliedViewStates = this->RenderThread->GetNumberOfAppliedViewStates();
+    EXPECT_TRUE( this->RenderThread->SyncWatchedCamera() );
+    EXPECT_FALSE( this->RenderThread->SyncWatchedCamera() );
+    this->RenderThread->Stop();
+
+    double renderedPosition[3];
+    double watchedPosition[3];
+    this->Renderer->GetActiveCamera()->GetPosition( renderedPosition );
+    interactionCamera->GetPosition( watchedPosition );
+    EXPECT_DOUBLE_EQ( renderedPosition[2], watchedPosition[2] );
+    // Syncing does not post the camera back
+    EXPECT_EQ( appliedViewStates, this->RenderThread->GetNumberOfAppliedViewStates() );
+}
@@ -0,0 +1,110 @@
+/*==============================================================================
+
+  Library: MSVTK
+
+  Copyright (c) Computational Image and Simulation Technologies in Biomedicine (CISTIB),
+                Universitat Pompeu Fabra (UPF), Barcelona, Spain
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#include <gtest/gtest.h>
+
+#include <vtkSmartPointer.h>
+#include <vtkMultiThreader.h>
+#include <vtksys/SystemTools.hxx>
+#include "msvSPSCRing.h"
+
+const int RingCapacity = 4;
+const int StressItems = 20000;
+
+TEST( TestSPSCRing, TestKeepsOrderAndBounds )
+{
+    msvSPSCRing<int> ring( RingCapacity );
+    EXPECT_TRUE( ring.IsEmpty() );
+    EXPECT_EQ( static_cast<unsigned int>( RingCapacity ), ring.GetFreeSpace() );
+
+    for( int item = 0; item < RingCapacity; item++ )
+    {
+        EXPECT_TRUE( ring.Push( item ) );
+    }
+    EXPECT_FALSE( ring.Push( RingCapacity ) );
+    EXPECT_EQ( 0u, ring.GetFreeSpace() );
+
+    int popped = -1;
+    for( int item = 0; item < RingCapacity; item++ )
+    {
+        EXPECT_TRUE( ring.Pop( popped ) );
+        EXPECT_EQ( item, popped );
+    }
+    EXPECT_FALSE( ring.Pop( popped ) );
+    EXPECT_TRUE( ring.IsEmpty() );
+}
+
+TEST( TestSPSCRing, TestWrapsAround )
+{
+    msvSPSCRing<int> ring( RingCapacity );
+    int popped = -1;
+    for( int item = 0; item < 3 * RingCapacity; item++ )
+    {
+        EXPECT_TRUE( ring.Push( item ) );
+        EXPECT_EQ( 1u, ring.GetSize() );
+        EXPECT_TRUE( ring.Pop( popped ) );
+        EXPECT_EQ( item, popped );
+    }
+}
+
+VTK_THREAD_RETURN_TYPE ProduceItems( void* arg )
+{
+    vtkMultiThreader::ThreadInfo* threadInfo = static_cast<vtkMultiThreader::ThreadInfo*>( arg );
+    msvSPSCRing<int>* ring = static_cast<msvSPSCRing<int>*>( threadInfo->UserData );
+    for( int item = 0; item < StressItems; )
+    {
+        if( ring->Push( item ) )
+        {
+            item++;
+        }
+        else
+        {
+            vtksys::SystemTools::Delay( 0 );
+        }
+    }
+
+    return VTK_THREAD_RETURN_VALUE;
+}
+
+TEST( TestSPSCRing, TestProducerAndConsumerThreads )
+{
+    msvSPSCRing<int> ring( RingCapacity );
+    vtkSmartPointer<vtkMultiThreader> multiThreaderSP = vtkSmartPointer<vtkMultiThreader>::New();
+    int threadID = multiThreaderSP->SpawnThread( ProduceItems, &ring );
+
+    // Every item arrives once and in order
+    int expected = 0;
+    int popped = -1;
+    while( expected < StressItems )
+    {
+        if( ring.Pop( popped ) )
+        {
+            ASSERT_EQ( expected, popped );
+            expected++;
+        }
+        else
+        {
+            vtksys::SystemTools::Delay( 0 );
+        }
+    }
+    multiThreaderSP->TerminateThread( threadID );
+    EXPECT_TRUE( ring.IsEmpty() );
+}
@@ -0,0 +1,232 @@
+/*==============================================================================
+
+  Library: MSVTK
+
+  Copyright (c) Computational Image and Simulation Technologies in Biomedicine (CISTIB),
+                Universitat Pompeu Fabra (UPF), Barcelona, Spain
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#include <gtest/gtest.h>
+
+#include <vtkSmartPointer.h>
+#include <vtkStringArray.h>
+#include <vtkSphereSource.h>
+#include <vtkPolyDataWriter.h>
+#include <vtkPolyData.h>
+#include <vtkTemporalDataSet.h>
+#include <vtkInformation.h>
+#include <vtkInformationVector.h>
+#include <vtkObjectFactory.h>
+#include <vtkTemporalDataSetAlgorithm.h>
+#include <vtkStreamingDemandDrivenPipeline.h>
+#include <vtksys/SystemTools.hxx>
+#include "vtkMultiplePolyDataReader.h"
+#include "vtkTemporalDataSetTimeStepProvider.h"
+
+#include <sstream>
+#include <string>
+#include <vector>
+using namespace std;
+
+const int NumFiles = 6;
+const int WindowSize = 3;
+
+// Passes the time steps of its input through, but the one at SkippedTime
+class vtkTimeStepSkipper : public vtkTemporalDataSetAlgorithm
+{
+public:
+    static vtkTimeStepSkipper* New();
+    vtkTypeMacro( vtkTimeStepSkipper, vtkTemporalDataSetAlgorithm );
+    vtkSetMacro( SkippedTime, double );
+
+protected:
+    vtkTimeStepSkipper() : SkippedTime( -1.0 ) {}
+
+    virtual int RequestData( vtkInformation*, vtkInformationVector** inputVector, vtkInformationVector* outputVector )
+    {
+        vtkInformation* inInfo = inputVector[0]->GetInformationObject( 0 );
+        vtkTemporalDataSet* inData = vtkTemporalDataSet::SafeDownCast( inInfo->Get( vtkDataObject::DATA_OBJECT() ) );
+        vtkTemporalDataSet* outData = vtkTemporalDataSet::GetData( outputVector );
+        double* inTimes = inData->GetInformation()->Get( vtkDataObject::DATA_TIME_STEPS() );
+        int numInTimes = inData->GetInformation()->Length( vtkDataObject::DATA_TIME_STEPS() );
+
+        vector<double> outTimes;
+        outData->Initialize();
+        for( int indexIn = 0; inTimes && ( indexIn < numInTimes ); indexIn++ )
+        {
+            if( inTimes[indexIn] != this->SkippedTime )
+            {
+                outData->SetTimeStep( static_cast<unsigned int>( outTimes.size() ), inData->GetTimeStep( indexIn ) );
+                outTimes.push_back( inTimes[indexIn] );
+            }
+        }
+        if( outTimes.size() )
+        {
+            outData->GetInformation()->Set( vtkDataObject::DATA_TIME_STEPS(), &outTimes[0], static_cast<int>( outTimes.size() ) );
+        }
+        return 1;
+    }
+
+    double SkippedTime;
+};
+
+vtkStandardNewMacro( vtkTimeStepSkipper );
+
+// Every file of the series is a sphere with a different theta resolution, so
+// the number of points tells which file a time step comes from
+class TestTemporalDataSetTimeStepProvider : public ::testing::Test
+{
+protected:
+    virtual void SetUp()
+    {
+        m_SeriesFolder = vtksys::SystemTools::GetCurrentWorkingDirectory() + "/TestTemporalDataSetTimeStepProviderSeries";
+        vtksys::SystemTools::RemoveADirectory( m_SeriesFolder.c_str() );
+        vtksys::SystemTools::MakeDirectory( m_SeriesFolder.c_str() );
+
+        vtkSmartPointer<vtkStringArray> fileNamesSP = vtkSmartPointer<vtkStringArray>::New();
+        vtkSmartPointer<vtkSphereSource> sphereSP = vtkSmartPointer<vtkSphereSource>::New();
+        vtkSmartPointer<vtkPolyDataWriter> writerSP = vtkSmartPointer<vtkPolyDataWriter>::New();
+        writerSP->SetInputConnection( sphereSP->GetOutputPort() );
+        for( int indexFile = 0; indexFile < NumFiles; indexFile++ )
+        {
+            ostringstream fileName;
+            fileName << m_SeriesFolder << "/step" << indexFile << ".vtk";
+            sphereSP->SetThetaResolution( ThetaResolution( indexFile ) );
+            writerSP->SetFileName( fileName.str().c_str() );
+            writerSP->Write();
+            fileNamesSP->InsertNextValue( fileName.str() );
+            m_NumPoints[indexFile] = sphereSP->GetOutput()->GetNumberOfPoints();
+        }
+
+        m_ReaderSP = vtkSmartPointer<vtkMultiplePolyDataReader>::New();
+        m_ReaderSP->SetFileNames( fileNamesSP );
+        m_ReaderSP->TimeStepWrapOn();
+        m_ProviderSP = vtkSmartPointer<vtkTemporalDataSetTimeStepProvider>::New();
+        m_ProviderSP->SetInputConnection( m_ReaderSP->GetOutputPort() );
+        m_ProviderSP->TimeStepWrapOn();
+        m_ProviderSP->SetCacheSize( WindowSize );
+    }
+
+    virtual void TearDown()
+    {
+        m_ProviderSP = 0;
+        m_ReaderSP = 0;
+        vtksys::SystemTools::RemoveADirectory( m_SeriesFolder.c_str() );
+    }
+
+    static int ThetaResolution( int indexFile )
+    {
+        return 8 + indexFile;
+    }
+
+    // Checks that the output holds the window starting at firstStep, in order
+    void ExpectWindow( int firstStep )
+    {
+        vtkTemporalDataSet* output = m_ProviderSP->GetOutput();
+        ASSERT_EQ( static_cast<unsigned int>( WindowSize ), output->GetNumberOfTimeSteps() );
+        for( int windowPosition = 0; windowPosition < WindowSize; windowPosition++ )
+        {
+            vtkPolyData* timeStep = vtkPolyData::SafeDownCast( output->GetTimeStep( windowPosition ) );
+            ASSERT_TRUE( timeStep != 0 );
+            EXPECT_EQ( m_NumPoints[( firstStep + windowPosition ) % NumFiles], timeStep->GetNumberOfPoints() );
+        }
+    }
+
+    string m_SeriesFolder;
+    vtkIdType m_NumPoints[NumFiles];
+    vtkSmartPointer<vtkMultiplePolyDataReader> m_ReaderSP;
+    vtkSmartPointer<vtkTemporalDataSetTimeStepProvider> m_ProviderSP;
+};
+
+TEST_F( TestTemporalDataSetTimeStepProvider, TestSlidingRequestsOneStep )
+{
+    m_ProviderSP->SetNextTimeStep( 0 );
+    m_ProviderSP->Update();
+    EXPECT_EQ( WindowSize, m_ProviderSP->GetLastNumberOfRequestedTimeSteps() );
+    ExpectWindow( 0 );
+
+    // Slide all around the series, wrapping at the end
+    for( int nextTimeStep = 1; nextTimeStep <= NumFiles + 1; nextTimeStep++ )
+    {
+        m_ProviderSP->SetNextTimeStep( nextTimeStep % NumFiles );
+        m_ProviderSP->Update();
+        EXPECT_EQ( 1, m_ProviderSP->GetLastNumberOfRequestedTimeSteps() );
+        ExpectWindow( nextTimeStep % NumFiles );
+    }
+}
+
+TEST_F( TestTemporalDataSetTimeStepProvider, TestJumpRequestsWholeWindow )
+{
+    m_ProviderSP->SetNextTimeStep( 0 );
+    m_ProviderSP->Update();
+
+    m_ProviderSP->SetNextTimeStep( WindowSize );
+    m_ProviderSP->Update();
+    EXPECT_EQ( WindowSize, m_ProviderSP->GetLastNumberOfRequestedTimeSteps() );
+    ExpectWindow( WindowSize );
+
+    // Going back by one keeps the two steps still inside the window
+    m_ProviderSP->SetNextTimeStep( WindowSize - 1 );
+    m_ProviderSP->Update();
+    EXPECT_EQ( 1, m_ProviderSP->GetLastNumberOfRequestedTimeSteps() );
+    ExpectWindow( WindowSize - 1 );
+}
+
+TEST_F( TestTemporalDataSetTimeStepProvider, TestSlidingEvictsTheLeavingStep )
+{
+    m_ProviderSP->SetNextTimeStep( 0 );
+    m_ProviderSP->Update();
+    EXPECT_EQ( 0, m_ProviderSP->GetNumberOfEvictedTimeSteps() );
+
+    m_ProviderSP->SetNextTimeStep( 1 );
+    m_ProviderSP->Update();
+    ASSERT_EQ( 1, m_ProviderSP->GetNumberOfEvictedTimeSteps() );
+    EXPECT_EQ( 0, m_ProviderSP->GetEvictedTimeStep( 0 ) );
+
+    // A jump evicts the whole window but the steps that stay
+    m_ProviderSP->SetNextTimeStep( WindowSize );
+    m_ProviderSP->Update();
+    ASSERT_EQ( WindowSize - 1, m_ProviderSP->GetNumberOfEvictedTimeSteps() );
+    for( int index = 0; index < WindowSize - 1; index++ )
+    {
+        EXPECT_EQ( index + 1, m_ProviderSP->GetEvictedTimeStep( index ) );
+    }
+}
+
+TEST_F( TestTemporalDataSetTimeStepProvider, TestSkippedStepLeavesEmptySlot )
+{
+    vtkSmartPointer<vtkTimeStepSkipper> skipperSP = vtkSmartPointer<vtkTimeStepSkipper>::New();
+    skipperSP->SetInputConnection( m_ReaderSP->GetOutputPort() );
+    m_ProviderSP->SetInputConnection( skipperSP->GetOutputPort() );
+    m_ProviderSP->SetNextTimeStep( 0 );
+    m_ProviderSP->Update();
+    ExpectWindow( 0 );
+
+    // The source does not provide the middle step of the next window, its
+    // position must not keep the dataset of the previous one
+    skipperSP->SetSkippedTime( WindowSize + 1 );
+    m_ProviderSP->SetNextTimeStep( WindowSize );
+    m_ProviderSP->Update();
+    vtkTemporalDataSet* output = m_ProviderSP->GetOutput();
+    ASSERT_EQ( static_cast<unsigned int>( WindowSize ), output->GetNumberOfTimeSteps() );
+    EXPECT_TRUE( output->GetTimeStep( 1 ) == 0 );
+    vtkPolyData* firstStep = vtkPolyData::SafeDownCast( output->GetTimeStep( 0 ) );
+    vtkPolyData* lastStep = vtkPolyData::SafeDownCast( output->GetTimeStep( 2 ) );
+    ASSERT_TRUE( firstStep != 0 );
+    ASSERT_TRUE( lastStep != 0 );
+    EXPECT_EQ( m_NumPoints[WindowSize], firstStep->GetNumberOfPoints() );
+    EXPECT_EQ( m_NumPoints[WindowSize + 2], lastStep->GetNumberOfPoints() );
+}
@@ -0,0 +1,181 @@
+/*==============================================================================
+
+  Library: MSVTK
+
+  Copyright (c) Computational Image and Simulation Technologies in Biomedicine (CISTIB),
+                Universitat Pompeu Fabra (UPF), Barcelona, Spain
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+#include <gtest/gtest.h>
+
+#include <vtkSmartPointer.h>
+#include <vtkTimerLog.h>
+#include "msvReadWriteLock.h"
+#include "msvDeferredCommandQueue.h"
+#include "msvThreadSafeGetSet.h"
+
+const int BenchmarkCalls = 2000000;
+
+// Stands for the wrapped VTK object
+class Target
+{
+public:
+    Target() : Value( 0 ), Scale( 1.0 ) { this->Color[0] = this->Color[1] = this->Color[2] = 0.0; }
+
+    void SetValue( int value ) { this->Value = value; }
+    int GetValue() { return this->Value; }
+    void SetScale( double scale ) { this->Scale = scale; }
+    double GetScale() { return this->Scale; }
+    void SetColor( double r, double g, double b ) { this->Color[0] = r; this->Color[1] = g; this->Color[2] = b; }
+    double* GetColor() { return this->Color; }
+    void GetColor( double color[3] ) { color[0] = this->Color[0]; color[1] = this->Color[1]; color[2] = this->Color[2]; }
+
+private:
+    int                                 Value;
+    double                              Scale;
+    double                              Color[3];
+};
+
+// One wrapper per policy, as the thread-safe classes declare them
+#define DECLARE_SAFE_TARGET(className,scalarAccess,compoundAccess) \
+    class className \
+    { \
+    public: \
+        typedef Target ImplType; \
+        typedef scalarAccess ScalarAccess; \
+        typedef compoundAccess CompoundAccess; \
+        className( Target* impl, msvReadWriteLock* mutex, msvDeferredCommandQueue* writes ) \
+            : Impl( impl ), Mutex( mutex ), Writes( writes ) {} \
+        vtkSafeSetMacro( Value, int ); \
+        vtkSafeGetMacro( Value, int ); \
+        vtkSafeSetMacro( Scale, double ); \
+        vtkSafeGetMacro( Scale, double ); \
+        vtkSafeSetVector3Macro( Color, double ); \
+        vtkSafeGetVectorMacro( Color, double, 3 ); \
+    private: \
+        void QueueWrite( msvDeferredCommand* command ) { this->Writes->Push( command ); } \
+        Target*                         Impl; \
+        msvReadWriteLock*               Mutex; \
+        msvDeferredCommandQueue*        Writes; \
+    };
+
+DECLARE_SAFE_TARGET( UnsynchronizedTarget, msvUnsynchronizedAccess, msvUnsynchronizedAccess )
+DECLARE_SAFE_TARGET( AtomicTarget, msvAtomicScalarAccess, msvLockedAccess )
+DECLARE_SAFE_TARGET( LockedTarget, msvLockedAccess, msvLockedAccess )
+
+template <class SafeTarget>
+void CheckAccessors( bool defersWrites )
+{
+    Target target;
+    msvReadWriteLockSP mutex = msvReadWriteLockSP::New();
+    msvDeferredCommandQueueSP writes = msvDeferredCommandQueueSP::New();
+    SafeTarget safeTarget( &target, mutex, writes );
+
+    safeTarget.SetValue( 3 );
+    safeTarget.SetScale( 0.5 );
+    safeTarget.SetColor( 0.1, 0.2, 0.3 );
+
+    // Deferred writes only show once the queue is applied
+    EXPECT_EQ( defersWrites ? 3 : 0, writes->GetNumberOfPendingCommands() );
+    writes->ApplyAll();
+
+    EXPECT_EQ( 3, safeTarget.GetValue() );
+    EXPECT_DOUBLE_EQ( 0.5, safeTarget.GetScale() );
+    double color[3];
+    safeTarget.GetColor( color );
+    EXPECT_DOUBLE_EQ( 0.2, color[1] );
+    EXPECT_DOUBLE_EQ( 0.3, safeTarget.GetColor()[2] );
+}
+
+TEST( TestThreadSafeGetSet, TestUnsynchronizedAccess )
+{
+    CheckAccessors<UnsynchronizedTarget>( false );
+}
+
+TEST( TestThreadSafeGetSet, TestAtomicScalarAccess )
+{
+    CheckAccessors<AtomicTarget>( true );
+}
+
+TEST( TestThreadSafeGetSet, TestLockedAccess )
+{
+    CheckAccessors<LockedTarget>( true );
+}
+
+TEST( TestThreadSafeGetSet, TestAtomicScalarAccessLeavesTheLockFree )
+{
+    Target target;
+    msvReadWriteLockSP mutex = msvReadWriteLockSP::New();
+    msvDeferredCommandQueueSP writes = msvDeferredCommandQueueSP::New();
+    AtomicTarget safeTarget( &target, mutex, writes );
+
+    safeTarget.GetValue();
+    safeTarget.GetScale();
+    msvLockCounters counters;
+    mutex->GetCounters( counters );
+    // Only values wider than a pointer take the read lock
+    EXPECT_EQ( sizeof( double ) <= sizeof( void* ) ? 0u : 1u, counters.ReadLocks );
+
+    safeTarget.GetColor();
+    mutex->GetCounters( counters );
+    EXPECT_EQ( sizeof( double ) <= sizeof( void* ) ? 1u : 2u, counters.ReadLocks );
+}
+
+// Nanoseconds per call of each getter of the wrapper
+template <class SafeTarget>
+void BenchmarkGetters( const char* policyName )
+{
+    Target target;
+    msvReadWriteLockSP mutex = msvReadWriteLockSP::New();
+    msvDeferredCommandQueueSP writes = msvDeferredCommandQueueSP::New();
+    SafeTarget safeTarget( &target, mutex, writes );
+
+    // Keeps the loops from being optimized away
+    volatile double sink = 0.0;
+
+    double startTime = vtkTimerLog::GetUniversalTime();
+    for( int i = 0; i < BenchmarkCalls; ++i )
+    {
+        sink += safeTarget.GetValue();
+    }
+    double valueTime = vtkTimerLog::GetUniversalTime() - startTime;
+
+    startTime = vtkTimerLog::GetUniversalTime();
+    for( int i = 0; i < BenchmarkCalls; ++i )
+    {
+        sink += safeTarget.GetScale();
+    }
+    double scaleTime = vtkTimerLog::GetUniversalTime() - startTime;
+
+    startTime = vtkTimerLog::GetUniversalTime();
+    double color[3];
+    for( int i = 0; i < BenchmarkCalls; ++i )
+    {
+        safeTarget.GetColor( color );
+        sink += color[0];
+    }
+    double colorTime = vtkTimerLog::GetUniversalTime() - startTime;
+
+    const double nanoseconds = 1.0e9 / BenchmarkCalls;
+    std::cout << policyName << ": GetValue " << valueTime * nanoseconds << " ns, GetScale "
+              << scaleTime * nanoseconds << " ns, GetColor " << colorTime * nanoseconds << " ns" << std::endl;
+}
+
+TEST( TestThreadSafeGetSet, BenchmarkAccessorCost )
+{
+    BenchmarkGetters<UnsynchronizedTarget>( "Unsynchronized" );
+    BenchmarkGetters<AtomicTarget>( "Atomic scalars" );
+    BenchmarkGetters<LockedTarget>( "Locked" );
+}
@@ -0,0 +1,96 @@
+/*==============================================================================
+
+  Library: MSVTK
+
+  Copyright (c) Computational Image and Simulation Technologies in Biomedicine (CISTIB),
+                Universitat Pompeu Fabra (UPF), Barcelona, Spain
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#include <gtest/gtest.h>
+
+#include <vtkSmartPointer.h>
+#include <vtkMultiThreader.h>
+#include <vtksys/SystemTools.hxx>
+#include "msvTripleBuffer.h"
+
+const int StressValues = 200000;
+
+// Both halves always hold the same value unless a slot is torn
+struct PairedValue
+{
+    PairedValue() : First( 0 ), Second( 0 ) {}
+    int                                 First;
+    int                                 Second;
+};
+
+TEST( TestTripleBuffer, TestKeepsTheNewestValue )
+{
+    msvTripleBuffer<int> buffer;
+    EXPECT_FALSE( buffer.Update() );
+
+    buffer.Publish( 1 );
+    buffer.Publish( 2 );
+    EXPECT_TRUE( buffer.Update() );
+    EXPECT_EQ( 2, buffer.GetFront() );
+
+    // Nothing new: the front value stays
+    EXPECT_FALSE( buffer.Update() );
+    EXPECT_EQ( 2, buffer.GetFront() );
+
+    buffer.Publish( 3 );
+    EXPECT_TRUE( buffer.Update() );
+    EXPECT_EQ( 3, buffer.GetFront() );
+}
+
+VTK_THREAD_RETURN_TYPE PublishValues( void* arg )
+{
+    vtkMultiThreader::ThreadInfo* threadInfo = static_cast<vtkMultiThreader::ThreadInfo*>( arg );
+    msvTripleBuffer<PairedValue>* buffer = static_cast<msvTripleBuffer<PairedValue>*>( threadInfo->UserData );
+    PairedValue value;
+    for( int i = 1; i <= StressValues; i++ )
+    {
+        value.First = i;
+        value.Second = i;
+        buffer->Publish( value );
+    }
+    return VTK_THREAD_RETURN_VALUE;
+}
+
+TEST( TestTripleBuffer, TestWriterAndReaderThreads )
+{
+    msvTripleBuffer<PairedValue> buffer;
+    vtkSmartPointer<vtkMultiThreader> multiThreaderSP = vtkSmartPointer<vtkMultiThreader>::New();
+    int threadID = multiThreaderSP->SpawnThread( PublishValues, &buffer );
+
+    // Values only move forward and are never torn
+    int lastValue = 0;
+    while( lastValue < StressValues )
+    {
+        if( buffer.Update() )
+        {
+            const PairedValue& value = buffer.GetFront();
+            ASSERT_EQ( value.First, value.Second );
+            ASSERT_GT( value.First, lastValue );
+            lastValue = value.First;
+        }
+        else
+        {
+            vtksys::SystemTools::Delay( 0 );
+        }
+    }
+    multiThreaderSP->TerminateThread( threadID );
+    EXPECT_FALSE( buffer.Update() );
+}
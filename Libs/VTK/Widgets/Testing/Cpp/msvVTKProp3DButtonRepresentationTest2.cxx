@@ -0,0 +1,163 @@
+/*==============================================================================
+
+  Program: MSVTK
+
+  Copyright (c) Kitware Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// MSVTK includes
+#include "msvVTKProp3DButtonRepresentation.h"
+
+// STD includes
+#include <cstdlib>
+#include <iostream>
+
+// VTK includes
+#include <vtkActor.h>
+#include <vtkButtonRepresentation.h>
+#include <vtkCamera.h>
+#include <vtkNew.h>
+#include <vtkPolyDataMapper.h>
+#include <vtkRenderer.h>
+#include <vtkRenderWindow.h>
+#include <vtkSphereSource.h>
+
+// Check the analytic picking modes. Nothing is rendered in this test.
+// -----------------------------------------------------------------------------
+int msvVTKProp3DButtonRepresentationTest2(int, char* [])
+{
+  vtkNew<vtkSphereSource> sphere;
+  sphere->SetRadius(0.5);
+  sphere->SetThetaResolution(16);
+  sphere->SetPhiResolution(16);
+  vtkNew<vtkPolyDataMapper> sphereMapper;
+  sphereMapper->SetInputConnection(sphere->GetOutputPort());
+  vtkNew<vtkActor> sphereActor;
+  sphereActor->SetMapper(sphereMapper.GetPointer());
+
+  vtkNew<msvVTKProp3DButtonRepresentation> prop3DButtonRep;
+  if (prop3DButtonRep->GetPickingMode() !=
+      msvVTKProp3DButtonRepresentation::HardwarePicking)
+    {
+    std::cerr << "Error: HardwarePicking is not the default picking mode."
+              << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Empty representation
+  double p1[3] = {0., 0., 5.};
+  double p2[3] = {0., 0., -5.};
+  prop3DButtonRep->SetPickingModeToBounds();
+  if (prop3DButtonRep->IntersectWithLine(p1, p2))
+    {
+    std::cerr << "Error: an empty representation was picked." << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  prop3DButtonRep->SetNumberOfStates(1);
+  prop3DButtonRep->SetButtonProp(0, sphereActor.GetPointer());
+  prop3DButtonRep->SetState(0);
+
+  // Ray through the center: picked in all modes
+  if (!prop3DButtonRep->IntersectWithLine(p1, p2))
+    {
+    std::cerr << "Error: [Bounds] center ray missed the button." << std::endl;
+    return EXIT_FAILURE;
+    }
+  prop3DButtonRep->SetPickingModeToGeometry();
+  if (!prop3DButtonRep->IntersectWithLine(p1, p2))
+    {
+    std::cerr << "Error: [Geometry] center ray missed the button." << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Segment stopping before the button
+  double p3[3] = {0., 0., 1.};
+  if (prop3DButtonRep->IntersectWithLine(p1, p3))
+    {
+    std::cerr << "Error: a segment ending before the button picked it."
+              << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Ray through a corner of the bounding box: only the bounds are hit
+  double p4[3] = {0.45, 0.45, 5.};
+  double p5[3] = {0.45, 0.45, -5.};
+  if (prop3DButtonRep->IntersectWithLine(p4, p5))
+    {
+    std::cerr << "Error: [Geometry] corner ray picked the button." << std::endl;
+    return EXIT_FAILURE;
+    }
+  prop3DButtonRep->SetPickingModeToBounds();
+  if (!prop3DButtonRep->IntersectWithLine(p4, p5))
+    {
+    std::cerr << "Error: [Bounds] corner ray missed the button." << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // The prop transform is taken into account
+  sphereActor->SetPosition(2., 0., 0.);
+  prop3DButtonRep->SetPickingModeToGeometry();
+  if (prop3DButtonRep->IntersectWithLine(p1, p2))
+    {
+    std::cerr << "Error: ray picked a moved button." << std::endl;
+    return EXIT_FAILURE;
+    }
+  double p6[3] = {2., 0., 5.};
+  double p7[3] = {2., 0., -5.};
+  if (!prop3DButtonRep->IntersectWithLine(p6, p7))
+    {
+    std::cerr << "Error: ray missed a moved button." << std::endl;
+    return EXIT_FAILURE;
+    }
+  sphereActor->SetPosition(0., 0., 0.);
+
+  // Display to world picking, without rendering
+  vtkNew<vtkRenderer> render;
+  vtkNew<vtkRenderWindow> renWin;
+  renWin->AddRenderer(render.GetPointer());
+  renWin->SetSize(300, 300);
+  render->GetActiveCamera()->SetPosition(0., 0., 5.);
+  render->GetActiveCamera()->SetFocalPoint(0., 0., 0.);
+  render->ResetCameraClippingRange(-1., 1., -1., 1., -1., 1.);
+  prop3DButtonRep->SetRenderer(render.GetPointer());
+
+  if (prop3DButtonRep->ComputeInteractionState(150, 150) !=
+      vtkButtonRepresentation::Inside)
+    {
+    std::cerr << "Error: center of the window is not inside the button."
+              << std::endl;
+    return EXIT_FAILURE;
+    }
+  if (prop3DButtonRep->ComputeInteractionState(5, 5) !=
+      vtkButtonRepresentation::Outside)
+    {
+    std::cerr << "Error: corner of the window is not outside the button."
+              << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  vtkNew<msvVTKProp3DButtonRepresentation> prop3DButtonRepCopy;
+  prop3DButtonRepCopy->ShallowCopy(prop3DButtonRep.GetPointer());
+  if (prop3DButtonRepCopy->GetPickingMode() !=
+      msvVTKProp3DButtonRepresentation::GeometryPicking)
+    {
+    std::cerr << "Error: picking mode not copied by ShallowCopy." << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -31,11 +31,17 @@
      PURPOSE.  See the above copyright notice for more information.
 
 =========================================================================*/
+#include "vtkActor.h"
 #include "vtkAssemblyPath.h"
+#include "vtkBox.h"
 #include "vtkCamera.h"
+#include "vtkCell.h"
 #include "vtkCoordinate.h"
+#include "vtkDataSet.h"
+#include "vtkGenericCell.h"
 #include "vtkInteractorObserver.h"
 #include "vtkMath.h"
+#include "vtkMapper.h"
 #include "vtkMatrix4x4.h"
 #include "vtkNew.h"
 #include "vtkObjectFactory.h"
@@ -80,6 +86,7 @@ msvVTKProp3DButtonRepresentation::msvVTKProp3DButtonRepresentation()
 
   this->Picker = vtkPropPicker::New();
   this->Picker->PickFromListOn();
+  this->PickingMode = HardwarePicking;
 }
 
 //----------------------------------------------------------------------
@@ -258,11 +265,21 @@ void msvVTKProp3DButtonRepresentation::PlaceWidget(double bds[6])
 int msvVTKProp3DButtonRepresentation
 ::ComputeInteractionState(int X, int Y, int vtkNotUsed(modify))
 {
-  this->VisibilityOn(); //actor must be on to be picked
-  this->Picker->Pick(X,Y,0.0,this->Renderer);
-  vtkAssemblyPath *path = this->Picker->GetPath();
+  int picked = 0;
+  if ( this->PickingMode == HardwarePicking )
+    {
+    this->VisibilityOn(); //actor must be on to be picked
+    this->Picker->Pick(X,Y,0.0,this->Renderer);
+    picked = (this->Picker->GetPath() != NULL);
+    }
+  else
+    {
+    double p1[3], p2[3];
+    picked = this->ComputePickRay(X, Y, p1, p2) &&
+             this->IntersectWithLine(p1, p2);
+    }
 
-  if ( path != NULL )
+  if ( picked )
     {
     this->InteractionState = vtkButtonRepresentation::Inside;
     }
@@ -274,6 +291,120 @@ int msvVTKProp3DButtonRepresentation
   return this->InteractionState;
 }
 
+//-------------------------------------------------------------------------
+int msvVTKProp3DButtonRepresentation
+::ComputePickRay(int X, int Y, double p1[3], double p2[3])
+{
+  if ( !this->Renderer )
+    {
+    return 0;
+    }
+
+  // Display depth 0 and 1 map to the near and far clipping planes.
+  double worldPt[4];
+  vtkInteractorObserver::ComputeDisplayToWorld(this->Renderer,
+    static_cast<double>(X), static_cast<double>(Y), 0.0, worldPt);
+  p1[0] = worldPt[0]; p1[1] = worldPt[1]; p1[2] = worldPt[2];
+  vtkInteractorObserver::ComputeDisplayToWorld(this->Renderer,
+    static_cast<double>(X), static_cast<double>(Y), 1.0, worldPt);
+  p2[0] = worldPt[0]; p2[1] = worldPt[1]; p2[2] = worldPt[2];
+
+  return 1;
+}
+
+//-------------------------------------------------------------------------
+int msvVTKProp3DButtonRepresentation
+::IntersectWithLine(double p1[3], double p2[3])
+{
+  if ( !this->CurrentProp || !this->GetVisibility() )
+    {
+    return 0;
+    }
+
+  if ( !this->IntersectBoundsWithLine(p1, p2) )
+    {
+    return 0;
+    }
+
+  if ( this->PickingMode != GeometryPicking )
+    {
+    return 1;
+    }
+
+  return this->IntersectGeometryWithLine(p1, p2);
+}
+
+//-------------------------------------------------------------------------
+int msvVTKProp3DButtonRepresentation
+::IntersectBoundsWithLine(double p1[3], double p2[3])
+{
+  double *bounds = this->GetBounds();
+  if ( bounds == NULL || !vtkMath::AreBoundsInitialized(bounds) )
+    {
+    return 0;
+    }
+
+  // IntersectBox() does not handle a segment starting inside the box.
+  if ( p1[0] >= bounds[0] && p1[0] <= bounds[1] &&
+       p1[1] >= bounds[2] && p1[1] <= bounds[3] &&
+       p1[2] >= bounds[4] && p1[2] <= bounds[5] )
+    {
+    return 1;
+    }
+
+  double dir[3], coord[3], t;
+  dir[0] = p2[0] - p1[0];
+  dir[1] = p2[1] - p1[1];
+  dir[2] = p2[2] - p1[2];
+  return vtkBox::IntersectBox(bounds, p1, dir, coord, t) && t <= 1.0;
+}
+
+//-------------------------------------------------------------------------
+int msvVTKProp3DButtonRepresentation
+::IntersectGeometryWithLine(double p1[3], double p2[3])
+{
+  vtkActor *actor = vtkActor::SafeDownCast(this->CurrentProp);
+  vtkDataSet *input = (actor && actor->GetMapper()) ?
+    actor->GetMapper()->GetInput() : NULL;
+  if ( input == NULL || input->GetNumberOfCells() == 0 )
+    {
+    // No geometry to test against, the bounds test is all we have.
+    return 1;
+    }
+
+  // Bring the ray into the model coordinates of the prop rather than
+  // transforming every point of the geometry. When following the camera,
+  // the follower sets its matrix as the user matrix of the prop.
+  vtkNew<vtkMatrix4x4> inverse;
+  vtkMatrix4x4::Invert(this->CurrentProp->GetMatrix(), inverse.GetPointer());
+  double q1[4] = {p1[0], p1[1], p1[2], 1.0};
+  double q2[4] = {p2[0], p2[1], p2[2], 1.0};
+  inverse->MultiplyPoint(q1, q1);
+  inverse->MultiplyPoint(q2, q2);
+  for (int i=0; i < 3; ++i)
+    {
+    q1[i] /= q1[3];
+    q2[i] /= q2[3];
+    }
+
+  double tol = 1e-6 * sqrt(input->GetLength2());
+  double t, x[3], pcoords[3];
+  int subId;
+  vtkNew<vtkGenericCell> cell;
+  vtkIdType numCells = input->GetNumberOfCells();
+  for (vtkIdType cellId=0; cellId < numCells; ++cellId)
+    {
+    input->GetCell(cellId, cell.GetPointer());
+    if ( cell->GetCellDimension() == 2 &&
+         cell->IntersectWithLine(q1, q2, tol, t, x, pcoords, subId) )
+      {
+      return 1;
+      }
+    }
+
+  return 0;
+}
+
 //----------------------------------------------------------------------
 void msvVTKProp3DButtonRepresentation::BuildRepresentation()
 {
@@ -320,6 +451,7 @@ void msvVTKProp3DButtonRepresentation::ShallowCopy(vtkProp *prop)
       }
     }
   this->FollowCamera = rep->FollowCamera;
+  this->PickingMode = rep->PickingMode;
 
   this->Superclass::ShallowCopy(prop);
 }
@@ -444,6 +576,7 @@ void msvVTKProp3DButtonRepresentation::PrintSelf(ostream& os, vtkIndent indent)
   this->Superclass::PrintSelf(os,indent);
 
   os << indent << "Follow Camera: " << (this->FollowCamera ? "On\n" : "Off\n");
+  os << indent << "Picking Mode: " << this->PickingMode << "\n";
 
   os << indent << "3D Props: \n";
   vtkPropArrayIterator iter;
@@ -49,6 +49,12 @@
 // you must define the number of button states and each state (i.e., vtkProp3D)
 // prior to calling vtkPlaceWidget.
 
+// The representation can be picked in several ways, see SetPickingMode().
+// HardwarePicking relies on vtkPropPicker and renders to pick. BoundsPicking
+// and GeometryPicking cast the pick ray analytically in world space against
+// the bounding box or the polygons of the current button prop; they never
+// render and can therefore be used without a display.
+
 // .SECTION See Also
 // vtkButtonWidget vtkButtonRepresentation vtkButtonSource vtkEllipticalButtonSource
 // vtkRectangularButtonSource
@@ -95,6 +101,36 @@ public:
   vtkGetMacro(FollowCamera,int);
   vtkBooleanMacro(FollowCamera,int);
 
+  // Description:
+  // Specify how the button is picked in ComputeInteractionState().
+  // HardwarePicking (default) uses a vtkPropPicker, which renders to pick.
+  // BoundsPicking intersects the pick ray with the world bounds of the
+  // current prop. GeometryPicking first rejects the ray against the bounds,
+  // then intersects it with the polygons of the current prop (if the prop is
+  // a vtkActor whose mapper has a dataset input, otherwise it behaves as
+  // BoundsPicking).
+  enum PickingModes
+    {
+    HardwarePicking = 0,
+    BoundsPicking,
+    GeometryPicking
+    };
+  vtkSetClampMacro(PickingMode,int,HardwarePicking,GeometryPicking);
+  vtkGetMacro(PickingMode,int);
+  void SetPickingModeToHardware()
+    {this->SetPickingMode(HardwarePicking);}
+  void SetPickingModeToBounds()
+    {this->SetPickingMode(BoundsPicking);}
+  void SetPickingModeToGeometry()
+    {this->SetPickingMode(GeometryPicking);}
+
+  // Description:
+  // Intersect the line segment p1-p2 (world coordinates) with the current
+  // button prop using the analytic test selected by PickingMode
+  // (HardwarePicking is treated as BoundsPicking). Return 1 if the segment
+  // hits the button, 0 otherwise. No rendering is involved.
+  virtual int IntersectWithLine(double p1[3], double p2[3]);
+
   // Description:
   // Extend the vtkButtonRepresentation::SetState() method.
   virtual void SetState(int state);
@@ -137,6 +173,18 @@ protected:
 
   // For picking the button
   vtkPropPicker *Picker;
+  int PickingMode;
+
+  // Description:
+  // Compute the world coordinates of the pick ray going through the display
+  // position (X,Y), from the near (p1) to the far (p2) clipping plane.
+  // Return 0 if there is no renderer to compute it.
+  int ComputePickRay(int X, int Y, double p1[3], double p2[3]);
+
+  // Description:
+  // Analytic intersection tests used by IntersectWithLine().
+  int IntersectBoundsWithLine(double p1[3], double p2[3]);
+  int IntersectGeometryWithLine(double p1[3], double p2[3]);
 
 private:
   msvVTKProp3DButtonRepresentation(const msvVTKProp3DButtonRepresentation&);  //Not implemented